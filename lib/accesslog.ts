@@ -0,0 +1,174 @@
+/**
+ * Batched Access Log
+ *
+ * Logging each request with a synchronous console.log (a fresh ISO
+ * timestamp, and a body re-measured by wrapping res.send) costs main-thread
+ * time at high request rates and can block on a slow stdout. The access log
+ * instead:
+ *
+ * - takes response sizes from Content-Length, or from the socket's byte
+ *   counter (bytes on the wire) for chunked or compressed responses
+ * - records each finished request into a preallocated ring buffer of
+ *   SGP4_ACCESS_LOG_BUFFER entries (fields only, no formatting)
+ * - formats and writes the buffered entries as one stdout write every
+ *   SGP4_ACCESS_LOG_FLUSH_MS, reusing the timestamp text within a second
+ * - logs only a SGP4_ACCESS_LOG_SAMPLE fraction of successful requests
+ *   faster than SGP4_ACCESS_LOG_SLOW_MS; errors and slow requests always
+ * - drops entries (and counts them) when the buffer is full because stdout
+ *   cannot keep up, instead of blocking or growing without bound
+ *
+ * Line format is unchanged:
+ * `<timestamp> - <ip> - [<tag>] "<method> <path> <protocol>" <status> <bytes>`
+ */
+
+import type { Request, Response, NextFunction } from 'express';
+
+/** Skip a flush while stdout holds more than this many unwritten bytes */
+const STDOUT_BACKLOG_BYTES = 1 << 20;
+
+/** Access log statistics */
+export interface AccessLogStats {
+  logged: number;
+  /** Successful fast requests not sampled */
+  sampledOut: number;
+  /** Entries lost to a full buffer */
+  dropped: number;
+  buffered: number;
+  capacity: number;
+  sampleRate: number;
+}
+
+/**
+ * Ring-buffered access log with timed batch writes
+ */
+export class AccessLog {
+  readonly capacity: number;
+  readonly sampleRate: number;
+  readonly slowMs: number;
+  readonly flushMs: number;
+  private tag: string;
+  private time: Float64Array;
+  private status: Uint16Array;
+  private bytes: Float64Array;
+  private ip: string[];
+  private request: string[];
+  private head = 0;
+  private count = 0;
+  private logged = 0;
+  private sampledOut = 0;
+  private dropped = 0;
+  private droppedReported = 0;
+  private stampSecond = -1;
+  private stampText = '';
+
+  /**
+   * @param tag - Server identification inside the brackets of each line
+   */
+  constructor(tag: string) {
+    this.tag = tag;
+    this.capacity = parseInt(process.env.SGP4_ACCESS_LOG_BUFFER || '', 10) || 8192;
+    const rate = parseFloat(process.env.SGP4_ACCESS_LOG_SAMPLE || '');
+    this.sampleRate = Number.isNaN(rate) ? 1 : Math.min(1, Math.max(0, rate));
+    this.slowMs = parseFloat(process.env.SGP4_ACCESS_LOG_SLOW_MS || '') || 1000;
+    this.flushMs = parseInt(process.env.SGP4_ACCESS_LOG_FLUSH_MS || '', 10) || 1000;
+    this.time = new Float64Array(this.capacity);
+    this.status = new Uint16Array(this.capacity);
+    this.bytes = new Float64Array(this.capacity);
+    this.ip = new Array<string>(this.capacity).fill('');
+    this.request = new Array<string>(this.capacity).fill('');
+
+    setInterval(() => this.flush(), this.flushMs).unref();
+    process.on('exit', () => this.flush());
+  }
+
+  /**
+   * Express middleware recording every finished request
+   */
+  middleware(): (req: Request, res: Response, next: NextFunction) => void {
+    return (req, res, next) => {
+      const start = performance.now();
+      // req.socket is unset once a response closing its connection finishes
+      const socket = req.socket;
+      const socketBytes = socket.bytesWritten;
+      const ip = req.ip || socket.remoteAddress || '-';
+      res.on('finish', () => {
+        const status = res.statusCode;
+        if (status < 400 && performance.now() - start < this.slowMs && Math.random() >= this.sampleRate) {
+          this.sampledOut++;
+          return;
+        }
+        const length = Number(res.getHeader('content-length'));
+        this.push(
+          status,
+          Number.isFinite(length) ? length : socket.bytesWritten - socketBytes,
+          ip,
+          `${req.method} ${req.originalUrl} HTTP/${req.httpVersion}`
+        );
+      });
+      next();
+    };
+  }
+
+  private push(status: number, bytes: number, ip: string, request: string): void {
+    if (this.count === this.capacity) {
+      this.dropped++;
+      return;
+    }
+    const slot = (this.head + this.count) % this.capacity;
+    this.time[slot] = Date.now();
+    this.status[slot] = status;
+    this.bytes[slot] = bytes;
+    this.ip[slot] = ip;
+    this.request[slot] = request;
+    this.count++;
+  }
+
+  /**
+   * Write the buffered entries to stdout (kept while stdout is backed up)
+   */
+  flush(): void {
+    if (this.count === 0 && this.dropped === this.droppedReported) {
+      return;
+    }
+    if (process.stdout.writableLength > STDOUT_BACKLOG_BYTES) {
+      return;
+    }
+
+    let out = '';
+    for (; this.count > 0; this.count--) {
+      const slot = this.head;
+      out +=
+        `${this.timestamp(this.time[slot])} - ${this.ip[slot]} - [${this.tag}] ` +
+        `"${this.request[slot]}" ${this.status[slot]} ${this.bytes[slot]}\n`;
+      this.ip[slot] = this.request[slot] = '';
+      this.head = (this.head + 1) % this.capacity;
+      this.logged++;
+    }
+    if (this.dropped > this.droppedReported) {
+      out += `Access log: ${this.dropped - this.droppedReported} entries dropped (buffer full)\n`;
+      this.droppedReported = this.dropped;
+    }
+    process.stdout.write(out);
+  }
+
+  /** ISO timestamp with +00:00, the text up to the seconds reused */
+  private timestamp(ms: number): string {
+    const second = Math.floor(ms / 1000);
+    if (second !== this.stampSecond) {
+      this.stampSecond = second;
+      this.stampText = new Date(second * 1000).toISOString().slice(0, 19);
+    }
+    return `${this.stampText}.${String(ms - second * 1000).padStart(3, '0')}+00:00`;
+  }
+
+  get stats(): AccessLogStats {
+    return {
+      logged: this.logged,
+      sampledOut: this.sampledOut,
+      dropped: this.dropped,
+      buffered: this.count,
+      capacity: this.capacity,
+      sampleRate: this.sampleRate,
+    };
+  }
+}
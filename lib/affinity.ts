@@ -0,0 +1,149 @@
+/**
+ * Satellite-to-Worker Affinity Routing
+ *
+ * Idle workers are otherwise picked first-found, so repeated requests for a
+ * satellite land on arbitrary workers and each worker's cache of prepared
+ * TLEs (parsed elements, and on the native pool initialized propagators)
+ * hits only by chance. With SGP4_AFFINITY=on, a range task is routed by
+ * (NORAD ID, model) instead:
+ *
+ * - Rendezvous hashing ranks the ready workers per key; resizing the pool
+ *   only moves the keys of the workers added or removed.
+ * - Bounded-load spillover: the task takes the first idle worker among the
+ *   key's SGP4_AFFINITY_CHOICES top-ranked ones, else any idle worker. A
+ *   hot satellite therefore spreads over a few workers instead of queueing
+ *   behind one, each key is cached on at most that many workers rather
+ *   than all N, and no worker idles while a task waits.
+ *
+ * Tasks without a single satellite (batches, pipelines, events) go to any
+ * idle worker. Workers keep up to SGP4_WORKER_CACHE prepared TLEs each in a
+ * TLECache (0 disables it).
+ */
+
+/** A worker as seen by the router */
+export interface RoutedWorker {
+  id: number;
+  ready: boolean;
+  busy: boolean;
+}
+
+/** Affinity statistics */
+export interface AffinityStats {
+  enabled: boolean;
+  choices: number;
+  /** Routed tasks that ran on one of their key's preferred workers */
+  preferred: number;
+  /** Routed tasks spilled over to another idle worker */
+  spilled: number;
+}
+
+/**
+ * Affinity key of a range task: NORAD ID (line 1 columns 3-7) and model
+ */
+export function affinityKey(task: { type: string; tle?: { line1: string }; model?: string }): string | undefined {
+  if (task.type !== 'propagate' || !task.tle) {
+    return undefined;
+  }
+  return `${task.tle.line1.slice(2, 7).trim()}|${task.model ?? ''}`;
+}
+
+/**
+ * 32-bit FNV-1a of a key and a worker ID, the rendezvous weight
+ */
+function weight(key: string, id: number): number {
+  let h = 0x811c9dc5 ^ id;
+  for (let i = 0; i < key.length; i++) {
+    h = Math.imul(h ^ key.charCodeAt(i), 0x01000193);
+  }
+  // Final avalanche so consecutive worker IDs rank independently
+  h = Math.imul(h ^ (h >>> 16), 0x85ebca6b);
+  h = Math.imul(h ^ (h >>> 13), 0xc2b2ae35);
+  return (h ^ (h >>> 16)) >>> 0;
+}
+
+/**
+ * Idle worker picker for one pool
+ */
+export class AffinityRouter {
+  readonly enabled: boolean;
+  readonly choices: number;
+  private preferred = 0;
+  private spilled = 0;
+
+  constructor() {
+    this.enabled = ['on', 'true', '1'].includes((process.env.SGP4_AFFINITY || 'off').toLowerCase());
+    this.choices = parseInt(process.env.SGP4_AFFINITY_CHOICES || '', 10) || 2;
+  }
+
+  /**
+   * Idle worker for a task with the given affinity key (or none)
+   */
+  pick<W extends RoutedWorker>(workers: W[], key: string | undefined): W | undefined {
+    if (!this.enabled || key === undefined) {
+      return workers.find((w) => w.ready && !w.busy);
+    }
+
+    const ranked = workers
+      .filter((w) => w.ready)
+      .map((w) => ({ w, rank: weight(key, w.id) }))
+      .sort((a, b) => b.rank - a.rank);
+    const index = ranked.findIndex((r) => !r.w.busy);
+    if (index < 0) {
+      return undefined;
+    }
+    if (index < this.choices) {
+      this.preferred++;
+    } else {
+      this.spilled++;
+    }
+    return ranked[index].w;
+  }
+
+  get stats(): AffinityStats {
+    return {
+      enabled: this.enabled,
+      choices: this.choices,
+      preferred: this.preferred,
+      spilled: this.spilled,
+    };
+  }
+}
+
+/**
+ * Per-worker LRU cache of prepared TLEs by (TLE, model)
+ */
+export class TLECache<T> {
+  /** Insertion order is recency order (oldest first) */
+  private entries = new Map<string, T>();
+  private prepare: (line1: string, line2: string) => T;
+  readonly maxEntries: number;
+
+  /**
+   * @param prepare - Parse (and initialize) a TLE under the current model
+   */
+  constructor(prepare: (line1: string, line2: string) => T) {
+    this.prepare = prepare;
+    const max = parseInt(process.env.SGP4_WORKER_CACHE || '', 10);
+    this.maxEntries = max >= 0 ? max : 4096;
+  }
+
+  get(tle: { line1: string; line2: string }, model: string): T {
+    if (this.maxEntries === 0) {
+      return this.prepare(tle.line1, tle.line2);
+    }
+
+    const key = `${model}|${tle.line1}|${tle.line2}`;
+    let value = this.entries.get(key);
+    if (value !== undefined) {
+      // Refresh recency
+      this.entries.delete(key);
+    } else {
+      value = this.prepare(tle.line1, tle.line2);
+      if (this.entries.size >= this.maxEntries) {
+        this.entries.delete(this.entries.keys().next().value!);
+      }
+    }
+    this.entries.set(key, value);
+    return value;
+  }
+}
@@ -0,0 +1,181 @@
+/**
+ * Element-Set History Archive
+ *
+ * Historical TLE catalogs are usually kept as gzipped text and re-parsed on
+ * every replay. The archive (src/sgp4_archive.c) stores them columnar
+ * instead: element sets sorted by object and epoch, cut into blocks of 256
+ * with each TLE field held as the exact integer the text encodes,
+ * delta-coded within the block. An index of per-block epoch ranges sits at
+ * the end of the file, so loading an object's history over a window decodes
+ * only the blocks that overlap it - straight into the 10-value element rows
+ * the batch methods take, bit-identical to parseTLE().
+ *
+ * Usage:
+ *   npx tsx lib/archive.ts build <archive> <tle.txt|tle.txt.gz>...
+ *   npx tsx lib/archive.ts query <archive> <norad,...> [t0] [tf]
+ *
+ * @example
+ * ```typescript
+ * const sgp4 = await createExtendedNativeSGP4();
+ * await sgp4.init();
+ * await buildArchive(sgp4, ['2024.txt.gz', '2025.txt.gz'], 'catalog.sgpa');
+ * const { elements, norad } = loadHistory(sgp4, 'catalog.sgpa', [25544], {
+ *   et0: sgp4.utcToET('2024-06-01T00:00:00'),
+ *   etf: sgp4.utcToET('2024-07-01T00:00:00'),
+ * });
+ * ```
+ */
+
+import { createReadStream } from 'fs';
+import { createInterface } from 'readline';
+import { createGunzip } from 'zlib';
+import { fileURLToPath } from 'url';
+import path from 'path';
+import type { NativeSGP4Module } from './sgp4-native.js';
+
+/** Lines handed to the native parser at a time while building */
+const BUILD_CHUNK_LINES = 30000;
+
+/** Opaque handle to an archive being built */
+export type ArchiveBuilderHandle = { readonly __archiveBuilder: true };
+
+/** Opaque handle to an open archive */
+export type ArchiveHandle = { readonly __archive: true };
+
+/** An open archive */
+export interface ArchiveInfo {
+  handle: ArchiveHandle;
+  records: number;
+  objects: number;
+  blocks: number;
+}
+
+/** Element sets loaded from an archive, by object then epoch */
+export interface ArchiveSets {
+  /** 10 values per set, as in TLEElements.elements */
+  elements: Float64Array;
+  /** NORAD ID of each set */
+  norad: Int32Array;
+}
+
+/**
+ * Convert a catalog number, including Alpha-5 ("A0001"), to the integer
+ * the archive indexes by
+ */
+export function noradNumber(id: string | number): number {
+  if (typeof id === 'number') {
+    return id;
+  }
+  const c = id.trim().toUpperCase();
+  if (/^[A-HJ-NP-Z]\d{4}$/.test(c)) {
+    const code = c.charCodeAt(0) - 65;
+    const lead = 10 + code - (c[0] > 'I' ? 1 : 0) - (c[0] > 'O' ? 1 : 0);
+    return lead * 10000 + parseInt(c.slice(1), 10);
+  }
+  return parseInt(c, 10);
+}
+
+/**
+ * Build an archive from 2LE/3LE text files (gzipped when named *.gz)
+ */
+export async function buildArchive(
+  sgp4: NativeSGP4Module,
+  inputs: string[],
+  out: string
+): Promise<{ records: number; objects: number; bytes: number; skipped: number }> {
+  const builder = sgp4.archiveBuilder();
+  let skipped = 0;
+
+  for (const input of inputs) {
+    const stream = createReadStream(input);
+    const lines = createInterface({
+      input: input.endsWith('.gz') ? stream.pipe(createGunzip()) : stream,
+      crlfDelay: Infinity,
+    });
+
+    let chunk: string[] = [];
+    for await (const line of lines) {
+      chunk.push(line);
+      // Only cut after a line 2 so no TLE straddles two chunks
+      if (chunk.length >= BUILD_CHUNK_LINES && line.startsWith('2 ')) {
+        skipped += sgp4.archiveAdd(builder, chunk.join('\n')).skipped;
+        chunk = [];
+      }
+    }
+    if (chunk.length) {
+      skipped += sgp4.archiveAdd(builder, chunk.join('\n')).skipped;
+    }
+  }
+
+  return { ...sgp4.archiveWrite(builder, out), skipped };
+}
+
+/**
+ * Load the element sets of the given objects, optionally limited to an
+ * epoch window (ET seconds, inclusive)
+ */
+export function loadHistory(
+  sgp4: NativeSGP4Module,
+  archive: string | ArchiveInfo,
+  norads: Array<string | number>,
+  window: { et0?: number; etf?: number } = {}
+): ArchiveSets {
+  const info = typeof archive === 'string' ? sgp4.archiveOpen(archive) : archive;
+  return sgp4.archiveQuery(
+    info.handle,
+    Int32Array.from(norads, noradNumber),
+    window.et0 ?? -Infinity,
+    window.etf ?? Infinity
+  );
+}
+
+async function main(): Promise<void> {
+  const [command, archive, ...rest] = process.argv.slice(2);
+  if ((command !== 'build' && command !== 'query') || !archive || rest.length === 0) {
+    console.error('Usage: npx tsx lib/archive.ts build <archive> <tle.txt|tle.txt.gz>...');
+    console.error('       npx tsx lib/archive.ts query <archive> <norad,...> [t0] [tf]');
+    process.exit(1);
+  }
+
+  const { createExtendedNativeSGP4 } = await import('./sgp4-native.js');
+  const sgp4 = await createExtendedNativeSGP4();
+  await sgp4.init();
+
+  if (command === 'build') {
+    const start = performance.now();
+    const result = await buildArchive(sgp4, rest, archive);
+    console.log(`Archive:        ${archive}`);
+    console.log(`  Element sets: ${result.records.toLocaleString()} (${result.skipped} malformed skipped)`);
+    console.log(`  Objects:      ${result.objects.toLocaleString()}`);
+    console.log(`  Size:         ${(result.bytes / 1024 / 1024).toFixed(2)} MB`);
+    console.log(`  Build time:   ${((performance.now() - start) / 1000).toFixed(2)}s`);
+    return;
+  }
+
+  const [ids, t0, tf] = rest;
+  const info = sgp4.archiveOpen(archive);
+  const start = performance.now();
+  const { elements, norad } = loadHistory(sgp4, info, ids.split(','), {
+    et0: t0 ? sgp4.utcToET(t0) : undefined,
+    etf: tf ? sgp4.utcToET(tf) : undefined,
+  });
+  const ms = performance.now() - start;
+
+  console.log(`Archive: ${archive} (${info.records.toLocaleString()} sets, ${info.objects} objects, ${info.blocks} blocks)`);
+  console.log(`Loaded ${norad.length.toLocaleString()} element sets in ${ms.toFixed(1)} ms\n`);
+  for (let i = 0; i < norad.length; ) {
+    let j = i;
+    while (j < norad.length && norad[j] === norad[i]) j++;
+    const first = sgp4.etToUTC(elements[i * 10 + 9]);
+    const last = sgp4.etToUTC(elements[(j - 1) * 10 + 9]);
+    console.log(`${String(norad[i]).padStart(7)}  ${String(j - i).padStart(6)} sets  ${first} .. ${last}`);
+    i = j;
+  }
+}
+
+if (process.argv[1] && path.resolve(process.argv[1]) === fileURLToPath(import.meta.url)) {
+  main().catch((err) => {
+    console.error('Archive failed:', err);
+    process.exit(1);
+  });
+}
@@ -0,0 +1,159 @@
+/**
+ * Traffic Capture
+ *
+ * Opt-in request sampler shared by both servers. Records the method, URL,
+ * JSON body, scheduling headers, arrival time, status and latency of sampled
+ * requests to an NDJSON log that lib/replay.ts re-issues against a server.
+ *
+ * Enabled by SGP4_CAPTURE_FILE. SGP4_CAPTURE_RATE (0-1, default 1) is the
+ * fraction of requests sampled; requests slower than SGP4_CAPTURE_SLOW_MS
+ * (default 1000) are always recorded and flagged `slow`.
+ *
+ * Log lines, in order:
+ * - header: `{"capture":1,"server":"native","started":"<ISO>","rate":1,"slowMs":1000}`
+ * - body:   `{"b":3,"v":{...}}` - a distinct request body, written once
+ * - entry:  `{"t":152.4,"m":"POST","u":"/api/...","h":{"x-qos-class":"bulk"},"b":3,"s":200,"d":8.1,"slow":1}`
+ *
+ * `t` is the arrival time in ms since `started` and `d` the latency in ms;
+ * entries refer to bodies by id so repeated TLE/OMM payloads cost one line.
+ * `h` holds the request's CAPTURED_HEADERS that were set.
+ *
+ * Streamed uploads (text/plain, NDJSON and binary element frames, see
+ * lib/ingest.ts) are read by their handlers straight off the socket and are
+ * often catalog-sized, so their bodies are not recorded: the entry is
+ * flagged `raw` instead, and replay skips it.
+ *
+ * The file is appended to, so each server start adds a session that begins
+ * with its own header line; `t` and body ids are scoped to that session.
+ */
+
+import { createWriteStream, type WriteStream } from 'fs';
+import type { Request, Response, NextFunction } from 'express';
+import crypto from 'crypto';
+import { satelliteStreamType } from './ingest.js';
+
+/** Distinct bodies remembered for de-duplication before the table is reset */
+const MAX_BODY_IDS = 10000;
+
+/**
+ * Request headers replayed with each entry: the body type and the
+ * scheduler's class, tenant and deadline (lib/scheduler.ts). API keys are
+ * deliberately not recorded.
+ */
+export const CAPTURED_HEADERS = ['content-type', 'x-qos-class', 'x-tenant-id', 'x-deadline-ms'] as const;
+
+/** Header line of a capture log */
+export interface CaptureHeader {
+  capture: 1;
+  server: string;
+  started: string;
+  rate: number;
+  slowMs: number;
+}
+
+/** One captured request */
+export interface CaptureEntry {
+  /** Arrival, ms since the header's `started` */
+  t: number;
+  m: string;
+  u: string;
+  /** CAPTURED_HEADERS present on the request */
+  h?: Record<string, string>;
+  /** Body id (see the body lines) */
+  b?: number;
+  /** Response status */
+  s: number;
+  /** Latency in ms */
+  d: number;
+  slow?: 1;
+  /** Streamed upload whose body was not recorded */
+  raw?: 1;
+}
+
+/**
+ * Create the capture middleware for a server.
+ * Returns a pass-through middleware when SGP4_CAPTURE_FILE is unset.
+ */
+export function trafficCapture(
+  server: string
+): (req: Request, res: Response, next: NextFunction) => void {
+  const file = process.env.SGP4_CAPTURE_FILE;
+  if (!file) {
+    return (_req, _res, next) => next();
+  }
+
+  const rate = Math.min(1, Math.max(0, parseFloat(process.env.SGP4_CAPTURE_RATE || '1') || 0));
+  const slowMs = parseFloat(process.env.SGP4_CAPTURE_SLOW_MS || '') || 1000;
+  const started = performance.now();
+  const out: WriteStream = createWriteStream(file, { flags: 'a' });
+  const bodyIds = new Map<string, number>();
+  let nextBodyId = 0;
+
+  const header: CaptureHeader = {
+    capture: 1,
+    server,
+    started: new Date().toISOString(),
+    rate,
+    slowMs,
+  };
+  out.write(JSON.stringify(header) + '\n');
+  console.log(`Capturing ${rate * 100}% of requests (and all over ${slowMs} ms) to ${file}`);
+
+  function bodyId(body: unknown): number | undefined {
+    if (body === undefined || body === null || (typeof body === 'object' && Object.keys(body).length === 0)) {
+      return undefined;
+    }
+    const json = JSON.stringify(body);
+    const hash = crypto.createHash('md5').update(json).digest('hex');
+    let id = bodyIds.get(hash);
+    if (id === undefined) {
+      if (bodyIds.size >= MAX_BODY_IDS) {
+        bodyIds.clear();
+      }
+      id = nextBodyId++;
+      bodyIds.set(hash, id);
+      out.write(`{"b":${id},"v":${json}}\n`);
+    }
+    return id;
+  }
+
+  function headersOf(req: Request): Record<string, string> | undefined {
+    let headers: Record<string, string> | undefined;
+    for (const name of CAPTURED_HEADERS) {
+      const value = req.headers[name];
+      if (typeof value === 'string') {
+        (headers ||= {})[name] = value;
+      }
+    }
+    return headers;
+  }
+
+  return (req: Request, res: Response, next: NextFunction) => {
+    const arrival = performance.now();
+    const sampled = Math.random() < rate;
+
+    res.on('finish', () => {
+      const d = performance.now() - arrival;
+      const slow = d >= slowMs;
+      if (!sampled && !slow) {
+        return;
+      }
+
+      const raw = satelliteStreamType(req) !== undefined;
+      const entry: CaptureEntry = {
+        t: Math.round((arrival - started) * 10) / 10,
+        m: req.method,
+        u: req.originalUrl,
+        h: headersOf(req),
+        b: raw ? undefined : bodyId(req.body),
+        s: res.statusCode,
+        d: Math.round(d * 10) / 10,
+        ...(slow && { slow: 1 as const }),
+        ...(raw && { raw: 1 as const }),
+      };
+      out.write(JSON.stringify(entry) + '\n');
+    });
+
+    next();
+  };
+}
@@ -0,0 +1,259 @@
+/**
+ * Resident Catalog and Orbital-Parameter Index
+ *
+ * Analysts ask for subsets such as "sun-synchronous objects 500-600 km",
+ * "GEO within 5 deg of longitude X" or "53 deg shells", which otherwise
+ * take a full catalog dump and a client-side filter. The native server can
+ * hold a resident catalog (loaded from SGP4_CATALOG at startup, or
+ * replaced with PUT /api/spice/sgp4/catalog in any streamed batch format)
+ * and index its derived orbital parameters (src/sgp4_catalog.c):
+ *
+ * | Parameter | Unit | Meaning |
+ * |-----------|------|---------|
+ * | perigee, apogee | km | Altitude above the equatorial radius |
+ * | inclination | deg | |
+ * | period | min | Anomalistic period from the mean motion |
+ * | raan | deg, 0..360 | Right ascension of the ascending node at epoch |
+ * | eccentricity | | |
+ * | longitude | deg, -180..180 | Earth-fixed mean longitude at epoch (the sub-satellite longitude of geosynchronous objects) |
+ *
+ * Each parameter is kept sorted, so a range predicate is two binary
+ * searches; predicates are intersected as SIMD bitmap ANDs. Matches come
+ * back as element columns that go straight into the batch pipeline.
+ *
+ * @example
+ * ```typescript
+ * const catalog = await ResidentCatalog.loadFile(sgp4, 'active.txt.gz', 'wgs72');
+ * const matches = catalog.query(parseCatalogPredicates({ perigee: '500,600', inclination: '97,99' }));
+ * const { columns } = catalog.subset(matches);
+ * ```
+ */
+
+import { createReadStream } from 'fs';
+import { createGunzip } from 'zlib';
+import type { Readable } from 'stream';
+import { getWgsConstants } from './models.js';
+import { noradNumber } from './archive.js';
+import { streamSatelliteChunks, type ElementFrame, type SatelliteInput, type SatelliteStreamType } from './ingest.js';
+import type { NativeSGP4Module } from './sgp4-native.js';
+import type { ElementColumns } from './worker-types.js';
+
+/** Opaque handle of a native catalog index */
+export type CatalogHandle = { readonly __catalog: true };
+
+/** Indexed parameters, in native index order */
+export const CATALOG_PARAMS = [
+  'perigee',
+  'apogee',
+  'inclination',
+  'period',
+  'raan',
+  'eccentricity',
+  'longitude',
+] as const;
+
+export type CatalogParam = (typeof CATALOG_PARAMS)[number];
+
+/** An inclusive range on one parameter (lo > hi wraps for raan and longitude) */
+export interface CatalogPredicate {
+  param: CatalogParam;
+  lo: number;
+  hi: number;
+}
+
+/** Satellites per chunk when reading a catalog */
+const CATALOG_CHUNK = 4096;
+
+/**
+ * Range predicates of query parameters given as "lo,hi" (either bound may
+ * be left empty)
+ *
+ * @throws Error on a malformed range
+ */
+export function parseCatalogPredicates(query: Record<string, unknown>): CatalogPredicate[] {
+  const predicates: CatalogPredicate[] = [];
+  for (const param of CATALOG_PARAMS) {
+    const value = query[param];
+    if (value === undefined) {
+      continue;
+    }
+    const [lo, hi] = Array.isArray(value) ? value : String(value).split(',');
+    const bound = (v: unknown, open: number): number =>
+      v === undefined || v === null || v === '' ? open : Number(v);
+    const predicate = { param, lo: bound(lo, -Infinity), hi: bound(hi, Infinity) };
+    if (Number.isNaN(predicate.lo) || Number.isNaN(predicate.hi)) {
+      throw new Error(`Invalid ${param} range (expected "lo,hi")`);
+    }
+    predicates.push(predicate);
+  }
+  return predicates;
+}
+
+/** Streamed body format of a catalog file, from its name */
+function catalogFileType(path: string): SatelliteStreamType {
+  const name = path.replace(/\.gz$/, '');
+  if (/\.(ndjson|jsonl)$/.test(name)) {
+    return 'application/x-ndjson';
+  }
+  return /\.(bin|sgpe)$/.test(name) ? 'application/x-sgp4-elements' : 'text/plain';
+}
+
+/**
+ * A catalog held in memory with its parameter index
+ */
+export class ResidentCatalog {
+  readonly size: number;
+  readonly model: string;
+  readonly source: string;
+  readonly loadedAt: string;
+  /** 10 element columns of `size` values (ElementColumns layout) */
+  private columns: Float64Array;
+  private norad: Int32Array;
+  private names: Array<string | undefined>;
+  private values: Float64Array;
+  private handle: CatalogHandle;
+  private sgp4: NativeSGP4Module;
+
+  private constructor(
+    sgp4: NativeSGP4Module,
+    columns: Float64Array,
+    norad: Int32Array,
+    names: Array<string | undefined>,
+    model: string,
+    source: string
+  ) {
+    this.sgp4 = sgp4;
+    this.columns = columns;
+    this.norad = norad;
+    this.names = names;
+    this.size = norad.length;
+    this.model = model;
+    this.source = source;
+    this.loadedAt = new Date().toISOString();
+
+    const constants = getWgsConstants(model);
+    if (constants) {
+      sgp4.setGeophysicalConstants(constants, model);
+    }
+    this.handle = sgp4.catalogIndex({ columns });
+    this.values = sgp4.catalogValues(this.handle);
+  }
+
+  /**
+   * Build a catalog from streamed satellite chunks (TLE lists or binary
+   * element frames)
+   *
+   * @param maxSize - Refuse catalogs with more satellites
+   * @throws Error on malformed input or too many satellites
+   */
+  static async load(
+    sgp4: NativeSGP4Module,
+    chunks: AsyncIterable<SatelliteInput[] | ElementFrame>,
+    model: string,
+    source: string,
+    maxSize: number
+  ): Promise<ResidentCatalog> {
+    const parts: Float64Array[] = [];
+    const norads: number[] = [];
+    const names: Array<string | undefined> = [];
+
+    for await (const chunk of chunks) {
+      if (Array.isArray(chunk)) {
+        const rows = new Float64Array(chunk.length * 10);
+        chunk.forEach((sat, i) => {
+          rows.set(sgp4.parseTLE(sat.line1, sat.line2).elements, i * 10);
+          norads.push(noradNumber(sat.line1.slice(2, 7)));
+          names.push(sat.name);
+        });
+        parts.push(rows);
+      } else {
+        // Element frames are columnar; keep rows until the catalog is complete
+        const n = chunk.norad.length;
+        const rows = new Float64Array(n * 10);
+        for (let i = 0; i < n; i++) {
+          for (let c = 0; c < 10; c++) {
+            rows[i * 10 + c] = chunk.columns[c * n + i];
+          }
+        }
+        parts.push(rows);
+        norads.push(...chunk.norad);
+        names.push(...new Array<undefined>(n));
+      }
+      if (norads.length > maxSize) {
+        throw new Error(`Catalog too large: more than ${maxSize} satellites`);
+      }
+    }
+
+    const n = norads.length;
+    const columns = new Float64Array(n * 10);
+    let i = 0;
+    for (const rows of parts) {
+      for (let r = 0; r < rows.length / 10; r++, i++) {
+        for (let c = 0; c < 10; c++) {
+          columns[c * n + i] = rows[r * 10 + c];
+        }
+      }
+    }
+    return new ResidentCatalog(sgp4, columns, Int32Array.from(norads), names, model, source);
+  }
+
+  /**
+   * Build a catalog from a 2LE/3LE, NDJSON (.ndjson/.jsonl) or binary
+   * element frame (.bin/.sgpe) file, optionally gzipped
+   */
+  static loadFile(sgp4: NativeSGP4Module, path: string, model: string, maxSize: number): Promise<ResidentCatalog> {
+    let stream: Readable = createReadStream(path);
+    if (path.endsWith('.gz')) {
+      stream = stream.pipe(createGunzip());
+    }
+    return ResidentCatalog.load(
+      sgp4,
+      streamSatelliteChunks(stream, catalogFileType(path), CATALOG_CHUNK),
+      model,
+      path,
+      maxSize
+    );
+  }
+
+  /**
+   * Indices of the satellites matching every predicate, in catalog order
+   */
+  query(predicates: CatalogPredicate[]): Int32Array {
+    const encoded = new Float64Array(predicates.length * 3);
+    predicates.forEach((p, i) => encoded.set([CATALOG_PARAMS.indexOf(p.param), p.lo, p.hi], i * 3));
+    return this.sgp4.catalogQuery(this.handle, encoded);
+  }
+
+  /**
+   * Element columns of the given satellites, for the batch methods
+   */
+  subset(indices: ArrayLike<number>): ElementColumns {
+    const n = this.size;
+    const m = indices.length;
+    const columns = new Float64Array(m * 10);
+    for (let c = 0; c < 10; c++) {
+      for (let k = 0; k < m; k++) {
+        columns[c * m + k] = this.columns[c * n + indices[k]];
+      }
+    }
+    return { columns };
+  }
+
+  /**
+   * NORAD ID, name and indexed parameters of one satellite
+   */
+  describe(index: number): { norad: number; name?: string } & Record<CatalogParam, number> {
+    const params = Object.fromEntries(
+      CATALOG_PARAMS.map((p, k) => [p, this.values[k * this.size + index]])
+    ) as Record<CatalogParam, number>;
+    return {
+      norad: this.norad[index],
+      ...(this.names[index] && { name: this.names[index] }),
+      ...params,
+    };
+  }
+
+  get stats(): { size: number; model: string; source: string; loadedAt: string } {
+    return { size: this.size, model: this.model, source: this.source, loadedAt: this.loadedAt };
+  }
+}
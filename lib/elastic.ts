@@ -0,0 +1,165 @@
+/**
+ * Elastic Worker Pool Sizing
+ *
+ * A fixed pool holds SGP4_POOL_SIZE workers (each a WASM instance of about
+ * 64 MB, or a native addon instance) through idle hours and cannot grow past
+ * it at peak. With SGP4_POOL_MIN < SGP4_POOL_MAX the pools resize instead,
+ * checked every 250 ms:
+ *
+ * - Scale up when the oldest queued task has waited SGP4_POOL_SCALE_WAIT_MS,
+ *   by up to the queue length but at most doubling per check, so a burst
+ *   does not start a cold-start storm.
+ * - Warm spares: SGP4_POOL_SPARES idle workers are kept ready beyond the
+ *   busy ones. Scale-up starts new spares in the background while queued
+ *   tasks go to the spares already warm, so requests never wait on a
+ *   worker's startup.
+ * - Scale down one idle worker per check once it has been idle for
+ *   SGP4_POOL_IDLE_MS, never below the minimum or the spares.
+ *
+ * The policy lives here; the pools start and terminate the workers.
+ */
+
+/** Resize check interval in ms */
+export const RESIZE_INTERVAL_MS = 250;
+
+/** Scaling events kept for pool stats */
+const EVENT_HISTORY = 20;
+
+/** A worker as seen by the sizing policy */
+export interface SizedWorker {
+  /** Initialized and accepting tasks */
+  ready: boolean;
+  busy: boolean;
+  /** performance.now() when the worker last became idle */
+  idleSince: number;
+}
+
+/** One resize of the pool */
+export interface ScalingEvent {
+  time: string;
+  action: 'up' | 'down';
+  /** Workers started or retired */
+  workers: number;
+  /** Pool size (ready and starting) after the event */
+  size: number;
+  reason: string;
+}
+
+/** Elastic sizing state as reported in pool stats */
+export interface ElasticStats {
+  enabled: boolean;
+  minSize: number;
+  maxSize: number;
+  spares: number;
+  /** Workers still starting up */
+  starting: number;
+  scaleUps: number;
+  scaleDowns: number;
+  /** Most recent scaling events, oldest first */
+  events: ScalingEvent[];
+}
+
+/**
+ * Sizing policy for one worker pool
+ */
+export class ElasticSizing {
+  readonly minSize: number;
+  readonly maxSize: number;
+  readonly initialSize: number;
+  readonly spares: number;
+  readonly idleTimeoutMs: number;
+  readonly scaleUpWaitMs: number;
+  private scaleUps = 0;
+  private scaleDowns = 0;
+  private events: ScalingEvent[] = [];
+
+  /**
+   * @param poolSize - Configured pool size, the initial size (and both
+   *                   bounds unless SGP4_POOL_MIN / SGP4_POOL_MAX are set)
+   */
+  constructor(poolSize: number) {
+    this.minSize = Math.max(1, parseInt(process.env.SGP4_POOL_MIN || '', 10) || poolSize);
+    this.maxSize = Math.max(this.minSize, parseInt(process.env.SGP4_POOL_MAX || '', 10) || poolSize);
+    this.initialSize = Math.max(this.minSize, Math.min(this.maxSize, poolSize));
+    const spares = parseInt(process.env.SGP4_POOL_SPARES || '', 10);
+    this.spares = this.enabled ? (spares >= 0 ? spares : 1) : 0;
+    this.idleTimeoutMs = parseFloat(process.env.SGP4_POOL_IDLE_MS || '') || 60000;
+    this.scaleUpWaitMs = parseFloat(process.env.SGP4_POOL_SCALE_WAIT_MS || '') || 50;
+  }
+
+  /** Whether the pool resizes at all */
+  get enabled(): boolean {
+    return this.maxSize > this.minSize;
+  }
+
+  /**
+   * Decide one resize step
+   *
+   * @param workers - All workers, starting ones included
+   * @param queued - Tasks waiting for a worker
+   * @param oldestWaitMs - How long the oldest of them has waited
+   * @returns Workers to start (with the reason), and idle workers to retire
+   */
+  plan<W extends SizedWorker>(
+    workers: W[],
+    queued: number,
+    oldestWaitMs: number
+  ): { start: number; reason: string; retire: W[] } {
+    const ready = workers.filter((w) => w.ready);
+    const starting = workers.length - ready.length;
+    const idle = ready.filter((w) => !w.busy);
+    const room = this.maxSize - workers.length;
+
+    if (workers.length < this.minSize) {
+      return { start: this.minSize - workers.length, reason: 'below minimum', retire: [] };
+    }
+    if (room > 0 && queued > 0 && oldestWaitMs >= this.scaleUpWaitMs) {
+      const start = Math.min(room, Math.min(queued, Math.max(1, ready.length)) - starting);
+      if (start > 0) {
+        return { start, reason: `queue wait ${Math.round(oldestWaitMs)} ms`, retire: [] };
+      }
+    }
+    if (room > 0 && idle.length + starting < this.spares) {
+      return { start: Math.min(room, this.spares - idle.length - starting), reason: 'warm spare', retire: [] };
+    }
+
+    if (queued > 0 || workers.length <= this.minSize || idle.length <= this.spares) {
+      return { start: 0, reason: '', retire: [] };
+    }
+    const now = performance.now();
+    const longest = idle.reduce((a, w) => (w.idleSince < a.idleSince ? w : a));
+    return {
+      start: 0,
+      reason: '',
+      retire: now - longest.idleSince >= this.idleTimeoutMs ? [longest] : [],
+    };
+  }
+
+  /**
+   * Count and log a resize
+   */
+  record(action: ScalingEvent['action'], workers: number, size: number, reason: string): void {
+    if (action === 'up') {
+      this.scaleUps++;
+    } else {
+      this.scaleDowns++;
+    }
+    this.events.push({ time: new Date().toISOString(), action, workers, size, reason });
+    if (this.events.length > EVENT_HISTORY) {
+      this.events.shift();
+    }
+  }
+
+  stats(starting: number): ElasticStats {
+    return {
+      enabled: this.enabled,
+      minSize: this.minSize,
+      maxSize: this.maxSize,
+      spares: this.spares,
+      starting,
+      scaleUps: this.scaleUps,
+      scaleDowns: this.scaleDowns,
+      events: [...this.events],
+    };
+  }
+}
@@ -0,0 +1,195 @@
+/**
+ * Hybrid Engine Routing
+ *
+ * The native server has two SGP4 engines:
+ *
+ * - `native`: the SIMD addon, 10-70x faster, but a near-earth kernel only
+ *   (no SDP4 deep-space terms, no simplified-drag branch)
+ * - `cspice`: CSPICE evsgp4_c in WASM workers (the WASM server's engine),
+ *   complete
+ *
+ * Each object is classified from its parsed elements and sent to the
+ * fastest engine able to handle it. An object goes to CSPICE when its
+ * orbital period is at least 225 min (SGP4's deep-space branch), its
+ * perigee is below 220 km (the simplified-drag branch), or its
+ * eccentricity exceeds SGP4_NATIVE_MAX_ECC. Requests can pin an engine with
+ * `engine=native|cspice` (default `auto`). With no WASM build, or with
+ * SGP4_CSPICE_POOL_SIZE=0, everything runs natively and such objects are
+ * flagged in the response.
+ *
+ * The two engines keep time differently: native ET counts UTC seconds past
+ * J2000 without leap seconds, CSPICE ET is TDB (about 69 s ahead in 2024).
+ * Times given to and returned by the router are native ET; CSPICE reads
+ * each grid start from its UTC.
+ */
+
+import { SGP4WorkerPool } from './worker-pool.js';
+import type { PropagateTask, PropagateResult, PropagateState } from './worker-types.js';
+
+export const ENGINES = ['native', 'cspice'] as const;
+
+export type Engine = (typeof ENGINES)[number];
+
+export const ENGINE_MODES = ['auto', ...ENGINES] as const;
+
+export type EngineMode = (typeof ENGINE_MODES)[number];
+
+/** Orbital period (minutes) from which SGP4 uses its deep-space branch */
+const DEEP_SPACE_PERIOD_MIN = 225;
+
+/** Perigee altitude (km) below which SGP4 uses its simplified-drag branch */
+const SIMPLE_DRAG_PERIGEE_KM = 220;
+
+/** WGS-72 ke (earth radii^1.5/min) and equatorial radius (km) */
+const KE = 7.43669161e-2;
+const RE_KM = 6378.135;
+
+/** Engine chosen for one object, and why */
+export interface EngineChoice {
+  engine: Engine;
+  reason: string;
+}
+
+/**
+ * Fastest engine able to propagate a satellite, from its 10-value element
+ * row (TLEElements.elements order: ecco at 5, mean motion in rad/min at 8)
+ */
+export function classifyElements(elements: ArrayLike<number>, offset = 0): EngineChoice {
+  const ecco = elements[offset + 5];
+  const no = elements[offset + 8];
+  const periodMin = (2 * Math.PI) / no;
+  if (periodMin >= DEEP_SPACE_PERIOD_MIN) {
+    return { engine: 'cspice', reason: `deep space (period ${periodMin.toFixed(0)} min)` };
+  }
+
+  const perigeeKm = (Math.pow(KE / no, 2 / 3) * (1 - ecco) - 1) * RE_KM;
+  if (perigeeKm < SIMPLE_DRAG_PERIGEE_KM) {
+    return { engine: 'cspice', reason: `low perigee (${perigeeKm.toFixed(0)} km)` };
+  }
+
+  const maxEcc = parseFloat(process.env.SGP4_NATIVE_MAX_ECC || '') || 0.25;
+  if (ecco > maxEcc) {
+    return { engine: 'cspice', reason: `eccentricity ${ecco.toFixed(3)}` };
+  }
+  return { engine: 'native', reason: 'near earth' };
+}
+
+/**
+ * Routes objects between the native pool (owned by the server) and a WASM
+ * pool of CSPICE workers started here
+ */
+export class EngineRouter {
+  readonly cspicePoolSize: number;
+  private cspicePool?: SGP4WorkerPool;
+  private cspiceReady?: Promise<boolean>;
+  private available = false;
+  private routed: Record<Engine, number> = { native: 0, cspice: 0 };
+  /** Objects CSPICE should have served that ran natively */
+  private fallbacks = 0;
+  private readonly etToUTC: (et: number) => string;
+
+  /**
+   * @param etToUTC - Native ET to UTC string conversion (the loaded SGP4 module's)
+   */
+  constructor(etToUTC: (et: number) => string) {
+    this.etToUTC = etToUTC;
+    const size = parseInt(process.env.SGP4_CSPICE_POOL_SIZE || '', 10);
+    this.cspicePoolSize = size >= 0 ? size : 2;
+  }
+
+  /**
+   * Start the CSPICE workers. Never throws: without a WASM build the router
+   * runs everything natively.
+   */
+  initialize(): Promise<boolean> {
+    if (!this.cspiceReady) {
+      if (this.cspicePoolSize === 0) {
+        this.cspiceReady = Promise.resolve(false);
+      } else {
+        this.cspicePool = new SGP4WorkerPool(this.cspicePoolSize);
+        this.cspiceReady = this.cspicePool.initialize().then(
+          () => (this.available = true),
+          (err) => {
+            console.warn(`CSPICE engine unavailable, all objects run natively: ${(err as Error).message}`);
+            void this.cspicePool?.shutdown();
+            return false;
+          }
+        );
+      }
+    }
+    return this.cspiceReady;
+  }
+
+  /**
+   * Engine for one object under a request's engine mode
+   *
+   * @param nativeOnly - The request needs a native-only feature (aggregates,
+   *                     partials); such objects stay native and are flagged
+   * @throws Error when the request pins CSPICE and it cannot serve it
+   */
+  select(elements: ArrayLike<number>, mode: EngineMode, nativeOnly?: string): EngineChoice {
+    let choice: EngineChoice =
+      mode === 'auto' ? classifyElements(elements) : { engine: mode, reason: 'requested' };
+
+    if (choice.engine === 'cspice' && (nativeOnly || !this.available)) {
+      const why = nativeOnly ? `${nativeOnly} requires the native engine` : 'CSPICE engine unavailable';
+      if (mode === 'cspice') {
+        throw new Error(`engine=cspice cannot be used: ${why}`);
+      }
+      this.fallbacks++;
+      choice = { engine: 'native', reason: `${choice.reason}; ${why}` };
+    }
+    this.routed[choice.engine]++;
+    return choice;
+  }
+
+  /**
+   * Propagate one object on the CSPICE engine over a native ET grid. States
+   * come back on that grid, labelled with CSPICE's UTC.
+   */
+  async propagate(task: Omit<PropagateTask, 'type' | 'taskId' | 'utc0'>): Promise<PropagateResult> {
+    const { et0, step } = task.times;
+    const utc0 = this.etToUTC(et0).replace(/Z$/, '');
+    const result = await this.cspicePool!.propagate({ ...task, utc0 });
+    result.states.forEach((s, i) => (s.et = et0 + i * step));
+    return result;
+  }
+
+  /**
+   * Stop the CSPICE workers
+   */
+  async shutdown(): Promise<void> {
+    await this.cspicePool?.shutdown();
+  }
+
+  get stats(): {
+    cspiceAvailable: boolean;
+    routed: Record<Engine, number>;
+    fallbacks: number;
+    cspicePool?: SGP4WorkerPool['stats'];
+  } {
+    return {
+      cspiceAvailable: this.available,
+      routed: { ...this.routed },
+      fallbacks: this.fallbacks,
+      ...(this.available && { cspicePool: this.cspicePool!.stats }),
+    };
+  }
+}
+
+/**
+ * Packed et | x | y | z | vx | vy | vz columns (the native packed layout)
+ * of CSPICE engine states
+ */
+export function statesToPacked(states: PropagateState[]): Float64Array {
+  const n = states.length;
+  const packed = new Float64Array(n * 7);
+  states.forEach((s, i) => {
+    packed[i] = s.et;
+    for (let c = 0; c < 3; c++) {
+      packed[(1 + c) * n + i] = s.position[c];
+      packed[(4 + c) * n + i] = s.velocity[c];
+    }
+  });
+  return packed;
+}
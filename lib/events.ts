@@ -0,0 +1,214 @@
+/**
+ * Orbit Event Finder
+ *
+ * Times at which built-in scalar event functions of a satellite's state
+ * change sign: node crossings, apsides, altitude and latitude thresholds,
+ * latitude-band entry/exit and solar beta-angle crossings.
+ *
+ * The native engine (src/sgp4_events.c) samples each function on an
+ * orbit-aware coarse grid, brackets sign changes and refines each one by
+ * root finding; this module describes, encodes and runs searches and names
+ * the resulting events.
+ *
+ * @example
+ * ```typescript
+ * const specs = parseEventSpecs([
+ *   { type: 'node' },
+ *   { type: 'altitude', value: 420 },
+ *   { type: 'lat_band', min: -10, max: 10 },
+ * ]);
+ * ```
+ */
+
+import type { NativeSGP4Module } from './sgp4-native.js';
+import type { SGP4NativeWorkerPool } from './worker-pool-native.js';
+import type { SatelliteList } from './worker-types.js';
+import { elementsOf, satelliteCount, sliceSatellites } from './ingest.js';
+
+// The index of each name is its SGP4EventFunction value in src/sgp4_events.c
+export const EVENT_TYPES = ['node', 'apsis', 'altitude', 'latitude', 'lat_band', 'beta'] as const;
+
+export type EventType = (typeof EVENT_TYPES)[number];
+
+/**
+ * Names of the two crossing directions of each event type:
+ * [negative → positive, positive → negative]
+ */
+export const EVENT_DIRECTIONS: Record<EventType, [string, string]> = {
+  node: ['ascending_node', 'descending_node'],
+  apsis: ['perigee', 'apogee'],
+  altitude: ['rise_above', 'fall_below'],
+  latitude: ['northward', 'southward'],
+  lat_band: ['enter', 'exit'],
+  beta: ['rise_above', 'fall_below'],
+};
+
+/**
+ * One event function, as written in JSON.
+ * `value` is the threshold for altitude (km), latitude and beta (deg,
+ * default 0); `min`/`max` bound a latitude band (deg).
+ */
+export interface EventSpec {
+  type: EventType;
+  value?: number;
+  min?: number;
+  max?: number;
+}
+
+/** Encoded values per spec */
+const EVENT_WORDS = 3;
+
+/** Maximum specs per search (SGP4_EVENT_MAX_SPECS) */
+export const MAX_EVENT_SPECS = 16;
+
+/**
+ * Raw output of the native finder, sorted by satellite then time
+ */
+export interface EventOutput {
+  et: Float64Array;
+  /** Satellite index of each event */
+  sat: Int32Array;
+  /** Index of the spec that produced each event */
+  spec: Int32Array;
+  /** +1: function went from negative to non-negative, -1: the reverse */
+  direction: Int32Array;
+  truncated: boolean;
+}
+
+function asNumber(value: unknown, name: string): number {
+  if (typeof value !== 'number' || !Number.isFinite(value)) {
+    throw new Error(`Invalid ${name} (must be a number)`);
+  }
+  return value;
+}
+
+/**
+ * Validate a JSON list of event functions.
+ *
+ * @throws Error describing the first invalid spec
+ */
+export function parseEventSpecs(input: unknown): EventSpec[] {
+  if (!Array.isArray(input) || input.length === 0 || input.length > MAX_EVENT_SPECS) {
+    throw new Error(`events must be an array of 1-${MAX_EVENT_SPECS} event functions`);
+  }
+
+  return input.map((raw, i): EventSpec => {
+    const spec = (raw || {}) as Record<string, unknown>;
+    const type = spec.type as EventType;
+    if (!EVENT_TYPES.includes(type)) {
+      throw new Error(`Unknown event type in event ${i}: ${String(spec.type)}`);
+    }
+
+    switch (type) {
+      case 'altitude':
+        return { type, value: asNumber(spec.value, `events[${i}].value`) };
+      case 'latitude':
+      case 'beta':
+        return { type, value: spec.value === undefined ? 0 : asNumber(spec.value, `events[${i}].value`) };
+      case 'lat_band': {
+        const min = asNumber(spec.min, `events[${i}].min`);
+        const max = asNumber(spec.max, `events[${i}].max`);
+        if (min >= max) {
+          throw new Error(`events[${i}]: min must be below max`);
+        }
+        return { type, min, max };
+      }
+      default:
+        return { type };
+    }
+  });
+}
+
+/**
+ * Encode specs into the flat layout read by the native finder
+ */
+export function encodeEventSpecs(specs: EventSpec[]): Float64Array {
+  const words = new Float64Array(specs.length * EVENT_WORDS);
+  specs.forEach((s, i) => {
+    words[i * EVENT_WORDS] = EVENT_TYPES.indexOf(s.type);
+    words[i * EVENT_WORDS + 1] = s.type === 'lat_band' ? s.min! : (s.value ?? 0);
+    words[i * EVENT_WORDS + 2] = s.type === 'lat_band' ? s.max! : 0;
+  });
+  return words;
+}
+
+/**
+ * Name of an event, e.g. "ascending_node" or "enter"
+ */
+export function eventName(spec: EventSpec, direction: number): string {
+  return EVENT_DIRECTIONS[spec.type][direction > 0 ? 0 : 1];
+}
+
+/**
+ * Find events in-process with a native module (single thread)
+ */
+export function findEvents(
+  sgp4: NativeSGP4Module,
+  tles: SatelliteList,
+  specs: Float64Array,
+  window: { et0: number; etf: number },
+  maxStep = 0,
+  maxEvents = 0
+): EventOutput {
+  return sgp4.findEvents(elementsOf(sgp4, tles), specs, window.et0, window.etf, maxStep, maxEvents);
+}
+
+/**
+ * Find events on the native worker pool.
+ *
+ * Satellites are split into one contiguous shard per worker; the merged
+ * output keeps the per-satellite time order.
+ */
+export async function executeEvents(
+  pool: SGP4NativeWorkerPool,
+  request: {
+    tles: SatelliteList;
+    specs: Float64Array;
+    window: { et0: number; etf: number };
+    model: string;
+    maxStep: number;
+    maxEvents: number;
+  }
+): Promise<EventOutput> {
+  const { tles, maxEvents } = request;
+  const count = satelliteCount(tles);
+  const size = Math.ceil(count / Math.max(1, Math.min(pool.stats.poolSize, count)));
+  const shards = Math.ceil(count / size);
+
+  const parts = await Promise.all(
+    Array.from({ length: shards }, (_, i) =>
+      pool.findEvents({
+        tles: sliceSatellites(tles, i * size, (i + 1) * size),
+        specs: request.specs,
+        window: request.window,
+        model: request.model,
+        maxStep: request.maxStep,
+        maxEvents,
+      })
+    )
+  );
+
+  const all = parts.reduce((n, p) => n + p.et.length, 0);
+  const total = maxEvents > 0 ? Math.min(all, maxEvents) : all;
+  const out: EventOutput = {
+    et: new Float64Array(total),
+    sat: new Int32Array(total),
+    spec: new Int32Array(total),
+    direction: new Int32Array(total),
+    truncated: total < all || parts.some((p) => p.truncated),
+  };
+
+  let offset = 0;
+  parts.forEach((p, i) => {
+    const count = Math.min(p.et.length, total - offset);
+    out.et.set(p.et.subarray(0, count), offset);
+    out.spec.set(p.spec.subarray(0, count), offset);
+    out.direction.set(p.direction.subarray(0, count), offset);
+    for (let e = 0; e < count; e++) {
+      out.sat[offset + e] = p.sat[e] + i * size;
+    }
+    offset += count;
+  });
+
+  return out;
+}
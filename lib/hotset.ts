@@ -0,0 +1,295 @@
+/**
+ * Hot-Object Tracking and Predictive Ephemeris Prewarming
+ *
+ * A few hundred objects (the ISS, new launches, active conjunction pairs)
+ * draw most of the traffic, yet every request propagates on demand. The
+ * native server counts accesses to objects routed to the native engine
+ * (the only ones a window can serve) per (NORAD ID, model) in a space-saving
+ * top-K summary of SGP4_HOT_K counters: constant memory however large the
+ * catalog, and any object with more than 1/K of the accesses is guaranteed
+ * to be tracked. Counts halve every HOT_HALF_LIFE_MS so the hot set follows
+ * current interest.
+ *
+ * With SGP4_PREWARM_OBJECTS > 0, a background prewarmer keeps a rolling
+ * ephemeris window for that many of the hottest objects:
+ *
+ * - from the current time (aligned to whole multiples of
+ *   SGP4_PREWARM_STEP in UTC) to SGP4_PREWARM_HORIZON_S ahead
+ * - rebuilt as `bulk` QoS work once a quarter of the horizon has passed,
+ *   or when the object is seen with a newer TLE
+ * - all windows share one time grid, so the native pool coalesces their
+ *   builds into multi-satellite SIMD batches, and the builds leave the
+ *   TLE's initialized propagator in a worker's cache (with affinity
+ *   routing, in the worker its requests go to)
+ *
+ * A range request on the window's grid (start on it within 0.1 ms, step a
+ * multiple of it) and inside the window is sliced from it instead of
+ * propagated.
+ */
+
+import { schedulingContext } from './scheduler.js';
+import type { SGP4NativeWorkerPool } from './worker-pool-native.js';
+
+/** Counts halve this often */
+const HOT_HALF_LIFE_MS = 300_000;
+
+/** Prewarm check interval in ms */
+const PREWARM_INTERVAL_MS = 5000;
+
+/** Rebuild a window once this fraction of its horizon has passed */
+const PREWARM_ADVANCE = 0.25;
+
+/**
+ * Tolerance (s) when matching request times to a window's grid: UTC to ET
+ * conversion carries tens of us of rounding, and 0.1 ms moves a LEO
+ * satellite by under a metre
+ */
+const GRID_TOLERANCE_S = 1e-4;
+
+/** One tracked object */
+export interface HotObject {
+  key: string;
+  /** Most recent TLE seen for the object */
+  tle: { line1: string; line2: string };
+  model: string;
+  /** Decayed access count (an overestimate by at most `error`) */
+  count: number;
+  error: number;
+}
+
+/**
+ * Space-saving top-K access counter
+ */
+export class HotObjectTracker {
+  readonly capacity: number;
+  private counters = new Map<string, HotObject>();
+  private accesses = 0;
+  private lastDecay = performance.now();
+
+  constructor() {
+    this.capacity = parseInt(process.env.SGP4_HOT_K || '', 10) || 256;
+  }
+
+  /**
+   * Count one access to an object
+   */
+  record(tle: { line1: string; line2: string }, model: string): void {
+    this.decay();
+    this.accesses++;
+    const key = `${tle.line1.slice(2, 7).trim()}|${model}`;
+    let counter = this.counters.get(key);
+    if (!counter) {
+      if (this.counters.size < this.capacity) {
+        counter = { key, tle, model, count: 0, error: 0 };
+      } else {
+        // Replace the smallest counter; the newcomer inherits its count as error
+        let min: HotObject | undefined;
+        for (const c of this.counters.values()) {
+          if (!min || c.count < min.count) {
+            min = c;
+          }
+        }
+        this.counters.delete(min!.key);
+        counter = { key, tle, model, count: min!.count, error: min!.count };
+      }
+      this.counters.set(key, counter);
+    }
+    counter.count++;
+    counter.tle = tle;
+  }
+
+  /**
+   * The n most accessed objects, hottest first
+   */
+  top(n: number): HotObject[] {
+    this.decay();
+    return [...this.counters.values()].sort((a, b) => b.count - a.count).slice(0, n);
+  }
+
+  private decay(): void {
+    const now = performance.now();
+    if (now - this.lastDecay < HOT_HALF_LIFE_MS) {
+      return;
+    }
+    this.lastDecay = now;
+    for (const c of this.counters.values()) {
+      c.count /= 2;
+      c.error /= 2;
+    }
+  }
+
+  get stats(): { capacity: number; tracked: number; accesses: number } {
+    return { capacity: this.capacity, tracked: this.counters.size, accesses: this.accesses };
+  }
+}
+
+/** A prewarmed ephemeris window */
+interface PrewarmWindow {
+  tle: { line1: string; line2: string };
+  model: string;
+  et0: number;
+  step: number;
+  /** Packed et | x | y | z | vx | vy | vz columns (TEME) */
+  packed: Float64Array;
+}
+
+/** Prewarmer statistics */
+export interface PrewarmStats {
+  enabled: boolean;
+  objects: number;
+  horizonSeconds: number;
+  step: number;
+  windows: number;
+  builds: number;
+  failures: number;
+  /** Range requests served from / not found in a window */
+  hits: number;
+  misses: number;
+  hitRate: number;
+}
+
+/**
+ * Keeps ephemeris windows of the hot set ready
+ */
+export class EphemerisPrewarmer {
+  readonly objects: number;
+  readonly horizonSeconds: number;
+  readonly step: number;
+  private pool: SGP4NativeWorkerPool;
+  private tracker: HotObjectTracker;
+  private utcToET: (utc: string) => number;
+  private windows = new Map<string, PrewarmWindow>();
+  private building = new Set<string>();
+  private builds = 0;
+  private failures = 0;
+  private hits = 0;
+  private misses = 0;
+
+  /**
+   * @param utcToET - UTC string to ET conversion (the loaded SGP4 module's)
+   */
+  constructor(pool: SGP4NativeWorkerPool, tracker: HotObjectTracker, utcToET: (utc: string) => number) {
+    this.pool = pool;
+    this.tracker = tracker;
+    this.utcToET = utcToET;
+    this.objects = parseInt(process.env.SGP4_PREWARM_OBJECTS || '', 10) || 0;
+    this.horizonSeconds = parseFloat(process.env.SGP4_PREWARM_HORIZON_S || '') || 21600;
+    this.step = parseFloat(process.env.SGP4_PREWARM_STEP || '') || 60;
+  }
+
+  /**
+   * Start the periodic prewarm check (no-op when disabled)
+   */
+  start(): void {
+    if (this.objects > 0) {
+      setInterval(() => this.refresh(), PREWARM_INTERVAL_MS).unref();
+    }
+  }
+
+  /**
+   * Packed TEME ephemeris of a range request from a prewarmed window, or
+   * undefined when no window covers it
+   */
+  lookup(
+    tle: { line1: string; line2: string },
+    model: string,
+    et0: number,
+    etf: number,
+    step: number
+  ): Float64Array | undefined {
+    if (this.objects === 0) {
+      return undefined;
+    }
+    const window = this.windows.get(`${tle.line1.slice(2, 7).trim()}|${model}`);
+    const n = window ? window.packed.length / 7 : 0;
+    const offset = window ? (et0 - window.et0) / window.step : NaN;
+    const stride = window ? step / window.step : NaN;
+    const count = Math.floor((etf - et0) / step) + 1;
+    if (
+      !window ||
+      window.tle.line1 !== tle.line1 ||
+      window.tle.line2 !== tle.line2 ||
+      Math.abs(offset - Math.round(offset)) * window.step > GRID_TOLERANCE_S ||
+      Math.abs(stride - Math.round(stride)) * window.step > GRID_TOLERANCE_S ||
+      Math.round(offset) < 0 ||
+      Math.round(stride) < 1 ||
+      Math.round(offset) + (count - 1) * Math.round(stride) >= n
+    ) {
+      this.misses++;
+      return undefined;
+    }
+
+    this.hits++;
+    const first = Math.round(offset);
+    const every = Math.round(stride);
+    const out = new Float64Array(count * 7);
+    for (let c = 0; c < 7; c++) {
+      for (let i = 0; i < count; i++) {
+        out[c * count + i] = window.packed[c * n + first + i * every];
+      }
+    }
+    return out;
+  }
+
+  /**
+   * Build or advance the windows of the current hot set, drop the rest
+   */
+  private refresh(): void {
+    const hot = this.tracker.top(this.objects);
+    const keys = new Set(hot.map((h) => h.key));
+    for (const key of this.windows.keys()) {
+      if (!keys.has(key)) {
+        this.windows.delete(key);
+      }
+    }
+
+    const nowSeconds = Math.floor(Date.now() / 1000 / this.step) * this.step;
+    const et0 = this.utcToET(new Date(nowSeconds * 1000).toISOString().slice(0, 19));
+    for (const h of hot) {
+      const window = this.windows.get(h.key);
+      const current =
+        window &&
+        window.tle.line1 === h.tle.line1 &&
+        window.tle.line2 === h.tle.line2 &&
+        et0 - window.et0 < this.horizonSeconds * PREWARM_ADVANCE;
+      if (!current && !this.building.has(h.key)) {
+        void this.build(h, et0);
+      }
+    }
+  }
+
+  private async build(h: HotObject, et0: number): Promise<void> {
+    this.building.add(h.key);
+    try {
+      const result = await schedulingContext.run({ qos: 'bulk', tenant: 'prewarm' }, () =>
+        this.pool.propagate({
+          tle: h.tle,
+          times: { et0, etf: et0 + this.horizonSeconds, step: this.step },
+          model: h.model,
+          packed: true,
+        })
+      );
+      this.windows.set(h.key, { tle: h.tle, model: h.model, et0, step: this.step, packed: result.packed! });
+      this.builds++;
+    } catch {
+      this.failures++;
+    } finally {
+      this.building.delete(h.key);
+    }
+  }
+
+  get stats(): PrewarmStats {
+    return {
+      enabled: this.objects > 0,
+      objects: this.objects,
+      horizonSeconds: this.horizonSeconds,
+      step: this.step,
+      windows: this.windows.size,
+      builds: this.builds,
+      failures: this.failures,
+      hits: this.hits,
+      misses: this.misses,
+      hitRate: this.hits + this.misses > 0 ? this.hits / (this.hits + this.misses) : 0,
+    };
+  }
+}
@@ -117,6 +117,21 @@ export async function createSGP4(): Promise<SGP4Module> {
     'number',
   ]) as (et: number, bufferPtr: number, maxLen: number) => number;
 
+  const _sgp4_utc_to_et_array = Module.cwrap('sgp4_utc_to_et_array', 'number', [
+    'number',
+    'number',
+    'number',
+    'number',
+  ]) as (stringsPtr: number, width: number, n: number, etPtr: number) => number;
+
+  const _sgp4_et_grid_to_utc = Module.cwrap('sgp4_et_grid_to_utc', 'number', [
+    'number',
+    'number',
+    'number',
+    'number',
+    'number',
+  ]) as (et0: number, step: number, n: number, bufferPtr: number, width: number) => number;
+
   const _sgp4_get_last_error = Module.cwrap('sgp4_get_last_error', 'string', []) as () => string;
 
   const _sgp4_clear_error = Module.cwrap('sgp4_clear_error', null, []) as () => void;
@@ -142,6 +157,8 @@ export async function createSGP4(): Promise<SGP4Module> {
   const STATE_SIZE = 6 * 8; // 6 doubles
   const GEOPHS_SIZE = 8 * 8; // 8 doubles
   const UTC_BUFFER_SIZE = 64;
+  // Fixed-width slot of one ISO calendar string ("2024-01-15T12:00:00.000")
+  const UTC_SLOT_SIZE = 23;
 
   const elemsPtr = Module._malloc(ELEMS_SIZE);
   const statePtr = Module._malloc(STATE_SIZE);
@@ -287,6 +304,52 @@ export async function createSGP4(): Promise<SGP4Module> {
       return Module.UTF8ToString(utcBufferPtr);
     },
 
+    utcToETArray(utcStrings: string[]): Float64Array {
+      if (!initialized) {
+        throw new Error('SGP4 module not initialized. Call init() first.');
+      }
+
+      const n = utcStrings.length;
+      const width = utcStrings.reduce((w, s) => Math.max(w, Module.lengthBytesUTF8(s) + 1), 1);
+      const stringsPtr = Module._malloc(n * width);
+      const etPtr = Module._malloc(n * 8);
+
+      try {
+        utcStrings.forEach((s, i) => Module.stringToUTF8(s, stringsPtr + i * width, width));
+
+        if (_sgp4_utc_to_et_array(stringsPtr, width, n, etPtr) !== 0) {
+          throw new Error(`UTC conversion failed: ${_sgp4_get_last_error()}`);
+        }
+
+        return Module.HEAPF64.slice(etPtr / 8, etPtr / 8 + n);
+      } finally {
+        Module._free(stringsPtr);
+        Module._free(etPtr);
+      }
+    },
+
+    etGridToUTC(et0: number, step: number, n: number): string[] {
+      if (!initialized) {
+        throw new Error('SGP4 module not initialized. Call init() first.');
+      }
+
+      const bufferPtr = Module._malloc(n * UTC_SLOT_SIZE);
+
+      try {
+        if (_sgp4_et_grid_to_utc(et0, step, n, bufferPtr, UTC_SLOT_SIZE) !== 0) {
+          throw new Error(`ET conversion failed: ${_sgp4_get_last_error()}`);
+        }
+
+        // Decode the packed slots once, then slice per point
+        const packed = Module.UTF8ToString(bufferPtr, n * UTC_SLOT_SIZE);
+        return Array.from({ length: n }, (_, i) =>
+          packed.slice(i * UTC_SLOT_SIZE, (i + 1) * UTC_SLOT_SIZE).trimEnd()
+        );
+      } finally {
+        Module._free(bufferPtr);
+      }
+    },
+
     getLastError(): string {
       return _sgp4_get_last_error();
     },
@@ -0,0 +1,390 @@
+/**
+ * Streaming Satellite Ingestion
+ *
+ * express.json() buffers a whole request body and parses it into objects
+ * before the handler runs, so a large TLE or OMM upload costs its full
+ * size in transient heap plus one long blocking parse. Batch endpoints
+ * also accept line-oriented bodies that are read from the request stream
+ * instead:
+ *
+ * - `text/plain`: 2LE/3LE text (an optional name line before each line 1)
+ * - `application/x-ndjson`: one OMM or `{ line1, line2, name? }` object per line
+ * - `application/x-sgp4-elements`: binary element frames (below)
+ *
+ * Satellites are handed out in chunks as soon as they are complete, so the
+ * handler can start propagating the first chunks while the upload continues.
+ * express.json() leaves these content types unread.
+ *
+ * A binary body is a sequence of frames, each a chunk of its own, for
+ * clients that already hold mean elements and should not format TLEs for
+ * the server to re-parse. All values are little-endian:
+ *
+ * | Offset | Type | Content |
+ * |--------|------|---------|
+ * | 0 | 8 bytes | magic `SGP4ELM1` |
+ * | 8 | uint32 | n, satellites in the frame |
+ * | 12 | uint32 | reserved, 0 |
+ * | 16 | float64[10][n] | element columns in TLEElements.elements order (CSPICE `elems`: ndot, nddot, bstar, inclo, nodeo, ecco, argpo, mo, no, epoch ET) |
+ * | 16 + 80n | int32[n] | NORAD IDs |
+ * | 16 + 84n | 4 bytes | zero padding when n is odd |
+ *
+ * Columns are copied once out of the socket buffers and then straight into
+ * the engine's SoA batch (one memcpy per column); nothing is parsed.
+ *
+ * @example
+ * ```typescript
+ * for await (const chunk of satelliteChunks(req, 1024)) {
+ *   pending.push(propagate(chunk));
+ * }
+ * ```
+ */
+
+import { StringDecoder } from 'string_decoder';
+import { endianness } from 'os';
+import type { Readable } from 'stream';
+import type { IncomingMessage } from 'http';
+import { OMMData, ommToTLE, validateOMM } from './omm.js';
+import type { NativeSGP4Module } from './sgp4-native.js';
+import type { ElementColumns, SatelliteList } from './worker-types.js';
+
+/** A satellite resolved to TLE lines */
+export interface SatelliteInput {
+  line1: string;
+  line2: string;
+  name?: string;
+}
+
+/** Streamed body formats, by content type */
+export const SATELLITE_STREAM_TYPES = [
+  'text/plain',
+  'application/x-ndjson',
+  'application/x-sgp4-elements',
+] as const;
+
+/** First 8 bytes of a binary element frame */
+export const ELEMENT_FRAME_MAGIC = 'SGP4ELM1';
+
+/** Binary element frame header size in bytes */
+const ELEMENT_FRAME_HEADER = 16;
+
+/** Largest accepted frame, in satellites */
+const MAX_FRAME_SATELLITES = 100000;
+
+/** One binary element frame: element columns with the NORAD ID of each satellite */
+export interface ElementFrame extends ElementColumns {
+  norad: Int32Array;
+}
+
+export type SatelliteStreamType = (typeof SATELLITE_STREAM_TYPES)[number];
+
+/**
+ * Streamed body format of a request, or undefined for other content types
+ */
+export function satelliteStreamType(req: IncomingMessage): SatelliteStreamType | undefined {
+  const type = (req.headers['content-type'] || '').split(';')[0].trim().toLowerCase();
+  return SATELLITE_STREAM_TYPES.find((t) => t === type);
+}
+
+/**
+ * Resolve one satellite given as TLE ({ line1, line2, name? }) or OMM into
+ * TLE lines
+ *
+ * @throws Error naming the entry by index
+ */
+export function toSatellite(entry: unknown, index: number): SatelliteInput {
+  const sat = (entry || {}) as Record<string, unknown>;
+  if (sat.line1 || sat.line2) {
+    if (typeof sat.line1 !== 'string' || typeof sat.line2 !== 'string') {
+      throw new Error(`Missing TLE lines for satellite ${index}`);
+    }
+    return { line1: sat.line1, line2: sat.line2, name: sat.name as string | undefined };
+  }
+  try {
+    validateOMM(sat);
+  } catch (err) {
+    throw new Error(`Satellite ${index}: ${(err as Error).message}`);
+  }
+  const omm = sat as unknown as OMMData;
+  return { ...ommToTLE(omm), name: omm.OBJECT_NAME };
+}
+
+/**
+ * Longest accepted line per line format, CR included: TLE lines are 69
+ * characters (names are shorter), OMM objects a few hundred bytes
+ */
+const MAX_LINE_LENGTH = { 'text/plain': 80, 'application/x-ndjson': 65536 } as const;
+
+/**
+ * Lines of a byte stream, decoded as UTF-8 without trailing CR
+ *
+ * @throws Error on a line longer than maxLength, without buffering the rest of it
+ */
+async function* streamLines(stream: Readable, maxLength: number): AsyncGenerator<string> {
+  const decoder = new StringDecoder('utf8');
+  let rest = '';
+  let number = 0;
+  const checked = (line: string): string => {
+    number++;
+    if (line.length > maxLength) {
+      throw new Error(`Line ${number}: longer than ${maxLength} characters`);
+    }
+    return line.endsWith('\r') ? line.slice(0, -1) : line;
+  };
+
+  for await (const data of stream) {
+    const text = rest + (typeof data === 'string' ? data : decoder.write(data));
+    const lines = text.split('\n');
+    rest = lines.pop()!;
+    for (const line of lines) {
+      yield checked(line);
+    }
+    if (rest.length > maxLength) {
+      checked(rest);
+    }
+  }
+  rest += decoder.end();
+  if (rest) {
+    yield checked(rest);
+  }
+}
+
+/**
+ * Satellites of a 2LE/3LE text stream. A name line is any non-blank line
+ * before a line 1 (a leading "0 " is dropped).
+ */
+async function* tleSatellites(lines: AsyncIterable<string>): AsyncGenerator<SatelliteInput> {
+  let name: string | undefined;
+  let line1: string | undefined;
+  let number = 0;
+
+  for await (const raw of lines) {
+    number++;
+    const line = raw.trimEnd();
+    if (!line) {
+      continue;
+    }
+    if (line1 !== undefined) {
+      if (!line.startsWith('2 ')) {
+        throw new Error(`Line ${number}: expected TLE line 2`);
+      }
+      yield { line1, line2: line, ...(name && { name }) };
+      line1 = undefined;
+      name = undefined;
+    } else if (line.startsWith('1 ')) {
+      line1 = line;
+    } else if (line.startsWith('2 ')) {
+      throw new Error(`Line ${number}: TLE line 2 without line 1`);
+    } else {
+      name = line.startsWith('0 ') ? line.slice(2).trim() : line.trim();
+    }
+  }
+
+  if (line1 !== undefined) {
+    throw new Error('Body ends after a TLE line 1');
+  }
+}
+
+/**
+ * Satellites of an NDJSON stream of OMM or TLE objects
+ */
+async function* ndjsonSatellites(lines: AsyncIterable<string>): AsyncGenerator<SatelliteInput> {
+  let index = 0;
+  let number = 0;
+
+  for await (const line of lines) {
+    number++;
+    if (!line.trim()) {
+      continue;
+    }
+    let entry: unknown;
+    try {
+      entry = JSON.parse(line);
+    } catch {
+      throw new Error(`Line ${number}: invalid JSON`);
+    }
+    yield toSatellite(entry, index++);
+  }
+}
+
+/**
+ * Bytes of a binary element frame with n satellites
+ */
+function elementFrameBytes(n: number): number {
+  return ELEMENT_FRAME_HEADER + 84 * n + (n % 2) * 4;
+}
+
+/**
+ * Encode element columns (10 columns of n values) and NORAD IDs as one
+ * binary element frame
+ */
+export function encodeElementFrame(columns: Float64Array, norad: ArrayLike<number>): Buffer {
+  const n = norad.length;
+  if (columns.length !== n * 10) {
+    throw new Error('columns must hold 10 values per NORAD ID');
+  }
+  const frame = Buffer.alloc(elementFrameBytes(n));
+  frame.write(ELEMENT_FRAME_MAGIC, 0, 'latin1');
+  frame.writeUInt32LE(n, 8);
+  Buffer.from(columns.buffer, columns.byteOffset, columns.byteLength).copy(frame, ELEMENT_FRAME_HEADER);
+  const ids = Int32Array.from(norad);
+  Buffer.from(ids.buffer).copy(frame, ELEMENT_FRAME_HEADER + 80 * n);
+  return frame;
+}
+
+/**
+ * Frames of a binary element stream, each yielded once fully received
+ */
+async function* elementFrames(stream: Readable): AsyncGenerator<ElementFrame> {
+  if (endianness() !== 'LE') {
+    throw new Error('Binary element frames need a little-endian host');
+  }
+
+  const pending: Buffer[] = [];
+  let available = 0;
+
+  // Copy the next `length` buffered bytes into `target`
+  const take = (target: Uint8Array, length: number): void => {
+    let offset = 0;
+    while (offset < length) {
+      const head = pending[0];
+      const count = Math.min(head.length, length - offset);
+      head.copy(target, offset, 0, count);
+      offset += count;
+      if (count === head.length) {
+        pending.shift();
+      } else {
+        pending[0] = head.subarray(count);
+      }
+    }
+    available -= length;
+  };
+
+  let frame = 0;
+  let header: Buffer | undefined;
+  const drain = function* (): Generator<ElementFrame> {
+    for (;;) {
+      if (!header) {
+        if (available < ELEMENT_FRAME_HEADER) {
+          return;
+        }
+        header = Buffer.alloc(ELEMENT_FRAME_HEADER);
+        take(header, ELEMENT_FRAME_HEADER);
+        if (header.toString('latin1', 0, 8) !== ELEMENT_FRAME_MAGIC) {
+          throw new Error(`Frame ${frame}: bad magic (expected ${ELEMENT_FRAME_MAGIC})`);
+        }
+        const n = header.readUInt32LE(8);
+        if (n === 0 || n > MAX_FRAME_SATELLITES) {
+          throw new Error(`Frame ${frame}: satellite count must be 1 to ${MAX_FRAME_SATELLITES}`);
+        }
+      }
+
+      const n = header.readUInt32LE(8);
+      const body = elementFrameBytes(n) - ELEMENT_FRAME_HEADER;
+      if (available < body) {
+        return;
+      }
+      const columns = new Float64Array(10 * n);
+      const norad = new Int32Array(n + (n % 2));
+      take(new Uint8Array(columns.buffer), columns.byteLength);
+      take(new Uint8Array(norad.buffer), norad.byteLength);
+      header = undefined;
+      frame++;
+      yield { columns, norad: norad.subarray(0, n) };
+    }
+  };
+
+  for await (const data of stream) {
+    pending.push(data as Buffer);
+    available += (data as Buffer).length;
+    yield* drain();
+  }
+  if (header || available > 0) {
+    throw new Error(`Frame ${frame}: body ends mid-frame`);
+  }
+}
+
+/**
+ * Read the satellites of a streamed request body in chunks of up to
+ * `chunkSize` (binary bodies: one chunk per frame), each yielded as soon
+ * as it is complete
+ *
+ * @throws Error on a malformed entry or a non-streamed content type
+ */
+export async function* satelliteChunks(
+  req: IncomingMessage,
+  chunkSize: number
+): AsyncGenerator<SatelliteInput[] | ElementFrame> {
+  const type = satelliteStreamType(req);
+  if (!type) {
+    throw new Error(`Unsupported content type: ${req.headers['content-type']}`);
+  }
+  yield* streamSatelliteChunks(req, type, chunkSize);
+}
+
+/**
+ * Read the satellites of any byte stream in a streamed body format, in
+ * chunks as satelliteChunks() does (e.g. a catalog file)
+ *
+ * @throws Error on a malformed entry
+ */
+export async function* streamSatelliteChunks(
+  stream: Readable,
+  type: SatelliteStreamType,
+  chunkSize: number
+): AsyncGenerator<SatelliteInput[] | ElementFrame> {
+  if (type === 'application/x-sgp4-elements') {
+    yield* elementFrames(stream);
+    return;
+  }
+
+  const lines = streamLines(stream, MAX_LINE_LENGTH[type]);
+  const satellites = type === 'text/plain' ? tleSatellites(lines) : ndjsonSatellites(lines);
+
+  let chunk: SatelliteInput[] = [];
+  for await (const sat of satellites) {
+    chunk.push(sat);
+    if (chunk.length >= chunkSize) {
+      yield chunk;
+      chunk = [];
+    }
+  }
+  if (chunk.length) {
+    yield chunk;
+  }
+}
+
+/**
+ * Number of satellites in a TLE list or element columns
+ */
+export function satelliteCount(list: SatelliteList): number {
+  return Array.isArray(list) ? list.length : list.columns.length / 10;
+}
+
+/**
+ * Satellites [from, to) of a TLE list or element columns
+ */
+export function sliceSatellites(list: SatelliteList, from: number, to: number): SatelliteList {
+  if (Array.isArray(list)) {
+    return list.slice(from, to);
+  }
+  const n = list.columns.length / 10;
+  const m = Math.min(to, n) - from;
+  const columns = new Float64Array(10 * m);
+  for (let c = 0; c < 10; c++) {
+    columns.set(list.columns.subarray(c * n + from, c * n + from + m), c * m);
+  }
+  return { columns };
+}
+
+/**
+ * Engine input for a TLE list (parsed into 10 values per set) or element
+ * columns (passed through)
+ */
+export function elementsOf(sgp4: NativeSGP4Module, list: SatelliteList): Float64Array | ElementColumns {
+  if (!Array.isArray(list)) {
+    return list;
+  }
+  const elements = new Float64Array(list.length * 10);
+  list.forEach((t, i) => elements.set(sgp4.parseTLE(t.line1, t.line2).elements, i * 10));
+  return elements;
+}
@@ -0,0 +1,201 @@
+/**
+ * Adaptive Concurrency Limiter
+ *
+ * A fixed worker pool behind an unbounded queue turns overload into
+ * latency: when the main thread saturates on serialization or compression,
+ * requests simply wait longer. The limiter caps requests in flight and
+ * moves the cap to where throughput stops improving, answering the excess
+ * at once with 503 and Retry-After instead of queueing it.
+ *
+ * The limit follows a latency gradient (as in Netflix's Gradient2): with a
+ * slow long-term latency average as the no-load baseline and a fast
+ * short-term average as the current latency,
+ *
+ *   gradient = clamp(tolerance x long / short, 0.5, 1)
+ *   limit    = smoothed(limit x gradient + sqrt(limit))
+ *
+ * so the limit grows by about sqrt(limit) while latency stays within the
+ * tolerance of the baseline, and shrinks in proportion once queueing
+ * inflates it. Two congestion signals checked every second decrease it
+ * multiplicatively (AIMD): event-loop delay p99 above SGP4_LIMIT_MAX_LAG_MS
+ * (main thread saturated) and pool queue wait above the baseline latency
+ * (workers saturated).
+ *
+ * Enabled with SGP4_CONCURRENCY_LIMIT=adaptive; a number sets a fixed limit.
+ */
+
+import { monitorEventLoopDelay, type IntervalHistogram } from 'perf_hooks';
+import type { Request, Response, NextFunction } from 'express';
+
+/** Allowed rise of current over baseline latency before the limit shrinks */
+const LATENCY_TOLERANCE = 1.5;
+
+/** Weight of each new limit estimate */
+const LIMIT_SMOOTHING = 0.2;
+
+/** EWMA weights of the short- and long-term latency averages */
+const SHORT_ALPHA = 0.1;
+const LONG_ALPHA = 0.002;
+
+/** Multiplicative decrease on a congestion signal */
+const BACKOFF = 0.8;
+
+/** Congestion check interval in ms */
+const CHECK_INTERVAL_MS = 1000;
+
+/** Limiter state as reported in pool stats */
+export interface LimiterStats {
+  mode: 'adaptive' | 'fixed' | 'off';
+  limit: number;
+  inFlight: number;
+  minLimit: number;
+  maxLimit: number;
+  /** Baseline (long-term) and current (short-term) request latency */
+  longLatencyMs: number;
+  shortLatencyMs: number;
+  /** Event-loop delay p99 over the last interval */
+  eventLoopLagMs: number;
+  queueWaitMs: number;
+  /** Requests answered 503 because the limit was reached */
+  shed: number;
+  /** Multiplicative decreases on event-loop lag or queue wait */
+  backoffs: number;
+}
+
+/**
+ * Concurrency limiter for one server
+ */
+export class ConcurrencyLimiter {
+  readonly mode: LimiterStats['mode'];
+  readonly minLimit: number;
+  readonly maxLimit: number;
+  readonly maxLagMs: number;
+  private limit: number;
+  private inFlight = 0;
+  private shortLatency = 0;
+  private longLatency = 0;
+  private eventLoopLag = 0;
+  private queueWait = 0;
+  private shed = 0;
+  private backoffs = 0;
+  private histogram?: IntervalHistogram;
+  private queueWaitMs: () => number;
+
+  /**
+   * @param poolSize - Workers behind the server (sets the default bounds)
+   * @param queueWaitMs - Current mean pool queue wait
+   */
+  constructor(poolSize: number, queueWaitMs: () => number) {
+    const setting = (process.env.SGP4_CONCURRENCY_LIMIT || 'off').toLowerCase();
+    const fixed = parseInt(setting, 10);
+    this.mode = setting === 'adaptive' ? 'adaptive' : fixed > 0 ? 'fixed' : 'off';
+    this.minLimit = parseInt(process.env.SGP4_LIMIT_MIN || '', 10) || poolSize;
+    this.maxLimit = parseInt(process.env.SGP4_LIMIT_MAX || '', 10) || poolSize * 64;
+    this.maxLagMs = parseFloat(process.env.SGP4_LIMIT_MAX_LAG_MS || '') || 100;
+    this.limit = this.mode === 'fixed' ? fixed : poolSize * 4;
+    this.queueWaitMs = queueWaitMs;
+
+    if (this.mode === 'adaptive') {
+      this.histogram = monitorEventLoopDelay({ resolution: 10 });
+      this.histogram.enable();
+      setInterval(() => this.check(), CHECK_INTERVAL_MS).unref();
+    }
+  }
+
+  /**
+   * Middleware admitting requests up to the limit. Health and stats
+   * endpoints are never shed.
+   */
+  middleware(): (req: Request, res: Response, next: NextFunction) => void {
+    return (req: Request, res: Response, next: NextFunction) => {
+      if (this.mode === 'off' || (req.method === 'GET' && /\/(health|stats)$/.test(req.path))) {
+        next();
+        return;
+      }
+
+      if (this.inFlight >= Math.floor(this.limit)) {
+        this.shed++;
+        res.set('Retry-After', '1');
+        res.status(503).json({ error: 'Server at its concurrency limit, retry shortly' });
+        return;
+      }
+
+      this.inFlight++;
+      const start = performance.now();
+      let done = false;
+      const finish = () => {
+        if (done) {
+          return;
+        }
+        done = true;
+        this.inFlight--;
+        this.sample(performance.now() - start);
+      };
+      res.on('finish', finish);
+      res.on('close', finish);
+      next();
+    };
+  }
+
+  /**
+   * Gradient update from one request's latency
+   */
+  private sample(ms: number): void {
+    if (this.longLatency === 0) {
+      this.shortLatency = this.longLatency = ms;
+      return;
+    }
+    this.shortLatency += SHORT_ALPHA * (ms - this.shortLatency);
+    this.longLatency += LONG_ALPHA * (ms - this.longLatency);
+    // Let the baseline follow a lasting drop in latency quickly
+    if (this.shortLatency < this.longLatency / 2) {
+      this.longLatency *= 0.95;
+    }
+
+    if (this.mode !== 'adaptive') {
+      return;
+    }
+    // Only probe upwards while the limit is actually being used
+    if (this.inFlight < this.limit / 2 && this.shortLatency <= this.longLatency) {
+      return;
+    }
+
+    const gradient = Math.max(0.5, Math.min(1, (LATENCY_TOLERANCE * this.longLatency) / this.shortLatency));
+    const estimate = this.limit * gradient + Math.sqrt(this.limit);
+    this.setLimit(this.limit * (1 - LIMIT_SMOOTHING) + estimate * LIMIT_SMOOTHING);
+  }
+
+  /**
+   * Periodic congestion check on event-loop delay and pool queue wait
+   */
+  private check(): void {
+    this.eventLoopLag = this.histogram!.percentile(99) / 1e6;
+    this.histogram!.reset();
+    this.queueWait = this.queueWaitMs();
+
+    if (this.eventLoopLag > this.maxLagMs || (this.longLatency > 0 && this.queueWait > this.longLatency)) {
+      this.backoffs++;
+      this.setLimit(this.limit * BACKOFF);
+    }
+  }
+
+  private setLimit(limit: number): void {
+    this.limit = Math.max(this.minLimit, Math.min(this.maxLimit, limit));
+  }
+
+  get stats(): LimiterStats {
+    return {
+      mode: this.mode,
+      limit: Math.floor(this.limit),
+      inFlight: this.inFlight,
+      minLimit: this.minLimit,
+      maxLimit: this.maxLimit,
+      longLatencyMs: this.longLatency,
+      shortLatencyMs: this.shortLatency,
+      eventLoopLagMs: this.eventLoopLag,
+      queueWaitMs: this.queueWait,
+      shed: this.shed,
+      backoffs: this.backoffs,
+    };
+  }
+}
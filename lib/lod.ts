@@ -0,0 +1,297 @@
+/**
+ * Level-of-Detail Ephemeris Pyramid
+ *
+ * Zoomable timeline clients ask for the same object at many resolutions.
+ * Instead of propagating every zoom window densely, the ephemeris of an
+ * object is built once per fixed-length tile as a pyramid of packed levels:
+ * level 0 at the base step, each further level LOD_FACTOR times coarser. A
+ * window is served from the finest level that fits its point budget.
+ *
+ * Tiles are aligned to multiples of the tile length in ET, so overlapping
+ * windows from different clients land on the same cached tiles. Each level
+ * keeps the level 0 samples at ET multiples of its own step rather than
+ * every k-th sample from the tile start, so a level stays evenly spaced
+ * across tile boundaries even when its step does not divide the tile
+ * length. The cache holds build promises, so concurrent requests for a tile
+ * share one build.
+ *
+ * @example
+ * ```typescript
+ * const lod = new EphemerisPyramidCache(nativeWorkerPool);
+ * const window = await lod.window(tle, 'wgs72', 'TEME', et0, etf, 1000);
+ * ```
+ */
+
+import type { SGP4NativeWorkerPool } from './worker-pool-native.js';
+
+/** Decimation factor between consecutive levels */
+export const LOD_FACTOR = 4;
+
+/** Levels stop once a tile holds at most this many points */
+const LOD_MIN_POINTS = 16;
+
+/** One tile's pyramid: packed (et | x | y | z | vx | vy | vz) levels */
+interface Pyramid {
+  levels: Float64Array[];
+  bytes: number;
+}
+
+/** Cache statistics */
+export interface PyramidCacheStats {
+  tiles: number;
+  bytes: number;
+  maxBytes: number;
+  hits: number;
+  misses: number;
+  evictions: number;
+}
+
+/** Points of a window, with the level they came from */
+export interface PyramidWindow {
+  /** Packed et | x | y | z | vx | vy | vz columns */
+  packed: Float64Array;
+  level: number;
+  levels: number;
+  /** Sample spacing of the returned points in seconds */
+  step: number;
+  /** Tiles served from cache / built for this window */
+  hits: number;
+  misses: number;
+}
+
+/**
+ * Decimate a packed ephemeris, keeping every `factor`-th row from `offset`
+ */
+function decimate(packed: Float64Array, factor: number, offset: number): Float64Array {
+  const n = packed.length / 7;
+  const m = Math.max(0, Math.ceil((n - offset) / factor));
+  const out = new Float64Array(m * 7);
+  for (let c = 0; c < 7; c++) {
+    for (let i = 0; i < m; i++) {
+      out[c * m + i] = packed[c * n + offset + i * factor];
+    }
+  }
+  return out;
+}
+
+/**
+ * LRU cache of ephemeris pyramids, bounded in bytes
+ */
+export class EphemerisPyramidCache {
+  /** Insertion order is recency order (oldest first) */
+  private tiles = new Map<string, Promise<Pyramid>>();
+  private sizes = new Map<string, number>();
+  private bytes = 0;
+  private hits = 0;
+  private misses = 0;
+  private evictions = 0;
+  private pool: SGP4NativeWorkerPool;
+  readonly baseStep: number;
+  readonly tileSeconds: number;
+  readonly maxBytes: number;
+
+  /**
+   * @param pool - Native worker pool used to build tiles
+   * @param baseStep - Level 0 sample spacing in seconds
+   * @param tileSeconds - Tile length in seconds, rounded up to a multiple
+   *                      of baseStep
+   * @param maxBytes - Cache budget
+   */
+  constructor(
+    pool: SGP4NativeWorkerPool,
+    baseStep?: number,
+    tileSeconds = 86400,
+    maxBytes?: number
+  ) {
+    this.pool = pool;
+    this.baseStep = baseStep || parseFloat(process.env.SGP4_LOD_BASE_STEP || '') || 10;
+    // Every tile then starts on the global base-step grid
+    this.tileSeconds = Math.ceil(tileSeconds / this.baseStep) * this.baseStep;
+    this.maxBytes = maxBytes || (parseFloat(process.env.SGP4_LOD_CACHE_MB || '') || 256) * 1024 * 1024;
+  }
+
+  /** Number of levels in each tile */
+  get levels(): number {
+    let n = Math.floor(this.tileSeconds / this.baseStep);
+    let levels = 1;
+    while (n > LOD_MIN_POINTS) {
+      n = Math.ceil(n / LOD_FACTOR);
+      levels++;
+    }
+    return levels;
+  }
+
+  /**
+   * Serve [et0, etf] with at most maxPoints points from the finest level
+   * that fits
+   */
+  async window(
+    tle: { line1: string; line2: string },
+    model: string,
+    frame: 'TEME' | 'GCRF',
+    et0: number,
+    etf: number,
+    maxPoints: number
+  ): Promise<PyramidWindow> {
+    const levels = this.levels;
+    let level = 0;
+    while (level < levels - 1 && Math.floor((etf - et0) / this.levelStep(level)) + 1 > maxPoints) {
+      level++;
+    }
+
+    const first = Math.floor(et0 / this.tileSeconds);
+    const last = Math.floor(etf / this.tileSeconds);
+    let hits = 0;
+    const tiles = await Promise.all(
+      Array.from({ length: last - first + 1 }, (_, i) => {
+        const { pyramid, hit } = this.tile(tle, model, frame, first + i);
+        hits += hit ? 1 : 0;
+        return pyramid;
+      })
+    );
+
+    // Rows of the chosen level inside the window, tile by tile
+    const parts: Array<{ packed: Float64Array; from: number; to: number }> = [];
+    let count = 0;
+    for (const pyramid of tiles) {
+      const packed = pyramid.levels[level];
+      const n = packed.length / 7;
+      let from = 0;
+      while (from < n && packed[from] < et0) from++;
+      let to = from;
+      while (to < n && packed[to] <= etf) to++;
+      parts.push({ packed, from, to });
+      count += to - from;
+    }
+
+    // The coarsest level can still exceed the budget over long windows
+    const stride = Math.max(1, Math.ceil(count / maxPoints));
+    const total = Math.ceil(count / stride);
+    const out = new Float64Array(total * 7);
+    let row = 0;
+    let index = 0;
+    for (const { packed, from, to } of parts) {
+      const n = packed.length / 7;
+      for (let i = from; i < to; i++, index++) {
+        if (index % stride !== 0) {
+          continue;
+        }
+        for (let c = 0; c < 7; c++) {
+          out[c * total + row] = packed[c * n + i];
+        }
+        row++;
+      }
+    }
+
+    return {
+      packed: out,
+      level,
+      levels,
+      step: this.levelStep(level) * stride,
+      hits,
+      misses: tiles.length - hits,
+    };
+  }
+
+  /** Sample spacing of a level in seconds */
+  levelStep(level: number): number {
+    return this.baseStep * LOD_FACTOR ** level;
+  }
+
+  /**
+   * Cached or newly started build of one tile
+   */
+  private tile(
+    tle: { line1: string; line2: string },
+    model: string,
+    frame: 'TEME' | 'GCRF',
+    index: number
+  ): { pyramid: Promise<Pyramid>; hit: boolean } {
+    const key = [model, frame, index, tle.line1, tle.line2].join('|');
+    const cached = this.tiles.get(key);
+    if (cached) {
+      // Refresh recency
+      this.tiles.delete(key);
+      this.tiles.set(key, cached);
+      this.hits++;
+      return { pyramid: cached, hit: true };
+    }
+
+    this.misses++;
+    const pyramid = this.build(tle, model, frame, index);
+    this.tiles.set(key, pyramid);
+    pyramid.then(
+      (p) => {
+        if (this.tiles.get(key) === pyramid) {
+          this.sizes.set(key, p.bytes);
+          this.bytes += p.bytes;
+          this.evict();
+        }
+      },
+      // Failed builds are not cached
+      () => {
+        if (this.tiles.get(key) === pyramid) {
+          this.tiles.delete(key);
+        }
+      }
+    );
+    return { pyramid, hit: false };
+  }
+
+  private async build(
+    tle: { line1: string; line2: string },
+    model: string,
+    frame: 'TEME' | 'GCRF',
+    index: number
+  ): Promise<Pyramid> {
+    const et0 = index * this.tileSeconds;
+    const result = await this.pool.propagate({
+      tle,
+      times: { et0, etf: et0 + this.tileSeconds - this.baseStep, step: this.baseStep },
+      model,
+      packed: true,
+      frame,
+    });
+
+    // Level L keeps the base samples whose global index (ET / baseStep) is
+    // a multiple of LOD_FACTOR^L
+    const base = result.packed!;
+    const first = Math.round(et0 / this.baseStep);
+    const levels = [base];
+    for (let level = 1; level < this.levels; level++) {
+      const factor = LOD_FACTOR ** level;
+      levels.push(decimate(base, factor, (((-first) % factor) + factor) % factor));
+    }
+    return { levels, bytes: levels.reduce((n, l) => n + l.byteLength, 0) };
+  }
+
+  /**
+   * Drop least recently used built tiles until within budget
+   */
+  private evict(): void {
+    for (const key of this.tiles.keys()) {
+      if (this.bytes <= this.maxBytes) {
+        break;
+      }
+      const size = this.sizes.get(key);
+      if (size === undefined) {
+        continue; // Still building
+      }
+      this.tiles.delete(key);
+      this.sizes.delete(key);
+      this.bytes -= size;
+      this.evictions++;
+    }
+  }
+
+  get stats(): PyramidCacheStats {
+    return {
+      tiles: this.sizes.size,
+      bytes: this.bytes,
+      maxBytes: this.maxBytes,
+      hits: this.hits,
+      misses: this.misses,
+      evictions: this.evictions,
+    };
+  }
+}
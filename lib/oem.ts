@@ -0,0 +1,190 @@
+/**
+ * Orbit Ephemeris Message (OEM) support
+ *
+ * OEM is the CCSDS standard for exchanging ephemerides as time-tagged
+ * state vectors. This module writes the header, metadata and framing for
+ * both encodings:
+ * - KVN: Keyword = Value Notation (plain text)
+ * - XML: CCSDS NDM/XML schema
+ *
+ * Data lines are written separately (natively by the SIMD addon, or with
+ * formatOEMStates() for the WASM server) so that products can be streamed
+ * chunk by chunk.
+ *
+ * Reference: CCSDS 502.0-B-2 Orbit Data Messages
+ */
+
+import { tleToOMM, type OMMData } from './omm.js';
+import type { PropagateState } from './worker-types.js';
+
+/**
+ * OEM encodings
+ */
+export type OEMFormat = 'kvn' | 'xml';
+
+/**
+ * Reference frames available for OEM output
+ */
+export type OEMRefFrame = 'TEME' | 'GCRF';
+
+export const OEM_FORMATS: readonly OEMFormat[] = ['kvn', 'xml'];
+export const OEM_REF_FRAMES: readonly OEMRefFrame[] = ['TEME', 'GCRF'];
+
+/**
+ * OEM metadata block (one segment per object)
+ */
+export interface OEMMetadata {
+  OBJECT_NAME: string;
+  OBJECT_ID: string;
+  CENTER_NAME: string;
+  REF_FRAME: OEMRefFrame;
+  TIME_SYSTEM: 'UTC';
+  START_TIME: string;
+  STOP_TIME: string;
+}
+
+/**
+ * Content type for each OEM encoding
+ */
+export function oemContentType(format: OEMFormat): string {
+  return format === 'xml' ? 'application/xml; charset=utf-8' : 'text/plain; charset=utf-8';
+}
+
+/**
+ * Convert an ISO UTC string to CCSDS ASCII time (no trailing "Z")
+ */
+export function toOEMEpoch(utc: string): string {
+  return utc.endsWith('Z') ? utc.slice(0, -1) : utc;
+}
+
+/**
+ * Build OEM metadata for a propagated object.
+ *
+ * Object name and ID come from the OMM when the input was OMM, otherwise
+ * from the TLE (international designator) and optional name.
+ */
+export function buildOEMMetadata(
+  source: { omm?: OMMData; line1: string; line2: string; name?: string },
+  refFrame: OEMRefFrame,
+  startUTC: string,
+  stopUTC: string
+): OEMMetadata {
+  const omm = source.omm || tleToOMM(source.line1, source.line2, source.name);
+  return {
+    OBJECT_NAME: omm.OBJECT_NAME,
+    OBJECT_ID: omm.OBJECT_ID,
+    CENTER_NAME: 'EARTH',
+    REF_FRAME: refFrame,
+    TIME_SYSTEM: 'UTC',
+    START_TIME: toOEMEpoch(startUTC),
+    STOP_TIME: toOEMEpoch(stopUTC),
+  };
+}
+
+/**
+ * Escape text content for XML
+ */
+function escapeXML(value: string): string {
+  return value.replace(/&/g, '&amp;').replace(/</g, '&lt;').replace(/>/g, '&gt;');
+}
+
+/**
+ * Format the OEM header, metadata and opening of the data section.
+ * Everything up to (but not including) the first state vector.
+ */
+export function formatOEMHeader(meta: OEMMetadata, format: OEMFormat): string {
+  const creationDate =
+    process.env.MODE === 'test' ? '<TESTING_MODE>' : toOEMEpoch(new Date().toISOString());
+
+  if (format === 'xml') {
+    return (
+      '<?xml version="1.0" encoding="UTF-8"?>\n' +
+      '<oem id="CCSDS_OEM_VERS" version="2.0">\n' +
+      '  <header>\n' +
+      `    <CREATION_DATE>${escapeXML(creationDate)}</CREATION_DATE>\n` +
+      '    <ORIGINATOR>SPICE-SGP4</ORIGINATOR>\n' +
+      '  </header>\n' +
+      '  <body>\n' +
+      formatOEMSegmentHeader(meta, format)
+    );
+  }
+
+  return (
+    'CCSDS_OEM_VERS = 2.0\n' +
+    `CREATION_DATE = ${creationDate}\n` +
+    'ORIGINATOR = SPICE-SGP4\n' +
+    formatOEMSegmentHeader(meta, format)
+  );
+}
+
+/**
+ * Format the metadata and opening of the data section of one segment.
+ * Multi-object messages write formatOEMHeader() for the first segment,
+ * then formatOEMSegmentFooter() and this for each further one.
+ */
+export function formatOEMSegmentHeader(meta: OEMMetadata, format: OEMFormat): string {
+  const entries = Object.entries(meta) as [string, string][];
+
+  if (format === 'xml') {
+    const metadata = entries
+      .map(([key, value]) => `        <${key}>${escapeXML(value)}</${key}>`)
+      .join('\n');
+    return (
+      '    <segment>\n' +
+      '      <metadata>\n' +
+      `${metadata}\n` +
+      '      </metadata>\n' +
+      '      <data>\n'
+    );
+  }
+
+  const metadata = entries.map(([key, value]) => `${key} = ${value}`).join('\n');
+  return '\nMETA_START\n' + `${metadata}\n` + 'META_STOP\n' + '\n';
+}
+
+/**
+ * Format the closing of one segment's data section
+ */
+export function formatOEMSegmentFooter(format: OEMFormat): string {
+  return format === 'xml' ? '      </data>\n    </segment>\n' : '';
+}
+
+/**
+ * Format the closing of the data section and document
+ */
+export function formatOEMFooter(format: OEMFormat): string {
+  if (format === 'xml') {
+    return formatOEMSegmentFooter(format) + '  </body>\n</oem>\n';
+  }
+  return '';
+}
+
+/**
+ * Format state vectors as OEM data lines (KVN) or stateVector elements (XML).
+ *
+ * Used where states are already JS objects (WASM worker results). The
+ * native server formats straight from its packed result buffers instead.
+ */
+export function formatOEMStates(states: PropagateState[], format: OEMFormat): string {
+  let out = '';
+  for (const s of states) {
+    const epoch = toOEMEpoch(s.datetime);
+    const [x, y, z] = s.position;
+    const [vx, vy, vz] = s.velocity;
+    if (format === 'xml') {
+      out +=
+        '        <stateVector>\n' +
+        `          <EPOCH>${epoch}</EPOCH>\n` +
+        `          <X>${x.toFixed(6)}</X>\n` +
+        `          <Y>${y.toFixed(6)}</Y>\n` +
+        `          <Z>${z.toFixed(6)}</Z>\n` +
+        `          <X_DOT>${vx.toFixed(9)}</X_DOT>\n` +
+        `          <Y_DOT>${vy.toFixed(9)}</Y_DOT>\n` +
+        `          <Z_DOT>${vz.toFixed(9)}</Z_DOT>\n` +
+        '        </stateVector>\n';
+    } else {
+      out += `${epoch} ${x.toFixed(6)} ${y.toFixed(6)} ${z.toFixed(6)} ${vx.toFixed(9)} ${vy.toFixed(9)} ${vz.toFixed(9)}\n`;
+    }
+  }
+  return out;
+}
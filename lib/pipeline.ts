@@ -0,0 +1,570 @@
+/**
+ * Native Pipeline Description and Execution
+ *
+ * A pipeline chains stages that the native engine runs over cache-sized
+ * SoA chunks of each satellite's ephemeris, so the full ephemeris is never
+ * materialized:
+ *
+ *   propagate → frame → derived quantities → filters → reductions / rows
+ *
+ * Pipelines are written as JSON (POST /api/spice/sgp4/pipeline) or with
+ * PipelineBuilder, and encoded to the flat layout read by
+ * sgp4_pipeline_decode() in src/sgp4_pipeline.c (5 values per stage).
+ *
+ * @example
+ * ```typescript
+ * const stages = new PipelineBuilder()
+ *   .observer(38.9, -77.0, 0.1)
+ *   .derive('el')
+ *   .filter('el', 'gt', 10)
+ *   .reduce('count')
+ *   .reduce('max', 'el')
+ *   .build();
+ * ```
+ */
+
+import type { NativeSGP4Module } from './sgp4-native.js';
+import type { SGP4NativeWorkerPool } from './worker-pool-native.js';
+import type { SatelliteList } from './worker-types.js';
+import { elementsOf, satelliteCount, sliceSatellites } from './ingest.js';
+
+// The index of each name is its enum value in src/sgp4_pipeline.c
+export const PIPELINE_FRAMES = ['TEME', 'GCRF', 'ECEF'] as const;
+export const PIPELINE_COLUMNS = [
+  'et',
+  'x',
+  'y',
+  'z',
+  'vx',
+  'vy',
+  'vz',
+  'radius',
+  'speed',
+  'alt',
+  'lat',
+  'lon',
+  'az',
+  'el',
+  'range',
+  'sma',
+  'ecc',
+  'inc',
+  'raan',
+  'argp',
+  'nu',
+  'eq_h',
+  'eq_k',
+  'eq_p',
+  'eq_q',
+  'eq_l',
+] as const;
+export const FILTER_OPS = ['lt', 'le', 'gt', 'ge', 'between', 'outside'] as const;
+export const REDUCE_OPS = ['min', 'max', 'sum', 'mean', 'count', 'argmin', 'argmax', 'duration'] as const;
+/** Comparisons allowed in a reduction's `where` clause */
+export const WHERE_OPS = ['lt', 'le', 'gt', 'ge'] as const;
+
+export type PipelineFrame = (typeof PIPELINE_FRAMES)[number];
+export type PipelineColumn = (typeof PIPELINE_COLUMNS)[number];
+export type FilterOp = (typeof FILTER_OPS)[number];
+export type ReduceOp = (typeof REDUCE_OPS)[number];
+export type WhereOp = (typeof WHERE_OPS)[number];
+
+const WHERE_SYMBOLS: Record<WhereOp, string> = { lt: '<', le: '<=', gt: '>', ge: '>=' };
+
+// Encoded reduce ops for conditional count/duration (SGP4ReduceOp)
+const REDUCE_COUNT_WHERE = 7;
+const REDUCE_DURATION_WHERE = 8;
+
+/** Columns computed by a derive stage (the rest are always present) */
+export const DERIVED_COLUMNS: readonly PipelineColumn[] = PIPELINE_COLUMNS.slice(7);
+
+/**
+ * Osculating element sets (frame=keplerian|equinoctial on /propagate):
+ * sma in km, angles in degrees, eq_l the true longitude
+ */
+export const ELEMENT_SETS = ['keplerian', 'equinoctial'] as const;
+
+export type ElementSet = (typeof ELEMENT_SETS)[number];
+
+/** Columns of each element set, in output order */
+export const ELEMENT_COLUMNS: Record<ElementSet, readonly PipelineColumn[]> = {
+  keplerian: ['sma', 'ecc', 'inc', 'raan', 'argp', 'nu'],
+  equinoctial: ['sma', 'eq_h', 'eq_k', 'eq_p', 'eq_q', 'eq_l'],
+};
+
+// Stage kinds in the encoded form
+const STAGE_FRAME = 0;
+const STAGE_OBSERVER = 1;
+const STAGE_DERIVE = 2;
+const STAGE_FILTER = 3;
+const STAGE_REDUCE = 4;
+const STAGE_SELECT = 5;
+
+export interface PipelineFilter {
+  column: PipelineColumn;
+  op: FilterOp;
+  /** Threshold for lt/le/gt/ge */
+  value?: number;
+  /** Bounds for between/outside */
+  min?: number;
+  max?: number;
+}
+
+export interface PipelineReduction {
+  op: ReduceOp;
+  /** Not used by count; argmin/argmax report the et of the extremum */
+  column?: PipelineColumn;
+  /**
+   * count/duration only: count (or sampled seconds of) rows where
+   * column <op> value, without narrowing later stages. Required for duration.
+   */
+  where?: { op: WhereOp; value: number };
+}
+
+/**
+ * One pipeline stage, as written in JSON
+ */
+export type PipelineStage =
+  | { frame: PipelineFrame }
+  | { observer: { lat: number; lon: number; alt?: number } }
+  | { derive: PipelineColumn[] }
+  | { filter: PipelineFilter }
+  | { reduce: PipelineReduction[] }
+  | { select: PipelineColumn[] };
+
+/**
+ * Raw output of the native executor for one set of satellites
+ */
+export interface PipelineOutput {
+  /** nReduce values per satellite, in reduction order */
+  reduce: Float64Array;
+  /** nSelect values per emitted row, in selected-column order */
+  rows: Float64Array;
+  /** Satellite index of each emitted row */
+  rowSat: Int32Array;
+  nReduce: number;
+  nSelect: number;
+  truncated: boolean;
+}
+
+/**
+ * Fluent builder for pipeline stages
+ */
+export class PipelineBuilder {
+  private stages: PipelineStage[] = [];
+
+  /** Convert state columns to another frame (from TEME, once) */
+  frame(frame: PipelineFrame): this {
+    this.stages.push({ frame });
+    return this;
+  }
+
+  /** Ground site for look angles (geodetic degrees, km) */
+  observer(lat: number, lon: number, alt = 0): this {
+    this.stages.push({ observer: { lat, lon, alt } });
+    return this;
+  }
+
+  /** Compute derived quantities */
+  derive(...columns: PipelineColumn[]): this {
+    this.stages.push({ derive: columns });
+    return this;
+  }
+
+  /** Keep rows where column <op> value (or within/outside [value, max]) */
+  filter(column: PipelineColumn, op: FilterOp, value: number, max?: number): this {
+    this.stages.push({
+      filter:
+        op === 'between' || op === 'outside'
+          ? { column, op, min: value, max }
+          : { column, op, value },
+    });
+    return this;
+  }
+
+  /** Reduce the rows selected so far, per satellite */
+  reduce(op: ReduceOp, column?: PipelineColumn): this {
+    this.stages.push({ reduce: [{ op, column }] });
+    return this;
+  }
+
+  /** Count (or sampled duration of) rows where column <op> value */
+  reduceWhere(op: 'count' | 'duration', column: PipelineColumn, where: WhereOp, value: number): this {
+    this.stages.push({ reduce: [{ op, column, where: { op: where, value } }] });
+    return this;
+  }
+
+  /** Emit these columns for every row that passes all filters */
+  select(...columns: PipelineColumn[]): this {
+    this.stages.push({ select: columns });
+    return this;
+  }
+
+  build(): PipelineStage[] {
+    return [...this.stages];
+  }
+}
+
+function asColumn(value: unknown, where: string): PipelineColumn {
+  if (!PIPELINE_COLUMNS.includes(value as PipelineColumn)) {
+    throw new Error(`Unknown column in ${where}: ${String(value)}`);
+  }
+  return value as PipelineColumn;
+}
+
+function asColumns(value: unknown, where: string): PipelineColumn[] {
+  const list = Array.isArray(value) ? value : [value];
+  if (list.length === 0) {
+    throw new Error(`Empty column list in ${where}`);
+  }
+  return list.map((c) => asColumn(c, where));
+}
+
+function asNumber(value: unknown, name: string): number {
+  if (typeof value !== 'number' || !Number.isFinite(value)) {
+    throw new Error(`Invalid ${name} (must be a number)`);
+  }
+  return value;
+}
+
+/**
+ * Validate a JSON pipeline description.
+ * Checks names and shapes; ordering rules are enforced by the engine.
+ *
+ * @throws Error describing the first invalid stage
+ */
+export function parsePipelineStages(input: unknown): PipelineStage[] {
+  if (!Array.isArray(input) || input.length === 0) {
+    throw new Error('stages must be a non-empty array');
+  }
+
+  return input.map((raw, i): PipelineStage => {
+    if (!raw || typeof raw !== 'object') {
+      throw new Error(`Invalid stage ${i}`);
+    }
+    const stage = raw as Record<string, unknown>;
+    const keys = Object.keys(stage);
+    if (keys.length !== 1) {
+      throw new Error(`Stage ${i} must have exactly one of: frame, observer, derive, filter, reduce, select`);
+    }
+
+    switch (keys[0]) {
+      case 'frame': {
+        const frame = String(stage.frame).toUpperCase() as PipelineFrame;
+        if (!PIPELINE_FRAMES.includes(frame)) {
+          throw new Error(`Unknown frame: ${String(stage.frame)}`);
+        }
+        return { frame };
+      }
+      case 'observer': {
+        const o = (stage.observer || {}) as Record<string, unknown>;
+        return {
+          observer: {
+            lat: asNumber(o.lat, 'observer.lat'),
+            lon: asNumber(o.lon, 'observer.lon'),
+            alt: o.alt === undefined ? 0 : asNumber(o.alt, 'observer.alt'),
+          },
+        };
+      }
+      case 'derive': {
+        const columns = asColumns(stage.derive, 'derive');
+        for (const c of columns) {
+          if (!DERIVED_COLUMNS.includes(c)) {
+            throw new Error(`Not a derived quantity: ${c}`);
+          }
+        }
+        return { derive: columns };
+      }
+      case 'filter': {
+        const f = (stage.filter || {}) as Record<string, unknown>;
+        const op = f.op as FilterOp;
+        if (!FILTER_OPS.includes(op)) {
+          throw new Error(`Unknown filter op: ${String(f.op)}`);
+        }
+        const column = asColumn(f.column, 'filter');
+        return {
+          filter:
+            op === 'between' || op === 'outside'
+              ? { column, op, min: asNumber(f.min, 'filter.min'), max: asNumber(f.max, 'filter.max') }
+              : { column, op, value: asNumber(f.value, 'filter.value') },
+        };
+      }
+      case 'reduce': {
+        const list = Array.isArray(stage.reduce) ? stage.reduce : [stage.reduce];
+        return {
+          reduce: list.map((r) => {
+            const red = (r || {}) as Record<string, unknown>;
+            const op = red.op as ReduceOp;
+            if (!REDUCE_OPS.includes(op)) {
+              throw new Error(`Unknown reduction: ${String(red.op)}`);
+            }
+            if (red.where !== undefined || op === 'duration') {
+              const w = (red.where || {}) as Record<string, unknown>;
+              if (op !== 'count' && op !== 'duration') {
+                throw new Error(`where is only supported by count and duration`);
+              }
+              if (!WHERE_OPS.includes(w.op as WhereOp)) {
+                throw new Error(`Invalid where op for ${op} (must be lt, le, gt or ge)`);
+              }
+              return {
+                op,
+                column: asColumn(red.column, 'reduce'),
+                where: { op: w.op as WhereOp, value: asNumber(w.value, 'where.value') },
+              };
+            }
+            return op === 'count' ? { op } : { op, column: asColumn(red.column, 'reduce') };
+          }),
+        };
+      }
+      case 'select':
+        return { select: asColumns(stage.select, 'select') };
+      default:
+        throw new Error(`Unknown stage type: ${keys[0]}`);
+    }
+  });
+}
+
+/**
+ * Encode stages into the flat layout read by the native executor
+ */
+export function encodePipeline(stages: PipelineStage[]): Float64Array {
+  const words: number[] = [];
+  const push = (kind: number, a = 0, b = 0, c = 0, d = 0) => words.push(kind, a, b, c, d);
+
+  for (const stage of stages) {
+    if ('frame' in stage) {
+      push(STAGE_FRAME, PIPELINE_FRAMES.indexOf(stage.frame));
+    } else if ('observer' in stage) {
+      push(STAGE_OBSERVER, stage.observer.lat, stage.observer.lon, stage.observer.alt ?? 0);
+    } else if ('derive' in stage) {
+      for (const c of stage.derive) push(STAGE_DERIVE, PIPELINE_COLUMNS.indexOf(c));
+    } else if ('filter' in stage) {
+      const f = stage.filter;
+      const lo = f.op === 'between' || f.op === 'outside' ? f.min : f.value;
+      push(STAGE_FILTER, PIPELINE_COLUMNS.indexOf(f.column), FILTER_OPS.indexOf(f.op), lo ?? NaN, f.max ?? NaN);
+    } else if ('reduce' in stage) {
+      for (const r of stage.reduce) {
+        const column = r.column ? PIPELINE_COLUMNS.indexOf(r.column) : 0;
+        if (r.where) {
+          const op = r.op === 'count' ? REDUCE_COUNT_WHERE : REDUCE_DURATION_WHERE;
+          push(STAGE_REDUCE, column, op, WHERE_OPS.indexOf(r.where.op), r.where.value);
+        } else if (r.op === 'duration') {
+          throw new Error('duration requires a where condition');
+        } else {
+          push(STAGE_REDUCE, column, REDUCE_OPS.indexOf(r.op));
+        }
+      }
+    } else if ('select' in stage) {
+      for (const c of stage.select) push(STAGE_SELECT, PIPELINE_COLUMNS.indexOf(c));
+    }
+  }
+
+  return Float64Array.from(words);
+}
+
+/**
+ * Label of a reduction, e.g. "max(el)", "count", "duration(alt<500)"
+ */
+export function reductionLabel(r: PipelineReduction): string {
+  if (r.where) {
+    return `${r.op}(${r.column}${WHERE_SYMBOLS[r.where.op]}${r.where.value})`;
+  }
+  return r.op === 'count' ? 'count' : `${r.op}(${r.column})`;
+}
+
+/**
+ * Parse an `aggregate=` query value into pipeline stages.
+ *
+ * The value is a comma-separated list of reductions over the whole range:
+ * min/max/sum/mean/argmin/argmax(column), count(), and the conditional
+ * count(column<op>value) / duration(column<op>value) with <, <=, > or >=.
+ * Derived columns are computed as needed; az/el/range need an observer.
+ *
+ * @example parseAggregateSpec('min(alt),argmin(alt),duration(alt<500)')
+ * @throws Error describing the first invalid term
+ */
+export function parseAggregateSpec(
+  spec: string,
+  observer?: { lat: number; lon: number; alt?: number }
+): PipelineStage[] {
+  const reductions: PipelineReduction[] = [];
+  const derive = new Set<PipelineColumn>();
+
+  for (const term of spec.split(',').map((t) => t.trim())) {
+    const match = /^(\w+)\(\s*(\w*)\s*(?:(<=|>=|<|>)\s*(-?[\d.eE+-]+))?\s*\)$/.exec(term);
+    if (!match) {
+      throw new Error(`Invalid aggregate: ${term} (expected e.g. min(alt) or duration(alt<500))`);
+    }
+    const [, fn, col, cmp, value] = match;
+    const op = fn as ReduceOp;
+    if (!REDUCE_OPS.includes(op)) {
+      throw new Error(`Unknown aggregate function: ${fn}`);
+    }
+
+    if (op === 'count' && !col) {
+      reductions.push({ op });
+      continue;
+    }
+    const column = asColumn(col, 'aggregate');
+    if (DERIVED_COLUMNS.includes(column)) {
+      derive.add(column);
+    }
+
+    if (cmp) {
+      if (op !== 'count' && op !== 'duration') {
+        throw new Error(`Conditions are only supported by count and duration: ${term}`);
+      }
+      const where = (Object.keys(WHERE_SYMBOLS) as WhereOp[]).find((k) => WHERE_SYMBOLS[k] === cmp)!;
+      reductions.push({ op, column, where: { op: where, value: asNumber(parseFloat(value), term) } });
+    } else if (op === 'count' || op === 'duration') {
+      throw new Error(`${op} over a column needs a condition, e.g. ${op}(${column}>0)`);
+    } else {
+      reductions.push({ op, column });
+    }
+  }
+
+  const stages: PipelineStage[] = [];
+  if (observer) {
+    stages.push({ observer });
+  }
+  if (derive.size > 0) {
+    stages.push({ derive: [...derive] });
+  }
+  stages.push({ reduce: reductions });
+  return stages;
+}
+
+/**
+ * Stages emitting et and the osculating elements of a set, in TEME or
+ * (after a frame stage) GCRF
+ */
+export function elementStages(set: ElementSet, frame: PipelineFrame = 'TEME'): PipelineStage[] {
+  const columns = [...ELEMENT_COLUMNS[set]];
+  return [
+    ...(frame === 'TEME' ? [] : [{ frame }]),
+    { derive: columns },
+    { select: ['et' as const, ...columns] },
+  ];
+}
+
+/**
+ * Output names of a pipeline: reduction labels (e.g. "max(el)", "count")
+ * and selected columns, in the order the executor produces them.
+ */
+export function pipelineOutputs(stages: PipelineStage[]): {
+  reductions: string[];
+  columns: PipelineColumn[];
+} {
+  const reductions: string[] = [];
+  const columns: PipelineColumn[] = [];
+
+  for (const stage of stages) {
+    if ('reduce' in stage) {
+      for (const r of stage.reduce) {
+        reductions.push(reductionLabel(r));
+      }
+    } else if ('select' in stage) {
+      columns.push(...stage.select);
+    }
+  }
+
+  return { reductions, columns };
+}
+
+/**
+ * Run a pipeline in-process with a native module (single thread)
+ */
+export function runPipeline(
+  sgp4: NativeSGP4Module,
+  tles: SatelliteList,
+  stages: Float64Array,
+  times: { et0: number; etf: number; step: number },
+  maxRows = 0
+): PipelineOutput {
+  return sgp4.runPipeline(elementsOf(sgp4, tles), stages, times.et0, times.etf, times.step, maxRows);
+}
+
+/**
+ * Run a pipeline on the native worker pool.
+ *
+ * Satellites are split into one contiguous shard per worker; per-satellite
+ * reductions and rows are merged back in input order. Every shard may
+ * return up to maxRows rows, since the rows can all come from one shard;
+ * the cap is applied to the merged rows.
+ */
+export async function executePipeline(
+  pool: SGP4NativeWorkerPool,
+  request: {
+    tles: SatelliteList;
+    stages: Float64Array;
+    times: { et0: number; etf: number; step: number };
+    model: string;
+    maxRows: number;
+  }
+): Promise<PipelineOutput> {
+  const { tles, maxRows } = request;
+  const count = satelliteCount(tles);
+  const size = Math.ceil(count / Math.max(1, Math.min(pool.stats.poolSize, count)));
+  const shards = Math.ceil(count / size);
+
+  const parts = await Promise.all(
+    Array.from({ length: shards }, (_, i) =>
+      pool.runPipeline({
+        tles: sliceSatellites(tles, i * size, (i + 1) * size),
+        stages: request.stages,
+        times: request.times,
+        model: request.model,
+        maxRows,
+      })
+    )
+  );
+
+  return mergePipelineOutputs(
+    parts,
+    parts.map((_, i) => Math.min(size, count - i * size)),
+    maxRows
+  );
+}
+
+/**
+ * Concatenate pipeline outputs of consecutive satellite ranges (`counts[i]`
+ * satellites in part i) in input order, trimming rows to maxRows (0: no cap)
+ */
+export function mergePipelineOutputs(
+  parts: PipelineOutput[],
+  counts: number[],
+  maxRows = 0
+): PipelineOutput {
+  const nReduce = parts[0].nReduce;
+  const nSelect = parts[0].nSelect;
+  // Parts are capped at maxRows each; keep the first maxRows in input order
+  const allRows = parts.reduce((n, p) => n + p.rowSat.length, 0);
+  const totalRows = maxRows > 0 ? Math.min(allRows, maxRows) : allRows;
+  const nSats = counts.reduce((n, c) => n + c, 0);
+
+  const reduce = new Float64Array(nSats * nReduce);
+  const rows = new Float64Array(totalRows * nSelect);
+  const rowSat = new Int32Array(totalRows);
+
+  let rowOffset = 0;
+  let satOffset = 0;
+  parts.forEach((p, i) => {
+    reduce.set(p.reduce, satOffset * nReduce);
+    const count = Math.min(p.rowSat.length, totalRows - rowOffset);
+    rows.set(p.rows.subarray(0, count * nSelect), rowOffset * nSelect);
+    for (let r = 0; r < count; r++) {
+      rowSat[rowOffset + r] = p.rowSat[r] + satOffset;
+    }
+    rowOffset += count;
+    satOffset += counts[i];
+  });
+
+  return {
+    reduce,
+    rows,
+    rowSat,
+    nReduce,
+    nSelect,
+    truncated: totalRows < allRows || parts.some((p) => p.truncated),
+  };
+}
@@ -0,0 +1,268 @@
+/**
+ * Traffic Replay - Re-issue a captured request log against a server
+ *
+ * Usage: npx tsx lib/replay.ts <capture.ndjson> [options]
+ *   --target <url>       server base URL (default: http://localhost:50001)
+ *   --speed <factor>     1 = original timing, 2 = twice as fast,
+ *                        0 = back to back (default: 1)
+ *   --concurrency <n>    in-flight cap for --speed 0 (default: 16)
+ *   --save <file>        write this run's latencies as JSON
+ *   --baseline <file>    compare against a run saved with --save
+ *
+ * Requests are replayed in arrival order on the captured schedule (scaled by
+ * --speed), with their captured Content-Type and scheduling headers, so two
+ * builds see the same load. A log appended to by several server starts is
+ * replayed as one timeline, each session placed at its start time. Latency
+ * percentiles are reported per route; with --baseline, next to those of the
+ * earlier run. Streamed uploads, whose bodies are not captured, are skipped.
+ *
+ * Example:
+ *   npx tsx lib/replay.ts prod.ndjson --target http://localhost:50001 --save before.json
+ *   npx tsx lib/replay.ts prod.ndjson --target http://localhost:50001 --baseline before.json
+ */
+
+import { readFileSync, writeFileSync } from 'fs';
+import path from 'path';
+import { fileURLToPath } from 'url';
+import type { CaptureEntry, CaptureHeader } from './capture.js';
+
+export interface ReplayRequest {
+  /** Arrival, ms since the first session's start */
+  t: number;
+  method: string;
+  url: string;
+  headers?: Record<string, string>;
+  body?: unknown;
+  slow: boolean;
+}
+
+/** Latencies (ms) of one replay, by route */
+type RouteLatencies = Record<string, number[]>;
+
+const PERCENTILES = [50, 90, 99] as const;
+
+/**
+ * Read a capture log into requests sorted by arrival.
+ *
+ * Streamed uploads (flagged `raw`) are counted in `skipped`, not returned.
+ * Each header line starts a session: body ids resolve within it, and its
+ * arrival times are shifted by its start relative to the first session's.
+ */
+export function loadCapture(file: string): { sessions: CaptureHeader[]; requests: ReplayRequest[]; skipped: number } {
+  const sessions: CaptureHeader[] = [];
+  const requests: ReplayRequest[] = [];
+  let skipped = 0;
+  let bodies = new Map<number, unknown>();
+  let offset = 0;
+
+  for (const line of readFileSync(file, 'utf8').split('\n')) {
+    if (!line) {
+      continue;
+    }
+    const record = JSON.parse(line);
+    if ('capture' in record) {
+      const header = record as CaptureHeader;
+      sessions.push(header);
+      bodies = new Map();
+      offset = Date.parse(header.started) - Date.parse(sessions[0].started) || 0;
+    } else if ('v' in record) {
+      bodies.set(record.b, record.v);
+    } else if (record.raw) {
+      skipped++;
+    } else {
+      const entry = record as CaptureEntry;
+      requests.push({
+        t: entry.t + offset,
+        method: entry.m,
+        url: entry.u,
+        headers: entry.h,
+        body: entry.b === undefined ? undefined : bodies.get(entry.b),
+        slow: entry.slow === 1,
+      });
+    }
+  }
+
+  requests.sort((a, b) => a.t - b.t);
+  return { sessions, requests, skipped };
+}
+
+/**
+ * Route of a request: method and path without the query string
+ */
+function routeOf(req: ReplayRequest): string {
+  return `${req.method} ${req.url.split('?')[0]}`;
+}
+
+/**
+ * Issue one request with its captured headers; a body without a captured
+ * Content-Type is sent as JSON
+ */
+export async function issue(target: string, req: ReplayRequest): Promise<{ ms: number; ok: boolean }> {
+  const start = performance.now();
+  const headers: Record<string, string> = { ...req.headers };
+  if (req.body !== undefined && !headers['content-type']) {
+    headers['content-type'] = 'application/json';
+  }
+  try {
+    const res = await fetch(target + req.url, {
+      method: req.method,
+      headers,
+      body: req.body === undefined ? undefined : JSON.stringify(req.body),
+    });
+    // Latency includes reading the whole response
+    await res.arrayBuffer();
+    return { ms: performance.now() - start, ok: res.ok };
+  } catch {
+    return { ms: performance.now() - start, ok: false };
+  }
+}
+
+/**
+ * Replay requests on their captured schedule (speed > 0) or back to back
+ * with a concurrency cap (speed 0)
+ */
+async function replay(
+  target: string,
+  requests: ReplayRequest[],
+  speed: number,
+  concurrency: number
+): Promise<{ latencies: RouteLatencies; errors: number }> {
+  const latencies: RouteLatencies = {};
+  let errors = 0;
+
+  const record = (req: ReplayRequest, result: { ms: number; ok: boolean }) => {
+    (latencies[routeOf(req)] ||= []).push(result.ms);
+    if (!result.ok) {
+      errors++;
+    }
+  };
+
+  if (speed > 0) {
+    const t0 = requests.length ? requests[0].t : 0;
+    const start = performance.now();
+    const inFlight: Promise<void>[] = [];
+    for (const req of requests) {
+      const wait = (req.t - t0) / speed - (performance.now() - start);
+      if (wait > 0) {
+        await new Promise((resolve) => setTimeout(resolve, wait));
+      }
+      inFlight.push(issue(target, req).then((r) => record(req, r)));
+    }
+    await Promise.all(inFlight);
+  } else {
+    let next = 0;
+    await Promise.all(
+      Array.from({ length: Math.min(concurrency, requests.length) }, async () => {
+        while (next < requests.length) {
+          const req = requests[next++];
+          record(req, await issue(target, req));
+        }
+      })
+    );
+  }
+
+  return { latencies, errors };
+}
+
+function percentile(sorted: number[], p: number): number {
+  if (sorted.length === 0) {
+    return NaN;
+  }
+  const rank = Math.min(sorted.length - 1, Math.ceil((p / 100) * sorted.length) - 1);
+  return sorted[Math.max(0, rank)];
+}
+
+function summarize(values: number[]): number[] {
+  const sorted = [...values].sort((a, b) => a - b);
+  return [...PERCENTILES.map((p) => percentile(sorted, p)), sorted[sorted.length - 1] ?? NaN];
+}
+
+function formatMs(value: number): string {
+  return Number.isNaN(value) ? '-' : value.toFixed(1);
+}
+
+function formatDiff(now: number, before: number): string {
+  if (Number.isNaN(now) || Number.isNaN(before) || before === 0) {
+    return '';
+  }
+  const pct = ((now - before) / before) * 100;
+  return ` (${pct >= 0 ? '+' : ''}${pct.toFixed(0)}%)`;
+}
+
+/**
+ * Print percentiles per route, with the change from a baseline run
+ */
+function report(latencies: RouteLatencies, baseline?: RouteLatencies): void {
+  const all: RouteLatencies = { ...latencies, ALL: Object.values(latencies).flat() };
+  const before: RouteLatencies | undefined = baseline && {
+    ...baseline,
+    ALL: Object.values(baseline).flat(),
+  };
+  const columns = [...PERCENTILES.map((p) => `p${p}`), 'max'];
+
+  console.log(`\n${'Route'.padEnd(44)} ${'n'.padStart(7)}  ${columns.map((c) => c.padStart(16)).join(' ')}`);
+  for (const [route, values] of Object.entries(all)) {
+    const now = summarize(values);
+    const prev = before?.[route] ? summarize(before[route]) : undefined;
+    const cells = now.map((v, i) => (formatMs(v) + (prev ? formatDiff(v, prev[i]) : '')).padStart(16));
+    console.log(`${route.padEnd(44)} ${String(values.length).padStart(7)}  ${cells.join(' ')}`);
+  }
+  console.log('\nLatencies in ms' + (baseline ? '; change vs baseline in parentheses' : ''));
+}
+
+function parseArgs(argv: string[]): Record<string, string> {
+  const args: Record<string, string> = {};
+  for (let i = 0; i < argv.length; i++) {
+    if (argv[i].startsWith('--')) {
+      args[argv[i].slice(2)] = argv[++i];
+    } else {
+      args._ = argv[i];
+    }
+  }
+  return args;
+}
+
+async function main(): Promise<void> {
+  const args = parseArgs(process.argv.slice(2));
+  if (!args._) {
+    console.error('Usage: npx tsx lib/replay.ts <capture.ndjson> [--target url] [--speed n] [--concurrency n] [--save file] [--baseline file]');
+    process.exit(1);
+  }
+
+  const target = (args.target || 'http://localhost:50001').replace(/\/$/, '');
+  const speed = args.speed === undefined ? 1 : parseFloat(args.speed);
+  const concurrency = parseInt(args.concurrency || '16', 10);
+  const { sessions, requests, skipped } = loadCapture(args._);
+  const header = sessions[0];
+  const more = sessions.length > 1 ? `, ${sessions.length} sessions` : '';
+
+  console.log(`Replay Configuration:`);
+  console.log(`  Capture:        ${args._}${header ? ` (${header.server}, ${header.started}${more})` : ''}`);
+  console.log(`  Requests:       ${requests.length.toLocaleString()} (${requests.filter((r) => r.slow).length} flagged slow${skipped ? `, ${skipped} streamed uploads skipped` : ''})`);
+  console.log(`  Target:         ${target}`);
+  console.log(`  Timing:         ${speed > 0 ? `${speed}x original` : `back to back, ${concurrency} in flight`}`);
+
+  const start = performance.now();
+  const { latencies, errors } = await replay(target, requests, speed, concurrency);
+  const wallSec = (performance.now() - start) / 1000;
+
+  console.log(`\n=== Results ===`);
+  console.log(`  Wall time:      ${wallSec.toFixed(2)}s`);
+  console.log(`  Throughput:     ${(requests.length / wallSec).toFixed(1)} req/s`);
+  console.log(`  Errors:         ${errors}`);
+
+  const baseline = args.baseline ? (JSON.parse(readFileSync(args.baseline, 'utf8')) as RouteLatencies) : undefined;
+  report(latencies, baseline);
+
+  if (args.save) {
+    writeFileSync(args.save, JSON.stringify(latencies));
+    console.log(`Saved latencies to ${args.save}`);
+  }
+}
+
+if (process.argv[1] && path.resolve(process.argv[1]) === fileURLToPath(import.meta.url)) {
+  main().catch((err) => {
+    console.error('Replay failed:', err);
+    process.exit(1);
+  });
+}
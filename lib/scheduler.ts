@@ -0,0 +1,338 @@
+/**
+ * Worker Pool Task Scheduling
+ *
+ * Replaces the pools' FIFO task queue so that one tenant's bulk sweep does
+ * not hold every interactive request behind it:
+ *
+ * - QoS classes: `interactive`, `standard` and `bulk`, weighted 16:4:1
+ * - Weighted fair queuing (start-time fair queuing) across flows, a flow
+ *   being one tenant in one class. A task's virtual finish tag advances by
+ *   its estimated cost over its class weight, so a tenant submitting many
+ *   tasks only delays its own later tasks.
+ * - Deadlines: a task whose latest start time (deadline minus estimated
+ *   service time) is within one mean service time is dispatched earliest
+ *   deadline first, ahead of the fair queue.
+ * - Early rejection: a task that cannot finish by its deadline given the
+ *   work queued ahead of it fails at submission with DeadlineError (503)
+ *   instead of occupying a worker; one whose deadline passes while queued
+ *   is dropped at dispatch.
+ *
+ * Costs are estimated as points (satellites x time steps) times a per task
+ * type ms/point average learned from completed tasks.
+ *
+ * Requests choose their class, tenant and deadline with headers, read by
+ * the qosContext() middleware into an AsyncLocalStorage, so pool submissions
+ * deep in a handler pick them up without extra parameters:
+ *
+ * - `X-QoS-Class: interactive | standard | bulk` (default standard)
+ * - `X-Tenant-ID` (else `X-API-Key`, else `anonymous`)
+ * - `X-Deadline-Ms`: time budget from arrival, in ms
+ */
+
+import { AsyncLocalStorage } from 'async_hooks';
+import type { Request, Response, NextFunction } from 'express';
+
+export const QOS_CLASSES = ['interactive', 'standard', 'bulk'] as const;
+
+export type QoSClass = (typeof QOS_CLASSES)[number];
+
+/** Share of the workers per class while all classes are backlogged */
+const CLASS_WEIGHTS: Record<QoSClass, number> = { interactive: 16, standard: 4, bulk: 1 };
+
+/** Weight of the newest sample in the ms/point and service time averages */
+const COST_EWMA_ALPHA = 0.2;
+
+/** Initial ms/point guess for a task type with no completed tasks */
+const DEFAULT_MS_PER_POINT = 0.001;
+
+/** Scheduling parameters of the request being served */
+export interface SchedulingContext {
+  qos: QoSClass;
+  tenant: string;
+  /** Absolute deadline on the performance.now() clock */
+  deadline?: number;
+}
+
+export const schedulingContext = new AsyncLocalStorage<SchedulingContext>();
+
+/**
+ * Scheduling context of the current request (standard, anonymous outside one)
+ */
+export function currentContext(): SchedulingContext {
+  return schedulingContext.getStore() ?? { qos: 'standard', tenant: 'anonymous' };
+}
+
+/**
+ * Time steps of a range task
+ */
+export function rangePoints(times: { et0: number; etf: number; step: number }): number {
+  return Math.floor((times.etf - times.et0) / times.step) + 1;
+}
+
+/**
+ * A task that cannot (or can no longer) finish by its deadline
+ */
+export class DeadlineError extends Error {
+  readonly status = 503;
+}
+
+/**
+ * Middleware reading the scheduling headers into schedulingContext for the
+ * rest of the request
+ */
+export function qosContext(): (req: Request, res: Response, next: NextFunction) => void {
+  return (req: Request, res: Response, next: NextFunction) => {
+    const qos = ((req.get('X-QoS-Class') || 'standard').toLowerCase()) as QoSClass;
+    if (!QOS_CLASSES.includes(qos)) {
+      res.status(400).json({ error: `Invalid X-QoS-Class (must be ${QOS_CLASSES.join(', ')})` });
+      return;
+    }
+
+    let deadline: number | undefined;
+    const budget = req.get('X-Deadline-Ms');
+    if (budget !== undefined) {
+      const ms = Number(budget);
+      if (!(ms > 0)) {
+        res.status(400).json({ error: 'Invalid X-Deadline-Ms (must be a positive number of ms)' });
+        return;
+      }
+      deadline = performance.now() + ms;
+    }
+
+    const tenant = req.get('X-Tenant-ID') || req.get('X-API-Key') || 'anonymous';
+    schedulingContext.run({ qos, tenant, deadline }, next);
+  };
+}
+
+/** Scheduling state attached to a task */
+export interface Schedule {
+  qos: QoSClass;
+  flow: string;
+  kind: string;
+  points: number;
+  /** Estimated service time in ms */
+  estimateMs: number;
+  deadline?: number;
+  /** Virtual start and finish tags */
+  start: number;
+  finish: number;
+  enqueued: number;
+  dispatched?: number;
+}
+
+/** A pool's pending task as seen by the scheduler */
+export interface Schedulable {
+  reject: (error: Error) => void;
+  schedule?: Schedule;
+}
+
+/** Scheduler statistics */
+export interface SchedulerStats {
+  queued: Record<QoSClass, number>;
+  dispatched: Record<QoSClass, number>;
+  /** Flows (tenant, class) with queued tasks */
+  activeFlows: number;
+  /** Rejected at submission: deadline could not be met */
+  deadlineRejected: number;
+  /** Dropped at dispatch: deadline passed while queued */
+  deadlineExpired: number;
+  /** Dispatched ahead of the fair queue to meet a deadline */
+  edfDispatches: number;
+  /** Learned cost per point (ms) by task type */
+  msPerPoint: Record<string, number>;
+  meanServiceMs: number;
+  /** Average time from submission to dispatch */
+  meanQueueWaitMs: number;
+}
+
+/**
+ * Fair, deadline-aware task queue for a worker pool
+ */
+export class TaskScheduler<P extends Schedulable> {
+  private queue: P[] = [];
+  private virtualTime = 0;
+  private flowFinish = new Map<string, number>();
+  private msPerPoint = new Map<string, number>();
+  private meanServiceMs = 1;
+  private meanQueueWaitMs = 0;
+  private queued: Record<QoSClass, number> = { interactive: 0, standard: 0, bulk: 0 };
+  private dispatchedCount: Record<QoSClass, number> = { interactive: 0, standard: 0, bulk: 0 };
+  private deadlineRejected = 0;
+  private deadlineExpired = 0;
+  private edfDispatches = 0;
+
+  get length(): number {
+    return this.queue.length;
+  }
+
+  /**
+   * How long the oldest queued task has waited, in ms (0 when empty)
+   */
+  oldestWaitMs(): number {
+    let oldest = Infinity;
+    for (const p of this.queue) {
+      oldest = Math.min(oldest, p.schedule!.enqueued);
+    }
+    return this.queue.length ? performance.now() - oldest : 0;
+  }
+
+  /**
+   * Tag a task with its class, flow and cost estimate, and reject it if it
+   * cannot meet its deadline behind the work already queued
+   *
+   * @param kind - Task type, for the cost model
+   * @param points - Satellites x time steps
+   * @param workers - Pool size and currently idle workers
+   * @throws DeadlineError
+   */
+  admit(pending: P, kind: string, points: number, workers: { size: number; idle: number }): void {
+    const ctx = currentContext();
+    const now = performance.now();
+    const estimateMs = Math.max(1, points) * (this.msPerPoint.get(kind) ?? DEFAULT_MS_PER_POINT);
+
+    if (ctx.deadline !== undefined) {
+      // Deadline tasks run EDF, so only queued work due no later than this
+      // one, and a busy pool's in-service tasks, stand in front of it
+      let ahead = 0;
+      for (const p of this.queue) {
+        const s = p.schedule!;
+        if (s.deadline !== undefined && s.deadline <= ctx.deadline) {
+          ahead += s.estimateMs;
+        }
+      }
+      const wait = ahead / workers.size + (workers.idle > 0 ? 0 : this.meanServiceMs);
+      if (now + wait + estimateMs > ctx.deadline) {
+        this.deadlineRejected++;
+        throw new DeadlineError(
+          `Deadline cannot be met: estimated ${Math.ceil(wait + estimateMs)} ms, ` +
+            `${Math.max(0, Math.floor(ctx.deadline - now))} ms left`
+        );
+      }
+    }
+
+    const flow = `${ctx.qos}|${ctx.tenant}`;
+    const start = Math.max(this.virtualTime, this.flowFinish.get(flow) ?? 0);
+    const finish = start + estimateMs / CLASS_WEIGHTS[ctx.qos];
+    this.flowFinish.set(flow, finish);
+
+    pending.schedule = {
+      qos: ctx.qos,
+      flow,
+      kind,
+      points,
+      estimateMs,
+      deadline: ctx.deadline,
+      start,
+      finish,
+      enqueued: now,
+    };
+  }
+
+  enqueue(pending: P): void {
+    this.queue.push(pending);
+    this.queued[pending.schedule!.qos]++;
+  }
+
+  /**
+   * Remove and return the next task to run: an urgent deadline task first
+   * (earliest deadline), else the smallest virtual finish tag. Tasks whose
+   * deadline has become unreachable are rejected on the way.
+   */
+  next(): P | undefined {
+    const now = performance.now();
+
+    let urgent = -1;
+    let fair = -1;
+    for (let i = 0; i < this.queue.length; i++) {
+      const s = this.queue[i].schedule!;
+      if (s.deadline !== undefined) {
+        if (now + s.estimateMs > s.deadline) {
+          this.remove(i--);
+          continue;
+        }
+        if (
+          s.deadline - s.estimateMs - now <= this.meanServiceMs &&
+          (urgent < 0 || s.deadline < this.queue[urgent].schedule!.deadline!)
+        ) {
+          urgent = i;
+        }
+      }
+      if (fair < 0 || s.finish < this.queue[fair].schedule!.finish) {
+        fair = i;
+      }
+    }
+
+    if (urgent >= 0) {
+      this.edfDispatches++;
+    }
+    const index = urgent >= 0 ? urgent : fair;
+    if (index < 0) {
+      return undefined;
+    }
+    const [pending] = this.queue.splice(index, 1);
+    this.queued[pending.schedule!.qos]--;
+    return pending;
+  }
+
+  /**
+   * Mark a task as handed to a worker (directly or from the queue)
+   */
+  dispatched(pending: P): void {
+    const s = pending.schedule!;
+    s.dispatched = performance.now();
+    this.meanQueueWaitMs += COST_EWMA_ALPHA * (s.dispatched - s.enqueued - this.meanQueueWaitMs);
+    // Start-time fair queuing: virtual time follows the task in service
+    this.virtualTime = Math.max(this.virtualTime, s.start);
+    this.dispatchedCount[s.qos]++;
+    if (this.queue.length === 0) {
+      // Idle flows must not keep credit from a past backlog
+      this.flowFinish.clear();
+    }
+  }
+
+  /**
+   * Feed a finished task's service time into the cost model
+   */
+  completed(pending: P): void {
+    const s = pending.schedule;
+    if (!s?.dispatched) {
+      return;
+    }
+    const ms = performance.now() - s.dispatched;
+    const perPoint = ms / Math.max(1, s.points);
+    const prev = this.msPerPoint.get(s.kind);
+    this.msPerPoint.set(s.kind, prev === undefined ? perPoint : prev + COST_EWMA_ALPHA * (perPoint - prev));
+    this.meanServiceMs += COST_EWMA_ALPHA * (ms - this.meanServiceMs);
+  }
+
+  /**
+   * Remove and return every queued task (pool shutdown)
+   */
+  drain(): P[] {
+    const all = this.queue;
+    this.queue = [];
+    this.queued = { interactive: 0, standard: 0, bulk: 0 };
+    return all;
+  }
+
+  private remove(index: number): void {
+    const [pending] = this.queue.splice(index, 1);
+    this.queued[pending.schedule!.qos]--;
+    this.deadlineExpired++;
+    pending.reject(new DeadlineError('Deadline passed while queued'));
+  }
+
+  get stats(): SchedulerStats {
+    return {
+      queued: { ...this.queued },
+      dispatched: { ...this.dispatchedCount },
+      activeFlows: new Set(this.queue.map((p) => p.schedule!.flow)).size,
+      deadlineRejected: this.deadlineRejected,
+      deadlineExpired: this.deadlineExpired,
+      edfDispatches: this.edfDispatches,
+      msPerPoint: Object.fromEntries(this.msPerPoint),
+      meanServiceMs: this.meanServiceMs,
+      meanQueueWaitMs: this.meanQueueWaitMs,
+    };
+  }
+}
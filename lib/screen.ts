@@ -0,0 +1,315 @@
+/**
+ * User Ephemeris Screening (launch and maneuver COLA)
+ *
+ * Screens user-supplied trajectories - a launch ascent, a planned maneuver
+ * sequence - against catalog objects and reports the close approaches
+ * within the requested thresholds.
+ *
+ * Ephemerides are sampled state vectors, given as:
+ * - CSV with a header naming `et` or `datetime` (UTC) and x,y,z,vx,vy,vz
+ *   (km, km/s), the layout of the propagate text output
+ * - CCSDS OEM in KVN or XML (REF_FRAME TEME, GCRF or EME2000, CENTER_NAME
+ *   EARTH, TIME_SYSTEM UTC); segments are joined in order
+ *
+ * The native engine (src/sgp4_screen.c) skips objects whose perigee..apogee
+ * shell cannot reach the ephemeris, sweeps the rest on an orbit-aware
+ * coarse grid against the Hermite-interpolated ephemeris and refines each
+ * range minimum to the time and distance of closest approach. Catalog
+ * shards run in parallel on the worker pool.
+ *
+ * @example
+ * ```typescript
+ * const eph = parseEphemeris(sgp4, csvText, { frame: 'GCRF' });
+ * const out = await executeScreen(pool, {
+ *   tles: catalog.subset(catalog.query([])),
+ *   ephemeris: eph,
+ *   limits: encodeScreenLimits({ distance: 10 }),
+ *   model: 'wgs72',
+ *   maxStep: 0,
+ *   maxApproaches: 0,
+ * });
+ * ```
+ */
+
+import type { NativeSGP4Module } from './sgp4-native.js';
+import type { SGP4NativeWorkerPool } from './worker-pool-native.js';
+import type { SatelliteList } from './worker-types.js';
+import type { OEMRefFrame } from './oem.js';
+import { elementsOf, satelliteCount, sliceSatellites } from './ingest.js';
+
+/** Ephemeris input formats */
+export const EPHEMERIS_FORMATS = ['csv', 'oem'] as const;
+
+export type EphemerisFormat = (typeof EPHEMERIS_FORMATS)[number];
+
+/** Native frame codes (SGP4_FRAME_TEME / SGP4_FRAME_GCRF in src/sgp4_pipeline.c) */
+const FRAME_CODES: Record<OEMRefFrame, number> = { TEME: 0, GCRF: 1 };
+
+/** OEM REF_FRAME values accepted, and the frame each is screened in */
+const OEM_FRAMES: Record<string, OEMRefFrame> = { TEME: 'TEME', GCRF: 'GCRF', EME2000: 'GCRF', J2000: 'GCRF' };
+
+/**
+ * A parsed user ephemeris: packed columns (et | x | y | z | vx | vy | vz)
+ */
+export interface UserEphemeris {
+  name?: string;
+  frame: OEMRefFrame;
+  packed: Float64Array;
+}
+
+/**
+ * Screening thresholds in km. Component limits apply to the miss vector in
+ * the radial / in-track / cross-track axes of the ephemeris object.
+ */
+export interface ScreenLimits {
+  distance: number;
+  radial?: number;
+  inTrack?: number;
+  crossTrack?: number;
+}
+
+/**
+ * Close approaches, sorted by satellite then time. `ric` holds 3 values
+ * (radial, in-track, cross-track in km) per approach.
+ */
+export interface ScreenOutput {
+  tca: Float64Array;
+  sat: Int32Array;
+  distance: Float64Array;
+  speed: Float64Array;
+  ric: Float64Array;
+  /** Satellites passing the orbit-shell prefilter */
+  candidates: number;
+  truncated: boolean;
+}
+
+/**
+ * Encode screening thresholds for the native screener
+ *
+ * @throws Error when a threshold is not a positive number
+ */
+export function encodeScreenLimits(limits: ScreenLimits): Float64Array {
+  const values = [limits.distance, limits.radial, limits.inTrack, limits.crossTrack];
+  values.forEach((v, i) => {
+    if (i === 0 ? !(v! > 0) : v !== undefined && !(v > 0)) {
+      throw new Error('Screening thresholds must be positive numbers (km)');
+    }
+  });
+  return Float64Array.from(values, (v) => v ?? 0);
+}
+
+/**
+ * Packed columns of a list of (et, x, y, z, vx, vy, vz) rows, dropping a
+ * row repeating the previous epoch (as at OEM segment boundaries)
+ *
+ * @throws Error when there are fewer than 2 states or epochs decrease
+ */
+function packRows(rows: number[][]): Float64Array {
+  const kept = rows.filter((row, i) => i === 0 || row[0] !== rows[i - 1][0]);
+  if (kept.length < 2) {
+    throw new Error('Ephemeris needs at least 2 states');
+  }
+  const n = kept.length;
+  const packed = new Float64Array(n * 7);
+  kept.forEach((row, i) => {
+    if (row.some((v) => !Number.isFinite(v))) {
+      throw new Error(`Ephemeris state ${i + 1} is not numeric`);
+    }
+    if (i > 0 && !(row[0] > kept[i - 1][0])) {
+      throw new Error(`Ephemeris epochs must increase (state ${i + 1})`);
+    }
+    for (let c = 0; c < 7; c++) {
+      packed[c * n + i] = row[c];
+    }
+  });
+  return packed;
+}
+
+/**
+ * Rows of a CSV ephemeris with a header line
+ */
+function parseCSV(sgp4: NativeSGP4Module, text: string): number[][] {
+  const lines = text.split(/\r?\n/).filter((l) => l.trim() && !l.startsWith('#'));
+  const header = (lines.shift() || '').split(',').map((h) => h.trim().toLowerCase());
+  const col = (name: string): number => header.indexOf(name);
+  const time = col('et') >= 0 ? col('et') : ['datetime', 'utc', 'epoch'].map(col).find((c) => c >= 0);
+  const state = ['x', 'y', 'z', 'vx', 'vy', 'vz'].map(col);
+  if (time === undefined || time < 0 || state.some((c) => c < 0)) {
+    throw new Error('CSV ephemeris needs a header with et or datetime, and x,y,z,vx,vy,vz');
+  }
+  const utc = header[time] !== 'et';
+
+  return lines.map((line) => {
+    const fields = line.split(',').map((f) => f.trim());
+    const et = utc ? sgp4.utcToET(fields[time]) : Number(fields[time]);
+    return [et, ...state.map((c) => Number(fields[c]))];
+  });
+}
+
+/**
+ * Frame and rows of an OEM (KVN or XML)
+ */
+function parseOEM(sgp4: NativeSGP4Module, text: string): { frame: OEMRefFrame; rows: number[][]; name?: string } {
+  const xml = text.trimStart().startsWith('<');
+  const meta: Record<string, string[]> = {};
+  const rows: number[][] = [];
+  const toET = (epoch: string): number => sgp4.utcToET(epoch.trim());
+
+  if (xml) {
+    for (const m of text.matchAll(/<(REF_FRAME|CENTER_NAME|TIME_SYSTEM|OBJECT_NAME)>([^<]*)</g)) {
+      (meta[m[1]] ||= []).push(m[2].trim());
+    }
+    for (const m of text.matchAll(/<stateVector>([\s\S]*?)<\/stateVector>/g)) {
+      const field = (key: string): string => new RegExp(`<${key}(\\s[^>]*)?>([^<]*)<`).exec(m[1])?.[2] ?? '';
+      rows.push([toET(field('EPOCH')), ...['X', 'Y', 'Z', 'X_DOT', 'Y_DOT', 'Z_DOT'].map((k) => Number(field(k)))]);
+    }
+  } else {
+    let inMeta = false;
+    let inCovariance = false;
+    for (const raw of text.split(/\r?\n/)) {
+      const line = raw.trim();
+      if (!line || line.startsWith('COMMENT')) {
+        continue;
+      }
+      if (line === 'META_START' || line === 'META_STOP') {
+        inMeta = line === 'META_START';
+        continue;
+      }
+      if (line === 'COVARIANCE_START' || line === 'COVARIANCE_STOP') {
+        inCovariance = line === 'COVARIANCE_START';
+        continue;
+      }
+      const kv = /^(\w+)\s*=\s*(.*)$/.exec(line);
+      if (kv) {
+        if (inMeta) {
+          (meta[kv[1]] ||= []).push(kv[2].trim());
+        }
+        continue;
+      }
+      if (!inMeta && !inCovariance) {
+        const fields = line.split(/\s+/);
+        rows.push([toET(fields[0]), ...fields.slice(1, 7).map(Number)]);
+      }
+    }
+  }
+
+  const frames = new Set((meta.REF_FRAME || []).map((f) => OEM_FRAMES[f.toUpperCase()]));
+  if (frames.size !== 1 || frames.has(undefined as unknown as OEMRefFrame)) {
+    throw new Error(`OEM REF_FRAME must be one of ${Object.keys(OEM_FRAMES).join(', ')} (the same in every segment)`);
+  }
+  if ((meta.CENTER_NAME || []).some((c) => c.toUpperCase() !== 'EARTH')) {
+    throw new Error('OEM CENTER_NAME must be EARTH');
+  }
+  if ((meta.TIME_SYSTEM || []).some((t) => t.toUpperCase() !== 'UTC')) {
+    throw new Error('OEM TIME_SYSTEM must be UTC');
+  }
+  return { frame: [...frames][0], rows, name: meta.OBJECT_NAME?.[0] };
+}
+
+/**
+ * Parse a CSV or OEM ephemeris. The format is detected when not given;
+ * `frame` applies to CSV (OEM carries its own REF_FRAME).
+ *
+ * @throws Error on malformed input
+ */
+export function parseEphemeris(
+  sgp4: NativeSGP4Module,
+  text: string,
+  options: { format?: EphemerisFormat; frame?: OEMRefFrame; name?: string } = {}
+): UserEphemeris {
+  const format =
+    options.format ?? (/^\s*(CCSDS_OEM_VERS|<)/.test(text) ? 'oem' : 'csv');
+  if (format === 'oem') {
+    const oem = parseOEM(sgp4, text);
+    const name = options.name ?? oem.name;
+    return { ...(name && { name }), frame: oem.frame, packed: packRows(oem.rows) };
+  }
+  return {
+    ...(options.name && { name: options.name }),
+    frame: options.frame ?? 'TEME',
+    packed: packRows(parseCSV(sgp4, text)),
+  };
+}
+
+/**
+ * Screen an ephemeris against a batch of satellites in-process (used by
+ * the worker for one shard)
+ */
+export function screenEphemeris(
+  sgp4: NativeSGP4Module,
+  tles: SatelliteList,
+  ephemeris: UserEphemeris,
+  limits: Float64Array,
+  maxStep = 0,
+  maxApproaches = 0
+): ScreenOutput {
+  return sgp4.screenEphemeris(
+    elementsOf(sgp4, tles),
+    ephemeris.packed,
+    FRAME_CODES[ephemeris.frame],
+    limits,
+    maxStep,
+    maxApproaches
+  );
+}
+
+/**
+ * Screen an ephemeris against many satellites, sharded across the worker
+ * pool. Approaches keep satellite order; `maxApproaches` caps the total.
+ */
+export async function executeScreen(
+  pool: SGP4NativeWorkerPool,
+  request: {
+    tles: SatelliteList;
+    ephemeris: UserEphemeris;
+    limits: Float64Array;
+    model: string;
+    maxStep: number;
+    maxApproaches: number;
+  }
+): Promise<ScreenOutput> {
+  const { tles, maxApproaches } = request;
+  const count = satelliteCount(tles);
+  const size = Math.ceil(count / Math.max(1, Math.min(pool.stats.poolSize, count)));
+  const shards = Math.ceil(count / size);
+
+  const parts = await Promise.all(
+    Array.from({ length: shards }, (_, i) =>
+      pool.screenEphemeris({
+        tles: sliceSatellites(tles, i * size, (i + 1) * size),
+        ephemeris: request.ephemeris,
+        limits: request.limits,
+        model: request.model,
+        maxStep: request.maxStep,
+        maxApproaches,
+      })
+    )
+  );
+
+  const all = parts.reduce((n, p) => n + p.tca.length, 0);
+  const total = maxApproaches > 0 ? Math.min(all, maxApproaches) : all;
+  const out: ScreenOutput = {
+    tca: new Float64Array(total),
+    sat: new Int32Array(total),
+    distance: new Float64Array(total),
+    speed: new Float64Array(total),
+    ric: new Float64Array(total * 3),
+    candidates: parts.reduce((n, p) => n + p.candidates, 0),
+    truncated: total < all || parts.some((p) => p.truncated),
+  };
+
+  let offset = 0;
+  parts.forEach((p, i) => {
+    const count = Math.min(p.tca.length, total - offset);
+    out.tca.set(p.tca.subarray(0, count), offset);
+    out.distance.set(p.distance.subarray(0, count), offset);
+    out.speed.set(p.speed.subarray(0, count), offset);
+    out.ric.set(p.ric.subarray(0, count * 3), offset * 3);
+    for (let a = 0; a < count; a++) {
+      out.sat[offset + a] = p.sat[a] + i * size;
+    }
+    offset += count;
+  });
+
+  return out;
+}
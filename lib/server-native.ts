@@ -7,15 +7,71 @@
 
 import express, { Request, Response, NextFunction } from 'express';
 import compression from 'compression';
-import { createExtendedNativeSGP4, type NativeSGP4Module } from './sgp4-native.js';
+import { createExtendedNativeSGP4, packedToStates, type NativeSGP4Module } from './sgp4-native.js';
+import { PARTIALS_WRT, type PropagateState, type SatelliteList } from './worker-types.js';
 import { getAllModels, getWgsModel, getWgsConstants, DEFAULT_MODEL } from './models.js';
 import { nativeWorkerPool } from './worker-pool-native.js';
 import { OMMData, ommToTLE, tleToOMM, validateOMM } from './omm.js';
+import {
+  OEM_FORMATS,
+  OEM_REF_FRAMES,
+  buildOEMMetadata,
+  formatOEMFooter,
+  formatOEMHeader,
+  formatOEMSegmentFooter,
+  formatOEMSegmentHeader,
+  oemContentType,
+  type OEMFormat,
+  type OEMMetadata,
+  type OEMRefFrame,
+} from './oem.js';
+import {
+  ELEMENT_COLUMNS,
+  ELEMENT_SETS,
+  elementStages,
+  encodePipeline,
+  executePipeline,
+  mergePipelineOutputs,
+  parseAggregateSpec,
+  parsePipelineStages,
+  pipelineOutputs,
+  type ElementSet,
+  type PipelineOutput,
+  type PipelineStage,
+} from './pipeline.js';
+import { EphemerisPyramidCache } from './lod.js';
+import { encodeEventSpecs, eventName, executeEvents, parseEventSpecs, type EventSpec } from './events.js';
+import { trafficCapture } from './capture.js';
+import { qosContext } from './scheduler.js';
+import { ConcurrencyLimiter } from './limiter.js';
+import { ENGINE_MODES, EngineRouter, statesToPacked, type EngineChoice, type EngineMode } from './engine.js';
+import { ShadowComparator } from './shadow.js';
+import { EphemerisPrewarmer, HotObjectTracker } from './hotset.js';
+import { AccessLog } from './accesslog.js';
+import { parseCatalogPredicates, ResidentCatalog, type CatalogPredicate } from './catalog.js';
+import { EPHEMERIS_FORMATS, encodeScreenLimits, executeScreen, parseEphemeris, type UserEphemeris } from './screen.js';
+import { noradNumber } from './archive.js';
+import {
+  elementsOf,
+  satelliteChunks,
+  satelliteCount,
+  satelliteStreamType,
+  sliceSatellites,
+  toSatellite,
+  type SatelliteInput,
+} from './ingest.js';
 import { execSync } from 'child_process';
+import { once } from 'events';
 import crypto from 'crypto';
 
 const app = express();
 app.use(compression());
+
+// Shed requests over the concurrency limit before their bodies are read
+const limiter = new ConcurrencyLimiter(nativeWorkerPool.stats.elastic.maxSize, () => nativeWorkerPool.stats.scheduler.meanQueueWaitMs);
+app.use(limiter.middleware());
+// Ephemerides make screening bodies larger than the default JSON limit
+app.use('/api/spice/sgp4/screen', express.json({ limit: process.env.SGP4_SCREEN_BODY_LIMIT || '16mb' }));
 app.use(express.json());
 
 let sgp4: NativeSGP4Module;
@@ -26,7 +82,35 @@ let GIT_HASH = process.env.GIT_COMMIT || '-';
 
 // Propagation limits (same as WASM server)
 const MAX_POINTS = 1209602;
+const BATCH_SIZE = Math.floor(MAX_POINTS / 1000);
 const CACHE_MAX_AGE = 3600;
+const MAX_PIPELINE_SATELLITES = 100000;
+const MAX_EVENT_WINDOW_DAYS = 31;
+const MAX_EVENTS = MAX_POINTS;
+const MAX_LOD_WINDOW_DAYS = 31;
+const MAX_LOD_POINTS = 100000;
+const MAX_CATALOG_SATELLITES = 500000;
+const MAX_SCREEN_EPHEMERIDES = 16;
+const MAX_SCREEN_SPAN_DAYS = 31;
+
+// Satellites per propagation chunk of a streamed batch upload
+const INGEST_CHUNK = parseInt(process.env.SGP4_INGEST_CHUNK || '', 10) || 1024;
+
+// Multi-resolution ephemeris tiles shared by all clients
+const lodCache = new EphemerisPyramidCache(nativeWorkerPool);
+
+// Native SIMD for near-earth objects, CSPICE (WASM workers) for the rest
+const engineRouter = new EngineRouter((et) => sgp4.etToUTC(et));
+
+// Sampled comparison of served results against the other engine
+const shadow = new ShadowComparator(engineRouter, nativeWorkerPool);
+
+// Access counts by object, and rolling ephemeris windows of the hottest
+const hotObjects = new HotObjectTracker();
+const prewarmer = new EphemerisPrewarmer(nativeWorkerPool, hotObjects, (utc) => sgp4.utcToET(utc));
+
+// Resident catalog with orbital-parameter indexes (SGP4_CATALOG or PUT)
+let catalog: ResidentCatalog | undefined;
 
 function generateETag(params: Record<string, unknown>): string {
   const hash = crypto.createHash('md5').update(JSON.stringify(params)).digest('hex');
@@ -42,35 +126,12 @@ if (GIT_HASH === '-') {
   }
 }
 
-// Request logging middleware
-function requestLogger(req: Request, res: Response, next: NextFunction): void {
-  const originalSend = res.send;
-  let responseSize = 0;
-
-  res.send = function (body): Response {
-    if (body) {
-      responseSize = Buffer.isBuffer(body) ? body.length : Buffer.byteLength(String(body));
-    }
-    return originalSend.call(this, body);
-  };
-
-  res.on('finish', () => {
-    const timestamp = new Date().toISOString().replace('Z', '+00:00');
-    const ip = req.ip || req.socket.remoteAddress || '-';
-    const method = req.method;
-    const path = req.originalUrl;
-    const protocol = `HTTP/${req.httpVersion}`;
-    const status = res.statusCode;
-
-    console.log(
-      `${timestamp} - ${ip} - [native hash:${GIT_HASH} srv:${SERVER_ID}] "${method} ${path} ${protocol}" ${status} ${responseSize}`
-    );
-  });
-
-  next();
-}
+// Access log, written in batches off the request path
+const accessLog = new AccessLog(`native hash:${GIT_HASH} srv:${SERVER_ID}`);
 
-app.use(requestLogger);
+app.use(accessLog.middleware());
+app.use(trafficCapture('native'));
+app.use(qosContext());
 
 // Error handler
 function asyncHandler(
@@ -103,7 +164,40 @@ app.get('/api/spice/sgp4/health', (_req: Request, res: Response) => {
  * GET /api/spice/sgp4/pool/stats
  */
 app.get('/api/spice/sgp4/pool/stats', (_req: Request, res: Response) => {
-  res.json(nativeWorkerPool.stats);
+  res.json({
+    ...nativeWorkerPool.stats,
+    limiter: limiter.stats,
+    engines: engineRouter.stats,
+    accessLog: accessLog.stats,
+  });
+});
+
+/**
+ * GET /api/spice/sgp4/shadow/stats
+ *
+ * Native vs CSPICE differences on sampled traffic (SGP4_SHADOW_RATE)
+ */
+app.get('/api/spice/sgp4/shadow/stats', (_req: Request, res: Response) => {
+  res.json(shadow.stats);
+});
+
+/**
+ * GET /api/spice/sgp4/hot/stats
+ *
+ * Most accessed objects and ephemeris prewarmer hit rate
+ */
+app.get('/api/spice/sgp4/hot/stats', (req: Request, res: Response) => {
+  const n = Math.min(parseInt(req.query.top as string, 10) || 20, hotObjects.capacity);
+  res.json({
+    ...hotObjects.stats,
+    prewarm: prewarmer.stats,
+    top: hotObjects.top(n).map(({ key, model, count, error }) => ({
+      norad: key.split('|')[0],
+      model,
+      count: Math.round(count),
+      error: Math.round(error),
+    })),
+  });
 });
 
 /**
@@ -127,6 +221,98 @@ app.post(
   })
 );
 
+/**
+ * Parse an observer location given as "lat,lon[,alt]" (deg, deg, km)
+ *
+ * @throws Error if the value is malformed
+ */
+function parseObserver(value: unknown): { lat: number; lon: number; alt: number } | undefined {
+  if (value === undefined || value === '') {
+    return undefined;
+  }
+  const parts = String(value).split(',').map(Number);
+  if (parts.length < 2 || parts.length > 3 || parts.some((v) => !Number.isFinite(v))) {
+    throw new Error('Invalid observer (expected lat,lon[,alt] in degrees and km)');
+  }
+  return { lat: parts[0], lon: parts[1], alt: parts[2] ?? 0 };
+}
+
+/**
+ * Check stage ordering by running the pipeline for one state on the main
+ * module, so that a bad pipeline is a 400 rather than a failed shard.
+ *
+ * @throws Error from the engine's pipeline validation
+ */
+function validatePipeline(encoded: Float64Array, satellites: SatelliteList, et0: number): void {
+  sgp4.runPipeline(elementsOf(sgp4, sliceSatellites(satellites, 0, 1)), encoded, et0, et0, 1, 0);
+}
+
+/**
+ * Named reductions of satellite `index` from a pipeline output
+ */
+function reductionsOf(names: string[], out: PipelineOutput, index: number): Record<string, number> {
+  return Object.fromEntries(names.map((name, r) => [name, out.reduce[index * out.nReduce + r]]));
+}
+
+/**
+ * Parse the frame parameter: undefined for Cartesian states, otherwise the
+ * osculating element set to return
+ *
+ * @throws Error on an unknown frame
+ */
+function parseElementSet(value: unknown): ElementSet | undefined {
+  const frame = String(value ?? 'cartesian').toLowerCase();
+  if (frame === 'cartesian') {
+    return undefined;
+  }
+  if (!ELEMENT_SETS.includes(frame as ElementSet)) {
+    throw new Error(`Invalid frame (must be cartesian, ${ELEMENT_SETS.join(' or ')})`);
+  }
+  return frame as ElementSet;
+}
+
+/**
+ * Named elements of one row selected by elementStages() (et first)
+ */
+function elementRecord(row: Float64Array, set: ElementSet): Record<string, string | number> {
+  const record: Record<string, string | number> = { datetime: sgp4.etToUTC(row[0]), et: row[0] };
+  ELEMENT_COLUMNS[set].forEach((c, k) => (record[c] = row[k + 1]));
+  return record;
+}
+
+/**
+ * Stream packed ephemerides as a CCSDS OEM, one segment per object.
+ *
+ * Data lines are serialized natively from the result buffers BATCH_SIZE rows
+ * at a time, waiting for the socket to drain between chunks, so the product
+ * never sits in memory as one string.
+ */
+async function sendOEM(
+  res: Response,
+  segments: Array<{ packed: Float64Array; meta: OEMMetadata }>,
+  format: OEMFormat
+): Promise<void> {
+  res.setHeader('Content-Type', oemContentType(format));
+
+  for (const [s, { packed, meta }] of segments.entries()) {
+    res.write(
+      s === 0 ? formatOEMHeader(meta, format) : formatOEMSegmentFooter(format) + formatOEMSegmentHeader(meta, format)
+    );
+    const n = packed.length / 7;
+    for (let start = 0; start < n; start += BATCH_SIZE) {
+      const chunk = sgp4.formatEphemeris(packed, start, BATCH_SIZE, format);
+      if (!res.write(chunk)) {
+        await Promise.race([once(res, 'drain'), once(res, 'close')]);
+        if (res.destroyed) {
+          return;
+        }
+      }
+    }
+  }
+
+  res.end(formatOEMFooter(format));
+}
+
 /**
  * GET/POST /api/spice/sgp4/propagate
  */
@@ -139,6 +325,19 @@ async function handlePropagate(req: Request, res: Response): Promise<void> {
   const modelName = (req.query.wgs as string) || DEFAULT_MODEL;
   const inputType = (req.query.input_type as string) || 'tle';
   const outputType = (req.query.output_type as string) || 'txt';
+  const oemFormat = ((req.query.oem_format as string) || 'kvn').toLowerCase() as OEMFormat;
+  const refFrame = ((req.query.ref_frame as string) || 'TEME').toUpperCase() as OEMRefFrame;
+  const withPartials = req.query.partials === 'true';
+  const aggregate = req.query.aggregate as string | undefined;
+  const engineMode = ((req.query.engine as string) || 'auto').toLowerCase() as EngineMode;
+
+  let elementSet: ElementSet | undefined;
+  try {
+    elementSet = parseElementSet(req.query.frame);
+  } catch (err) {
+    res.status(400).json({ error: (err as Error).message });
+    return;
+  }
 
   // Get body from POST or from body query param
   let bodyData = req.body;
@@ -157,6 +356,56 @@ async function handlePropagate(req: Request, res: Response): Promise<void> {
     return;
   }
 
+  // OEM options
+  if (outputType === 'oem') {
+    if (!OEM_FORMATS.includes(oemFormat)) {
+      res.status(400).json({ error: 'Invalid oem_format (must be kvn or xml)' });
+      return;
+    }
+  } else if (refFrame !== 'TEME' && !elementSet) {
+    res.status(400).json({ error: 'ref_frame is only supported with output_type=oem or orbital element frames' });
+    return;
+  }
+  if (!OEM_REF_FRAMES.includes(refFrame)) {
+    res.status(400).json({ error: 'Invalid ref_frame (must be TEME or GCRF)' });
+    return;
+  }
+
+  // Osculating elements are computed in the engine's pipeline; OEM carries Cartesian states only
+  if (elementSet && (outputType === 'oem' || withPartials || aggregate)) {
+    res.status(400).json({
+      error: `frame=${elementSet} cannot be combined with output_type=oem, partials or aggregate`,
+    });
+    return;
+  }
+
+  if (withPartials && outputType !== 'json') {
+    res.status(400).json({ error: 'partials=true requires output_type=json' });
+    return;
+  }
+
+  if (!ENGINE_MODES.includes(engineMode)) {
+    res.status(400).json({ error: `Invalid engine (must be ${ENGINE_MODES.join(', ')})` });
+    return;
+  }
+
+  // Aggregates are reduced in the engine and returned as JSON
+  let aggregateStages: PipelineStage[] | undefined;
+  if (aggregate) {
+    if (outputType === 'oem' || withPartials || !tf) {
+      res.status(400).json({
+        error: 'aggregate requires a time range (tf) and cannot be combined with output_type=oem or partials',
+      });
+      return;
+    }
+    try {
+      aggregateStages = parseAggregateSpec(aggregate, parseObserver(req.query.observer));
+    } catch (err) {
+      res.status(400).json({ error: (err as Error).message });
+      return;
+    }
+  }
+
   // Set geophysical constants
   const constants = getWgsConstants(modelName);
   if (!constants) {
@@ -168,6 +417,7 @@ async function handlePropagate(req: Request, res: Response): Promise<void> {
   // Get TLE lines from input
   let line1: string;
   let line2: string;
+  let omm: OMMData | undefined;
 
   if (inputType === 'omm') {
     const ommData = bodyData.omm || bodyData;
@@ -177,7 +427,8 @@ async function handlePropagate(req: Request, res: Response): Promise<void> {
       res.status(400).json({ error: (err as Error).message });
       return;
     }
-    const tlePair = ommToTLE(ommData as OMMData);
+    omm = ommData as OMMData;
+    const tlePair = ommToTLE(omm);
     line1 = tlePair.line1;
     line2 = tlePair.line2;
   } else {
@@ -193,33 +444,90 @@ async function handlePropagate(req: Request, res: Response): Promise<void> {
   // Convert times
   const et0 = sgp4.utcToET(t0);
 
-  // Single time propagation
-  if (!tf && !stepStr) {
-    const tle = sgp4.parseTLE(line1, line2);
-    const state = sgp4.propagate(tle, et0);
-    const datetime = sgp4.etToUTC(et0);
+  // Object identification for OEM metadata
+  const oemSource = { omm, line1, line2, name: bodyData.name as string | undefined };
 
-    const result = {
-      states: [
+  // Engine for this object
+  const tle = sgp4.parseTLE(line1, line2);
+  let choice: EngineChoice;
+  try {
+    choice = engineRouter.select(
+      tle.elements,
+      engineMode,
+      aggregate ? 'aggregate' : elementSet ? `frame=${elementSet}` : withPartials ? 'partials' : undefined
+    );
+  } catch (err) {
+    res.status(400).json({ error: (err as Error).message });
+    return;
+  }
+  res.set('X-SGP4-Engine', choice.engine);
+  const engineInfo = { engine: choice.engine, engine_reason: choice.reason };
+
+  // Only native results can be served from a prewarmed window
+  if (choice.engine === 'native') {
+    hotObjects.record({ line1, line2 }, modelName);
+  }
+
+  // Single time propagation (element frames take the range path with one point)
+  if (!tf && !stepStr && !elementSet) {
+    let state;
+    let datetime: string;
+    if (choice.engine === 'cspice') {
+      const [s] = (
+        await engineRouter.propagate({ tle: { line1, line2 }, times: { et0, etf: et0, step: 1 }, model: modelName })
+      ).states;
+      state = {
+        position: { x: s.position[0], y: s.position[1], z: s.position[2] },
+        velocity: { vx: s.velocity[0], vy: s.velocity[1], vz: s.velocity[2] },
+      };
+      datetime = s.datetime;
+    } else {
+      state = sgp4.propagate(tle, et0);
+      datetime = sgp4.etToUTC(et0);
+    }
+
+    let states: PropagateState[];
+    if (withPartials) {
+      const { packed, partials } = sgp4.propagateRangePartials(tle, et0, et0, 1);
+      states = packedToStates(sgp4, packed, partials);
+    } else {
+      states = [
         {
           datetime,
           et: et0,
           position: [state.position.x, state.position.y, state.position.z],
           velocity: [state.velocity.vx, state.velocity.vy, state.velocity.vz],
         },
-      ],
+      ];
+    }
+
+    const result = {
+      states,
       epoch: tle.epoch,
       model: modelName,
       count: 1,
       t0,
       input_type: inputType,
+      ...engineInfo,
+      ...(withPartials && { partials_wrt: PARTIALS_WRT }),
     };
 
-    const etag = generateETag({ line1, line2, t0, modelName });
+    const etag = generateETag({ line1, line2, t0, modelName, outputType, oemFormat, refFrame, withPartials, engine: choice.engine });
     res.set('ETag', etag);
     res.set('Cache-Control', `public, max-age=${CACHE_MAX_AGE}`);
 
-    if (outputType === 'json') {
+    if (outputType === 'oem') {
+      const packed = Float64Array.of(
+        et0,
+        state.position.x, state.position.y, state.position.z,
+        state.velocity.vx, state.velocity.vy, state.velocity.vz
+      );
+      if (refFrame === 'GCRF') {
+        sgp4.temeToGcrf(packed);
+      }
+      const meta = buildOEMMetadata(oemSource, refFrame, datetime, datetime);
+      await sendOEM(res, [{ packed, meta }], oemFormat);
+    } else if (outputType === 'json') {
       res.json(result);
     } else {
       res.type('text/plain');
@@ -246,18 +554,152 @@ async function handlePropagate(req: Request, res: Response): Promise<void> {
     return;
   }
 
-  // Use worker pool for time range propagation
-  const result = await nativeWorkerPool.propagate({
-    tle: { line1, line2 },
-    times: { et0, etf, step },
-    model: modelName,
-  });
+  if (aggregateStages) {
+    const encoded = encodePipeline(aggregateStages);
+    try {
+      validatePipeline(encoded, [{ line1, line2 }], et0);
+    } catch (err) {
+      res.status(400).json({ error: (err as Error).message });
+      return;
+    }
+
+    const out = await executePipeline(nativeWorkerPool, {
+      tles: [{ line1, line2 }],
+      stages: encoded,
+      times: { et0, etf, step },
+      model: modelName,
+      maxRows: 0,
+    });
+
+    res.set('ETag', generateETag({ line1, line2, t0, tf, step, modelName, aggregate, observer: req.query.observer }));
+    res.set('Cache-Control', `public, max-age=${CACHE_MAX_AGE}`);
+    res.json({
+      aggregates: reductionsOf(pipelineOutputs(aggregateStages).reductions, out, 0),
+      model: modelName,
+      count: numPoints,
+      t0,
+      tf,
+      step: stepStr ? parseFloat(stepStr) : 60,
+      unit,
+      input_type: inputType,
+      ...engineInfo,
+    });
+    return;
+  }
+
+  if (elementSet) {
+    const stages = encodePipeline(elementStages(elementSet, refFrame));
+    const out = await executePipeline(nativeWorkerPool, {
+      tles: [{ line1, line2 }],
+      stages,
+      times: { et0, etf, step },
+      model: modelName,
+      maxRows: numPoints,
+    });
+
+    res.set('ETag', generateETag({ line1, line2, t0, tf, step, modelName, outputType, refFrame, frame: elementSet }));
+    res.set('Cache-Control', `public, max-age=${CACHE_MAX_AGE}`);
+    if (outputType === 'json') {
+      const elements = [];
+      for (let r = 0; r < out.rowSat.length; r++) {
+        elements.push(elementRecord(out.rows.subarray(r * out.nSelect, (r + 1) * out.nSelect), elementSet));
+      }
+      res.json({
+        elements,
+        frame: elementSet,
+        ref_frame: refFrame,
+        epoch: tle.epoch,
+        model: modelName,
+        count: elements.length,
+        t0,
+        ...(tf && { tf, step: stepStr ? parseFloat(stepStr) : 60, unit }),
+        input_type: inputType,
+        ...engineInfo,
+      });
+    } else {
+      res.type('text/plain');
+      let output = `datetime,et,${ELEMENT_COLUMNS[elementSet].join(',')}\n`;
+      for (let r = 0; r < out.rowSat.length; r++) {
+        const row = out.rows.subarray(r * out.nSelect, (r + 1) * out.nSelect);
+        output += `${sgp4.etToUTC(row[0])},${row.join(',')}\n`;
+      }
+      res.send(output);
+    }
+    return;
+  }
 
-  const etag = generateETag({ line1, line2, t0, tf, step, modelName });
+  // Prewarmed window of a hot object, else the worker pool
+  const warm =
+    choice.engine === 'native' && !withPartials
+      ? prewarmer.lookup({ line1, line2 }, modelName, et0, etf, step)
+      : undefined;
+  if (prewarmer.objects > 0 && choice.engine === 'native') {
+    res.set('X-SGP4-Prewarm', warm ? 'hit' : 'miss');
+  }
+  if (warm && outputType === 'oem' && refFrame === 'GCRF') {
+    sgp4.temeToGcrf(warm);
+  }
+  const result = warm
+    ? {
+        states: outputType === 'oem' ? [] : packedToStates(sgp4, warm),
+        ...(outputType === 'oem' && { packed: warm }),
+        epoch: tle.epoch,
+        model: modelName,
+      }
+    : choice.engine === 'cspice'
+      ? await engineRouter.propagate({ tle: { line1, line2 }, times: { et0, etf, step }, model: modelName })
+      : await nativeWorkerPool.propagate({
+          tle: { line1, line2 },
+          times: { et0, etf, step },
+          model: modelName,
+          ...(outputType === 'oem' && { packed: true, frame: refFrame }),
+          ...(withPartials && { partials: true }),
+        });
+  if (outputType === 'oem' && !result.packed) {
+    result.packed = statesToPacked(result.states);
+    if (refFrame === 'GCRF') {
+      sgp4.temeToGcrf(result.packed);
+    }
+  }
+  if (refFrame === 'TEME' && !withPartials) {
+    shadow.offer({
+      tle: { line1, line2 },
+      elements: tle.elements,
+      times: { et0, etf, step },
+      model: modelName,
+      engine: choice.engine,
+      packed: result.packed,
+      states: result.states,
+    });
+  }
+
+  const etag = generateETag({
+    line1,
+    line2,
+    t0,
+    tf,
+    step,
+    modelName,
+    outputType,
+    oemFormat,
+    refFrame,
+    withPartials,
+    engine: choice.engine,
+  });
   res.set('ETag', etag);
   res.set('Cache-Control', `public, max-age=${CACHE_MAX_AGE}`);
 
-  if (outputType === 'json') {
+  if (outputType === 'oem' && result.packed) {
+    const packed = result.packed;
+    const n = packed.length / 7;
+    const meta = buildOEMMetadata(
+      oemSource,
+      refFrame,
+      sgp4.etToUTC(packed[0]),
+      sgp4.etToUTC(packed[n - 1])
+    );
+    await sendOEM(res, [{ packed, meta }], oemFormat);
+  } else if (outputType === 'json') {
     res.json({
       states: result.states,
       epoch: result.epoch,
@@ -268,6 +710,8 @@ async function handlePropagate(req: Request, res: Response): Promise<void> {
       step: stepStr ? parseFloat(stepStr) : 60,
       unit,
       input_type: inputType,
+      ...engineInfo,
+      ...(withPartials && { partials_wrt: PARTIALS_WRT }),
     });
   } else {
     // Text output (CSV)
@@ -284,6 +728,939 @@ async function handlePropagate(req: Request, res: Response): Promise<void> {
 app.get('/api/spice/sgp4/propagate', asyncHandler(handlePropagate));
 app.post('/api/spice/sgp4/propagate', asyncHandler(handlePropagate));
 
+/**
+ * Resolve a list of satellites given as TLE ({ line1, line2, name? }) or
+ * OMM objects into TLE lines.
+ *
+ * @throws Error naming the first invalid entry
+ */
+function parseSatellites(list: unknown): SatelliteInput[] {
+  if (!Array.isArray(list) || list.length === 0) {
+    throw new Error('satellites must be a non-empty array');
+  }
+
+  return list.map(toSatellite);
+}
+
+/**
+ * Read the satellites of a streamed batch body (lib/ingest.ts) and start a
+ * pipeline run for each chunk as soon as it has arrived, so propagation
+ * overlaps the upload.
+ *
+ * @param limit - Returns an error message once `count` satellites are too many
+ * @returns Name (text bodies) or NORAD ID (binary bodies) of each satellite,
+ *          and one pending output per chunk
+ * @throws Error on malformed input or a limit (runs already started are not awaited)
+ */
+async function ingestBatch(
+  req: Request,
+  request: { stages: Float64Array; times: { et0: number; etf: number; step: number }; model: string },
+  limit: (count: number) => string | undefined
+): Promise<{ labels: Array<{ name?: string; norad?: number }>; parts: Promise<PipelineOutput>[]; counts: number[] }> {
+  const labels: Array<{ name?: string; norad?: number }> = [];
+  const parts: Promise<PipelineOutput>[] = [];
+  const counts: number[] = [];
+
+  for await (const chunk of satelliteChunks(req, INGEST_CHUNK)) {
+    const count = satelliteCount(chunk);
+    const error = limit(labels.length + count);
+    if (error) {
+      throw new Error(error);
+    }
+    if (labels.length === 0) {
+      validatePipeline(request.stages, chunk, request.times.et0);
+    }
+    if (Array.isArray(chunk)) {
+      chunk.forEach((sat) => labels.push({ name: sat.name }));
+    } else {
+      chunk.norad.forEach((norad) => labels.push({ norad }));
+    }
+
+    const tles = Array.isArray(chunk) ? chunk : { columns: chunk.columns };
+    const part = executePipeline(nativeWorkerPool, { ...request, tles, maxRows: 0 });
+    // Rejections surface when the parts are awaited; not if ingestion fails first
+    part.catch(() => {});
+    parts.push(part);
+    counts.push(count);
+  }
+
+  if (labels.length === 0) {
+    throw new Error('Request body holds no satellites');
+  }
+  return { labels, parts, counts };
+}
+
+/**
+ * PUT /api/spice/sgp4/catalog?wgs=
+ *
+ * Replace the resident catalog with a streamed body (text/plain 3LE,
+ * application/x-ndjson OMM or application/x-sgp4-elements frames) and
+ * index its orbital parameters
+ */
+app.put(
+  '/api/spice/sgp4/catalog',
+  asyncHandler(async (req: Request, res: Response) => {
+    const modelName = (req.query.wgs as string) || DEFAULT_MODEL;
+    if (!getWgsConstants(modelName)) {
+      res.status(400).json({ error: `Unknown model: ${modelName}` });
+      return;
+    }
+    try {
+      catalog = await ResidentCatalog.load(
+        sgp4,
+        satelliteChunks(req, INGEST_CHUNK),
+        modelName,
+        'upload',
+        MAX_CATALOG_SATELLITES
+      );
+    } catch (err) {
+      res.status(400).json({ error: (err as Error).message });
+      return;
+    }
+    res.json(catalog.stats);
+  })
+);
+
+/**
+ * GET /api/spice/sgp4/catalog
+ */
+app.get('/api/spice/sgp4/catalog', (_req: Request, res: Response) => {
+  res.json(catalog ? catalog.stats : { size: 0 });
+});
+
+/**
+ * Matches of catalog range predicates, or an error message
+ */
+function queryCatalog(
+  where: Record<string, unknown>,
+  limit: unknown
+): { matches: Int32Array; total: number; ms: number } | string {
+  if (!catalog) {
+    return 'No catalog loaded (set SGP4_CATALOG or PUT /api/spice/sgp4/catalog)';
+  }
+  let predicates: CatalogPredicate[];
+  try {
+    predicates = parseCatalogPredicates(where);
+  } catch (err) {
+    return (err as Error).message;
+  }
+  const start = performance.now();
+  const all = catalog.query(predicates);
+  const ms = performance.now() - start;
+  const max = limit === undefined ? all.length : Number(limit);
+  if (!(max >= 0)) {
+    return 'Invalid limit';
+  }
+  return { matches: all.subarray(0, max), total: all.length, ms };
+}
+
+/**
+ * GET /api/spice/sgp4/catalog/query?perigee=lo,hi&inclination=lo,hi&...&limit=
+ *
+ * Catalog objects whose parameters (perigee, apogee, inclination, period,
+ * raan, eccentricity, longitude) fall in every given range
+ */
+app.get('/api/spice/sgp4/catalog/query', (req: Request, res: Response) => {
+  const result = queryCatalog(req.query, req.query.limit ?? 1000);
+  if (typeof result === 'string') {
+    res.status(400).json({ error: result });
+    return;
+  }
+  res.json({
+    total: result.total,
+    count: result.matches.length,
+    queryMs: result.ms,
+    objects: Array.from(result.matches, (i) => catalog!.describe(i)),
+  });
+});
+
+/**
+ * POST /api/spice/sgp4/catalog/query
+ *
+ * Run the batch pipeline over the catalog objects matching `where` (as the
+ * GET query parameters, ranges as "lo,hi" or [lo, hi]). The body takes the
+ * pipeline parameters (t0, tf, step, unit, stages, max_rows); stages
+ * default to selecting the TEME states, and wgs to the catalog's model.
+ */
+app.post(
+  '/api/spice/sgp4/catalog/query',
+  asyncHandler(async (req: Request, res: Response) => {
+    const body = req.body ?? {};
+    const result = queryCatalog(body.where ?? {}, body.limit);
+    if (typeof result === 'string') {
+      res.status(400).json({ error: result });
+      return;
+    }
+    if (result.matches.length === 0) {
+      res.status(400).json({ error: 'No catalog objects match' });
+      return;
+    }
+    const labels = Array.from(result.matches, (i) => {
+      const { norad, name } = catalog!.describe(i);
+      return { norad, ...(name && { name }) };
+    });
+    await runPipelineRequest(
+      res,
+      {
+        wgs: catalog!.model,
+        stages: [{ select: ['et', 'x', 'y', 'z', 'vx', 'vy', 'vz'] }],
+        ...body,
+      },
+      catalog!.subset(result.matches),
+      labels
+    );
+  })
+);
+
+/**
+ * POST /api/spice/sgp4/pipeline
+ *
+ * Propagate many satellites and run a stage pipeline (frame, observer,
+ * derive, filter, reduce, select) natively over the ephemeris chunks,
+ * sharded across the worker pool. Only reductions and selected rows are
+ * returned.
+ */
+app.post(
+  '/api/spice/sgp4/pipeline',
+  asyncHandler(async (req: Request, res: Response) => {
+    let satellites: SatelliteInput[];
+    try {
+      satellites = parseSatellites(req.body?.satellites);
+    } catch (err) {
+      res.status(400).json({ error: (err as Error).message });
+      return;
+    }
+    await runPipelineRequest(res, req.body, satellites, satellites);
+  })
+);
+
+/**
+ * Run the pipeline of a request body (t0, tf, step, unit, wgs, stages,
+ * max_rows) over satellites and send the reductions and selected rows
+ *
+ * @param labels - Name and/or NORAD ID reported for each satellite
+ */
+async function runPipelineRequest(
+  res: Response,
+  body: Record<string, unknown>,
+  satellites: SatelliteList,
+  labels: Array<{ name?: string; norad?: number }>
+): Promise<void> {
+  const modelName = (body.wgs as string) || DEFAULT_MODEL;
+  const count = satelliteCount(satellites);
+
+  let stages: PipelineStage[];
+  try {
+    stages = parsePipelineStages(body.stages);
+  } catch (err) {
+    res.status(400).json({ error: (err as Error).message });
+    return;
+  }
+
+  if (count > MAX_PIPELINE_SATELLITES) {
+    res.status(400).json({
+      error: `Too many satellites: ${count}. Maximum is ${MAX_PIPELINE_SATELLITES}.`,
+    });
+    return;
+  }
+
+  if (!body.t0 || !body.tf) {
+    res.status(400).json({ error: 'Missing required parameter: t0 or tf' });
+    return;
+  }
+
+  const constants = getWgsConstants(modelName);
+  if (!constants) {
+    res.status(400).json({ error: `Unknown model: ${modelName}` });
+    return;
+  }
+  sgp4.setGeophysicalConstants(constants, modelName);
+
+  const et0 = sgp4.utcToET(body.t0 as string);
+  const etf = sgp4.utcToET(body.tf as string);
+  let step = body.step === undefined ? 60 : Number(body.step);
+  if (body.unit === 'min') {
+    step *= 60;
+  }
+  if (!(step > 0) || etf < et0) {
+    res.status(400).json({ error: 'Invalid time range (step must be > 0 and tf >= t0)' });
+    return;
+  }
+
+  const numPoints = Math.floor((etf - et0) / step) + 1;
+  if (numPoints > MAX_POINTS) {
+    res.status(400).json({
+      error: `Too many points: ${numPoints}. Maximum is ${MAX_POINTS}.`,
+    });
+    return;
+  }
+
+  const maxRows = body.max_rows === undefined ? MAX_POINTS : Number(body.max_rows);
+  const encoded = encodePipeline(stages);
+
+  try {
+    validatePipeline(encoded, satellites, et0);
+  } catch (err) {
+    res.status(400).json({ error: (err as Error).message });
+    return;
+  }
+
+  const out = await executePipeline(nativeWorkerPool, {
+    tles: satellites,
+    stages: encoded,
+    times: { et0, etf, step },
+    model: modelName,
+    maxRows,
+  });
+
+  const { reductions, columns } = pipelineOutputs(stages);
+  const results = labels.map((sat, i) => ({
+    index: i,
+    ...(sat.name && { name: sat.name }),
+    ...(sat.norad !== undefined && { norad: sat.norad }),
+    reduce: reductionsOf(reductions, out, i),
+    rows: [] as number[][],
+  }));
+  for (let r = 0; r < out.rowSat.length; r++) {
+    results[out.rowSat[r]].rows.push(Array.from(out.rows.subarray(r * out.nSelect, (r + 1) * out.nSelect)));
+  }
+
+  res.json({
+    count,
+    steps: numPoints,
+    model: modelName,
+    t0: body.t0,
+    tf: body.tf,
+    step,
+    reductions,
+    columns,
+    results,
+    truncated: out.truncated,
+  });
+}
+
+/**
+ * Packed ephemeris of each object of a batch, from the natively run rows
+ * (`nativeIndex` maps their satellites back to the batch) and the states
+ * of the CSPICE-routed objects
+ */
+function oemSegments(
+  count: number,
+  out: PipelineOutput | undefined,
+  nativeIndex: number[],
+  cspiceStates: Map<number, PropagateState[]>
+): Float64Array[] {
+  const rows = new Int32Array(count);
+  const rowSat = out ? Array.from(out.rowSat, (s) => nativeIndex[s]) : [];
+  rowSat.forEach((i) => rows[i]++);
+
+  const segments = Array.from({ length: count }, (_, i) =>
+    cspiceStates.has(i) ? statesToPacked(cspiceStates.get(i)!) : new Float64Array(rows[i] * 7)
+  );
+  const filled = new Int32Array(count);
+  rowSat.forEach((i, r) => {
+    const n = rows[i];
+    for (let c = 0; c < 7; c++) {
+      segments[i][c * n + filled[i]] = out!.rows[r * 7 + c];
+    }
+    filled[i]++;
+  });
+  return segments;
+}
+
+/**
+ * POST /api/spice/sgp4/propagate/batch
+ *
+ * Propagate many satellites over one time grid. Returns the states of each
+ * object, with frame=keplerian|equinoctial its osculating elements, with
+ * aggregate= only the per-object reductions, or with output_type=oem one
+ * CCSDS OEM holding a segment per object.
+ *
+ * Satellites come as a JSON array (or { satellites }), or streamed as
+ * text/plain 3LE or application/x-ndjson OMM, in which case propagation
+ * starts on the first chunks while the upload continues.
+ *
+ * JSON batches are split by engine (see engine.ts) and merged back in
+ * order; aggregates, element frames and streamed bodies run natively.
+ */
+app.post(
+  '/api/spice/sgp4/propagate/batch',
+  asyncHandler(async (req: Request, res: Response) => {
+    const t0 = (req.query.t0 as string) || '';
+    const tf = (req.query.tf as string) || '';
+    const stepStr = req.query.step as string | undefined;
+    const unit = (req.query.unit as string) || 'sec';
+    const modelName = (req.query.wgs as string) || DEFAULT_MODEL;
+    const aggregate = req.query.aggregate as string | undefined;
+    const engineMode = ((req.query.engine as string) || 'auto').toLowerCase() as EngineMode;
+    const outputType = (req.query.output_type as string) || 'json';
+    const oemFormat = ((req.query.oem_format as string) || 'kvn').toLowerCase() as OEMFormat;
+    const refFrame = ((req.query.ref_frame as string) || 'TEME').toUpperCase() as OEMRefFrame;
+    const streamed = satelliteStreamType(req) !== undefined;
+
+    if (!t0 || !tf) {
+      res.status(400).json({ error: 'Missing required parameter: t0 or tf' });
+      return;
+    }
+
+    // One multi-segment OEM of the full ephemerides of a JSON batch
+    if (outputType === 'oem') {
+      if (!OEM_FORMATS.includes(oemFormat) || !OEM_REF_FRAMES.includes(refFrame)) {
+        res.status(400).json({ error: 'Invalid oem_format (must be kvn or xml) or ref_frame (must be TEME or GCRF)' });
+        return;
+      }
+      if (aggregate || req.query.frame !== undefined || streamed) {
+        res.status(400).json({
+          error: 'output_type=oem cannot be combined with aggregate, frame or a streamed body',
+        });
+        return;
+      }
+    } else if (outputType !== 'json' || refFrame !== 'TEME') {
+      res.status(400).json({ error: 'output_type must be json or oem; ref_frame requires output_type=oem' });
+      return;
+    }
+
+    if (!ENGINE_MODES.includes(engineMode) || (streamed && engineMode === 'cspice')) {
+      res.status(400).json({
+        error: `Invalid engine (must be ${ENGINE_MODES.join(', ')}; streamed bodies run natively)`,
+      });
+      return;
+    }
+
+    let satellites: SatelliteInput[] = [];
+    let labels: Array<{ name?: string; norad?: number }> = satellites;
+    let stages: PipelineStage[];
+    let elementSet: ElementSet | undefined;
+    try {
+      if (!streamed) {
+        labels = satellites = parseSatellites(Array.isArray(req.body) ? req.body : req.body?.satellites);
+      }
+      elementSet = parseElementSet(req.query.frame);
+      if (elementSet && aggregate) {
+        throw new Error(`frame=${elementSet} cannot be combined with aggregate`);
+      }
+      stages = aggregate
+        ? parseAggregateSpec(aggregate, parseObserver(req.query.observer))
+        : elementSet
+          ? elementStages(elementSet)
+          : [{ select: ['et', 'x', 'y', 'z', 'vx', 'vy', 'vz'] }];
+    } catch (err) {
+      res.status(400).json({ error: (err as Error).message });
+      return;
+    }
+
+    const constants = getWgsConstants(modelName);
+    if (!constants) {
+      res.status(400).json({ error: `Unknown model: ${modelName}` });
+      return;
+    }
+    sgp4.setGeophysicalConstants(constants, modelName);
+
+    const et0 = sgp4.utcToET(t0);
+    const etf = sgp4.utcToET(tf);
+    let step = stepStr ? parseFloat(stepStr) : 60;
+    if (unit === 'min') {
+      step *= 60;
+    }
+    if (!(step > 0) || etf < et0) {
+      res.status(400).json({ error: 'Invalid time range (step must be > 0 and tf >= t0)' });
+      return;
+    }
+
+    // Full ephemerides count against MAX_POINTS in total, aggregates per object
+    const numPoints = Math.floor((etf - et0) / step) + 1;
+    const limit = (count: number): string | undefined => {
+      const totalPoints = aggregate ? numPoints : numPoints * count;
+      return totalPoints > MAX_POINTS || count > MAX_PIPELINE_SATELLITES
+        ? `Too many points: ${totalPoints} for ${count} satellites. Maximum is ${MAX_POINTS}.`
+        : undefined;
+    };
+
+    const request = { stages: encodePipeline(stages), times: { et0, etf, step }, model: modelName };
+    let out: PipelineOutput | undefined;
+    // Engine of each object; the indices in `out` of natively run objects
+    let choices: EngineChoice[] | undefined;
+    let elements: Float64Array[] = [];
+    let nativeIndex: number[] | undefined;
+    const cspiceStates = new Map<number, PropagateState[]>();
+    if (streamed) {
+      let ingested: Awaited<ReturnType<typeof ingestBatch>>;
+      try {
+        ingested = await ingestBatch(req, request, limit);
+      } catch (err) {
+        // The rest of the upload is not read
+        res.set('Connection', 'close');
+        res.status(400).json({ error: (err as Error).message });
+        return;
+      }
+      labels = ingested.labels;
+      out = mergePipelineOutputs(await Promise.all(ingested.parts), ingested.counts);
+    } else {
+      const error = limit(satellites.length);
+      if (error) {
+        res.status(400).json({ error });
+        return;
+      }
+      try {
+        validatePipeline(request.stages, satellites, et0);
+        elements = satellites.map((sat) => sgp4.parseTLE(sat.line1, sat.line2).elements);
+        const nativeOnly = aggregate ? 'aggregate' : elementSet && `frame=${elementSet}`;
+        choices = elements.map((e) => engineRouter.select(e, engineMode, nativeOnly));
+        choices.forEach((c, i) => c.engine === 'native' && hotObjects.record(satellites[i], modelName));
+      } catch (err) {
+        res.status(400).json({ error: (err as Error).message });
+        return;
+      }
+
+      nativeIndex = [];
+      const cspiceIndex: number[] = [];
+      choices.forEach((c, i) => (c.engine === 'native' ? nativeIndex! : cspiceIndex).push(i));
+      const [nativeOut] = await Promise.all([
+        nativeIndex.length > 0
+          ? executePipeline(nativeWorkerPool, {
+              ...request,
+              tles: nativeIndex.length === satellites.length ? satellites : nativeIndex.map((i) => satellites[i]),
+              maxRows: 0,
+            })
+          : undefined,
+        ...cspiceIndex.map(async (i) => {
+          const result = await engineRouter.propagate({ tle: satellites[i], times: request.times, model: modelName });
+          cspiceStates.set(i, result.states);
+        }),
+      ]);
+      out = nativeOut;
+    }
+
+    if (outputType === 'oem') {
+      const segments = oemSegments(labels.length, out, nativeIndex!, cspiceStates).map((packed, i) => {
+        const n = packed.length / 7;
+        if (refFrame === 'TEME') {
+          shadow.offer({
+            tle: satellites[i],
+            elements: elements[i],
+            times: request.times,
+            model: modelName,
+            engine: choices![i].engine,
+            packed,
+          });
+        } else {
+          sgp4.temeToGcrf(packed);
+        }
+        const meta = buildOEMMetadata(
+          satellites[i],
+          refFrame,
+          sgp4.etToUTC(n > 0 ? packed[0] : et0),
+          sgp4.etToUTC(n > 0 ? packed[n - 1] : et0)
+        );
+        return { packed, meta };
+      });
+      await sendOEM(res, segments, oemFormat);
+      return;
+    }
+
+    const { reductions } = pipelineOutputs(stages);
+    const results = labels.map((sat, i) => ({
+      index: i,
+      ...(sat.name && { name: sat.name }),
+      ...(sat.norad !== undefined && { norad: sat.norad }),
+      engine: choices?.[i].engine ?? 'native',
+      ...(choices && { engine_reason: choices[i].reason }),
+      ...(aggregate
+        ? { aggregates: reductionsOf(reductions, out!, i) }
+        : elementSet
+          ? { elements: [] as Array<Record<string, string | number>> }
+          : { states: cspiceStates.get(i) ?? [] }),
+    }));
+
+    if (elementSet && out) {
+      for (let r = 0; r < out.rowSat.length; r++) {
+        const row = out.rows.subarray(r * out.nSelect, (r + 1) * out.nSelect);
+        results[nativeIndex ? nativeIndex[out.rowSat[r]] : out.rowSat[r]].elements!.push(elementRecord(row, elementSet));
+      }
+    } else if (!aggregate && out) {
+      for (let r = 0; r < out.rowSat.length; r++) {
+        const row = out.rows.subarray(r * 7, r * 7 + 7);
+        results[nativeIndex ? nativeIndex[out.rowSat[r]] : out.rowSat[r]].states!.push({
+          datetime: sgp4.etToUTC(row[0]),
+          et: row[0],
+          position: [row[1], row[2], row[3]],
+          velocity: [row[4], row[5], row[6]],
+        });
+      }
+    }
+
+    res.json({
+      results,
+      model: modelName,
+      count: labels.length,
+      steps: numPoints,
+      t0,
+      tf,
+      step: stepStr ? parseFloat(stepStr) : 60,
+      unit,
+      ...(elementSet && { frame: elementSet }),
+    });
+
+    if (!aggregate && !elementSet && choices) {
+      results.forEach((r, i) =>
+        shadow.offer({
+          tle: satellites[i],
+          elements: elements[i],
+          times: request.times,
+          model: modelName,
+          engine: choices![i].engine,
+          states: r.states,
+        })
+      );
+    }
+  })
+);
+
+/**
+ * POST /api/spice/sgp4/propagate/lod
+ *
+ * Zoomable ephemeris: serve [t0, tf] with at most max_points states from
+ * the finest cached pyramid level that fits, building missing day tiles
+ * once for all clients.
+ */
+app.post(
+  '/api/spice/sgp4/propagate/lod',
+  asyncHandler(async (req: Request, res: Response) => {
+    const t0 = (req.query.t0 as string) || '';
+    const tf = (req.query.tf as string) || '';
+    const modelName = (req.query.wgs as string) || DEFAULT_MODEL;
+    const refFrame = ((req.query.ref_frame as string) || 'TEME').toUpperCase() as OEMRefFrame;
+    const outputType = (req.query.output_type as string) || 'json';
+    const maxPoints = req.query.max_points === undefined ? 1000 : Number(req.query.max_points);
+
+    if (!t0 || !tf) {
+      res.status(400).json({ error: 'Missing required parameter: t0 or tf' });
+      return;
+    }
+    if (!OEM_REF_FRAMES.includes(refFrame)) {
+      res.status(400).json({ error: 'Invalid ref_frame (must be TEME or GCRF)' });
+      return;
+    }
+    if (!Number.isInteger(maxPoints) || maxPoints < 2 || maxPoints > MAX_LOD_POINTS) {
+      res.status(400).json({ error: `Invalid max_points (must be an integer from 2 to ${MAX_LOD_POINTS})` });
+      return;
+    }
+
+    let satellite: { line1: string; line2: string; name?: string };
+    try {
+      [satellite] = parseSatellites([req.body]);
+    } catch {
+      res.status(400).json({ error: 'Missing TLE lines or OMM in request body' });
+      return;
+    }
+
+    const constants = getWgsConstants(modelName);
+    if (!constants) {
+      res.status(400).json({ error: `Unknown model: ${modelName}` });
+      return;
+    }
+
+    const et0 = sgp4.utcToET(t0);
+    const etf = sgp4.utcToET(tf);
+    if (!(etf >= et0) || etf - et0 > MAX_LOD_WINDOW_DAYS * 86400) {
+      res.status(400).json({
+        error: `Invalid time window (tf must be after t0, at most ${MAX_LOD_WINDOW_DAYS} days)`,
+      });
+      return;
+    }
+
+    const window = await lodCache.window(satellite, modelName, refFrame, et0, etf, maxPoints);
+    const states = packedToStates(sgp4, window.packed);
+
+    res.set('X-LOD-Cache', window.misses === 0 ? 'hit' : 'miss');
+    if (outputType === 'txt') {
+      res.type('text/plain');
+      let output = 'datetime,et,x,y,z,vx,vy,vz\n';
+      for (const s of states) {
+        output += `${s.datetime},${s.et},${s.position[0]},${s.position[1]},${s.position[2]},${s.velocity[0]},${s.velocity[1]},${s.velocity[2]}\n`;
+      }
+      res.send(output);
+      return;
+    }
+
+    res.json({
+      states,
+      model: modelName,
+      ref_frame: refFrame,
+      count: states.length,
+      t0,
+      tf,
+      lod: {
+        level: window.level,
+        levels: window.levels,
+        step: window.step,
+        base_step: lodCache.baseStep,
+      },
+      cache: { hits: window.hits, misses: window.misses },
+    });
+  })
+);
+
+/**
+ * GET /api/spice/sgp4/propagate/lod/stats
+ * Returns ephemeris pyramid cache statistics
+ */
+app.get('/api/spice/sgp4/propagate/lod/stats', (_req: Request, res: Response) => {
+  res.json(lodCache.stats);
+});
+
+/**
+ * POST /api/spice/sgp4/events
+ *
+ * Find node crossings, apsides, altitude/latitude threshold crossings,
+ * latitude-band entry/exit and beta-angle crossings for many satellites.
+ * Events are located by root finding, not sampling, and returned sorted by
+ * time per satellite.
+ */
+app.post(
+  '/api/spice/sgp4/events',
+  asyncHandler(async (req: Request, res: Response) => {
+    const body = req.body || {};
+    const modelName = (body.wgs as string) || DEFAULT_MODEL;
+
+    let satellites: Array<{ line1: string; line2: string; name?: string }>;
+    let specs: EventSpec[];
+    try {
+      satellites = parseSatellites(body.satellites);
+      specs = parseEventSpecs(body.events);
+    } catch (err) {
+      res.status(400).json({ error: (err as Error).message });
+      return;
+    }
+
+    if (satellites.length > MAX_PIPELINE_SATELLITES) {
+      res.status(400).json({
+        error: `Too many satellites: ${satellites.length}. Maximum is ${MAX_PIPELINE_SATELLITES}.`,
+      });
+      return;
+    }
+
+    if (!body.t0 || !body.tf) {
+      res.status(400).json({ error: 'Missing required parameter: t0 or tf' });
+      return;
+    }
+
+    const constants = getWgsConstants(modelName);
+    if (!constants) {
+      res.status(400).json({ error: `Unknown model: ${modelName}` });
+      return;
+    }
+    sgp4.setGeophysicalConstants(constants, modelName);
+
+    const et0 = sgp4.utcToET(body.t0);
+    const etf = sgp4.utcToET(body.tf);
+    if (!(etf >= et0) || etf - et0 > MAX_EVENT_WINDOW_DAYS * 86400) {
+      res.status(400).json({
+        error: `Invalid time window (tf must be after t0, at most ${MAX_EVENT_WINDOW_DAYS} days)`,
+      });
+      return;
+    }
+
+    const maxStep = body.max_step === undefined ? 0 : Number(body.max_step);
+    const maxEvents = body.max_events === undefined ? MAX_EVENTS : Number(body.max_events);
+    if (!(maxStep >= 0) || !(maxEvents >= 0)) {
+      res.status(400).json({ error: 'max_step and max_events must be non-negative numbers' });
+      return;
+    }
+
+    const out = await executeEvents(nativeWorkerPool, {
+      tles: satellites,
+      specs: encodeEventSpecs(specs),
+      window: { et0, etf },
+      model: modelName,
+      maxStep,
+      maxEvents,
+    });
+
+    const results = satellites.map((sat, i) => ({
+      index: i,
+      ...(sat.name && { name: sat.name }),
+      events: [] as Array<{ datetime: string; et: number; type: string; event: string; spec: number }>,
+    }));
+    for (let e = 0; e < out.et.length; e++) {
+      const spec = specs[out.spec[e]];
+      results[out.sat[e]].events.push({
+        datetime: sgp4.etToUTC(out.et[e]),
+        et: out.et[e],
+        type: spec.type,
+        event: eventName(spec, out.direction[e]),
+        spec: out.spec[e],
+      });
+    }
+
+    res.json({
+      count: satellites.length,
+      model: modelName,
+      t0: body.t0,
+      tf: body.tf,
+      events: specs,
+      results,
+      truncated: out.truncated,
+    });
+  })
+);
+
+/**
+ * POST /api/spice/sgp4/screen
+ *
+ * Screen user ephemerides (launch or maneuver trajectories as CSV or OEM
+ * state series) against the resident catalog, optionally narrowed with
+ * `where` ranges, or against the given `satellites`. Returns the close
+ * approaches within `distance` (and the optional radial / in_track /
+ * cross_track limits) for each ephemeris, sorted by object then time.
+ */
+app.post(
+  '/api/spice/sgp4/screen',
+  asyncHandler(async (req: Request, res: Response) => {
+    const body = req.body || {};
+
+    let tles: SatelliteList;
+    let labels: Array<{ norad: number; name?: string }>;
+    let modelName: string;
+    if (body.satellites !== undefined) {
+      let satellites: SatelliteInput[];
+      try {
+        satellites = parseSatellites(body.satellites);
+      } catch (err) {
+        res.status(400).json({ error: (err as Error).message });
+        return;
+      }
+      if (satellites.length > MAX_PIPELINE_SATELLITES) {
+        res.status(400).json({
+          error: `Too many satellites: ${satellites.length}. Maximum is ${MAX_PIPELINE_SATELLITES}.`,
+        });
+        return;
+      }
+      tles = satellites;
+      labels = satellites.map((sat) => ({
+        norad: noradNumber(sat.line1.slice(2, 7)),
+        ...(sat.name && { name: sat.name }),
+      }));
+      modelName = (body.wgs as string) || DEFAULT_MODEL;
+    } else {
+      const result = queryCatalog(body.where ?? {}, undefined);
+      if (typeof result === 'string') {
+        res.status(400).json({ error: result });
+        return;
+      }
+      if (result.matches.length === 0) {
+        res.status(400).json({ error: 'No catalog objects match' });
+        return;
+      }
+      tles = catalog!.subset(result.matches);
+      labels = Array.from(result.matches, (i) => {
+        const { norad, name } = catalog!.describe(i);
+        return { norad, ...(name && { name }) };
+      });
+      modelName = catalog!.model;
+    }
+
+    const constants = getWgsConstants(modelName);
+    if (!constants) {
+      res.status(400).json({ error: `Unknown model: ${modelName}` });
+      return;
+    }
+    sgp4.setGeophysicalConstants(constants, modelName);
+
+    let limits: Float64Array;
+    const ephemerides: UserEphemeris[] = [];
+    try {
+      limits = encodeScreenLimits({
+        distance: body.distance === undefined ? NaN : Number(body.distance),
+        radial: body.radial === undefined ? undefined : Number(body.radial),
+        inTrack: body.in_track === undefined ? undefined : Number(body.in_track),
+        crossTrack: body.cross_track === undefined ? undefined : Number(body.cross_track),
+      });
+      const list = body.ephemerides;
+      if (!Array.isArray(list) || list.length === 0 || list.length > MAX_SCREEN_EPHEMERIDES) {
+        throw new Error(`ephemerides must be an array of 1-${MAX_SCREEN_EPHEMERIDES} ephemerides`);
+      }
+      list.forEach((entry: Record<string, unknown>, i: number) => {
+        if (typeof entry?.data !== 'string') {
+          throw new Error(`Ephemeris ${i}: data must be a CSV or OEM string`);
+        }
+        if (entry.format !== undefined && !EPHEMERIS_FORMATS.includes(entry.format as 'csv')) {
+          throw new Error(`Ephemeris ${i}: format must be one of ${EPHEMERIS_FORMATS.join(', ')}`);
+        }
+        if (entry.frame !== undefined && !OEM_REF_FRAMES.includes(entry.frame as OEMRefFrame)) {
+          throw new Error(`Ephemeris ${i}: frame must be one of ${OEM_REF_FRAMES.join(', ')}`);
+        }
+        try {
+          const eph = parseEphemeris(sgp4, entry.data, {
+            format: entry.format as 'csv' | 'oem' | undefined,
+            frame: entry.frame as OEMRefFrame | undefined,
+            name: entry.name as string | undefined,
+          });
+          const n = eph.packed.length / 7;
+          if (eph.packed[n - 1] - eph.packed[0] > MAX_SCREEN_SPAN_DAYS * 86400) {
+            throw new Error(`spans more than ${MAX_SCREEN_SPAN_DAYS} days`);
+          }
+          ephemerides.push(eph);
+        } catch (err) {
+          throw new Error(`Ephemeris ${i}: ${(err as Error).message}`);
+        }
+      });
+    } catch (err) {
+      res.status(400).json({ error: (err as Error).message });
+      return;
+    }
+
+    const maxStep = body.max_step === undefined ? 0 : Number(body.max_step);
+    const maxApproaches = body.max_approaches === undefined ? MAX_EVENTS : Number(body.max_approaches);
+    if (!(maxStep >= 0) || !(maxApproaches >= 0)) {
+      res.status(400).json({ error: 'max_step and max_approaches must be non-negative numbers' });
+      return;
+    }
+
+    const start = performance.now();
+    const outputs = await Promise.all(
+      ephemerides.map((ephemeris) =>
+        executeScreen(nativeWorkerPool, { tles, ephemeris, limits, model: modelName, maxStep, maxApproaches })
+      )
+    );
+
+    res.json({
+      count: labels.length,
+      model: modelName,
+      distance: limits[0],
+      ...(limits[1] > 0 && { radial: limits[1] }),
+      ...(limits[2] > 0 && { in_track: limits[2] }),
+      ...(limits[3] > 0 && { cross_track: limits[3] }),
+      screenMs: performance.now() - start,
+      results: ephemerides.map((eph, e) => {
+        const out = outputs[e];
+        const n = eph.packed.length / 7;
+        return {
+          index: e,
+          ...(eph.name && { name: eph.name }),
+          frame: eph.frame,
+          start: sgp4.etToUTC(eph.packed[0]),
+          stop: sgp4.etToUTC(eph.packed[n - 1]),
+          states: n,
+          candidates: out.candidates,
+          approaches: Array.from(out.tca, (tca, a) => ({
+            object: out.sat[a],
+            ...labels[out.sat[a]],
+            tca: sgp4.etToUTC(tca),
+            et: tca,
+            distance: out.distance[a],
+            relative_speed: out.speed[a],
+            radial: out.ric[3 * a],
+            in_track: out.ric[3 * a + 1],
+            cross_track: out.ric[3 * a + 2],
+          })),
+          truncated: out.truncated,
+        };
+      }),
+    });
+  })
+);
+
 /**
  * GET /api/spice/sgp4/time/utc-to-et
  */
@@ -400,7 +1777,8 @@ app.post(
 // Error handling middleware
 app.use((err: Error, _req: Request, res: Response, _next: NextFunction) => {
   console.error('Error:', err.message);
-  res.status(500).json({ error: err.message });
+  // DeadlineError and other load-shedding errors carry their own status
+  res.status((err as { status?: number }).status || 500).json({ error: err.message });
 });
 
 // Initialize and start server
@@ -416,10 +1794,28 @@ async function main() {
     // Initialize native worker pool
     await nativeWorkerPool.initialize();
 
+    // CSPICE workers for objects outside the native kernel (optional)
+    await engineRouter.initialize();
+
+    // Resident catalog for parameter queries (optional)
+    if (process.env.SGP4_CATALOG) {
+      catalog = await ResidentCatalog.loadFile(
+        sgp4,
+        process.env.SGP4_CATALOG,
+        process.env.SGP4_CATALOG_WGS || DEFAULT_MODEL,
+        MAX_CATALOG_SATELLITES
+      );
+      console.log(`Catalog: ${catalog.size} objects from ${process.env.SGP4_CATALOG}`);
+    }
+
+    // Rolling ephemeris windows of the hottest objects (optional)
+    prewarmer.start();
+
     app.listen(PORT, () => {
       console.log(`Native SGP4 server listening on port ${PORT}`);
       console.log(`  Health:    http://localhost:${PORT}/api/spice/sgp4/health`);
       console.log(`  Propagate: http://localhost:${PORT}/api/spice/sgp4/propagate`);
+      console.log(`  Pipeline:  http://localhost:${PORT}/api/spice/sgp4/pipeline`);
     });
   } catch (err) {
     console.error('Failed to start native server:', err);
@@ -13,7 +13,20 @@ import { dirname, join } from 'path';
 import { createSGP4, type SGP4Module } from './index.js';
 import { getAllModels, getWgsModel, getWgsConstants, DEFAULT_MODEL } from './models.js';
 import { workerPool } from './worker-pool.js';
+import type { PropagateState } from './worker-types.js';
 import { OMMData, ommToTLE, tleToOMM, validateOMM } from './omm.js';
+import {
+  OEM_FORMATS,
+  buildOEMMetadata,
+  formatOEMFooter,
+  formatOEMHeader,
+  formatOEMStates,
+  oemContentType,
+  type OEMFormat,
+} from './oem.js';
+import { trafficCapture } from './capture.js';
+import { qosContext } from './scheduler.js';
+import { ConcurrencyLimiter } from './limiter.js';
 import { execSync } from 'child_process';
 import crypto from 'crypto';
 
@@ -22,6 +35,10 @@ const __dirname = dirname(__filename);
 
 const app = express();
 app.use(compression());
+
+// Shed requests over the concurrency limit before their bodies are read
+const limiter = new ConcurrencyLimiter(workerPool.stats.elastic.maxSize, () => workerPool.stats.scheduler.meanQueueWaitMs);
+app.use(limiter.middleware());
 app.use(express.json());
 
 let sgp4: SGP4Module;
@@ -86,6 +103,8 @@ function requestLogger(req: Request, res: Response, next: NextFunction): void {
 }
 
 app.use(requestLogger);
+app.use(trafficCapture('wasm'));
+app.use(qosContext());
 
 // Load OpenAPI spec and serve Swagger UI
 const openapiPath = join(__dirname, 'openapi.yaml');
@@ -150,6 +169,7 @@ app.post(
  * Unified propagation endpoint for TLE or OMM input
  *
  * Query: ?t0=<UTC>[&tf=<UTC>&step=<number>&unit=sec|min][&wgs=wgs72|wgs84][&input_type=tle|omm][&body=<JSON>]
+ *        [&output_type=txt|json|oem][&oem_format=kvn|xml]
  * Body (POST only): { line1: string, line2: string } for TLE or OMMData for OMM
  * Alternative: Pass body as URL-encoded JSON in 'body' query parameter (works with GET)
  *
@@ -166,6 +186,8 @@ app.all(
     const queryModel = req.query.wgs as string | undefined;
     const inputType = (req.query.input_type as string) || 'tle';
     const outputType = (req.query.output_type as string) || 'txt';
+    const oemFormat = ((req.query.oem_format as string) || 'kvn').toLowerCase() as OEMFormat;
+    const refFrame = ((req.query.ref_frame as string) || 'TEME').toUpperCase();
     const batchSizeStr = req.query.batch_size as string | undefined;
 
     if (!t0) {
@@ -178,8 +200,24 @@ app.all(
       return;
     }
 
-    if (outputType !== 'json' && outputType !== 'txt') {
-      res.status(400).json({ error: 'Invalid output_type (must be json or txt)' });
+    if (outputType !== 'json' && outputType !== 'txt' && outputType !== 'oem') {
+      res.status(400).json({ error: 'Invalid output_type (must be json, txt or oem)' });
+      return;
+    }
+
+    if (outputType === 'oem' && !OEM_FORMATS.includes(oemFormat)) {
+      res.status(400).json({ error: 'Invalid oem_format (must be kvn or xml)' });
+      return;
+    }
+
+    // TEME -> GCRF rotation is only implemented in the native SIMD engine
+    if (refFrame !== 'TEME') {
+      res.status(400).json({
+        error:
+          refFrame === 'GCRF'
+            ? 'ref_frame=GCRF is only available on the native SIMD server'
+            : 'Invalid ref_frame (must be TEME)',
+      });
       return;
     }
 
@@ -247,7 +285,17 @@ app.all(
     }
 
     // Generate ETag for caching based on request parameters
-    const cacheParams = { t0, tf, step: stepStr, unit, model: modelName, inputType, outputType, body };
+    const cacheParams = {
+      t0,
+      tf,
+      step: stepStr,
+      unit,
+      model: modelName,
+      inputType,
+      outputType,
+      oemFormat,
+      body,
+    };
     const etag = generateETag(cacheParams);
 
     // Check If-None-Match header for cache validation
@@ -263,11 +311,38 @@ app.all(
 
     const et0 = sgp4.utcToET(t0);
 
+    // Object identification for OEM metadata
+    const oemSource = {
+      omm: inputType === 'omm' ? (body as OMMData) : undefined,
+      line1: tleLine1,
+      line2: tleLine2,
+      name: body.name as string | undefined,
+    };
+
     // Single time mode: only t0 provided
     if (!tf && !stepStr) {
       const state = sgp4.propagate(tle, et0);
       const utc = sgp4.etToUTC(et0);
 
+      if (outputType === 'oem') {
+        const states: PropagateState[] = [
+          {
+            datetime: utc,
+            et: et0,
+            position: [state.position.x, state.position.y, state.position.z],
+            velocity: [state.velocity.vx, state.velocity.vy, state.velocity.vz],
+          },
+        ];
+        const meta = buildOEMMetadata(oemSource, 'TEME', utc, utc);
+        res.setHeader('Content-Type', oemContentType(oemFormat));
+        res.send(
+          formatOEMHeader(meta, oemFormat) +
+            formatOEMStates(states, oemFormat) +
+            formatOEMFooter(oemFormat)
+        );
+        return;
+      }
+
       if (outputType === 'txt') {
         const header = 'datetime,et,x,y,z,vx,vy,vz';
         const row = `${utc},${et0},${state.position.x},${state.position.y},${state.position.z},${state.velocity.vx},${state.velocity.vy},${state.velocity.vz}`;
@@ -337,6 +412,24 @@ app.all(
       model: modelName,
     });
 
+    // Output OEM format, streamed in batches
+    if (outputType === 'oem') {
+      const states = result.states;
+      const meta = buildOEMMetadata(
+        oemSource,
+        'TEME',
+        states[0].datetime,
+        states[states.length - 1].datetime
+      );
+      res.setHeader('Content-Type', oemContentType(oemFormat));
+      res.write(formatOEMHeader(meta, oemFormat));
+      for (let i = 0; i < states.length; i += batchSize) {
+        res.write(formatOEMStates(states.slice(i, i + batchSize), oemFormat));
+      }
+      res.end(formatOEMFooter(oemFormat));
+      return;
+    }
+
     // Output txt format
     if (outputType === 'txt') {
       res.setHeader('Content-Type', 'text/plain; charset=utf-8');
@@ -444,7 +537,7 @@ app.get('/api/spice/sgp4/health', (_req: Request, res: Response) => {
  * Worker pool statistics endpoint
  */
 app.get('/api/spice/sgp4/pool/stats', (_req: Request, res: Response) => {
-  res.json(workerPool.stats);
+  res.json({ ...workerPool.stats, limiter: limiter.stats });
 });
 
 // =============================================================================
@@ -560,7 +653,8 @@ app.get('/api/models/wgs/:name', (req: Request, res: Response) => {
 // Error handling middleware
 app.use((err: Error, _req: Request, res: Response, _next: NextFunction) => {
   console.error('Error:', err.message);
-  res.status(500).json({ error: err.message });
+  // DeadlineError and other load-shedding errors carry their own status
+  res.status((err as { status?: number }).status || 500).json({ error: err.message });
 });
 
 const PORT = process.env.PORT || 3000;
@@ -22,6 +22,13 @@ import type {
   StateVector,
   GeophysicalConstants,
 } from './types.js';
+import type { PropagateState } from './worker-types.js';
+import type { PipelineOutput } from './pipeline.js';
+import type { EventOutput } from './events.js';
+import type { ScreenOutput } from './screen.js';
+import type { ElementColumns } from './worker-types.js';
+import type { ArchiveBuilderHandle, ArchiveInfo, ArchiveHandle, ArchiveSets } from './archive.js';
+import type { CatalogHandle } from './catalog.js';
 
 import path from 'path';
 import { fileURLToPath } from 'url';
@@ -38,8 +45,9 @@ interface NativeAddon {
     position: { x: number; y: number; z: number };
     velocity: { vx: number; vy: number; vz: number };
   };
+  propagator(elements: Float64Array): PropagatorHandle;
   propagateRange(
-    elements: Float64Array,
+    elements: Float64Array | PropagatorHandle,
     et0: number,
     etf: number,
     step: number
@@ -48,6 +56,67 @@ interface NativeAddon {
     position: { x: number; y: number; z: number };
     velocity: { vx: number; vy: number; vz: number };
   }>;
+  propagateRangePacked(
+    elements: Float64Array | PropagatorHandle,
+    et0: number,
+    etf: number,
+    step: number
+  ): Float64Array;
+  propagateRangePartials(
+    elements: Float64Array,
+    et0: number,
+    etf: number,
+    step: number
+  ): { packed: Float64Array; partials: Float64Array };
+  propagateBatchPacked(
+    elements: Float64Array | ElementColumns,
+    et0: number,
+    etf: number,
+    step: number
+  ): Float64Array;
+  temeToGcrf(packed: Float64Array): void;
+  formatEphemeris(
+    packed: Float64Array,
+    start: number,
+    count: number,
+    format: 'kvn' | 'xml'
+  ): string;
+  runPipeline(
+    elements: Float64Array | ElementColumns,
+    stages: Float64Array,
+    et0: number,
+    etf: number,
+    step: number,
+    maxRows: number
+  ): PipelineOutput;
+  findEvents(
+    elements: Float64Array | ElementColumns,
+    specs: Float64Array,
+    et0: number,
+    etf: number,
+    maxStep: number,
+    maxEvents: number
+  ): EventOutput;
+  screenEphemeris(
+    elements: Float64Array | ElementColumns,
+    ephemeris: Float64Array,
+    frame: number,
+    limits: Float64Array,
+    maxStep: number,
+    maxApproaches: number
+  ): ScreenOutput;
+  archiveBuilder(): ArchiveBuilderHandle;
+  archiveAdd(builder: ArchiveBuilderHandle, text: string): { added: number; skipped: number };
+  archiveWrite(
+    builder: ArchiveBuilderHandle,
+    path: string
+  ): { records: number; objects: number; bytes: number };
+  archiveOpen(path: string): ArchiveInfo;
+  archiveQuery(archive: ArchiveHandle, norads: Int32Array, et0: number, etf: number): ArchiveSets;
+  catalogIndex(elements: Float64Array | ElementColumns): CatalogHandle;
+  catalogValues(catalog: CatalogHandle): Float64Array;
+  catalogQuery(catalog: CatalogHandle, predicates: Float64Array): Int32Array;
+  setCompactCoefficients(enabled: boolean): void;
   utcToET(utc: string): number;
   etToUTC(et: number): string;
   setGeophysicalConstants(constants: GeophysicalConstants, modelName?: string): void;
@@ -171,6 +240,22 @@ export async function createNativeSGP4(): Promise<SGP4Module> {
       return native.etToUTC(et);
     },
 
+    utcToETArray(utcStrings: string[]): Float64Array {
+      if (!initialized) {
+        throw new Error('SGP4 module not initialized. Call init() first.');
+      }
+
+      return Float64Array.from(utcStrings, (utc) => native.utcToET(utc));
+    },
+
+    etGridToUTC(et0: number, step: number, n: number): string[] {
+      if (!initialized) {
+        throw new Error('SGP4 module not initialized. Call init() first.');
+      }
+
+      return Array.from({ length: n }, (_, i) => native.etToUTC(et0 + i * step));
+    },
+
     getLastError(): string {
       return native.getLastError();
     },
@@ -196,16 +281,31 @@ export async function createNativeSGP4(): Promise<SGP4Module> {
   };
 }
 
+/** Opaque handle to one satellite's initialized propagator */
+export type PropagatorHandle = { readonly __propagator: true };
+
+/** Parsed TLE with its propagator initialized for reuse across calls */
+export interface PreparedTLE extends TLEElements {
+  propagator: PropagatorHandle;
+}
+
 /**
  * Extended interface for native-specific features
  */
 export interface NativeSGP4Module extends SGP4Module {
+  /**
+   * Initialize a TLE's propagator once under the current geophysical
+   * model. propagateRange() and propagateRangePacked() then skip the
+   * per-call initialization; a model change needs a new one.
+   */
+  prepareTLE(tle: TLEElements): PreparedTLE;
+
   /**
    * Propagate over a time range in a single call.
    * More efficient than calling propagate() in a loop.
    */
   propagateRange(
-    tle: TLEElements,
+    tle: TLEElements | PreparedTLE,
     et0: number,
     etf: number,
     step: number
@@ -215,6 +315,160 @@ export interface NativeSGP4Module extends SGP4Module {
     velocity: { vx: number; vy: number; vz: number };
   }>;
 
+  /**
+   * Propagate over a time range into packed result buffers.
+   * Returns 7 SoA columns of n values each: et | x | y | z | vx | vy | vz.
+   */
+  propagateRangePacked(
+    tle: TLEElements | PreparedTLE,
+    et0: number,
+    etf: number,
+    step: number
+  ): Float64Array;
+
+  /**
+   * Propagate over a time range with state partials.
+   * `packed` is laid out as in propagateRangePacked(). `partials` holds
+   * 42 values per state: the row-major 6x7 Jacobian of (x, y, z, vx, vy, vz)
+   * w.r.t. (inclo, nodeo, ecco, argpo, mo, no, bstar), from forward-mode
+   * differentiation of the kernel.
+   */
+  propagateRangePartials(
+    tle: TLEElements,
+    et0: number,
+    etf: number,
+    step: number
+  ): { packed: Float64Array; partials: Float64Array };
+
+  /**
+   * Propagate several satellites over one time grid in a single
+   * multi-satellite sweep. `elements` holds 10 values per satellite, as in
+   * TLEElements.elements; the result holds one propagateRangePacked()
+   * block per satellite, back to back.
+   */
+  propagateBatchPacked(
+    elements: Float64Array | ElementColumns,
+    et0: number,
+    etf: number,
+    step: number
+  ): Float64Array;
+
+  /**
+   * Rotate a packed ephemeris from TEME to GCRF in place.
+   */
+  temeToGcrf(packed: Float64Array): void;
+
+  /**
+   * Serialize rows [start, start + count) of a packed ephemeris as
+   * CCSDS OEM data lines (KVN) or stateVector elements (XML).
+   */
+  formatEphemeris(
+    packed: Float64Array,
+    start: number,
+    count: number,
+    format: 'kvn' | 'xml'
+  ): string;
+
+  /**
+   * Run an encoded pipeline (see lib/pipeline.ts) over a batch of
+   * satellites. `elements` holds 10 values per satellite, as in
+   * TLEElements.elements, or is given as ElementColumns.
+   *
+   * @throws Error if the stages are invalid or out of order
+   */
+  runPipeline(
+    elements: Float64Array | ElementColumns,
+    stages: Float64Array,
+    et0: number,
+    etf: number,
+    step: number,
+    maxRows: number
+  ): PipelineOutput;
+
+  /**
+   * Find sign changes of encoded event functions (see lib/events.ts) for
+   * a batch of satellites in [et0, etf], sorted by satellite then time.
+   * `maxStep` caps the orbit-aware coarse step (seconds, 0 = no cap).
+   */
+  findEvents(
+    elements: Float64Array | ElementColumns,
+    specs: Float64Array,
+    et0: number,
+    etf: number,
+    maxStep: number,
+    maxEvents: number
+  ): EventOutput;
+
+  /**
+   * Screen a packed ephemeris (TEME = 0 or GCRF = 1) against a batch of
+   * satellites for close approaches within `limits` (see lib/screen.ts),
+   * sorted by satellite then time. `maxStep` caps the coarse step.
+   */
+  screenEphemeris(
+    elements: Float64Array | ElementColumns,
+    ephemeris: Float64Array,
+    frame: number,
+    limits: Float64Array,
+    maxStep: number,
+    maxApproaches: number
+  ): ScreenOutput;
+
+  /**
+   * Start collecting element sets for a history archive (lib/archive.ts).
+   */
+  archiveBuilder(): ArchiveBuilderHandle;
+
+  /**
+   * Add every TLE in a block of 2LE/3LE text to an archive builder.
+   * Malformed line pairs are counted as skipped.
+   */
+  archiveAdd(builder: ArchiveBuilderHandle, text: string): { added: number; skipped: number };
+
+  /**
+   * Sort, de-duplicate and write the collected element sets to `path`.
+   */
+  archiveWrite(
+    builder: ArchiveBuilderHandle,
+    path: string
+  ): { records: number; objects: number; bytes: number };
+
+  /**
+   * Open a history archive and load its epoch index.
+   */
+  archiveOpen(path: string): ArchiveInfo;
+
+  /**
+   * Load every element set of the given objects with epoch in [et0, etf]:
+   * 10 values per set as in TLEElements.elements, ready for the batch
+   * methods, with the NORAD ID of each set.
+   */
+  archiveQuery(archive: ArchiveHandle, norads: Int32Array, et0: number, etf: number): ArchiveSets;
+
+  /**
+   * Index the derived orbital parameters of a catalog (lib/catalog.ts),
+   * under the current geophysical constants.
+   */
+  catalogIndex(elements: Float64Array | ElementColumns): CatalogHandle;
+
+  /**
+   * Indexed parameters: one column of n values per parameter, in
+   * CATALOG_PARAMS order (NaN for invalid element sets).
+   */
+  catalogValues(catalog: CatalogHandle): Float64Array;
+
+  /**
+   * Indices of the element sets matching every (parameter, lo, hi) triple,
+   * ascending.
+   */
+  catalogQuery(catalog: CatalogHandle, predicates: Float64Array): Int32Array;
+
+  /**
+   * Use compact (quantized, 72 instead of 112 bytes per satellite) or full
+   * coefficient storage in the sweeps from now on; positions differ by a
+   * few cm at most. Applies to the whole process.
+   */
+  setCompactCoefficients(enabled: boolean): void;
+
   /**
    * Get the name of the SIMD implementation in use.
    */
@@ -270,8 +524,16 @@ export async function createExtendedNativeSGP4(): Promise<NativeSGP4Module> {
       return native.propagate(tle.elements, et);
     },
 
+    prepareTLE(tle: TLEElements): PreparedTLE {
+      if (!initialized) {
+        throw new Error('SGP4 module not initialized. Call init() first.');
+      }
+
+      return { ...tle, propagator: native.propagator(tle.elements) };
+    },
+
     propagateRange(
-      tle: TLEElements,
+      tle: TLEElements | PreparedTLE,
       et0: number,
       etf: number,
       step: number
@@ -284,7 +546,139 @@ export async function createExtendedNativeSGP4(): Promise<NativeSGP4Module> {
         throw new Error('SGP4 module not initialized. Call init() first.');
       }
 
-      return native.propagateRange(tle.elements, et0, etf, step);
+      return native.propagateRange('propagator' in tle ? tle.propagator : tle.elements, et0, etf, step);
+    },
+
+    propagateRangePacked(
+      tle: TLEElements | PreparedTLE,
+      et0: number,
+      etf: number,
+      step: number
+    ): Float64Array {
+      if (!initialized) {
+        throw new Error('SGP4 module not initialized. Call init() first.');
+      }
+
+      return native.propagateRangePacked('propagator' in tle ? tle.propagator : tle.elements, et0, etf, step);
+    },
+
+    propagateRangePartials(
+      tle: TLEElements,
+      et0: number,
+      etf: number,
+      step: number
+    ): { packed: Float64Array; partials: Float64Array } {
+      if (!initialized) {
+        throw new Error('SGP4 module not initialized. Call init() first.');
+      }
+
+      return native.propagateRangePartials(tle.elements, et0, etf, step);
+    },
+
+    propagateBatchPacked(
+      elements: Float64Array | ElementColumns,
+      et0: number,
+      etf: number,
+      step: number
+    ): Float64Array {
+      if (!initialized) {
+        throw new Error('SGP4 module not initialized. Call init() first.');
+      }
+
+      return native.propagateBatchPacked(elements, et0, etf, step);
+    },
+
+    temeToGcrf(packed: Float64Array): void {
+      native.temeToGcrf(packed);
+    },
+
+    formatEphemeris(
+      packed: Float64Array,
+      start: number,
+      count: number,
+      format: 'kvn' | 'xml'
+    ): string {
+      return native.formatEphemeris(packed, start, count, format);
+    },
+
+    runPipeline(
+      elements: Float64Array | ElementColumns,
+      stages: Float64Array,
+      et0: number,
+      etf: number,
+      step: number,
+      maxRows: number
+    ): PipelineOutput {
+      if (!initialized) {
+        throw new Error('SGP4 module not initialized. Call init() first.');
+      }
+
+      return native.runPipeline(elements, stages, et0, etf, step, maxRows);
+    },
+
+    findEvents(
+      elements: Float64Array | ElementColumns,
+      specs: Float64Array,
+      et0: number,
+      etf: number,
+      maxStep: number,
+      maxEvents: number
+    ): EventOutput {
+      if (!initialized) {
+        throw new Error('SGP4 module not initialized. Call init() first.');
+      }
+
+      return native.findEvents(elements, specs, et0, etf, maxStep, maxEvents);
+    },
+
+    screenEphemeris(
+      elements: Float64Array | ElementColumns,
+      ephemeris: Float64Array,
+      frame: number,
+      limits: Float64Array,
+      maxStep: number,
+      maxApproaches: number
+    ): ScreenOutput {
+      if (!initialized) {
+        throw new Error('SGP4 module not initialized. Call init() first.');
+      }
+
+      return native.screenEphemeris(elements, ephemeris, frame, limits, maxStep, maxApproaches);
+    },
+
+    archiveBuilder(): ArchiveBuilderHandle {
+      return native.archiveBuilder();
+    },
+
+    archiveAdd(builder: ArchiveBuilderHandle, text: string): { added: number; skipped: number } {
+      return native.archiveAdd(builder, text);
+    },
+
+    archiveWrite(
+      builder: ArchiveBuilderHandle,
+      path: string
+    ): { records: number; objects: number; bytes: number } {
+      return native.archiveWrite(builder, path);
+    },
+
+    archiveOpen(path: string): ArchiveInfo {
+      return native.archiveOpen(path);
+    },
+
+    archiveQuery(archive: ArchiveHandle, norads: Int32Array, et0: number, etf: number): ArchiveSets {
+      return native.archiveQuery(archive, norads, et0, etf);
+    },
+
+    catalogIndex(elements: Float64Array | ElementColumns): CatalogHandle {
+      return native.catalogIndex(elements);
+    },
+
+    catalogValues(catalog: CatalogHandle): Float64Array {
+      return native.catalogValues(catalog);
+    },
+
+    catalogQuery(catalog: CatalogHandle, predicates: Float64Array): Int32Array {
+      return native.catalogQuery(catalog, predicates);
     },
 
     utcToET(utcString: string): number {
@@ -303,6 +697,22 @@ export async function createExtendedNativeSGP4(): Promise<NativeSGP4Module> {
       return native.etToUTC(et);
     },
 
+    utcToETArray(utcStrings: string[]): Float64Array {
+      if (!initialized) {
+        throw new Error('SGP4 module not initialized. Call init() first.');
+      }
+
+      return Float64Array.from(utcStrings, (utc) => native.utcToET(utc));
+    },
+
+    etGridToUTC(et0: number, step: number, n: number): string[] {
+      if (!initialized) {
+        throw new Error('SGP4 module not initialized. Call init() first.');
+      }
+
+      return Array.from({ length: n }, (_, i) => native.etToUTC(et0 + i * step));
+    },
+
     getLastError(): string {
       return native.getLastError();
     },
@@ -326,8 +736,47 @@ export async function createExtendedNativeSGP4(): Promise<NativeSGP4Module> {
       return native.getModelName();
     },
 
+    setCompactCoefficients(enabled: boolean): void {
+      native.setCompactCoefficients(enabled);
+    },
+
     getSimdName(): string {
       return native.getSimdName();
     },
   };
 }
+
+/**
+ * Convert a packed ephemeris (and optional flat 6x7 partials per state)
+ * into state objects.
+ */
+export function packedToStates(
+  sgp4: NativeSGP4Module,
+  packed: Float64Array,
+  partials?: Float64Array
+): PropagateState[] {
+  const n = packed.length / 7;
+  const states: PropagateState[] = new Array(n);
+
+  for (let i = 0; i < n; i++) {
+    const et = packed[i];
+    const state: PropagateState = {
+      datetime: sgp4.etToUTC(et),
+      et,
+      position: [packed[n + i], packed[2 * n + i], packed[3 * n + i]],
+      velocity: [packed[4 * n + i], packed[5 * n + i], packed[6 * n + i]],
+    };
+
+    if (partials) {
+      const rows: number[][] = [];
+      for (let r = 0; r < 6; r++) {
+        rows.push(Array.from(partials.subarray(i * 42 + r * 7, i * 42 + r * 7 + 7)));
+      }
+      state.partials = rows;
+    }
+
+    states[i] = state;
+  }
+
+  return states;
+}
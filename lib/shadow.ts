@@ -0,0 +1,260 @@
+/**
+ * Shadow-Mode Engine Comparison
+ *
+ * Before an orbit class is trusted to the native engine, its results should
+ * be shown to agree with CSPICE on the catalog actually served. With
+ * SGP4_SHADOW_RATE > 0 the native server re-runs that fraction of range
+ * propagations on the other engine (native results against CSPICE, CSPICE
+ * results against native) after the response has been sent:
+ *
+ * - off the response path, as `bulk` QoS work of tenant `shadow`, with at
+ *   most SGP4_SHADOW_MAX_INFLIGHT comparisons running (further samples are
+ *   skipped, not queued)
+ * - at most SHADOW_MAX_POINTS states per comparison, taken evenly from the
+ *   served time grid; a reference state at another ET fails the comparison
+ *   rather than being recorded as a difference
+ *
+ * The largest position and velocity differences of each comparison go into
+ * decade histograms by orbit regime, and the worst cases are kept (and
+ * logged) with their inputs, so they can be replayed.
+ */
+
+import { schedulingContext } from './scheduler.js';
+import type { Engine, EngineRouter } from './engine.js';
+import type { SGP4NativeWorkerPool } from './worker-pool-native.js';
+import { statesToPacked } from './engine.js';
+import type { PropagateState } from './worker-types.js';
+
+/** States compared per sample at most */
+const SHADOW_MAX_POINTS = 1000;
+
+/** Largest ET difference (s) between paired served and reference states */
+const SHADOW_MAX_TIME_DIFF = 1e-3;
+
+/** Worst cases kept */
+const WORST_CASES = 10;
+
+/** Histogram bucket upper bounds: decades from 1 mm (or mm/s) to 1000 km */
+const BUCKET_BOUNDS = [1e-6, 1e-5, 1e-4, 1e-3, 1e-2, 1e-1, 1, 10, 100, 1000, Infinity];
+
+export const ORBIT_REGIMES = ['LEO', 'MEO', 'GEO', 'HEO', 'deep'] as const;
+
+export type OrbitRegime = (typeof ORBIT_REGIMES)[number];
+
+/**
+ * Orbit regime of a satellite from its element row (ecco at 5, mean motion
+ * in rad/min at 8)
+ */
+export function orbitRegime(elements: ArrayLike<number>): OrbitRegime {
+  const ecco = elements[5];
+  const periodMin = (2 * Math.PI) / elements[8];
+  if (ecco >= 0.25) {
+    return 'HEO';
+  }
+  if (periodMin < 128) {
+    return 'LEO';
+  }
+  if (periodMin >= 1400 && periodMin <= 1500) {
+    return 'GEO';
+  }
+  return periodMin < 1400 ? 'MEO' : 'deep';
+}
+
+/** Difference distribution of one regime */
+export interface RegimeStats {
+  samples: number;
+  /** Counts per bucket of the max position difference (km) */
+  positionKm: number[];
+  /** Counts per bucket of the max velocity difference (km/s) */
+  velocityKmS: number[];
+  maxPositionKm: number;
+  maxVelocityKmS: number;
+}
+
+/** One comparison, with the inputs to reproduce it */
+export interface ShadowCase {
+  line1: string;
+  line2: string;
+  model: string;
+  et0: number;
+  etf: number;
+  step: number;
+  regime: OrbitRegime;
+  /** Engine that served the request, and the reference it was checked against */
+  primary: Engine;
+  reference: Engine;
+  positionKm: number;
+  velocityKmS: number;
+  /** ET of the largest position difference */
+  worstEt: number;
+}
+
+/** A propagation served to a client, offered for comparison */
+export interface ShadowSample {
+  tle: { line1: string; line2: string };
+  elements: ArrayLike<number>;
+  times: { et0: number; etf: number; step: number };
+  model: string;
+  engine: Engine;
+  /** Served states, as packed columns or state objects */
+  packed?: Float64Array;
+  states?: PropagateState[];
+}
+
+/**
+ * Shadow comparator for the native server
+ */
+export class ShadowComparator {
+  readonly rate: number;
+  readonly maxInFlight: number;
+  private router: EngineRouter;
+  private nativePool: SGP4NativeWorkerPool;
+  private inFlight = 0;
+  private skipped = 0;
+  private failed = 0;
+  private regimes = new Map<OrbitRegime, RegimeStats>();
+  private worst: ShadowCase[] = [];
+
+  constructor(router: EngineRouter, nativePool: SGP4NativeWorkerPool) {
+    this.router = router;
+    this.nativePool = nativePool;
+    this.rate = Math.min(1, parseFloat(process.env.SGP4_SHADOW_RATE || '') || 0);
+    this.maxInFlight = parseInt(process.env.SGP4_SHADOW_MAX_INFLIGHT || '', 10) || 4;
+  }
+
+  /**
+   * Sample a served propagation and, if picked, compare it against the
+   * other engine in the background. Never throws or delays the caller.
+   */
+  offer(sample: ShadowSample): void {
+    if (this.rate <= 0 || !this.router.stats.cspiceAvailable || Math.random() >= this.rate) {
+      return;
+    }
+    if (this.inFlight >= this.maxInFlight) {
+      this.skipped++;
+      return;
+    }
+
+    this.inFlight++;
+    setImmediate(() =>
+      schedulingContext
+        .run({ qos: 'bulk', tenant: 'shadow' }, () => this.compare(sample))
+        .catch(() => this.failed++)
+        .finally(() => this.inFlight--)
+    );
+  }
+
+  private async compare(sample: ShadowSample): Promise<void> {
+    const served = sample.packed ?? statesToPacked(sample.states!);
+    const n = served.length / 7;
+    if (n === 0) {
+      return;
+    }
+
+    // Every stride-th served state, at most SHADOW_MAX_POINTS of them, on
+    // the served ET grid (both engines return native ET, see EngineRouter)
+    const stride = Math.ceil(n / SHADOW_MAX_POINTS);
+    const m = Math.ceil(n / stride);
+    const times = {
+      et0: served[0],
+      etf: served[0] + (m - 1) * stride * sample.times.step,
+      step: stride * sample.times.step,
+    };
+
+    const reference: Engine = sample.engine === 'native' ? 'cspice' : 'native';
+    const task = { tle: sample.tle, times, model: sample.model };
+    const result =
+      reference === 'cspice'
+        ? await this.router.propagate(task)
+        : await this.nativePool.propagate({ ...task, packed: true });
+    const ref = result.packed ?? statesToPacked(result.states);
+    const k = Math.min(m, ref.length / 7);
+
+    let dr = 0;
+    let dv = 0;
+    let worstEt = times.et0;
+    for (let i = 0; i < k; i++) {
+      const s = i * stride;
+      if (Math.abs(served[s] - ref[i]) > SHADOW_MAX_TIME_DIFF) {
+        throw new Error(`Shadow grids differ at state ${s}: ET ${served[s]} vs ${ref[i]}`);
+      }
+      let r2 = 0;
+      let v2 = 0;
+      for (let c = 0; c < 3; c++) {
+        r2 += (served[(1 + c) * n + s] - ref[(1 + c) * k + i]) ** 2;
+        v2 += (served[(4 + c) * n + s] - ref[(4 + c) * k + i]) ** 2;
+      }
+      if (Math.sqrt(r2) > dr) {
+        dr = Math.sqrt(r2);
+        worstEt = ref[i];
+      }
+      dv = Math.max(dv, Math.sqrt(v2));
+    }
+
+    this.record({
+      ...sample.tle,
+      model: sample.model,
+      ...sample.times,
+      regime: orbitRegime(sample.elements),
+      primary: sample.engine,
+      reference,
+      positionKm: dr,
+      velocityKmS: dv,
+      worstEt,
+    });
+  }
+
+  private record(c: ShadowCase): void {
+    let stats = this.regimes.get(c.regime);
+    if (!stats) {
+      stats = {
+        samples: 0,
+        positionKm: BUCKET_BOUNDS.map(() => 0),
+        velocityKmS: BUCKET_BOUNDS.map(() => 0),
+        maxPositionKm: 0,
+        maxVelocityKmS: 0,
+      };
+      this.regimes.set(c.regime, stats);
+    }
+    stats.samples++;
+    stats.positionKm[BUCKET_BOUNDS.findIndex((b) => c.positionKm < b)]++;
+    stats.velocityKmS[BUCKET_BOUNDS.findIndex((b) => c.velocityKmS < b)]++;
+    stats.maxPositionKm = Math.max(stats.maxPositionKm, c.positionKm);
+    stats.maxVelocityKmS = Math.max(stats.maxVelocityKmS, c.velocityKmS);
+
+    if (this.worst.length < WORST_CASES || c.positionKm > this.worst[this.worst.length - 1].positionKm) {
+      this.worst.push(c);
+      this.worst.sort((a, b) => b.positionKm - a.positionKm);
+      this.worst.length = Math.min(this.worst.length, WORST_CASES);
+      console.warn(
+        `Shadow ${c.primary} vs ${c.reference} (${c.regime}): ${c.positionKm.toExponential(3)} km, ` +
+          `${c.velocityKmS.toExponential(3)} km/s at ET ${c.worstEt} for ${JSON.stringify({
+            line1: c.line1,
+            line2: c.line2,
+            model: c.model,
+          })}`
+      );
+    }
+  }
+
+  get stats(): {
+    rate: number;
+    inFlight: number;
+    skipped: number;
+    failed: number;
+    /** Upper bounds of the histogram buckets (km or km/s); one more bucket holds the rest */
+    buckets: number[];
+    regimes: Partial<Record<OrbitRegime, RegimeStats>>;
+    worst: ShadowCase[];
+  } {
+    return {
+      rate: this.rate,
+      inFlight: this.inFlight,
+      skipped: this.skipped,
+      failed: this.failed,
+      buckets: BUCKET_BOUNDS.slice(0, -1),
+      regimes: Object.fromEntries(this.regimes),
+      worst: [...this.worst],
+    };
+  }
+}
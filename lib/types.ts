@@ -201,6 +201,26 @@ export interface SGP4Module {
    */
   etToUTC(et: number): string;
 
+  /**
+   * Convert many UTC time strings to ephemeris times in one call.
+   *
+   * @param utcStrings - UTC time strings (formats as for utcToET)
+   * @returns Ephemeris times, in input order
+   * @throws Error naming the first string that fails to convert
+   */
+  utcToETArray(utcStrings: string[]): Float64Array;
+
+  /**
+   * Format the ET grid et0 + i * step (i < n) as UTC strings in one call.
+   *
+   * @param et0 - First ephemeris time (seconds past J2000 TDB)
+   * @param step - Grid step in seconds
+   * @param n - Number of times
+   * @returns UTC time strings in ISO format, as from etToUTC
+   * @throws Error if conversion fails
+   */
+  etGridToUTC(et0: number, step: number, n: number): string[];
+
   /**
    * Get the last error message from CSPICE.
    *
@@ -256,7 +276,7 @@ export interface EmscriptenModule {
   ): (...args: unknown[]) => unknown;
   getValue(ptr: number, type: string): number;
   setValue(ptr: number, value: number, type: string): void;
-  UTF8ToString(ptr: number): string;
+  UTF8ToString(ptr: number, maxBytesToRead?: number): string;
   stringToUTF8(str: string, ptr: number, maxLen: number): void;
   lengthBytesUTF8(str: string): number;
   HEAPF64: Float64Array;
@@ -6,18 +6,29 @@
  */
 
 import { parentPort } from 'worker_threads';
-import { createExtendedNativeSGP4, type NativeSGP4Module } from './sgp4-native.js';
+import { createExtendedNativeSGP4, type NativeSGP4Module, type PreparedTLE } from './sgp4-native.js';
 import { getWgsConstants } from './models.js';
 import type { WorkerTask, WorkerMessage, PropagateState } from './worker-types.js';
+import { packedToStates } from './sgp4-native.js';
+import { runPipeline } from './pipeline.js';
+import { findEvents } from './events.js';
+import { screenEphemeris } from './screen.js';
+import { TLECache } from './affinity.js';
 
 let sgp4: NativeSGP4Module;
 
+/** Initialized propagators of recent TLEs; hit rates rise with affinity routing */
+let propagators: TLECache<PreparedTLE>;
+
 /**
  * Initialize the native SGP4 module for this worker
  */
 async function initialize(): Promise<void> {
   sgp4 = await createExtendedNativeSGP4();
   await sgp4.init();
+  // Quantized propagation coefficients for large batches (a few cm of error)
+  sgp4.setCompactCoefficients(process.env.SGP4_COMPACT_COEFFS === '1');
+  propagators = new TLECache((line1, line2) => sgp4.prepareTLE(sgp4.parseTLE(line1, line2)));
 
   // Log SIMD implementation in use
   console.log(`Native worker initialized with ${sgp4.getSimdName()}`);
@@ -42,12 +53,47 @@ parentPort?.on('message', async (task: WorkerTask) => {
         sgp4.setGeophysicalConstants(constants, task.model);
       }
 
-      // Parse TLE
-      const tle = sgp4.parseTLE(task.tle.line1, task.tle.line2);
+      // Parsed TLE with its propagator, cached per model
+      const tle = propagators.get(task.tle, task.model);
 
       // Propagate over the time range using batch function
       const { et0, etf, step } = task.times;
 
+      // Packed output: hand the result buffers back without per-state objects
+      if (task.packed) {
+        const packed = sgp4.propagateRangePacked(tle, et0, etf, step);
+        if (task.frame === 'GCRF') {
+          sgp4.temeToGcrf(packed);
+        }
+
+        parentPort?.postMessage(
+          {
+            type: 'propagate-result',
+            taskId: task.taskId,
+            states: [],
+            packed,
+            epoch: tle.epoch,
+            model: task.model,
+          } as WorkerMessage,
+          [packed.buffer]
+        );
+        return;
+      }
+
+      // States with partials from the differentiated kernel
+      if (task.partials) {
+        const { packed, partials } = sgp4.propagateRangePartials(tle, et0, etf, step);
+
+        parentPort?.postMessage({
+          type: 'propagate-result',
+          taskId: task.taskId,
+          states: packedToStates(sgp4, packed, partials),
+          epoch: tle.epoch,
+          model: task.model,
+        } as WorkerMessage);
+        return;
+      }
+
       // Use native batch propagation for efficiency
       const rawStates = sgp4.propagateRange(tle, et0, etf, step);
 
@@ -75,6 +121,99 @@ parentPort?.on('message', async (task: WorkerTask) => {
         model: task.model,
       } as WorkerMessage);
     }
+
+    if (task.type === 'propagate-batch') {
+      const constants = getWgsConstants(task.model);
+      if (constants) {
+        sgp4.setGeophysicalConstants(constants, task.model);
+      }
+
+      // One multi-satellite sweep over the shared grid, split per TLE
+      const tles = task.tles.map((t) => sgp4.parseTLE(t.line1, t.line2));
+      const elements = new Float64Array(tles.length * 10);
+      tles.forEach((tle, i) => elements.set(tle.elements, i * 10));
+
+      const { et0, etf, step } = task.times;
+      const all = sgp4.propagateBatchPacked(elements, et0, etf, step);
+      const size = all.length / tles.length;
+
+      const transfer: ArrayBuffer[] = [];
+      const results = tles.map((tle, i) => {
+        const packed = all.slice(i * size, (i + 1) * size);
+        if (!task.packed) {
+          return { states: packedToStates(sgp4, packed), epoch: tle.epoch };
+        }
+        if (task.frame === 'GCRF') {
+          sgp4.temeToGcrf(packed);
+        }
+        transfer.push(packed.buffer);
+        return { states: [], packed, epoch: tle.epoch };
+      });
+
+      parentPort?.postMessage(
+        {
+          type: 'propagate-batch-result',
+          taskId: task.taskId,
+          results,
+          model: task.model,
+        } as WorkerMessage,
+        transfer
+      );
+    }
+
+    if (task.type === 'pipeline') {
+      const constants = getWgsConstants(task.model);
+      if (constants) {
+        sgp4.setGeophysicalConstants(constants, task.model);
+      }
+
+      const out = runPipeline(sgp4, task.tles, task.stages, task.times, task.maxRows);
+
+      parentPort?.postMessage(
+        {
+          type: 'pipeline-result',
+          taskId: task.taskId,
+          ...out,
+        } as WorkerMessage,
+        [out.reduce.buffer, out.rows.buffer, out.rowSat.buffer]
+      );
+    }
+
+    if (task.type === 'events') {
+      const constants = getWgsConstants(task.model);
+      if (constants) {
+        sgp4.setGeophysicalConstants(constants, task.model);
+      }
+
+      const out = findEvents(sgp4, task.tles, task.specs, task.window, task.maxStep, task.maxEvents);
+
+      parentPort?.postMessage(
+        {
+          type: 'events-result',
+          taskId: task.taskId,
+          ...out,
+        } as WorkerMessage,
+        [out.et.buffer, out.sat.buffer, out.spec.buffer, out.direction.buffer]
+      );
+    }
+
+    if (task.type === 'screen') {
+      const constants = getWgsConstants(task.model);
+      if (constants) {
+        sgp4.setGeophysicalConstants(constants, task.model);
+      }
+
+      const out = screenEphemeris(sgp4, task.tles, task.ephemeris, task.limits, task.maxStep, task.maxApproaches);
+
+      parentPort?.postMessage(
+        {
+          type: 'screen-result',
+          taskId: task.taskId,
+          ...out,
+        } as WorkerMessage,
+        [out.tca.buffer, out.sat.buffer, out.distance.buffer, out.speed.buffer, out.ric.buffer]
+      );
+    }
   } catch (err) {
     parentPort?.postMessage({
       type: 'error',
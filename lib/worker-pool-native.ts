@@ -2,7 +2,8 @@
  * SGP4 Native Worker Pool Manager
  *
  * Manages a pool of worker threads using native SIMD SGP4 addon.
- * Same interface as the WASM worker pool for easy comparison.
+ * Same interface (and elastic sizing) as the WASM worker pool for easy
+ * comparison.
  */
 
 import { Worker } from 'worker_threads';
@@ -15,7 +16,26 @@ import type {
   WorkerMessage,
   PropagateTask,
   PropagateResult,
+  PropagateBatchTask,
+  PropagateBatchResult,
+  PipelineTask,
+  PipelineResult,
+  EventsTask,
+  EventsResult,
+  ScreenTask,
+  ScreenResult,
 } from './worker-types.js';
+import {
+  TaskScheduler,
+  currentContext,
+  rangePoints,
+  schedulingContext,
+  type Schedule,
+  type SchedulerStats,
+  type SchedulingContext,
+} from './scheduler.js';
+import { ElasticSizing, RESIZE_INTERVAL_MS, type ElasticStats } from './elastic.js';
+import { AffinityRouter, affinityKey, type AffinityStats } from './affinity.js';
 
 const __filename = fileURLToPath(import.meta.url);
 const __dirname = dirname(__filename);
@@ -49,27 +69,86 @@ interface PoolWorker {
   worker: Worker;
   busy: boolean;
   id: number;
+  /** Initialized and accepting tasks */
+  ready: boolean;
+  idleSince: number;
 }
 
 /**
  * Pending task with its promise callbacks
  */
 interface PendingTask {
-  task: PropagateTask;
-  resolve: (result: PropagateResult) => void;
+  task: PoolTask;
+  resolve: (result: PoolResult) => void;
   reject: (error: Error) => void;
+  schedule?: Schedule;
+}
+
+type PoolTask = PropagateTask | PropagateBatchTask | PipelineTask | EventsTask | ScreenTask;
+type PoolResult = PropagateResult | PropagateBatchResult | PipelineResult | EventsResult | ScreenResult;
+
+/**
+ * Scheduling cost of a task in points (satellites x time steps)
+ */
+function taskPoints(task: PoolTask): number {
+  switch (task.type) {
+    case 'propagate':
+      return rangePoints(task.times);
+    case 'propagate-batch':
+      return task.tles.length * rangePoints(task.times);
+    case 'pipeline':
+    case 'events': {
+      const sats = Array.isArray(task.tles) ? task.tles.length : task.tles.columns.length / 10;
+      const times = task.type === 'pipeline' ? task.times : { ...task.window, step: 60 };
+      return sats * rangePoints(times);
+    }
+    case 'screen': {
+      const sats = Array.isArray(task.tles) ? task.tles.length : task.tles.columns.length / 10;
+      const n = task.ephemeris.packed.length / 7;
+      return sats * rangePoints({ et0: task.ephemeris.packed[0], etf: task.ephemeris.packed[n - 1], step: 60 });
+    }
+  }
+}
+
+/**
+ * Range propagations sharing a time grid and model, waiting out the
+ * coalescing window to be run as one multi-satellite batch
+ */
+interface CoalesceGroup {
+  task: Omit<PropagateTask, 'type' | 'taskId' | 'tle'>;
+  members: Array<{
+    tle: { line1: string; line2: string };
+    /** Scheduling context of the member's request */
+    context: SchedulingContext;
+    resolve: (result: PropagateResult) => void;
+    reject: (error: Error) => void;
+  }>;
+  timer: NodeJS.Timeout;
 }
 
 /**
  * Pool statistics
  */
 export interface PoolStats {
+  /** Workers ready for tasks (the current size of an elastic pool) */
   poolSize: number;
   busyWorkers: number;
   availableWorkers: number;
   queueLength: number;
   pendingTasks: number;
   implementation: string;
+  /** Range tasks currently waiting in a coalescing window */
+  coalescingTasks: number;
+  /** Multi-satellite batches run from coalesced range tasks */
+  coalescedBatches: number;
+  /** Range tasks served by those batches */
+  coalescedTasks: number;
+  /** QoS classes, fair queuing and deadlines (see scheduler.ts) */
+  scheduler: SchedulerStats;
+  /** Size bounds, warm spares and scaling events (see elastic.ts) */
+  elastic: ElasticStats;
+  /** Satellite-to-worker routing (see affinity.ts) */
+  affinity: AffinityStats;
 }
 
 /**
@@ -80,20 +159,37 @@ export interface PoolStats {
  */
 export class SGP4NativeWorkerPool {
   private workers: PoolWorker[] = [];
-  private taskQueue: PendingTask[] = [];
+  private taskQueue = new TaskScheduler<PendingTask>();
   private pendingTasks = new Map<string, PendingTask>();
   private initialized = false;
-  private poolSize: number;
+  private sizing: ElasticSizing;
+  private nextWorkerId = 0;
+  private resizeTimer?: NodeJS.Timeout;
+  private router = new AffinityRouter();
+  private coalesceWindowMs: number;
+  private coalesceMax: number;
+  private groups = new Map<string, CoalesceGroup>();
+  /** Range tasks and batches submitted and not yet settled, per coalescing key */
+  private inFlight = new Map<string, number>();
+  private coalescedBatches = 0;
+  private coalescedTasks = 0;
 
   /**
    * Create a new native worker pool
-   * @param poolSize - Number of workers (defaults to CPU core count)
+   * @param poolSize - Number of workers (defaults to CPU core count); the
+   *                   initial size when SGP4_POOL_MIN/MAX make it elastic
    */
   constructor(poolSize?: number) {
-    this.poolSize =
+    this.sizing = new ElasticSizing(
       poolSize ||
-      parseInt(process.env.SGP4_POOL_SIZE || '', 10) ||
-      cpus().length;
+        parseInt(process.env.SGP4_POOL_SIZE || '', 10) ||
+        cpus().length
+    );
+
+    // Range propagation coalescing: window in ms (0 disables) and batch cap
+    const windowMs = parseFloat(process.env.SGP4_COALESCE_MS || '');
+    this.coalesceWindowMs = Number.isFinite(windowMs) && windowMs >= 0 ? windowMs : 1;
+    this.coalesceMax = parseInt(process.env.SGP4_COALESCE_MAX || '', 10) || 64;
   }
 
   /**
@@ -106,8 +202,30 @@ export class SGP4NativeWorkerPool {
       return;
     }
 
-    const workerPath = getWorkerPath();
     const initPromises: Promise<void>[] = [];
+    for (let i = 0; i < this.sizing.initialSize; i++) {
+      initPromises.push(this.spawnWorker());
+    }
+
+    await Promise.all(initPromises);
+    this.initialized = true;
+    if (this.sizing.enabled) {
+      this.resizeTimer = setInterval(() => this.resize(), RESIZE_INTERVAL_MS);
+      this.resizeTimer.unref();
+    }
+    console.log(
+      `SGP4 native worker pool initialized with ${this.sizing.initialSize} workers` +
+        (this.sizing.enabled ? ` (elastic ${this.sizing.minSize}-${this.sizing.maxSize})` : '')
+    );
+  }
+
+  /**
+   * Start a worker and add it to the pool
+   *
+   * @returns Promise that resolves once the worker is ready for tasks
+   */
+  private spawnWorker(): Promise<void> {
+    const workerPath = getWorkerPath();
 
     // For .ts files, we need tsx to execute the worker
     // Use --import for Node 18.19+ or --loader for older versions
@@ -117,56 +235,90 @@ export class SGP4NativeWorkerPool {
       nodeVersion >= 20 ? ['--import', 'tsx'] : ['--loader', 'tsx'];
     const workerOptions = isTsFile ? { execArgv: tsxFlag } : undefined;
 
-    for (let i = 0; i < this.poolSize; i++) {
-      const worker = new Worker(workerPath, workerOptions);
-      const poolWorker: PoolWorker = { worker, busy: false, id: i };
-
-      // Wait for worker to signal ready
-      const initPromise = new Promise<void>((resolve, reject) => {
-        const timeout = setTimeout(() => {
-          reject(new Error(`Native worker ${i} initialization timed out`));
-        }, 30000); // 30 second timeout
-
-        const messageHandler = (msg: WorkerMessage) => {
-          if (msg.type === 'ready') {
-            clearTimeout(timeout);
-            worker.off('message', messageHandler);
-            resolve();
-          }
-        };
+    const id = this.nextWorkerId++;
+    const worker = new Worker(workerPath, workerOptions);
+    const poolWorker: PoolWorker = { worker, busy: false, id, ready: false, idleSince: 0 };
+
+    // Wait for worker to signal ready
+    const initPromise = new Promise<void>((resolve, reject) => {
+      const timeout = setTimeout(() => {
+        reject(new Error(`Native worker ${id} initialization timed out`));
+      }, 30000); // 30 second timeout
 
-        worker.on('message', messageHandler);
-        worker.once('error', (err) => {
+      const messageHandler = (msg: WorkerMessage) => {
+        if (msg.type === 'ready') {
           clearTimeout(timeout);
-          reject(err);
-        });
-      });
+          worker.off('message', messageHandler);
+          poolWorker.ready = true;
+          poolWorker.idleSince = performance.now();
+          resolve();
+        }
+      };
 
-      // Set up permanent message handler
-      worker.on('message', (msg: WorkerMessage) => {
-        this.handleMessage(poolWorker, msg);
+      worker.on('message', messageHandler);
+      worker.once('error', (err) => {
+        clearTimeout(timeout);
+        reject(err);
       });
+    });
 
-      worker.on('error', (err) => {
-        console.error(`Native worker ${i} error:`, err);
-        this.handleWorkerError(poolWorker, err);
-      });
+    // Set up permanent message handler
+    worker.on('message', (msg: WorkerMessage) => {
+      this.handleMessage(poolWorker, msg);
+    });
 
-      worker.on('exit', (code) => {
-        if (code !== 0) {
-          console.error(`Native worker ${i} exited with code ${code}`);
+    worker.on('error', (err) => {
+      console.error(`Native worker ${id} error:`, err);
+      this.handleWorkerError(poolWorker, err);
+    });
+
+    worker.on('exit', (code) => {
+      // Retired workers have already left the pool
+      if (code !== 0 && this.workers.includes(poolWorker)) {
+        console.error(`Native worker ${id} exited with code ${code}`);
+        this.workers = this.workers.filter((w) => w !== poolWorker);
+      }
+    });
+
+    this.workers.push(poolWorker);
+    return initPromise;
+  }
+
+  /**
+   * One elastic sizing step: start workers in the background (queued tasks
+   * keep going to ready ones) or retire a worker idle for too long
+   */
+  private resize(): void {
+    const plan = this.sizing.plan(this.workers, this.taskQueue.length, this.taskQueue.oldestWaitMs());
+
+    for (let i = 0; i < plan.start; i++) {
+      const starting = this.spawnWorker();
+      const poolWorker = this.workers[this.workers.length - 1];
+      starting.then(
+        () => this.processQueue(),
+        (err) => {
+          console.error(`Native worker ${poolWorker.id} failed to start:`, err);
+          this.retire(poolWorker);
         }
-      });
+      );
+    }
+    if (plan.start > 0) {
+      this.sizing.record('up', plan.start, this.workers.length, plan.reason);
+    }
 
-      this.workers.push(poolWorker);
-      initPromises.push(initPromise);
+    for (const poolWorker of plan.retire) {
+      const idleSeconds = Math.round((performance.now() - poolWorker.idleSince) / 1000);
+      this.retire(poolWorker);
+      this.sizing.record('down', 1, this.workers.length, `idle ${idleSeconds} s`);
     }
+  }
 
-    await Promise.all(initPromises);
-    this.initialized = true;
-    console.log(
-      `SGP4 native worker pool initialized with ${this.poolSize} workers`
-    );
+  /**
+   * Remove an idle worker from the pool and terminate it
+   */
+  private retire(poolWorker: PoolWorker): void {
+    this.workers = this.workers.filter((w) => w !== poolWorker);
+    poolWorker.worker.terminate();
   }
 
   /**
@@ -178,7 +330,11 @@ export class SGP4NativeWorkerPool {
     }
 
     const taskId =
-      msg.type === 'propagate-result'
+      msg.type === 'propagate-result' ||
+      msg.type === 'propagate-batch-result' ||
+      msg.type === 'pipeline-result' ||
+      msg.type === 'events-result' ||
+      msg.type === 'screen-result'
         ? msg.taskId
         : msg.type === 'error'
           ? msg.taskId
@@ -195,12 +351,14 @@ export class SGP4NativeWorkerPool {
     }
 
     this.pendingTasks.delete(taskId);
+    this.taskQueue.completed(pending);
     poolWorker.busy = false;
+    poolWorker.idleSince = performance.now();
 
-    if (msg.type === 'propagate-result') {
-      pending.resolve(msg);
-    } else if (msg.type === 'error') {
+    if (msg.type === 'error') {
       pending.reject(new Error(msg.error));
+    } else {
+      pending.resolve(msg);
     }
 
     // Process next task in queue
@@ -213,6 +371,7 @@ export class SGP4NativeWorkerPool {
   private handleWorkerError(poolWorker: PoolWorker, error: Error): void {
     console.error(`Native worker ${poolWorker.id} error:`, error);
     poolWorker.busy = false;
+    poolWorker.idleSince = performance.now();
     this.processQueue();
   }
 
@@ -220,15 +379,64 @@ export class SGP4NativeWorkerPool {
    * Process the next task in the queue if a worker is available
    */
   private processQueue(): void {
-    const availableWorker = this.workers.find((w) => !w.busy);
-    if (!availableWorker || this.taskQueue.length === 0) {
+    if (!this.workers.some((w) => w.ready && !w.busy) || this.taskQueue.length === 0) {
       return;
     }
 
-    const pending = this.taskQueue.shift()!;
-    availableWorker.busy = true;
+    const pending = this.taskQueue.next();
+    if (!pending) {
+      return;
+    }
+    this.dispatch(this.router.pick(this.workers, affinityKey(pending.task))!, pending);
+  }
+
+  /**
+   * Hand a task to an idle worker
+   */
+  private dispatch(poolWorker: PoolWorker, pending: PendingTask): void {
+    poolWorker.busy = true;
+    this.taskQueue.dispatched(pending);
     this.pendingTasks.set(pending.task.taskId, pending);
-    availableWorker.worker.postMessage(pending.task);
+    poolWorker.worker.postMessage(pending.task);
+  }
+
+  /**
+   * Dispatch a task to an idle worker, or queue it by class, tenant and
+   * deadline. Rejects with DeadlineError if the deadline cannot be met.
+   */
+  private submit<R extends PoolResult>(task: PoolTask): Promise<R> {
+    if (!this.initialized) {
+      throw new Error(
+        'Native worker pool not initialized. Call initialize() first.'
+      );
+    }
+
+    return new Promise((resolve, reject) => {
+      const pending: PendingTask = {
+        task,
+        resolve: resolve as (result: PoolResult) => void,
+        reject,
+      };
+
+      const availableWorker = this.router.pick(this.workers, affinityKey(task));
+      try {
+        this.taskQueue.admit(pending, task.type, taskPoints(task), {
+          size: this.readyWorkers,
+          idle: availableWorker ? 1 : 0,
+        });
+      } catch (err) {
+        reject(err as Error);
+        return;
+      }
+
+      if (availableWorker) {
+        // Dispatch immediately to available worker
+        this.dispatch(availableWorker, pending);
+      } else {
+        // Queue for later processing
+        this.taskQueue.enqueue(pending);
+      }
+    });
   }
 
   /**
@@ -240,49 +448,198 @@ export class SGP4NativeWorkerPool {
   async propagate(
     task: Omit<PropagateTask, 'type' | 'taskId'>
   ): Promise<PropagateResult> {
-    if (!this.initialized) {
-      throw new Error(
-        'Native worker pool not initialized. Call initialize() first.'
-      );
+    if (this.coalesceWindowMs > 0 && !task.partials && this.initialized) {
+      return this.coalesce(task);
     }
 
     const taskId = crypto.randomUUID();
-    const fullTask: PropagateTask = { type: 'propagate', taskId, ...task };
+    return this.submit<PropagateResult>({ type: 'propagate', taskId, ...task });
+  }
+
+  /**
+   * Coalesce concurrent range tasks on the same time grid and model into
+   * one batch. A task with nothing of its key in flight is submitted at
+   * once; tasks arriving behind it wait out the coalescing window together.
+   */
+  private coalesce(
+    task: Omit<PropagateTask, 'type' | 'taskId'>
+  ): Promise<PropagateResult> {
+    const { tle, ...rest } = task;
+    const { et0, etf, step } = task.times;
+    const context = currentContext();
+    // Batches stay within one QoS class so bulk work cannot slow interactive requests
+    const key = [task.model, et0, etf, step, task.packed ? 1 : 0, task.frame || 'TEME', context.qos].join('|');
+
+    if (!this.groups.has(key) && !this.inFlight.has(key)) {
+      return this.track(key, this.submit<PropagateResult>({ type: 'propagate', taskId: crypto.randomUUID(), ...task }));
+    }
 
     return new Promise((resolve, reject) => {
-      const pending: PendingTask = { task: fullTask, resolve, reject };
+      let group = this.groups.get(key);
+      if (!group) {
+        group = {
+          task: rest,
+          members: [],
+          timer: setTimeout(() => this.flushGroup(key), this.coalesceWindowMs),
+        };
+        this.groups.set(key, group);
+      }
 
-      const availableWorker = this.workers.find((w) => !w.busy);
-      if (availableWorker) {
-        // Dispatch immediately to available worker
-        availableWorker.busy = true;
-        this.pendingTasks.set(taskId, pending);
-        availableWorker.worker.postMessage(fullTask);
-      } else {
-        // Queue for later processing
-        this.taskQueue.push(pending);
+      group.members.push({ tle, context, resolve, reject });
+      if (group.members.length >= this.coalesceMax) {
+        this.flushGroup(key);
       }
     });
   }
 
+  /**
+   * Count a submitted task as in flight for its key until it settles
+   */
+  private track<T>(key: string, promise: Promise<T>): Promise<T> {
+    this.inFlight.set(key, (this.inFlight.get(key) ?? 0) + 1);
+    const settle = (): void => {
+      const n = this.inFlight.get(key)! - 1;
+      if (n > 0) {
+        this.inFlight.set(key, n);
+      } else {
+        this.inFlight.delete(key);
+      }
+    };
+    promise.then(settle, settle);
+    return promise;
+  }
+
+  /**
+   * Submit a coalescing group: a lone task as itself, several as one batch
+   * whose results are split back per request
+   */
+  private flushGroup(key: string): void {
+    const group = this.groups.get(key);
+    if (!group) {
+      return;
+    }
+    clearTimeout(group.timer);
+    this.groups.delete(key);
+
+    const { task, members } = group;
+    const single = (m: CoalesceGroup['members'][number]) =>
+      this.track(
+        key,
+        schedulingContext.run(m.context, () =>
+          this.submit<PropagateResult>({
+            type: 'propagate',
+            taskId: crypto.randomUUID(),
+            ...task,
+            tle: m.tle,
+          })
+        )
+      ).then(m.resolve, m.reject);
+
+    if (members.length === 1) {
+      single(members[0]);
+      return;
+    }
+
+    this.coalescedBatches++;
+    this.coalescedTasks += members.length;
+
+    // The batch is scheduled as its most urgent member
+    const urgent = members.reduce((a, m) =>
+      (m.context.deadline ?? Infinity) < (a.context.deadline ?? Infinity) ? m : a
+    );
+    this.track(
+      key,
+      schedulingContext.run(urgent.context, () =>
+        this.submit<PropagateBatchResult>({
+          type: 'propagate-batch',
+          taskId: crypto.randomUUID(),
+          tles: members.map((m) => m.tle),
+          ...task,
+        })
+      )
+    ).then(
+        (batch) => {
+          members.forEach((m, i) =>
+            m.resolve({
+              type: 'propagate-result',
+              taskId: batch.taskId,
+              ...batch.results[i],
+              model: batch.model,
+            })
+          );
+        },
+        // One bad TLE fails the whole batch; retry individually so only its
+        // own request sees the error
+        () => members.forEach(single)
+      );
+  }
+
+  /**
+   * Submit a pipeline shard to the pool
+   *
+   * @param task - Pipeline task parameters (without type and taskId)
+   * @returns Promise that resolves with the shard's pipeline output
+   */
+  async runPipeline(
+    task: Omit<PipelineTask, 'type' | 'taskId'>
+  ): Promise<PipelineResult> {
+    const taskId = crypto.randomUUID();
+    return this.submit<PipelineResult>({ type: 'pipeline', taskId, ...task });
+  }
+
+  /**
+   * Submit an event search shard to the pool
+   *
+   * @param task - Event task parameters (without type and taskId)
+   * @returns Promise that resolves with the shard's events
+   */
+  async findEvents(
+    task: Omit<EventsTask, 'type' | 'taskId'>
+  ): Promise<EventsResult> {
+    const taskId = crypto.randomUUID();
+    return this.submit<EventsResult>({ type: 'events', taskId, ...task });
+  }
+
+  /**
+   * Submit an ephemeris screening shard to the pool
+   *
+   * @param task - Screening task parameters (without type and taskId)
+   * @returns Promise that resolves with the shard's close approaches
+   */
+  async screenEphemeris(
+    task: Omit<ScreenTask, 'type' | 'taskId'>
+  ): Promise<ScreenResult> {
+    const taskId = crypto.randomUUID();
+    return this.submit<ScreenResult>({ type: 'screen', taskId, ...task });
+  }
+
   /**
    * Gracefully shut down the worker pool
    */
   async shutdown(): Promise<void> {
+    // Reject tasks still waiting to be coalesced
+    for (const group of this.groups.values()) {
+      clearTimeout(group.timer);
+      group.members.forEach((m) => m.reject(new Error('Native worker pool shutting down')));
+    }
+    this.groups.clear();
+
     // Reject any queued tasks
-    for (const pending of this.taskQueue) {
+    for (const pending of this.taskQueue.drain()) {
       pending.reject(new Error('Native worker pool shutting down'));
     }
-    this.taskQueue = [];
+
+    clearInterval(this.resizeTimer);
 
     // Terminate all workers
+    const workers = this.workers;
+    this.workers = [];
     await Promise.all(
-      this.workers.map(async (pw) => {
+      workers.map(async (pw) => {
         await pw.worker.terminate();
       })
     );
 
-    this.workers = [];
     this.pendingTasks.clear();
     this.initialized = false;
     console.log('SGP4 native worker pool shut down');
@@ -294,15 +651,25 @@ export class SGP4NativeWorkerPool {
   get stats(): PoolStats {
     const busyWorkers = this.workers.filter((w) => w.busy).length;
     return {
-      poolSize: this.poolSize,
+      poolSize: this.readyWorkers,
       busyWorkers,
-      availableWorkers: this.poolSize - busyWorkers,
+      availableWorkers: this.readyWorkers - busyWorkers,
       queueLength: this.taskQueue.length,
       pendingTasks: this.pendingTasks.size,
       implementation: 'native-simd',
+      coalescingTasks: [...this.groups.values()].reduce((n, g) => n + g.members.length, 0),
+      coalescedBatches: this.coalescedBatches,
+      coalescedTasks: this.coalescedTasks,
+      scheduler: this.taskQueue.stats,
+      elastic: this.sizing.stats(this.workers.length - this.readyWorkers),
+      affinity: this.router.stats,
     };
   }
 
+  private get readyWorkers(): number {
+    return this.workers.filter((w) => w.ready).length;
+  }
+
   /**
    * Check if the pool is initialized
    */
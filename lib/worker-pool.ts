@@ -2,7 +2,8 @@
  * SGP4 Worker Pool Manager
  *
  * Manages a pool of worker threads, each with its own SGP4 WASM instance.
- * Provides task queuing, worker lifecycle management, and graceful shutdown.
+ * Provides task queuing, worker lifecycle management, elastic sizing (see
+ * elastic.ts), and graceful shutdown.
  */
 
 import { Worker } from 'worker_threads';
@@ -15,6 +16,9 @@ import type {
   PropagateTask,
   PropagateResult,
 } from './worker-types.js';
+import { TaskScheduler, rangePoints, type Schedule, type SchedulerStats } from './scheduler.js';
+import { ElasticSizing, RESIZE_INTERVAL_MS, type ElasticStats } from './elastic.js';
+import { AffinityRouter, affinityKey, type AffinityStats } from './affinity.js';
 
 const __filename = fileURLToPath(import.meta.url);
 const __dirname = dirname(__filename);
@@ -26,6 +30,9 @@ interface PoolWorker {
   worker: Worker;
   busy: boolean;
   id: number;
+  /** Initialized and accepting tasks */
+  ready: boolean;
+  idleSince: number;
 }
 
 /**
@@ -35,17 +42,25 @@ interface PendingTask {
   task: PropagateTask;
   resolve: (result: PropagateResult) => void;
   reject: (error: Error) => void;
+  schedule?: Schedule;
 }
 
 /**
  * Pool statistics
  */
 export interface PoolStats {
+  /** Workers ready for tasks (the current size of an elastic pool) */
   poolSize: number;
   busyWorkers: number;
   availableWorkers: number;
   queueLength: number;
   pendingTasks: number;
+  /** QoS classes, fair queuing and deadlines (see scheduler.ts) */
+  scheduler: SchedulerStats;
+  /** Size bounds, warm spares and scaling events (see elastic.ts) */
+  elastic: ElasticStats;
+  /** Satellite-to-worker routing (see affinity.ts) */
+  affinity: AffinityStats;
 }
 
 /**
@@ -56,20 +71,25 @@ export interface PoolStats {
  */
 export class SGP4WorkerPool {
   private workers: PoolWorker[] = [];
-  private taskQueue: PendingTask[] = [];
+  private taskQueue = new TaskScheduler<PendingTask>();
   private pendingTasks = new Map<string, PendingTask>();
   private initialized = false;
-  private poolSize: number;
+  private sizing: ElasticSizing;
+  private nextWorkerId = 0;
+  private resizeTimer?: NodeJS.Timeout;
+  private router = new AffinityRouter();
 
   /**
    * Create a new worker pool
-   * @param poolSize - Number of workers (defaults to CPU core count)
+   * @param poolSize - Number of workers (defaults to CPU core count); the
+   *                   initial size when SGP4_POOL_MIN/MAX make it elastic
    */
   constructor(poolSize?: number) {
-    this.poolSize =
+    this.sizing = new ElasticSizing(
       poolSize ||
-      parseInt(process.env.SGP4_POOL_SIZE || '', 10) ||
-      cpus().length;
+        parseInt(process.env.SGP4_POOL_SIZE || '', 10) ||
+        cpus().length
+    );
   }
 
   /**
@@ -82,57 +102,113 @@ export class SGP4WorkerPool {
       return;
     }
 
-    const workerPath = join(__dirname, 'worker.js');
     const initPromises: Promise<void>[] = [];
+    for (let i = 0; i < this.sizing.initialSize; i++) {
+      initPromises.push(this.spawnWorker());
+    }
 
-    for (let i = 0; i < this.poolSize; i++) {
-      const worker = new Worker(workerPath);
-      const poolWorker: PoolWorker = { worker, busy: false, id: i };
-
-      // Wait for worker to signal ready
-      const initPromise = new Promise<void>((resolve, reject) => {
-        const timeout = setTimeout(() => {
-          reject(new Error(`Worker ${i} initialization timed out`));
-        }, 30000); // 30 second timeout
-
-        const messageHandler = (msg: WorkerMessage) => {
-          if (msg.type === 'ready') {
-            clearTimeout(timeout);
-            worker.off('message', messageHandler);
-            resolve();
-          }
-        };
-
-        worker.on('message', messageHandler);
-        worker.once('error', (err) => {
+    await Promise.all(initPromises);
+    this.initialized = true;
+    if (this.sizing.enabled) {
+      this.resizeTimer = setInterval(() => this.resize(), RESIZE_INTERVAL_MS);
+      this.resizeTimer.unref();
+    }
+    console.log(
+      `SGP4 worker pool initialized with ${this.sizing.initialSize} workers` +
+        (this.sizing.enabled ? ` (elastic ${this.sizing.minSize}-${this.sizing.maxSize})` : '')
+    );
+  }
+
+  /**
+   * Start a worker and add it to the pool
+   *
+   * @returns Promise that resolves once the worker is ready for tasks
+   */
+  private spawnWorker(): Promise<void> {
+    const id = this.nextWorkerId++;
+    const worker = new Worker(join(__dirname, 'worker.js'));
+    const poolWorker: PoolWorker = { worker, busy: false, id, ready: false, idleSince: 0 };
+
+    // Wait for worker to signal ready
+    const initPromise = new Promise<void>((resolve, reject) => {
+      const timeout = setTimeout(() => {
+        reject(new Error(`Worker ${id} initialization timed out`));
+      }, 30000); // 30 second timeout
+
+      const messageHandler = (msg: WorkerMessage) => {
+        if (msg.type === 'ready') {
           clearTimeout(timeout);
-          reject(err);
-        });
-      });
+          worker.off('message', messageHandler);
+          poolWorker.ready = true;
+          poolWorker.idleSince = performance.now();
+          resolve();
+        }
+      };
 
-      // Set up permanent message handler
-      worker.on('message', (msg: WorkerMessage) => {
-        this.handleMessage(poolWorker, msg);
+      worker.on('message', messageHandler);
+      worker.once('error', (err) => {
+        clearTimeout(timeout);
+        reject(err);
       });
+    });
 
-      worker.on('error', (err) => {
-        console.error(`Worker ${i} error:`, err);
-        this.handleWorkerError(poolWorker, err);
-      });
+    // Set up permanent message handler
+    worker.on('message', (msg: WorkerMessage) => {
+      this.handleMessage(poolWorker, msg);
+    });
+
+    worker.on('error', (err) => {
+      console.error(`Worker ${id} error:`, err);
+      this.handleWorkerError(poolWorker, err);
+    });
 
-      worker.on('exit', (code) => {
-        if (code !== 0) {
-          console.error(`Worker ${i} exited with code ${code}`);
+    worker.on('exit', (code) => {
+      // Retired workers have already left the pool
+      if (code !== 0 && this.workers.includes(poolWorker)) {
+        console.error(`Worker ${id} exited with code ${code}`);
+        this.workers = this.workers.filter((w) => w !== poolWorker);
+      }
+    });
+
+    this.workers.push(poolWorker);
+    return initPromise;
+  }
+
+  /**
+   * One elastic sizing step: start workers in the background (queued tasks
+   * keep going to ready ones) or retire a worker idle for too long
+   */
+  private resize(): void {
+    const plan = this.sizing.plan(this.workers, this.taskQueue.length, this.taskQueue.oldestWaitMs());
+
+    for (let i = 0; i < plan.start; i++) {
+      const starting = this.spawnWorker();
+      const poolWorker = this.workers[this.workers.length - 1];
+      starting.then(
+        () => this.processQueue(),
+        (err) => {
+          console.error(`Worker ${poolWorker.id} failed to start:`, err);
+          this.retire(poolWorker);
         }
-      });
+      );
+    }
+    if (plan.start > 0) {
+      this.sizing.record('up', plan.start, this.workers.length, plan.reason);
+    }
 
-      this.workers.push(poolWorker);
-      initPromises.push(initPromise);
+    for (const poolWorker of plan.retire) {
+      const idleSeconds = Math.round((performance.now() - poolWorker.idleSince) / 1000);
+      this.retire(poolWorker);
+      this.sizing.record('down', 1, this.workers.length, `idle ${idleSeconds} s`);
     }
+  }
 
-    await Promise.all(initPromises);
-    this.initialized = true;
-    console.log(`SGP4 worker pool initialized with ${this.poolSize} workers`);
+  /**
+   * Remove an idle worker from the pool and terminate it
+   */
+  private retire(poolWorker: PoolWorker): void {
+    this.workers = this.workers.filter((w) => w !== poolWorker);
+    poolWorker.worker.terminate();
   }
 
   /**
@@ -161,7 +237,9 @@ export class SGP4WorkerPool {
     }
 
     this.pendingTasks.delete(taskId);
+    this.taskQueue.completed(pending);
     poolWorker.busy = false;
+    poolWorker.idleSince = performance.now();
 
     if (msg.type === 'propagate-result') {
       pending.resolve(msg);
@@ -181,6 +259,7 @@ export class SGP4WorkerPool {
     // which task failed. Log the error - the task will timeout eventually.
     console.error(`Worker ${poolWorker.id} error:`, error);
     poolWorker.busy = false;
+    poolWorker.idleSince = performance.now();
     this.processQueue();
   }
 
@@ -188,19 +267,30 @@ export class SGP4WorkerPool {
    * Process the next task in the queue if a worker is available
    */
   private processQueue(): void {
-    const availableWorker = this.workers.find((w) => !w.busy);
-    if (!availableWorker || this.taskQueue.length === 0) {
+    if (!this.workers.some((w) => w.ready && !w.busy) || this.taskQueue.length === 0) {
+      return;
+    }
+
+    const pending = this.taskQueue.next();
+    if (!pending) {
       return;
     }
+    this.dispatch(this.router.pick(this.workers, affinityKey(pending.task))!, pending);
+  }
 
-    const pending = this.taskQueue.shift()!;
-    availableWorker.busy = true;
+  /**
+   * Hand a task to an idle worker
+   */
+  private dispatch(poolWorker: PoolWorker, pending: PendingTask): void {
+    poolWorker.busy = true;
+    this.taskQueue.dispatched(pending);
     this.pendingTasks.set(pending.task.taskId, pending);
-    availableWorker.worker.postMessage(pending.task);
+    poolWorker.worker.postMessage(pending.task);
   }
 
   /**
-   * Submit a propagation task to the pool
+   * Submit a propagation task to the pool. Tasks wait by class, tenant and
+   * deadline; rejects with DeadlineError if the deadline cannot be met.
    *
    * @param task - Propagation task parameters (without type and taskId)
    * @returns Promise that resolves with the propagation result
@@ -218,15 +308,23 @@ export class SGP4WorkerPool {
     return new Promise((resolve, reject) => {
       const pending: PendingTask = { task: fullTask, resolve, reject };
 
-      const availableWorker = this.workers.find((w) => !w.busy);
+      const availableWorker = this.router.pick(this.workers, affinityKey(fullTask));
+      try {
+        this.taskQueue.admit(pending, 'propagate', rangePoints(task.times), {
+          size: this.readyWorkers,
+          idle: availableWorker ? 1 : 0,
+        });
+      } catch (err) {
+        reject(err as Error);
+        return;
+      }
+
       if (availableWorker) {
         // Dispatch immediately to available worker
-        availableWorker.busy = true;
-        this.pendingTasks.set(taskId, pending);
-        availableWorker.worker.postMessage(fullTask);
+        this.dispatch(availableWorker, pending);
       } else {
         // Queue for later processing
-        this.taskQueue.push(pending);
+        this.taskQueue.enqueue(pending);
       }
     });
   }
@@ -236,19 +334,21 @@ export class SGP4WorkerPool {
    */
   async shutdown(): Promise<void> {
     // Reject any queued tasks
-    for (const pending of this.taskQueue) {
+    for (const pending of this.taskQueue.drain()) {
       pending.reject(new Error('Worker pool shutting down'));
     }
-    this.taskQueue = [];
+
+    clearInterval(this.resizeTimer);
 
     // Terminate all workers
+    const workers = this.workers;
+    this.workers = [];
     await Promise.all(
-      this.workers.map(async (pw) => {
+      workers.map(async (pw) => {
         await pw.worker.terminate();
       })
     );
 
-    this.workers = [];
     this.pendingTasks.clear();
     this.initialized = false;
     console.log('SGP4 worker pool shut down');
@@ -260,14 +360,21 @@ export class SGP4WorkerPool {
   get stats(): PoolStats {
     const busyWorkers = this.workers.filter((w) => w.busy).length;
     return {
-      poolSize: this.poolSize,
+      poolSize: this.readyWorkers,
       busyWorkers,
-      availableWorkers: this.poolSize - busyWorkers,
+      availableWorkers: this.readyWorkers - busyWorkers,
       queueLength: this.taskQueue.length,
       pendingTasks: this.pendingTasks.size,
+      scheduler: this.taskQueue.stats,
+      elastic: this.sizing.stats(this.workers.length - this.readyWorkers),
+      affinity: this.router.stats,
     };
   }
 
+  private get readyWorkers(): number {
+    return this.workers.filter((w) => w.ready).length;
+  }
+
   /**
    * Check if the pool is initialized
    */
@@ -12,8 +12,28 @@ export interface PropagateState {
   et: number;
   position: [number, number, number];
   velocity: [number, number, number];
+  /** d(state)/d(elements): 6 rows (x..vz) of 7 columns (see PARTIALS_WRT) */
+  partials?: number[][];
 }
 
+/**
+ * Columns of state partials, in order: mean elements (radians, rad/min
+ * for no) and bstar (1/earth radii)
+ */
+export const PARTIALS_WRT = ['inclo', 'nodeo', 'ecco', 'argpo', 'mo', 'no', 'bstar'] as const;
+
+/**
+ * Satellites given directly as mean elements: 10 columns of n values each,
+ * in TLEElements.elements order (binary ingress, see lib/ingest.ts). The
+ * engine copies each column straight into its SoA batch.
+ */
+export interface ElementColumns {
+  columns: Float64Array;
+}
+
+/** Satellites of a pipeline or events task */
+export type SatelliteList = Array<{ line1: string; line2: string }> | ElementColumns;
+
 // =============================================================================
 // Main Thread → Worker Messages
 // =============================================================================
@@ -27,6 +47,79 @@ export interface PropagateTask {
   tle: { line1: string; line2: string };
   times: { et0: number; etf: number; step: number };
   model: string;
+  /** Return packed SoA result buffers instead of state objects (native only) */
+  packed?: boolean;
+  /** Output reference frame for packed results (native only, default TEME) */
+  frame?: 'TEME' | 'GCRF';
+  /** Attach state partials w.r.t. the mean elements to each state (native only) */
+  partials?: boolean;
+  /** UTC of times.et0: the grid starts at this instant in the worker's own ET scale (CSPICE TDB) */
+  utc0?: string;
+}
+
+/**
+ * Task to propagate several TLEs over one shared time grid in a single
+ * multi-satellite sweep (native only). Built by the pool from coalesced
+ * PropagateTasks; results come back in `tles` order.
+ */
+export interface PropagateBatchTask {
+  type: 'propagate-batch';
+  taskId: string;
+  tles: Array<{ line1: string; line2: string }>;
+  times: { et0: number; etf: number; step: number };
+  model: string;
+  packed?: boolean;
+  frame?: 'TEME' | 'GCRF';
+}
+
+/**
+ * Task to run an encoded pipeline over a shard of satellites (native only)
+ */
+export interface PipelineTask {
+  type: 'pipeline';
+  taskId: string;
+  tles: SatelliteList;
+  /** Stages encoded by encodePipeline() */
+  stages: Float64Array;
+  times: { et0: number; etf: number; step: number };
+  model: string;
+  /** Cap on emitted rows for this shard (0 = unlimited) */
+  maxRows: number;
+}
+
+/**
+ * Task to find orbit events for a shard of satellites (native only)
+ */
+export interface EventsTask {
+  type: 'events';
+  taskId: string;
+  tles: SatelliteList;
+  /** Event functions encoded by encodeEventSpecs() */
+  specs: Float64Array;
+  window: { et0: number; etf: number };
+  model: string;
+  /** Cap on the coarse sampling step in seconds (0 = orbit-aware only) */
+  maxStep: number;
+  /** Cap on events for this shard (0 = unlimited) */
+  maxEvents: number;
+}
+
+/**
+ * Task to screen a user ephemeris against a shard of satellites (native only)
+ */
+export interface ScreenTask {
+  type: 'screen';
+  taskId: string;
+  tles: SatelliteList;
+  /** Parsed ephemeris (see UserEphemeris in screen.ts) */
+  ephemeris: { name?: string; frame: 'TEME' | 'GCRF'; packed: Float64Array };
+  /** Thresholds encoded by encodeScreenLimits() */
+  limits: Float64Array;
+  model: string;
+  /** Cap on the coarse sampling step in seconds (0 = orbit-aware only) */
+  maxStep: number;
+  /** Cap on approaches for this shard (0 = unlimited) */
+  maxApproaches: number;
 }
 
 /**
@@ -39,7 +132,13 @@ export interface InitTask {
 /**
  * Union type of all tasks that can be sent to workers
  */
-export type WorkerTask = PropagateTask | InitTask;
+export type WorkerTask =
+  | PropagateTask
+  | PropagateBatchTask
+  | PipelineTask
+  | EventsTask
+  | ScreenTask
+  | InitTask;
 
 // =============================================================================
 // Worker → Main Thread Messages
@@ -52,10 +151,64 @@ export interface PropagateResult {
   type: 'propagate-result';
   taskId: string;
   states: PropagateState[];
+  /** Packed ephemeris (et | x | y | z | vx | vy | vz columns) when requested */
+  packed?: Float64Array;
   epoch: number;
   model: string;
 }
 
+/**
+ * Per-TLE results of a PropagateBatchTask, in task order
+ */
+export interface PropagateBatchResult {
+  type: 'propagate-batch-result';
+  taskId: string;
+  results: Array<{ states: PropagateState[]; packed?: Float64Array; epoch: number }>;
+  model: string;
+}
+
+/**
+ * Pipeline result for one shard (see PipelineOutput in pipeline.ts)
+ */
+export interface PipelineResult {
+  type: 'pipeline-result';
+  taskId: string;
+  reduce: Float64Array;
+  rows: Float64Array;
+  rowSat: Int32Array;
+  nReduce: number;
+  nSelect: number;
+  truncated: boolean;
+}
+
+/**
+ * Events found for one shard (see EventOutput in events.ts)
+ */
+export interface EventsResult {
+  type: 'events-result';
+  taskId: string;
+  et: Float64Array;
+  sat: Int32Array;
+  spec: Int32Array;
+  direction: Int32Array;
+  truncated: boolean;
+}
+
+/**
+ * Close approaches found for one shard (see ScreenOutput in screen.ts)
+ */
+export interface ScreenResult {
+  type: 'screen-result';
+  taskId: string;
+  tca: Float64Array;
+  sat: Int32Array;
+  distance: Float64Array;
+  speed: Float64Array;
+  ric: Float64Array;
+  candidates: number;
+  truncated: boolean;
+}
+
 /**
  * Error result from worker
  */
@@ -75,4 +228,11 @@ export interface ReadyMessage {
 /**
  * Union type of all messages that workers can send
  */
-export type WorkerMessage = PropagateResult | ErrorResult | ReadyMessage;
+export type WorkerMessage =
+  | PropagateResult
+  | PropagateBatchResult
+  | PipelineResult
+  | EventsResult
+  | ScreenResult
+  | ErrorResult
+  | ReadyMessage;
@@ -9,15 +9,21 @@ import { parentPort } from 'worker_threads';
 import { createSGP4, type SGP4Module } from './index.js';
 import { getWgsConstants } from './models.js';
 import type { WorkerTask, WorkerMessage, PropagateState } from './worker-types.js';
+import type { TLEElements } from './types.js';
+import { TLECache } from './affinity.js';
 
 let sgp4: SGP4Module;
 
+/** Parsed elements of recent TLEs; hit rates rise with affinity routing */
+let parsed: TLECache<TLEElements>;
+
 /**
  * Initialize the SGP4 module for this worker
  */
 async function initialize(): Promise<void> {
   sgp4 = await createSGP4();
   await sgp4.init();
+  parsed = new TLECache((line1, line2) => sgp4.parseTLE(line1, line2));
   parentPort?.postMessage({ type: 'ready' } as WorkerMessage);
 }
 
@@ -38,18 +44,23 @@ parentPort?.on('message', async (task: WorkerTask) => {
         sgp4.setGeophysicalConstants(constants, task.model);
       }
 
-      // Parse TLE
-      const tle = sgp4.parseTLE(task.tle.line1, task.tle.line2);
+      // Parse TLE (cached)
+      const tle = parsed.get(task.tle, task.model);
 
       // Propagate over the time range
       const states: PropagateState[] = [];
-      const { et0, etf, step } = task.times;
+      const { etf, step } = task.times;
+      const n = Math.floor((etf - task.times.et0) / step) + 1;
+      const et0 = task.utc0 !== undefined ? sgp4.utcToET(task.utc0) : task.times.et0;
+
+      // All timestamps in one call rather than one WASM crossing per point
+      const utc = sgp4.etGridToUTC(et0, step, n);
 
-      for (let et = et0; et <= etf; et += step) {
+      for (let i = 0; i < n; i++) {
+        const et = et0 + i * step;
         const state = sgp4.propagate(tle, et);
-        const utc = sgp4.etToUTC(et);
         states.push({
-          datetime: utc,
+          datetime: utc[i],
           et,
           position: [state.position.x, state.position.y, state.position.z],
           velocity: [state.velocity.vx, state.velocity.vy, state.velocity.vz],
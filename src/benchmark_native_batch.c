@@ -4,7 +4,11 @@
  * Tests throughput of SIMD-accelerated batch propagation.
  * Compares against scalar implementation.
  *
- * Usage: ./benchmark_native_batch [satellites] [step] [workers]
+ * With `compact`, the sweep reads quantized coefficients (see
+ * SGP4CompactCoeffs), and their largest position and velocity error
+ * against full storage is reported for LEO, MEO, GEO and HEO orbits.
+ *
+ * Usage: ./benchmark_native_batch [satellites] [step] [workers] [compact]
  */
 
 #include <stdio.h>
@@ -53,6 +57,7 @@ static void worker_process(
     int end_sat,
     int steps,
     double step,
+    int compact,
     WorkerResult* result
 ) {
     int n_sats = end_sat - start_sat;
@@ -85,9 +90,20 @@ static void worker_process(
         );
     }
 
-    // Allocate result buffers (single step at a time to save memory)
+    // Per-satellite coefficients are computed once, outside the timed sweep
+    SGP4BatchCoeffs* coeffs = sgp4_coeffs_alloc_mode(n_sats, compact);
+    if (!coeffs) {
+        fprintf(stderr, "Worker %d: Failed to allocate coefficients\n", worker_id);
+        sgp4_batch_free(batch);
+        result->props = -1;
+        return;
+    }
+    sgp4_batch_init_coeffs(batch, &WGS72, coeffs);
+
+    // Allocate result buffers (one tile of steps at a time to save memory)
     // Round up size for alignment
-    size_t alloc_size = ((n_sats + 7) / 8) * 8 * sizeof(double);
+    int capacity = ((n_sats + 7) / 8) * 8;
+    size_t alloc_size = (size_t)capacity * SGP4_TILE_STEPS * sizeof(double);
     double* x  = aligned_alloc(64, alloc_size);
     double* y  = aligned_alloc(64, alloc_size);
     double* z  = aligned_alloc(64, alloc_size);
@@ -97,6 +113,7 @@ static void worker_process(
 
     if (!x || !y || !z || !vx || !vy || !vz) {
         fprintf(stderr, "Worker %d: Failed to allocate result buffers\n", worker_id);
+        sgp4_coeffs_free(coeffs);
         sgp4_batch_free(batch);
         result->props = -1;
         return;
@@ -104,21 +121,23 @@ static void worker_process(
 
     long props = 0;
 
-    // Propagate each time step
-    for (int t = 0; t < steps; t++) {
-        double tsince = t * step / 60.0;  // seconds to minutes
+    // Sweep the time grid with the blocked kernel
+    for (int t = 0; t < steps; t += SGP4_TILE_STEPS) {
+        int chunk = steps - t < SGP4_TILE_STEPS ? steps - t : SGP4_TILE_STEPS;
 
-        sgp4_batch_propagate_step(
-            batch, tsince, &WGS72,
-            x, y, z, vx, vy, vz
+        sgp4_batch_sweep(
+            coeffs, 0, n_sats, t * step, step, chunk,
+            x, y, z, vx, vy, vz,
+            1, capacity
         );
 
-        props += n_sats;
+        props += (long)n_sats * chunk;
     }
 
     // Cleanup
     free(x); free(y); free(z);
     free(vx); free(vy); free(vz);
+    sgp4_coeffs_free(coeffs);
     sgp4_batch_free(batch);
 
     result->start_sat = start_sat;
@@ -127,14 +146,71 @@ static void worker_process(
     result->props = props;
 }
 
+/**
+ * Largest difference between compact and full coefficient storage over
+ * 7 days at 60 s, for one orbit per regime (elements in sgp4_batch_set()
+ * order, angles in degrees, mean motion in rev/day).
+ */
+static void compact_accuracy(void) {
+    static const struct { const char* name; double incl, node, ecc, argp, mo, revs; } orbits[] = {
+        { "LEO (ISS)",     51.64, 208.92, 0.0006703,  30.08, 330.06, 15.4956 },
+        { "MEO (GPS)",     55.44, 100.00, 0.005,      50.00, 310.00,  2.00564 },
+        { "GEO",            0.03,  90.00, 0.0001,    180.00,  30.00,  1.0027 },
+        { "HEO (Molniya)", 63.40, 300.00, 0.70,      270.00,  10.00,  2.006 },
+    };
+    const int n = sizeof(orbits) / sizeof(orbits[0]);
+    const int steps = 7 * 1440 + 1;
+
+    SGP4Batch* batch = sgp4_batch_alloc(n);
+    for (int i = 0; i < n; i++) {
+        sgp4_batch_set(batch, i, 0.0, 0.0, 1e-5,
+            orbits[i].incl * DEG2RAD, orbits[i].node * DEG2RAD, orbits[i].ecc,
+            orbits[i].argp * DEG2RAD, orbits[i].mo * DEG2RAD,
+            orbits[i].revs * TWOPI / MIN_PER_DAY, 0.0);
+    }
+    SGP4BatchCoeffs* full = sgp4_coeffs_alloc(n);
+    SGP4BatchCoeffs* compact = sgp4_coeffs_alloc_compact(n);
+    sgp4_batch_init_coeffs(batch, &WGS72, full);
+    sgp4_batch_init_coeffs(batch, &WGS72, compact);
+
+    double* a = malloc((size_t)steps * 6 * sizeof(double));
+    double* b = malloc((size_t)steps * 6 * sizeof(double));
+    printf("\nCompact storage error (7 days, 60s):\n");
+    for (int i = 0; i < n; i++) {
+        sgp4_batch_sweep(full, i, 1, 0.0, 60.0, steps,
+            a, a + steps, a + 2 * steps, a + 3 * steps, a + 4 * steps, a + 5 * steps, 0, 1);
+        sgp4_batch_sweep(compact, i, 1, 0.0, 60.0, steps,
+            b, b + steps, b + 2 * steps, b + 3 * steps, b + 4 * steps, b + 5 * steps, 0, 1);
+        double dr = 0.0, dv = 0.0;
+        for (int t = 0; t < steps; t++) {
+            double r2 = 0.0, v2 = 0.0;
+            for (int c = 0; c < 3; c++) {
+                r2 += pow(a[c * steps + t] - b[c * steps + t], 2);
+                v2 += pow(a[(3 + c) * steps + t] - b[(3 + c) * steps + t], 2);
+            }
+            if (sqrt(r2) > dr) dr = sqrt(r2);
+            if (sqrt(v2) > dv) dv = sqrt(v2);
+        }
+        printf("  %-14s %8.2f mm  %8.4f mm/s\n", orbits[i].name, dr * 1e6, dv * 1e6);
+    }
+
+    free(a);
+    free(b);
+    sgp4_coeffs_free(full);
+    sgp4_coeffs_free(compact);
+    sgp4_batch_free(batch);
+}
+
 int main(int argc, char* argv[]) {
     int satellites = 9534;
     int step = 60;
     int num_workers = 1;
+    int compact = 0;
 
     if (argc > 1) satellites = atoi(argv[1]);
     if (argc > 2) step = atoi(argv[2]);
     if (argc > 3) num_workers = atoi(argv[3]);
+    if (argc > 4) compact = strcmp(argv[4], "compact") == 0;
 
     // Clamp workers
     if (num_workers < 1) num_workers = 1;
@@ -148,12 +224,17 @@ int main(int argc, char* argv[]) {
     printf("SGP4 Batch Benchmark (SIMD)\n");
     printf("===========================\n");
     printf("SIMD:          %s\n", sgp4_simd_name());
+    printf("Tile:          %d sats x %d steps\n", SGP4_TILE_SATS, SGP4_TILE_STEPS);
     printf("\nConfiguration:\n");
     printf("  Satellites:  %d\n", satellites);
     printf("  Step size:   %ds\n", step);
     printf("  Points/sat:  %d\n", points_per_sat);
     printf("  Total props: %ld\n", total_props);
     printf("  Workers:     %d\n", num_workers);
+    printf("  Storage:     %s (%d bytes/sat)\n", compact ? "compact" : "full", compact ? 72 : 112);
+    if (compact) {
+        compact_accuracy();
+    }
     printf("\nRunning benchmark...\n");
 
     // Allocate shared memory for results
@@ -184,7 +265,7 @@ int main(int argc, char* argv[]) {
         pid_t pid = fork();
         if (pid == 0) {
             // Child process
-            worker_process(i, start_sat, end_sat, points_per_sat, step, &results[i]);
+            worker_process(i, start_sat, end_sat, points_per_sat, step, compact, &results[i]);
             _exit(0);
         } else if (pid > 0) {
             pids[i] = pid;
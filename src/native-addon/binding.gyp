@@ -26,7 +26,8 @@
             "GCC_OPTIMIZATION_LEVEL": "3",
             "OTHER_CFLAGS": [
               "-O3",
-              "-march=native"
+              "-march=native",
+              "-fno-math-errno"
             ],
             "MACOSX_DEPLOYMENT_TARGET": "11.0"
           }
@@ -34,7 +35,8 @@
         ["OS=='linux'", {
           "cflags": [
             "-O3",
-            "-march=native"
+            "-march=native",
+            "-fno-math-errno"
           ]
         }],
         ["OS=='win'", {
@@ -16,10 +16,20 @@
 // Include SIMD implementation
 #include "../sgp4_batch.h"
 #include "../sgp4_simd.c"
+#include "../sgp4_frames.c"
+#include "../sgp4_partials.c"
+#include "../sgp4_pipeline.c"
+#include "../sgp4_events.c"
+#include "../sgp4_archive.c"
+#include "../sgp4_catalog.c"
+#include "../sgp4_screen.c"
 
 // Current geophysical model
 static SGP4Geophs current_geophs;
 static char current_model_name[64] = "wgs72";
+
+// Coefficient storage of the sweeps (setCompactCoefficients)
+static int compact_coeffs = 0;
 static char last_error[512] = "";
 
 // J2000 epoch: 2000-01-01T12:00:00.000 TDB
@@ -88,39 +98,47 @@ static double utc_to_et(const char* utc) {
 }
 
 /**
- * Convert ephemeris time to UTC ISO string
+ * Format ephemeris time as an ISO 8601 UTC string with millisecond precision.
+ * Rounds to the millisecond before splitting into calendar fields so that
+ * seconds never print as "60.000".
+ *
+ * @param zulu  Append the "Z" designator when non-zero
  */
-static void et_to_utc(double et, char* buffer, size_t max_len) {
-    // Convert ET (seconds past J2000) to Julian Day
-    double jd = et / 86400.0 + 2451545.0;
-
-    // Julian Day to calendar date (simplified algorithm)
-    int z = (int)(jd + 0.5);
-    double f = jd + 0.5 - z;
-
-    int a = z;
-    if (z >= 2299161) {
-        int alpha = (int)((z - 1867216.25) / 36524.25);
-        a = z + 1 + alpha - alpha / 4;
+static void format_utc(double et, char* buffer, size_t max_len, int zulu) {
+    // Milliseconds since 2000-01-01T00:00:00 (J2000 is 12:00 on that day)
+    long long ms = llround((et + 43200.0) * 1000.0);
+    long long days = ms / 86400000LL;
+    long long ms_of_day = ms % 86400000LL;
+    if (ms_of_day < 0) {
+        ms_of_day += 86400000LL;
+        days -= 1;
     }
 
-    int b = a + 1524;
-    int c = (int)((b - 122.1) / 365.25);
-    int d = (int)(365.25 * c);
-    int e = (int)((b - d) / 30.6001);
-
-    int day = b - d - (int)(30.6001 * e);
-    int month = (e < 14) ? e - 1 : e - 13;
-    int year = (month > 2) ? c - 4716 : c - 4715;
-
-    double day_frac = f * 24.0;
-    int hour = (int)day_frac;
-    double min_frac = (day_frac - hour) * 60.0;
-    int min = (int)min_frac;
-    double sec = (min_frac - min) * 60.0;
+    // Civil date from days since 1970-01-01 (H. Hinnant's algorithm)
+    long long z = days + 10957 + 719468;
+    long long era = (z >= 0 ? z : z - 146096) / 146097;
+    long long doe = z - era * 146097;
+    long long yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    long long doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    long long mp = (5 * doy + 2) / 153;
+    int day = (int)(doy - (153 * mp + 2) / 5 + 1);
+    int month = (int)(mp < 10 ? mp + 3 : mp - 9);
+    int year = (int)(yoe + era * 400 + (month <= 2));
+
+    int hour = (int)(ms_of_day / 3600000LL);
+    int min = (int)((ms_of_day / 60000LL) % 60);
+    int sec = (int)((ms_of_day / 1000LL) % 60);
+    int milli = (int)(ms_of_day % 1000LL);
+
+    snprintf(buffer, max_len, "%04d-%02d-%02dT%02d:%02d:%02d.%03d%s",
+             year, month, day, hour, min, sec, milli, zulu ? "Z" : "");
+}
 
-    snprintf(buffer, max_len, "%04d-%02d-%02dT%02d:%02d:%06.3fZ",
-             year, month, day, hour, min, sec);
+/**
+ * Convert ephemeris time to UTC ISO string
+ */
+static void et_to_utc(double et, char* buffer, size_t max_len) {
+    format_utc(et, buffer, max_len, 1);
 }
 
 /**
@@ -163,25 +181,6 @@ static int parse_tle(const char* line1, const char* line2, double* elements, dou
     epoch_str[14] = '\0';
 
     double epoch_val = atof(epoch_str);
-    int epoch_year = (int)(epoch_val / 1000.0);
-    double epoch_day = epoch_val - epoch_year * 1000.0;
-
-    // Convert 2-digit year to 4-digit
-    if (epoch_year < 57) {
-        epoch_year += 2000;
-    } else {
-        epoch_year += 1900;
-    }
-
-    // Convert epoch to ET (seconds past J2000)
-    // Days since J2000 for Jan 1 of epoch year
-    int a = (14 - 1) / 12;
-    int y = epoch_year + 4800 - a;
-    int m = 1 + 12 * a - 3;
-    int jdn_jan1 = 1 + (153 * m + 2) / 5 + 365 * y + y / 4 - y / 100 + y / 400 - 32045;
-    double jd_jan1 = jdn_jan1 - 0.5;  // JD at midnight
-    double jd_epoch = jd_jan1 + epoch_day - 1.0;  // epoch_day is 1-indexed
-    *epoch_et = (jd_epoch - 2451545.0) * 86400.0;
 
     // Parse mean motion derivative (columns 34-43)
     char ndot_str[12];
@@ -193,11 +192,13 @@ static int parse_tle(const char* line1, const char* line2, double* elements, dou
     char nddot_str[10];
     strncpy(nddot_str, line1 + 44, 8);
     nddot_str[8] = '\0';
-    // Format: " NNNNN-E" where decimal is implied before first digit
+    // Format: "SNNNNNSE" where decimal is implied before first digit
+    // (mantissa sign, 5 digits, exponent sign at column 51, exponent digit)
+    nddot_str[6] = '\0';
     double nddot_mantissa = atof(nddot_str);
     int nddot_exp = 0;
-    if (strlen(line1) > 51 && (line1[51] == '-' || line1[51] == '+')) {
-        nddot_exp = atoi(line1 + 51);
+    if (strlen(line1) > 51 && (line1[50] == '-' || line1[50] == '+')) {
+        nddot_exp = atoi(line1 + 50);
     }
     double nddot = nddot_mantissa * pow(10.0, nddot_exp - 5);
 
@@ -205,10 +206,11 @@ static int parse_tle(const char* line1, const char* line2, double* elements, dou
     char bstar_str[10];
     strncpy(bstar_str, line1 + 53, 8);
     bstar_str[8] = '\0';
+    bstar_str[6] = '\0';
     double bstar_mantissa = atof(bstar_str);
     int bstar_exp = 0;
-    if (strlen(line1) > 60 && (line1[60] == '-' || line1[60] == '+')) {
-        bstar_exp = atoi(line1 + 60);
+    if (strlen(line1) > 60 && (line1[59] == '-' || line1[59] == '+')) {
+        bstar_exp = atoi(line1 + 59);
     }
     double bstar = bstar_mantissa * pow(10.0, bstar_exp - 5);
 
@@ -229,11 +231,8 @@ static int parse_tle(const char* line1, const char* line2, double* elements, dou
     double ma = atof(ma_str);          // degrees
     double mm = atof(mm_str);          // rev/day
 
-    // Convert to radians and CSPICE units
-    double deg2rad = PI / 180.0;
-    double rev_per_day_to_rad_per_min = TWOPI / MIN_PER_DAY;
-
-    // Elements array format (matching CSPICE getelm_c):
+    // Convert to radians and CSPICE units. Elements array format
+    // (matching CSPICE getelm_c):
     // [0] NDT20 - first derivative of mean motion / 2 (rad/min^2)
     // [1] NDD60 - second derivative of mean motion / 6 (rad/min^3)
     // [2] BSTAR - drag term (1/earth-radii)
@@ -244,17 +243,8 @@ static int parse_tle(const char* line1, const char* line2, double* elements, dou
     // [7] M0    - mean anomaly (radians)
     // [8] N0    - mean motion (radians/minute)
     // [9] EPOCH - epoch (seconds past J2000)
-
-    elements[0] = ndot * TWOPI / (MIN_PER_DAY * MIN_PER_DAY);  // NDT20
-    elements[1] = nddot * TWOPI / (MIN_PER_DAY * MIN_PER_DAY * MIN_PER_DAY);  // NDD60
-    elements[2] = bstar;
-    elements[3] = incl * deg2rad;
-    elements[4] = raan * deg2rad;
-    elements[5] = ecc;
-    elements[6] = argp * deg2rad;
-    elements[7] = ma * deg2rad;
-    elements[8] = mm * rev_per_day_to_rad_per_min;
-    elements[9] = *epoch_et;
+    sgp4_tle_values_to_elements(epoch_val, ndot, nddot, bstar, incl, raan, ecc, argp, ma, mm, elements);
+    *epoch_et = elements[9];
 
     return 0;
 }
@@ -436,36 +426,116 @@ static napi_value NativePropagate(napi_env env, napi_callback_info info) {
 }
 
 /**
- * propagateRange(elements: Float64Array, et0: number, etf: number, step: number)
- *   -> Array<{ et, position, velocity }>
+ * Helper: time-independent coefficients for one satellite's elements,
+ * using the current geophysical model. Returns NULL on allocation failure.
+ */
+static SGP4BatchCoeffs* init_single_coeffs(const double* elements) {
+    SGP4Batch* batch = sgp4_batch_alloc(1);
+    if (!batch) return NULL;
+
+    sgp4_batch_set(batch, 0,
+        elements[0], elements[1], elements[2], elements[3], elements[4],
+        elements[5], elements[6], elements[7], elements[8], elements[9]
+    );
+
+    SGP4BatchCoeffs* coeffs = sgp4_coeffs_alloc_mode(1, compact_coeffs);
+    if (coeffs) {
+        sgp4_batch_init_coeffs(batch, &current_geophs, coeffs);
+    }
+
+    sgp4_batch_free(batch);
+    return coeffs;
+}
+
+static void propagator_finalize(napi_env env, void* data, void* hint) {
+    sgp4_coeffs_free((SGP4BatchCoeffs*)data);
+}
+
+/**
+ * propagator(elements: Float64Array) -> propagator handle
  *
- * Batch propagation for time range - this is where SIMD shines
+ * Initialize one satellite's coefficients under the current geophysical
+ * model and keep them, so that workers can reuse them across requests.
+ * The range calls accept the handle in place of the elements.
  */
-static napi_value NativePropagateRange(napi_env env, napi_callback_info info) {
-    size_t argc = 4;
-    napi_value argv[4];
+static napi_value NativePropagator(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value argv[1];
     NAPI_CHECK_STATUS(env, napi_get_cb_info(env, info, &argc, argv, NULL, NULL),
                       "Failed to get arguments");
 
-    if (argc < 4) {
-        napi_throw_error(env, NULL, "propagateRange requires 4 arguments: elements, et0, etf, step");
+    napi_typedarray_type type;
+    size_t length;
+    void* data;
+    if (argc < 1 ||
+        napi_get_typedarray_info(env, argv[0], &type, &length, &data, NULL, NULL) != napi_ok ||
+        type != napi_float64_array || length < 10) {
+        napi_throw_error(env, NULL, "elements must be Float64Array with 10 elements");
         return NULL;
     }
 
-    // Get elements array
+    SGP4BatchCoeffs* coeffs = init_single_coeffs((const double*)data);
+    if (!coeffs) {
+        napi_throw_error(env, NULL, "Failed to allocate batch");
+        return NULL;
+    }
+
+    napi_value handle;
+    NAPI_CHECK_STATUS(env, napi_create_external(env, coeffs, propagator_finalize, NULL, &handle),
+                      "Failed to create propagator");
+    return handle;
+}
+
+/**
+ * Helper: coefficients for a range call's first argument, either a
+ * propagator handle (borrowed, *owned = 0) or elements (initialized here,
+ * *owned = 1, free with sgp4_coeffs_free). Throws and returns NULL on a
+ * bad argument or allocation failure.
+ */
+static SGP4BatchCoeffs* get_single_coeffs(napi_env env, napi_value arg, int* owned) {
+    napi_valuetype kind;
+    napi_typeof(env, arg, &kind);
+    if (kind == napi_external) {
+        void* coeffs;
+        napi_get_value_external(env, arg, &coeffs);
+        *owned = 0;
+        return (SGP4BatchCoeffs*)coeffs;
+    }
+
     napi_typedarray_type type;
     size_t length;
     void* data;
-    napi_value array_buffer;
-    size_t offset;
-    napi_get_typedarray_info(env, argv[0], &type, &length, &data, &array_buffer, &offset);
+    if (napi_get_typedarray_info(env, arg, &type, &length, &data, NULL, NULL) != napi_ok ||
+        type != napi_float64_array || length < 10) {
+        napi_throw_error(env, NULL, "elements must be Float64Array with 10 elements or a propagator");
+        return NULL;
+    }
 
-    if (type != napi_float64_array || length < 10) {
-        napi_throw_error(env, NULL, "elements must be Float64Array with 10 elements");
+    SGP4BatchCoeffs* coeffs = init_single_coeffs((const double*)data);
+    if (!coeffs) {
+        napi_throw_error(env, NULL, "Failed to allocate batch");
         return NULL;
     }
+    *owned = 1;
+    return coeffs;
+}
 
-    double* elements = (double*)data;
+/**
+ * propagateRange(elements: Float64Array | propagator, et0: number, etf: number, step: number)
+ *   -> Array<{ et, position, velocity }>
+ *
+ * Batch propagation for time range - this is where SIMD shines
+ */
+static napi_value NativePropagateRange(napi_env env, napi_callback_info info) {
+    size_t argc = 4;
+    napi_value argv[4];
+    NAPI_CHECK_STATUS(env, napi_get_cb_info(env, info, &argc, argv, NULL, NULL),
+                      "Failed to get arguments");
+
+    if (argc < 4) {
+        napi_throw_error(env, NULL, "propagateRange requires 4 arguments: elements, et0, etf, step");
+        return NULL;
+    }
 
     // Get time parameters
     double et0, etf, step;
@@ -473,37 +543,38 @@ static napi_value NativePropagateRange(napi_env env, napi_callback_info info) {
     napi_get_value_double(env, argv[2], &etf);
     napi_get_value_double(env, argv[3], &step);
 
-    double epoch_et = elements[9];
-
     // Calculate number of steps
     int n_steps = (int)((etf - et0) / step) + 1;
     if (n_steps <= 0) n_steps = 1;
 
-    // Create batch with single satellite (we propagate one sat over many times)
-    SGP4Batch* batch = sgp4_batch_alloc(1);
-    if (!batch) {
+    // Coefficients once (or from a propagator), then a register-tiled
+    // sweep over the time grid
+    int owned;
+    SGP4BatchCoeffs* coeffs = get_single_coeffs(env, argv[0], &owned);
+    if (!coeffs) return NULL;
+    double* states = (double*)malloc((size_t)n_steps * 6 * sizeof(double));
+    if (!states) {
+        if (owned) sgp4_coeffs_free(coeffs);
         napi_throw_error(env, NULL, "Failed to allocate batch");
         return NULL;
     }
 
-    sgp4_batch_set(batch, 0,
-        elements[0], elements[1], elements[2], elements[3], elements[4],
-        elements[5], elements[6], elements[7], elements[8], epoch_et
-    );
+    double* x  = states;
+    double* y  = states + (size_t)n_steps;
+    double* z  = states + (size_t)n_steps * 2;
+    double* vx = states + (size_t)n_steps * 3;
+    double* vy = states + (size_t)n_steps * 4;
+    double* vz = states + (size_t)n_steps * 5;
 
-    // Allocate output arrays
-    double x[8], y[8], z[8], vx[8], vy[8], vz[8];
+    sgp4_batch_sweep(coeffs, 0, 1, et0, step, n_steps, x, y, z, vx, vy, vz, 0, 1);
+    if (owned) sgp4_coeffs_free(coeffs);
 
     // Create result array
     napi_value result_array;
     napi_create_array_with_length(env, n_steps, &result_array);
 
-    // Propagate each time step
     for (int i = 0; i < n_steps; i++) {
         double et = et0 + i * step;
-        double tsince = (et - epoch_et) / 60.0;  // minutes
-
-        sgp4_batch_propagate_step(batch, tsince, &current_geophs, x, y, z, vx, vy, vz);
 
         // Create state object
         napi_value state;
@@ -518,9 +589,9 @@ static napi_value NativePropagateRange(napi_env env, napi_callback_info info) {
         napi_value position;
         napi_create_object(env, &position);
         napi_value px, py, pz;
-        napi_create_double(env, x[0], &px);
-        napi_create_double(env, y[0], &py);
-        napi_create_double(env, z[0], &pz);
+        napi_create_double(env, x[i], &px);
+        napi_create_double(env, y[i], &py);
+        napi_create_double(env, z[i], &pz);
         napi_set_named_property(env, position, "x", px);
         napi_set_named_property(env, position, "y", py);
         napi_set_named_property(env, position, "z", pz);
@@ -530,9 +601,9 @@ static napi_value NativePropagateRange(napi_env env, napi_callback_info info) {
         napi_value velocity;
         napi_create_object(env, &velocity);
         napi_value vvx, vvy, vvz;
-        napi_create_double(env, vx[0], &vvx);
-        napi_create_double(env, vy[0], &vvy);
-        napi_create_double(env, vz[0], &vvz);
+        napi_create_double(env, vx[i], &vvx);
+        napi_create_double(env, vy[i], &vvy);
+        napi_create_double(env, vz[i], &vvz);
         napi_set_named_property(env, velocity, "vx", vvx);
         napi_set_named_property(env, velocity, "vy", vvy);
         napi_set_named_property(env, velocity, "vz", vvz);
@@ -541,132 +612,1225 @@ static napi_value NativePropagateRange(napi_env env, napi_callback_info info) {
         napi_set_element(env, result_array, i, state);
     }
 
-    sgp4_batch_free(batch);
+    free(states);
 
     return result_array;
 }
 
 /**
- * utcToET(utc: string) -> number
+ * propagateRangePacked(elements: Float64Array | propagator, et0: number, etf: number, step: number)
+ *   -> Float64Array
+ *
+ * Same time grid as propagateRange(), but returns the result buffers
+ * directly instead of building one JS object per state. The array holds
+ * 7 columns of n values each (SoA): et | x | y | z | vx | vy | vz.
+ * Its ArrayBuffer can be transferred between threads without copying.
  */
-static napi_value NativeUtcToET(napi_env env, napi_callback_info info) {
-    size_t argc = 1;
-    napi_value argv[1];
+static napi_value NativePropagateRangePacked(napi_env env, napi_callback_info info) {
+    size_t argc = 4;
+    napi_value argv[4];
     NAPI_CHECK_STATUS(env, napi_get_cb_info(env, info, &argc, argv, NULL, NULL),
                       "Failed to get arguments");
 
-    if (argc < 1) {
-        napi_throw_error(env, NULL, "utcToET requires 1 argument: utc string");
+    if (argc < 4) {
+        napi_throw_error(env, NULL, "propagateRangePacked requires 4 arguments: elements, et0, etf, step");
         return NULL;
     }
 
-    size_t utc_len;
-    napi_get_value_string_utf8(env, argv[0], NULL, 0, &utc_len);
-    char* utc = malloc(utc_len + 1);
-    napi_get_value_string_utf8(env, argv[0], utc, utc_len + 1, &utc_len);
+    double et0, etf, step;
+    napi_get_value_double(env, argv[1], &et0);
+    napi_get_value_double(env, argv[2], &etf);
+    napi_get_value_double(env, argv[3], &step);
 
-    double et = utc_to_et(utc);
-    free(utc);
+    int n_steps = (int)((etf - et0) / step) + 1;
+    if (n_steps <= 0) n_steps = 1;
 
-    napi_value result;
-    napi_create_double(env, et, &result);
-    return result;
+    int owned;
+    SGP4BatchCoeffs* coeffs = get_single_coeffs(env, argv[0], &owned);
+    if (!coeffs) return NULL;
+
+    // Output columns live directly in the returned ArrayBuffer
+    void* out_data;
+    napi_value out_buffer;
+    if (napi_create_arraybuffer(env, (size_t)n_steps * 7 * sizeof(double), &out_data, &out_buffer) != napi_ok) {
+        if (owned) sgp4_coeffs_free(coeffs);
+        napi_throw_error(env, NULL, "Failed to allocate result buffer");
+        return NULL;
+    }
+
+    double* cols = (double*)out_data;
+    for (int i = 0; i < n_steps; i++) {
+        cols[i] = et0 + i * step;
+    }
+
+    sgp4_batch_sweep(coeffs, 0, 1, et0, step, n_steps,
+                     cols + (size_t)n_steps, cols + (size_t)n_steps * 2, cols + (size_t)n_steps * 3,
+                     cols + (size_t)n_steps * 4, cols + (size_t)n_steps * 5, cols + (size_t)n_steps * 6,
+                     0, 1);
+
+    if (owned) sgp4_coeffs_free(coeffs);
+
+    napi_value typed_array;
+    napi_create_typedarray(env, napi_float64_array, (size_t)n_steps * 7, out_buffer, 0, &typed_array);
+    return typed_array;
 }
 
 /**
- * etToUTC(et: number) -> string
+ * propagateRangePartials(elements: Float64Array, et0: number, etf: number, step: number)
+ *   -> { packed: Float64Array, partials: Float64Array }
+ *
+ * Same time grid and packed layout as propagateRangePacked(), plus the
+ * 6x7 partials of each state w.r.t. (inclo, nodeo, ecco, argpo, mo, no,
+ * bstar) from the dual-number kernel: 42 values per state, row-major.
  */
-static napi_value NativeEtToUTC(napi_env env, napi_callback_info info) {
-    size_t argc = 1;
-    napi_value argv[1];
+static napi_value NativePropagateRangePartials(napi_env env, napi_callback_info info) {
+    size_t argc = 4;
+    napi_value argv[4];
     NAPI_CHECK_STATUS(env, napi_get_cb_info(env, info, &argc, argv, NULL, NULL),
                       "Failed to get arguments");
 
-    if (argc < 1) {
-        napi_throw_error(env, NULL, "etToUTC requires 1 argument: et");
+    if (argc < 4) {
+        napi_throw_error(env, NULL, "propagateRangePartials requires 4 arguments: elements, et0, etf, step");
         return NULL;
     }
 
-    double et;
-    napi_get_value_double(env, argv[0], &et);
+    napi_typedarray_type type;
+    size_t length;
+    void* data;
+    napi_value array_buffer;
+    size_t offset;
+    napi_get_typedarray_info(env, argv[0], &type, &length, &data, &array_buffer, &offset);
 
-    char utc[64];
-    et_to_utc(et, utc, sizeof(utc));
+    if (type != napi_float64_array || length < 10) {
+        napi_throw_error(env, NULL, "elements must be Float64Array with 10 elements");
+        return NULL;
+    }
 
-    napi_value result;
-    napi_create_string_utf8(env, utc, NAPI_AUTO_LENGTH, &result);
+    double* elements = (double*)data;
+
+    double et0, etf, step;
+    napi_get_value_double(env, argv[1], &et0);
+    napi_get_value_double(env, argv[2], &etf);
+    napi_get_value_double(env, argv[3], &step);
+
+    int n_steps = (int)((etf - et0) / step) + 1;
+    if (n_steps <= 0) n_steps = 1;
+
+    SGP4Batch* batch = sgp4_batch_alloc(1);
+    if (!batch) {
+        napi_throw_error(env, NULL, "Failed to allocate batch");
+        return NULL;
+    }
+
+    sgp4_batch_set(batch, 0,
+        elements[0], elements[1], elements[2], elements[3], elements[4],
+        elements[5], elements[6], elements[7], elements[8], elements[9]
+    );
+
+    void* packed_data;
+    void* partials_data;
+    napi_value packed_buffer, partials_buffer;
+    if (napi_create_arraybuffer(env, (size_t)n_steps * 7 * sizeof(double), &packed_data, &packed_buffer) != napi_ok ||
+        napi_create_arraybuffer(env, (size_t)n_steps * SGP4_NJACOBIAN * sizeof(double), &partials_data, &partials_buffer) != napi_ok) {
+        sgp4_batch_free(batch);
+        napi_throw_error(env, NULL, "Failed to allocate result buffer");
+        return NULL;
+    }
+
+    double* cols = (double*)packed_data;
+    for (int i = 0; i < n_steps; i++) {
+        cols[i] = et0 + i * step;
+    }
+
+    sgp4_batch_propagate_partials(batch, 0, 1, et0, step, n_steps, &current_geophs,
+        cols + (size_t)n_steps, cols + (size_t)n_steps * 2, cols + (size_t)n_steps * 3,
+        cols + (size_t)n_steps * 4, cols + (size_t)n_steps * 5, cols + (size_t)n_steps * 6,
+        (double*)partials_data, 0, 1);
+
+    sgp4_batch_free(batch);
+
+    napi_value result, packed, partials;
+    napi_create_object(env, &result);
+    napi_create_typedarray(env, napi_float64_array, (size_t)n_steps * 7, packed_buffer, 0, &packed);
+    napi_create_typedarray(env, napi_float64_array, (size_t)n_steps * SGP4_NJACOBIAN, partials_buffer, 0, &partials);
+    napi_set_named_property(env, result, "packed", packed);
+    napi_set_named_property(env, result, "partials", partials);
     return result;
 }
 
 /**
- * setGeophysicalConstants(constants, modelName)
+ * Helper: build a batch from element sets given either as a Float64Array of
+ * concatenated sets (10 values each, parseTLE() layout) or as
+ * { columns: Float64Array } with 10 columns of n values (binary ingress,
+ * copied column by column). Returns NULL after throwing a JS error.
  */
-static napi_value NativeSetGeophs(napi_env env, napi_callback_info info) {
-    size_t argc = 2;
-    napi_value argv[2];
-    NAPI_CHECK_STATUS(env, napi_get_cb_info(env, info, &argc, argv, NULL, NULL),
-                      "Failed to get arguments");
+static SGP4Batch* get_element_batch(napi_env env, napi_value value, int* n_sats) {
+    napi_typedarray_type type;
+    size_t length;
+    void* data;
+    napi_value array_buffer;
+    size_t offset;
+    bool is_typedarray = false;
+    bool columnar = false;
+
+    napi_is_typedarray(env, value, &is_typedarray);
+    if (!is_typedarray) {
+        napi_value columns;
+        if (napi_get_named_property(env, value, "columns", &columns) == napi_ok) {
+            napi_is_typedarray(env, columns, &is_typedarray);
+            value = columns;
+            columnar = true;
+        }
+    }
 
-    if (argc < 1) {
-        napi_throw_error(env, NULL, "setGeophysicalConstants requires constants object");
+    if (!is_typedarray ||
+        napi_get_typedarray_info(env, value, &type, &length, &data, &array_buffer, &offset) != napi_ok ||
+        type != napi_float64_array || length == 0 || length % 10 != 0) {
+        napi_throw_error(env, NULL, "elements must be a Float64Array of 10 values per satellite");
         return NULL;
     }
 
-    // Get constants from object
-    napi_value j2_val, j3_val, j4_val, ke_val, qo_val, so_val, re_val, ae_val;
-    napi_get_named_property(env, argv[0], "J2", &j2_val);
-    napi_get_named_property(env, argv[0], "J3", &j3_val);
-    napi_get_named_property(env, argv[0], "J4", &j4_val);
-    napi_get_named_property(env, argv[0], "KE", &ke_val);
-    napi_get_named_property(env, argv[0], "QO", &qo_val);
-    napi_get_named_property(env, argv[0], "SO", &so_val);
-    napi_get_named_property(env, argv[0], "RE", &re_val);
-    napi_get_named_property(env, argv[0], "AE", &ae_val);
+    const double* e = (const double*)data;
+    int n = (int)(length / 10);
 
-    napi_get_value_double(env, j2_val, &current_geophs.j2);
-    napi_get_value_double(env, j3_val, &current_geophs.j3);
-    napi_get_value_double(env, j4_val, &current_geophs.j4);
-    napi_get_value_double(env, ke_val, &current_geophs.ke);
-    napi_get_value_double(env, qo_val, &current_geophs.qo);
-    napi_get_value_double(env, so_val, &current_geophs.so);
-    napi_get_value_double(env, re_val, &current_geophs.re);
-    napi_get_value_double(env, ae_val, &current_geophs.ae);
+    SGP4Batch* batch = sgp4_batch_alloc(n);
+    if (!batch) {
+        napi_throw_error(env, NULL, "Failed to allocate batch");
+        return NULL;
+    }
 
-    // Get model name if provided
-    if (argc >= 2) {
-        size_t name_len;
-        napi_get_value_string_utf8(env, argv[1], NULL, 0, &name_len);
-        if (name_len > 0 && name_len < sizeof(current_model_name)) {
-            napi_get_value_string_utf8(env, argv[1], current_model_name,
-                                       sizeof(current_model_name), &name_len);
+    if (columnar) {
+        sgp4_batch_set_columns(batch, e, n);
+    } else {
+        for (int i = 0; i < n; i++, e += 10) {
+            sgp4_batch_set(batch, i, e[0], e[1], e[2], e[3], e[4], e[5], e[6], e[7], e[8], e[9]);
         }
     }
 
-    napi_value result;
-    napi_get_undefined(env, &result);
-    return result;
+    *n_sats = n;
+    return batch;
 }
 
 /**
- * getGeophysicalConstants() -> constants object
+ * propagateBatchPacked(elements: Float64Array, et0: number, etf: number, step: number)
+ *   -> Float64Array
+ *
+ * Propagate several satellites (10 element values each) over one time
+ * grid in a single multi-satellite sweep, so SIMD lanes are filled across
+ * satellites. Returns one propagateRangePacked() block (7 columns of
+ * n_steps) per satellite, back to back.
  */
-static napi_value NativeGetGeophs(napi_env env, napi_callback_info info) {
-    napi_value result;
-    napi_create_object(env, &result);
+static napi_value NativePropagateBatchPacked(napi_env env, napi_callback_info info) {
+    size_t argc = 4;
+    napi_value argv[4];
+    NAPI_CHECK_STATUS(env, napi_get_cb_info(env, info, &argc, argv, NULL, NULL),
+                      "Failed to get arguments");
 
-    napi_value j2, j3, j4, ke, qo, so, re, ae;
-    napi_create_double(env, current_geophs.j2, &j2);
-    napi_create_double(env, current_geophs.j3, &j3);
-    napi_create_double(env, current_geophs.j4, &j4);
-    napi_create_double(env, current_geophs.ke, &ke);
-    napi_create_double(env, current_geophs.qo, &qo);
-    napi_create_double(env, current_geophs.so, &so);
-    napi_create_double(env, current_geophs.re, &re);
-    napi_create_double(env, current_geophs.ae, &ae);
+    if (argc < 4) {
+        napi_throw_error(env, NULL, "propagateBatchPacked requires 4 arguments: elements, et0, etf, step");
+        return NULL;
+    }
 
-    napi_set_named_property(env, result, "J2", j2);
-    napi_set_named_property(env, result, "J3", j3);
-    napi_set_named_property(env, result, "J4", j4);
+    double et0, etf, step;
+    napi_get_value_double(env, argv[1], &et0);
+    napi_get_value_double(env, argv[2], &etf);
+    napi_get_value_double(env, argv[3], &step);
+
+    int n_steps = (int)((etf - et0) / step) + 1;
+    if (n_steps <= 0) n_steps = 1;
+
+    int n_sats;
+    SGP4Batch* batch = get_element_batch(env, argv[0], &n_sats);
+    if (!batch) return NULL;
+
+    SGP4BatchCoeffs* coeffs = sgp4_coeffs_alloc_mode(n_sats, compact_coeffs);
+    void* out_data;
+    napi_value out_buffer;
+    size_t block = (size_t)n_steps * 7;
+    if (!coeffs ||
+        napi_create_arraybuffer(env, block * n_sats * sizeof(double), &out_data, &out_buffer) != napi_ok) {
+        sgp4_coeffs_free(coeffs);
+        sgp4_batch_free(batch);
+        napi_throw_error(env, NULL, "Failed to allocate result buffer");
+        return NULL;
+    }
+    sgp4_batch_init_coeffs(batch, &current_geophs, coeffs);
+    sgp4_batch_free(batch);
+
+    double* cols = (double*)out_data;
+    for (int s = 0; s < n_sats; s++) {
+        for (int i = 0; i < n_steps; i++) {
+            cols[s * block + i] = et0 + i * step;
+        }
+    }
+
+    // Satellite-major: satellite s starts at s * block, each column n_steps long
+    sgp4_batch_sweep(coeffs, 0, n_sats, et0, step, n_steps,
+                     cols + (size_t)n_steps, cols + (size_t)n_steps * 2, cols + (size_t)n_steps * 3,
+                     cols + (size_t)n_steps * 4, cols + (size_t)n_steps * 5, cols + (size_t)n_steps * 6,
+                     (long)block, 1);
+
+    sgp4_coeffs_free(coeffs);
+
+    napi_value typed_array;
+    napi_create_typedarray(env, napi_float64_array, block * n_sats, out_buffer, 0, &typed_array);
+    return typed_array;
+}
+
+/**
+ * runPipeline(elements: Float64Array, stages: Float64Array, et0: number,
+ *             etf: number, step: number, maxRows: number)
+ *   -> { reduce: Float64Array, rows: Float64Array, rowSat: Int32Array,
+ *        nReduce: number, nSelect: number, truncated: boolean }
+ *
+ * Run an encoded pipeline (5 values per stage) for every satellite in
+ * `elements` (10 values each) over the same time grid as propagateRange().
+ */
+static napi_value NativeRunPipeline(napi_env env, napi_callback_info info) {
+    size_t argc = 6;
+    napi_value argv[6];
+    NAPI_CHECK_STATUS(env, napi_get_cb_info(env, info, &argc, argv, NULL, NULL),
+                      "Failed to get arguments");
+
+    if (argc < 6) {
+        napi_throw_error(env, NULL, "runPipeline requires 6 arguments: elements, stages, et0, etf, step, maxRows");
+        return NULL;
+    }
+
+    napi_typedarray_type type;
+    size_t length;
+    void* data;
+    napi_value array_buffer;
+    size_t offset;
+    if (napi_get_typedarray_info(env, argv[1], &type, &length, &data, &array_buffer, &offset) != napi_ok ||
+        type != napi_float64_array || length % SGP4_PIPELINE_WORDS != 0) {
+        napi_throw_error(env, NULL, "stages must be an encoded pipeline Float64Array");
+        return NULL;
+    }
+
+    SGP4Pipeline pipeline;
+    if (sgp4_pipeline_decode(&pipeline, (const double*)data, (int)(length / SGP4_PIPELINE_WORDS)) != 0) {
+        napi_throw_error(env, NULL, pipeline.error);
+        return NULL;
+    }
+
+    double et0, etf, step, max_rows;
+    napi_get_value_double(env, argv[2], &et0);
+    napi_get_value_double(env, argv[3], &etf);
+    napi_get_value_double(env, argv[4], &step);
+    napi_get_value_double(env, argv[5], &max_rows);
+
+    if (!(step > 0)) {
+        napi_throw_error(env, NULL, "step must be positive");
+        return NULL;
+    }
+
+    int n_steps = (int)((etf - et0) / step) + 1;
+    if (n_steps <= 0) n_steps = 1;
+
+    int n_sats;
+    SGP4Batch* batch = get_element_batch(env, argv[0], &n_sats);
+    if (!batch) return NULL;
+
+    SGP4PipelineResult out;
+    memset(&out, 0, sizeof(out));
+    out.max_rows = (long)max_rows;
+
+    int status = sgp4_pipeline_run(&pipeline, batch, 0, n_sats, &current_geophs, et0, step, n_steps,
+                                   compact_coeffs, &out);
+    sgp4_batch_free(batch);
+
+    if (status != 0) {
+        sgp4_pipeline_result_free(&out);
+        napi_throw_error(env, NULL, "Pipeline ran out of memory");
+        return NULL;
+    }
+
+    // Copy results into JS-owned buffers
+    size_t n_reduce = (size_t)n_sats * out.n_reduce;
+    size_t n_values = (size_t)out.n_rows * out.n_select;
+    void* reduce_data;
+    void* rows_data;
+    void* row_sat_data;
+    napi_value reduce_buffer, rows_buffer, row_sat_buffer;
+    napi_create_arraybuffer(env, n_reduce * sizeof(double), &reduce_data, &reduce_buffer);
+    napi_create_arraybuffer(env, n_values * sizeof(double), &rows_data, &rows_buffer);
+    napi_create_arraybuffer(env, (size_t)out.n_rows * sizeof(int32_t), &row_sat_data, &row_sat_buffer);
+    if (n_reduce) memcpy(reduce_data, out.reduce, n_reduce * sizeof(double));
+    if (n_values) memcpy(rows_data, out.rows, n_values * sizeof(double));
+    if (out.n_rows) memcpy(row_sat_data, out.row_sat, (size_t)out.n_rows * sizeof(int32_t));
+
+    napi_value result, reduce, rows, row_sat, n_reduce_val, n_select_val, truncated;
+    napi_create_object(env, &result);
+    napi_create_typedarray(env, napi_float64_array, n_reduce, reduce_buffer, 0, &reduce);
+    napi_create_typedarray(env, napi_float64_array, n_values, rows_buffer, 0, &rows);
+    napi_create_typedarray(env, napi_int32_array, (size_t)out.n_rows, row_sat_buffer, 0, &row_sat);
+    napi_create_int32(env, out.n_reduce, &n_reduce_val);
+    napi_create_int32(env, out.n_select, &n_select_val);
+    napi_get_boolean(env, out.truncated, &truncated);
+    napi_set_named_property(env, result, "reduce", reduce);
+    napi_set_named_property(env, result, "rows", rows);
+    napi_set_named_property(env, result, "rowSat", row_sat);
+    napi_set_named_property(env, result, "nReduce", n_reduce_val);
+    napi_set_named_property(env, result, "nSelect", n_select_val);
+    napi_set_named_property(env, result, "truncated", truncated);
+
+    sgp4_pipeline_result_free(&out);
+    return result;
+}
+
+/**
+ * findEvents(elements: Float64Array, specs: Float64Array, et0: number,
+ *            etf: number, maxStep: number, maxEvents: number)
+ *   -> { et: Float64Array, sat: Int32Array, spec: Int32Array,
+ *        direction: Int32Array, truncated: boolean }
+ *
+ * Find sign changes of encoded event functions (3 values per spec) for
+ * every satellite in `elements`, sorted by satellite then time.
+ */
+static napi_value NativeFindEvents(napi_env env, napi_callback_info info) {
+    size_t argc = 6;
+    napi_value argv[6];
+    NAPI_CHECK_STATUS(env, napi_get_cb_info(env, info, &argc, argv, NULL, NULL),
+                      "Failed to get arguments");
+
+    if (argc < 6) {
+        napi_throw_error(env, NULL, "findEvents requires 6 arguments: elements, specs, et0, etf, maxStep, maxEvents");
+        return NULL;
+    }
+
+    napi_typedarray_type type;
+    size_t length;
+    void* data;
+    napi_value array_buffer;
+    size_t offset;
+    SGP4EventSpec specs[SGP4_EVENT_MAX_SPECS];
+    int n_specs = -1;
+    if (napi_get_typedarray_info(env, argv[1], &type, &length, &data, &array_buffer, &offset) == napi_ok &&
+        type == napi_float64_array && length % SGP4_EVENT_WORDS == 0) {
+        n_specs = sgp4_events_decode((const double*)data, (int)(length / SGP4_EVENT_WORDS), specs);
+    }
+    if (n_specs < 0) {
+        napi_throw_error(env, NULL, "specs must be 1-16 encoded event functions");
+        return NULL;
+    }
+
+    double et0, etf, max_step, max_events;
+    napi_get_value_double(env, argv[2], &et0);
+    napi_get_value_double(env, argv[3], &etf);
+    napi_get_value_double(env, argv[4], &max_step);
+    napi_get_value_double(env, argv[5], &max_events);
+
+    if (!(etf >= et0)) {
+        napi_throw_error(env, NULL, "etf must not be before et0");
+        return NULL;
+    }
+
+    int n_sats;
+    SGP4Batch* batch = get_element_batch(env, argv[0], &n_sats);
+    if (!batch) return NULL;
+
+    SGP4EventResult out;
+    memset(&out, 0, sizeof(out));
+    out.max_events = (long)max_events;
+
+    int status = sgp4_events_find(specs, n_specs, batch, 0, n_sats, &current_geophs,
+                                  et0, etf, max_step, compact_coeffs, &out);
+    sgp4_batch_free(batch);
+
+    if (status != 0) {
+        sgp4_events_result_free(&out);
+        napi_throw_error(env, NULL, "Event search ran out of memory");
+        return NULL;
+    }
+
+    size_t n = (size_t)out.n_events;
+    void *et_data, *sat_data, *spec_data, *dir_data;
+    napi_value et_buffer, sat_buffer, spec_buffer, dir_buffer;
+    napi_create_arraybuffer(env, n * sizeof(double), &et_data, &et_buffer);
+    napi_create_arraybuffer(env, n * sizeof(int32_t), &sat_data, &sat_buffer);
+    napi_create_arraybuffer(env, n * sizeof(int32_t), &spec_data, &spec_buffer);
+    napi_create_arraybuffer(env, n * sizeof(int32_t), &dir_data, &dir_buffer);
+    for (size_t i = 0; i < n; i++) {
+        ((double*)et_data)[i] = out.events[i].et;
+        ((int32_t*)sat_data)[i] = out.events[i].sat;
+        ((int32_t*)spec_data)[i] = out.events[i].spec;
+        ((int32_t*)dir_data)[i] = out.events[i].direction;
+    }
+
+    napi_value result, et, sat, spec, direction, truncated;
+    napi_create_object(env, &result);
+    napi_create_typedarray(env, napi_float64_array, n, et_buffer, 0, &et);
+    napi_create_typedarray(env, napi_int32_array, n, sat_buffer, 0, &sat);
+    napi_create_typedarray(env, napi_int32_array, n, spec_buffer, 0, &spec);
+    napi_create_typedarray(env, napi_int32_array, n, dir_buffer, 0, &direction);
+    napi_get_boolean(env, out.truncated, &truncated);
+    napi_set_named_property(env, result, "et", et);
+    napi_set_named_property(env, result, "sat", sat);
+    napi_set_named_property(env, result, "spec", spec);
+    napi_set_named_property(env, result, "direction", direction);
+    napi_set_named_property(env, result, "truncated", truncated);
+
+    sgp4_events_result_free(&out);
+    return result;
+}
+
+/**
+ * screenEphemeris(elements: Float64Array, ephemeris: Float64Array,
+ *                 frame: number, limits: Float64Array, maxStep: number,
+ *                 maxApproaches: number)
+ *   -> { tca: Float64Array, sat: Int32Array, distance: Float64Array,
+ *        speed: Float64Array, ric: Float64Array, candidates: number,
+ *        truncated: boolean }
+ *
+ * Screen a packed ephemeris (et|x|y|z|vx|vy|vz columns, TEME or GCRF)
+ * against every satellite in `elements`. limits = [distance, radial,
+ * in_track, cross_track] (km, component limits <= 0 unused). ric holds 3
+ * values per approach.
+ */
+static napi_value NativeScreenEphemeris(napi_env env, napi_callback_info info) {
+    size_t argc = 6;
+    napi_value argv[6];
+    NAPI_CHECK_STATUS(env, napi_get_cb_info(env, info, &argc, argv, NULL, NULL),
+                      "Failed to get arguments");
+
+    if (argc < 6) {
+        napi_throw_error(env, NULL, "screenEphemeris requires 6 arguments: elements, ephemeris, frame, limits, maxStep, maxApproaches");
+        return NULL;
+    }
+
+    napi_typedarray_type type;
+    size_t length;
+    void* data;
+    napi_value array_buffer;
+    size_t offset;
+    if (napi_get_typedarray_info(env, argv[1], &type, &length, &data, &array_buffer, &offset) != napi_ok ||
+        type != napi_float64_array || length % 7 != 0 || length < 14) {
+        napi_throw_error(env, NULL, "ephemeris must be a packed Float64Array of at least 2 states");
+        return NULL;
+    }
+    const double* packed = (const double*)data;
+    int n_states = (int)(length / 7);
+    for (int i = 1; i < n_states; i++) {
+        if (!(packed[i] > packed[i - 1])) {
+            napi_throw_error(env, NULL, "ephemeris epochs must be strictly increasing");
+            return NULL;
+        }
+    }
+
+    int32_t frame;
+    napi_get_value_int32(env, argv[2], &frame);
+    if (frame != SGP4_FRAME_TEME && frame != SGP4_FRAME_GCRF) {
+        napi_throw_error(env, NULL, "frame must be TEME (0) or GCRF (1)");
+        return NULL;
+    }
+
+    SGP4ScreenLimits limits;
+    if (napi_get_typedarray_info(env, argv[3], &type, &length, &data, &array_buffer, &offset) != napi_ok ||
+        type != napi_float64_array || length != 4 || !(((const double*)data)[0] > 0.0)) {
+        napi_throw_error(env, NULL, "limits must be a Float64Array [distance > 0, radial, in_track, cross_track]");
+        return NULL;
+    }
+    limits.distance = ((const double*)data)[0];
+    limits.radial = ((const double*)data)[1];
+    limits.in_track = ((const double*)data)[2];
+    limits.cross_track = ((const double*)data)[3];
+
+    double max_step, max_approaches;
+    napi_get_value_double(env, argv[4], &max_step);
+    napi_get_value_double(env, argv[5], &max_approaches);
+
+    SGP4Ephemeris eph = {
+        n_states, packed,
+        packed + n_states, packed + 2 * n_states, packed + 3 * n_states,
+        packed + 4 * n_states, packed + 5 * n_states, packed + 6 * n_states,
+        frame
+    };
+
+    int n_sats;
+    SGP4Batch* batch = get_element_batch(env, argv[0], &n_sats);
+    if (!batch) return NULL;
+
+    SGP4ScreenResult out;
+    memset(&out, 0, sizeof(out));
+    out.max_approaches = (long)max_approaches;
+
+    int status = sgp4_screen_run(&eph, &limits, batch, 0, n_sats, &current_geophs,
+                                 max_step, compact_coeffs, &out);
+    sgp4_batch_free(batch);
+
+    if (status != 0) {
+        sgp4_screen_result_free(&out);
+        napi_throw_error(env, NULL, "Ephemeris screening ran out of memory");
+        return NULL;
+    }
+
+    size_t n = (size_t)out.n_approaches;
+    void *tca_data, *sat_data, *dist_data, *speed_data, *ric_data;
+    napi_value tca_buffer, sat_buffer, dist_buffer, speed_buffer, ric_buffer;
+    napi_create_arraybuffer(env, n * sizeof(double), &tca_data, &tca_buffer);
+    napi_create_arraybuffer(env, n * sizeof(int32_t), &sat_data, &sat_buffer);
+    napi_create_arraybuffer(env, n * sizeof(double), &dist_data, &dist_buffer);
+    napi_create_arraybuffer(env, n * sizeof(double), &speed_data, &speed_buffer);
+    napi_create_arraybuffer(env, n * 3 * sizeof(double), &ric_data, &ric_buffer);
+    for (size_t i = 0; i < n; i++) {
+        ((double*)tca_data)[i] = out.approaches[i].tca;
+        ((int32_t*)sat_data)[i] = out.approaches[i].sat;
+        ((double*)dist_data)[i] = out.approaches[i].distance;
+        ((double*)speed_data)[i] = out.approaches[i].speed;
+        memcpy((double*)ric_data + 3 * i, out.approaches[i].ric, 3 * sizeof(double));
+    }
+
+    napi_value result, tca, sat, distance, speed, ric, candidates, truncated;
+    napi_create_object(env, &result);
+    napi_create_typedarray(env, napi_float64_array, n, tca_buffer, 0, &tca);
+    napi_create_typedarray(env, napi_int32_array, n, sat_buffer, 0, &sat);
+    napi_create_typedarray(env, napi_float64_array, n, dist_buffer, 0, &distance);
+    napi_create_typedarray(env, napi_float64_array, n, speed_buffer, 0, &speed);
+    napi_create_typedarray(env, napi_float64_array, n * 3, ric_buffer, 0, &ric);
+    napi_create_int32(env, out.candidates, &candidates);
+    napi_get_boolean(env, out.truncated, &truncated);
+    napi_set_named_property(env, result, "tca", tca);
+    napi_set_named_property(env, result, "sat", sat);
+    napi_set_named_property(env, result, "distance", distance);
+    napi_set_named_property(env, result, "speed", speed);
+    napi_set_named_property(env, result, "ric", ric);
+    napi_set_named_property(env, result, "candidates", candidates);
+    napi_set_named_property(env, result, "truncated", truncated);
+
+    sgp4_screen_result_free(&out);
+    return result;
+}
+
+/**
+ * Helper: copy a string argument into a malloc'd buffer (caller frees)
+ */
+static char* get_string_arg(napi_env env, napi_value value, size_t* length) {
+    if (napi_get_value_string_utf8(env, value, NULL, 0, length) != napi_ok) {
+        napi_throw_type_error(env, NULL, "Expected a string");
+        return NULL;
+    }
+    char* str = (char*)malloc(*length + 1);
+    if (!str) {
+        napi_throw_error(env, NULL, "Out of memory");
+        return NULL;
+    }
+    napi_get_value_string_utf8(env, value, str, *length + 1, length);
+    return str;
+}
+
+static void archive_builder_finalize(napi_env env, void* data, void* hint) {
+    sgp4_archive_builder_free((SGP4ArchiveBuilder*)data);
+}
+
+static void archive_finalize(napi_env env, void* data, void* hint) {
+    sgp4_archive_close((SGP4Archive*)data);
+}
+
+/**
+ * archiveBuilder() -> builder handle
+ *
+ * Start collecting element sets for a history archive.
+ */
+static napi_value NativeArchiveBuilder(napi_env env, napi_callback_info info) {
+    SGP4ArchiveBuilder* builder = sgp4_archive_builder_alloc();
+    if (!builder) {
+        napi_throw_error(env, NULL, "Out of memory");
+        return NULL;
+    }
+
+    napi_value handle;
+    NAPI_CHECK_STATUS(env, napi_create_external(env, builder, archive_builder_finalize, NULL, &handle),
+                      "Failed to create archive builder");
+    return handle;
+}
+
+/**
+ * archiveAdd(builder, text: string) -> { added: number, skipped: number }
+ *
+ * Add every TLE in a block of 2LE/3LE text. Malformed pairs are skipped.
+ */
+static napi_value NativeArchiveAdd(napi_env env, napi_callback_info info) {
+    size_t argc = 2;
+    napi_value argv[2];
+    NAPI_CHECK_STATUS(env, napi_get_cb_info(env, info, &argc, argv, NULL, NULL),
+                      "Failed to get arguments");
+
+    SGP4ArchiveBuilder* builder;
+    if (argc < 2 || napi_get_value_external(env, argv[0], (void**)&builder) != napi_ok) {
+        napi_throw_error(env, NULL, "archiveAdd requires 2 arguments: builder, text");
+        return NULL;
+    }
+
+    size_t length;
+    char* text = get_string_arg(env, argv[1], &length);
+    if (!text) return NULL;
+
+    long skipped;
+    long added = sgp4_archive_builder_add_text(builder, text, length, &skipped);
+    free(text);
+
+    if (added < 0) {
+        napi_throw_error(env, NULL, "Archive builder ran out of memory");
+        return NULL;
+    }
+
+    napi_value result, added_value, skipped_value;
+    napi_create_object(env, &result);
+    napi_create_int64(env, added, &added_value);
+    napi_create_int64(env, skipped, &skipped_value);
+    napi_set_named_property(env, result, "added", added_value);
+    napi_set_named_property(env, result, "skipped", skipped_value);
+    return result;
+}
+
+/**
+ * archiveWrite(builder, path: string) -> { records, objects, bytes }
+ *
+ * Sort, de-duplicate and write the collected element sets.
+ */
+static napi_value NativeArchiveWrite(napi_env env, napi_callback_info info) {
+    size_t argc = 2;
+    napi_value argv[2];
+    NAPI_CHECK_STATUS(env, napi_get_cb_info(env, info, &argc, argv, NULL, NULL),
+                      "Failed to get arguments");
+
+    SGP4ArchiveBuilder* builder;
+    if (argc < 2 || napi_get_value_external(env, argv[0], (void**)&builder) != napi_ok) {
+        napi_throw_error(env, NULL, "archiveWrite requires 2 arguments: builder, path");
+        return NULL;
+    }
+
+    size_t length;
+    char* path = get_string_arg(env, argv[1], &length);
+    if (!path) return NULL;
+
+    long n_records = 0, n_objects = 0;
+    long bytes = sgp4_archive_builder_write(builder, path, &n_records, &n_objects);
+    free(path);
+
+    if (bytes < 0) {
+        napi_throw_error(env, NULL, "Failed to write archive");
+        return NULL;
+    }
+
+    napi_value result, records, objects, size;
+    napi_create_object(env, &result);
+    napi_create_int64(env, n_records, &records);
+    napi_create_int64(env, n_objects, &objects);
+    napi_create_int64(env, bytes, &size);
+    napi_set_named_property(env, result, "records", records);
+    napi_set_named_property(env, result, "objects", objects);
+    napi_set_named_property(env, result, "bytes", size);
+    return result;
+}
+
+/**
+ * archiveOpen(path: string) -> archive handle
+ *
+ * Open a history archive and load its epoch index. The file stays open
+ * until the handle is garbage collected.
+ */
+static napi_value NativeArchiveOpen(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value argv[1];
+    NAPI_CHECK_STATUS(env, napi_get_cb_info(env, info, &argc, argv, NULL, NULL),
+                      "Failed to get arguments");
+
+    if (argc < 1) {
+        napi_throw_error(env, NULL, "archiveOpen requires 1 argument: path");
+        return NULL;
+    }
+
+    size_t length;
+    char* path = get_string_arg(env, argv[0], &length);
+    if (!path) return NULL;
+
+    SGP4Archive* archive = sgp4_archive_open(path);
+    free(path);
+    if (!archive) {
+        napi_throw_error(env, NULL, "Cannot open archive (missing file, not an element-set archive, or corrupt index)");
+        return NULL;
+    }
+
+    napi_value handle, records, objects, blocks;
+    NAPI_CHECK_STATUS(env, napi_create_external(env, archive, archive_finalize, NULL, &handle),
+                      "Failed to create archive handle");
+
+    napi_value result;
+    napi_create_object(env, &result);
+    napi_create_int64(env, (int64_t)archive->header.n_records, &records);
+    napi_create_int64(env, (int64_t)archive->header.n_objects, &objects);
+    napi_create_int64(env, (int64_t)archive->header.n_blocks, &blocks);
+    napi_set_named_property(env, result, "handle", handle);
+    napi_set_named_property(env, result, "records", records);
+    napi_set_named_property(env, result, "objects", objects);
+    napi_set_named_property(env, result, "blocks", blocks);
+    return result;
+}
+
+/**
+ * archiveQuery(archive, norads: Int32Array, et0: number, etf: number)
+ *   -> { elements: Float64Array, norad: Int32Array }
+ *
+ * Load all element sets of the given objects with epoch in [et0, etf],
+ * 10 values each (as parseTLE().elements), ready for the batch calls.
+ */
+static napi_value NativeArchiveQuery(napi_env env, napi_callback_info info) {
+    size_t argc = 4;
+    napi_value argv[4];
+    NAPI_CHECK_STATUS(env, napi_get_cb_info(env, info, &argc, argv, NULL, NULL),
+                      "Failed to get arguments");
+
+    SGP4Archive* archive;
+    if (argc < 4 || napi_get_value_external(env, argv[0], (void**)&archive) != napi_ok) {
+        napi_throw_error(env, NULL, "archiveQuery requires 4 arguments: archive, norads, et0, etf");
+        return NULL;
+    }
+
+    napi_typedarray_type type;
+    size_t n_norads;
+    void* norads;
+    napi_value array_buffer;
+    size_t offset;
+    if (napi_get_typedarray_info(env, argv[1], &type, &n_norads, &norads, &array_buffer, &offset) != napi_ok ||
+        type != napi_int32_array) {
+        napi_throw_type_error(env, NULL, "norads must be an Int32Array");
+        return NULL;
+    }
+
+    double et0, etf;
+    napi_get_value_double(env, argv[2], &et0);
+    napi_get_value_double(env, argv[3], &etf);
+
+    SGP4ArchiveResult out;
+    memset(&out, 0, sizeof(out));
+    if (sgp4_archive_query(archive, (const int32_t*)norads, (int)n_norads, et0, etf, &out) != 0) {
+        sgp4_archive_result_free(&out);
+        napi_throw_error(env, NULL, "Failed to read archive (I/O error or corrupt block)");
+        return NULL;
+    }
+
+    size_t n = (size_t)out.n;
+    void *elements_data, *norad_data;
+    napi_value elements_buffer, norad_buffer;
+    napi_create_arraybuffer(env, n * 10 * sizeof(double), &elements_data, &elements_buffer);
+    napi_create_arraybuffer(env, n * sizeof(int32_t), &norad_data, &norad_buffer);
+    if (n) {
+        memcpy(elements_data, out.elements, n * 10 * sizeof(double));
+        memcpy(norad_data, out.norad, n * sizeof(int32_t));
+    }
+    sgp4_archive_result_free(&out);
+
+    napi_value result, elements, norad;
+    napi_create_object(env, &result);
+    napi_create_typedarray(env, napi_float64_array, n * 10, elements_buffer, 0, &elements);
+    napi_create_typedarray(env, napi_int32_array, n, norad_buffer, 0, &norad);
+    napi_set_named_property(env, result, "elements", elements);
+    napi_set_named_property(env, result, "norad", norad);
+    return result;
+}
+
+static void catalog_finalize(napi_env env, void* data, void* hint) {
+    sgp4_catalog_free((SGP4Catalog*)data);
+}
+
+/**
+ * catalogIndex(elements: Float64Array | { columns: Float64Array }) -> catalog handle
+ *
+ * Derive perigee/apogee altitude, inclination, period, RAAN, eccentricity
+ * and Earth-fixed mean longitude of every element set (under the current
+ * geophysical constants) and index each in sorted order.
+ */
+static napi_value NativeCatalogIndex(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value argv[1];
+    NAPI_CHECK_STATUS(env, napi_get_cb_info(env, info, &argc, argv, NULL, NULL),
+                      "Failed to get arguments");
+
+    if (argc < 1) {
+        napi_throw_error(env, NULL, "catalogIndex requires 1 argument: elements");
+        return NULL;
+    }
+
+    int n;
+    SGP4Batch* batch = get_element_batch(env, argv[0], &n);
+    if (!batch) return NULL;
+
+    SGP4Catalog* cat = sgp4_catalog_build(batch, &current_geophs);
+    sgp4_batch_free(batch);
+    if (!cat) {
+        napi_throw_error(env, NULL, "Out of memory");
+        return NULL;
+    }
+
+    napi_value handle;
+    NAPI_CHECK_STATUS(env, napi_create_external(env, cat, catalog_finalize, NULL, &handle),
+                      "Failed to create catalog handle");
+    return handle;
+}
+
+/**
+ * catalogValues(catalog) -> Float64Array
+ *
+ * The indexed parameters, one column of n values per parameter in
+ * SGP4CatalogParam order (NaN for invalid element sets).
+ */
+static napi_value NativeCatalogValues(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value argv[1];
+    NAPI_CHECK_STATUS(env, napi_get_cb_info(env, info, &argc, argv, NULL, NULL),
+                      "Failed to get arguments");
+
+    SGP4Catalog* cat;
+    if (argc < 1 || napi_get_value_external(env, argv[0], (void**)&cat) != napi_ok) {
+        napi_throw_error(env, NULL, "catalogValues requires 1 argument: catalog");
+        return NULL;
+    }
+
+    size_t length = (size_t)SGP4_CAT_NPARAMS * cat->n;
+    void* data;
+    napi_value buffer, values;
+    napi_create_arraybuffer(env, length * sizeof(double), &data, &buffer);
+    if (length) {
+        memcpy(data, cat->values, length * sizeof(double));
+    }
+    napi_create_typedarray(env, napi_float64_array, length, buffer, 0, &values);
+    return values;
+}
+
+/**
+ * catalogQuery(catalog, predicates: Float64Array) -> Int32Array
+ *
+ * Indices of the element sets matching every (parameter, lo, hi) triple,
+ * ascending.
+ */
+static napi_value NativeCatalogQuery(napi_env env, napi_callback_info info) {
+    size_t argc = 2;
+    napi_value argv[2];
+    NAPI_CHECK_STATUS(env, napi_get_cb_info(env, info, &argc, argv, NULL, NULL),
+                      "Failed to get arguments");
+
+    SGP4Catalog* cat;
+    if (argc < 2 || napi_get_value_external(env, argv[0], (void**)&cat) != napi_ok) {
+        napi_throw_error(env, NULL, "catalogQuery requires 2 arguments: catalog, predicates");
+        return NULL;
+    }
+
+    napi_typedarray_type type;
+    size_t length;
+    void* preds;
+    napi_value array_buffer;
+    size_t offset;
+    if (napi_get_typedarray_info(env, argv[1], &type, &length, &preds, &array_buffer, &offset) != napi_ok ||
+        type != napi_float64_array || length % 3 != 0) {
+        napi_throw_type_error(env, NULL, "predicates must be a Float64Array of (parameter, lo, hi) triples");
+        return NULL;
+    }
+
+    int32_t* out = (int32_t*)malloc((cat->n > 0 ? cat->n : 1) * sizeof(int32_t));
+    if (!out) {
+        napi_throw_error(env, NULL, "Out of memory");
+        return NULL;
+    }
+    long count = sgp4_catalog_query(cat, (const double*)preds, (int)(length / 3), out);
+    if (count < 0) {
+        free(out);
+        napi_throw_error(env, NULL, "Unknown catalog parameter");
+        return NULL;
+    }
+
+    void* data;
+    napi_value buffer, indices;
+    napi_create_arraybuffer(env, (size_t)count * sizeof(int32_t), &data, &buffer);
+    if (count) {
+        memcpy(data, out, (size_t)count * sizeof(int32_t));
+    }
+    free(out);
+    napi_create_typedarray(env, napi_int32_array, (size_t)count, buffer, 0, &indices);
+    return indices;
+}
+
+/**
+ * Helper: read a packed ephemeris argument (7 SoA columns).
+ * Returns the row count, or -1 after throwing a JS error.
+ */
+static long get_packed_ephemeris(napi_env env, napi_value value, double** cols) {
+    napi_typedarray_type type;
+    size_t length;
+    void* data;
+    napi_value array_buffer;
+    size_t offset;
+
+    if (napi_get_typedarray_info(env, value, &type, &length, &data, &array_buffer, &offset) != napi_ok ||
+        type != napi_float64_array || length % 7 != 0) {
+        napi_throw_error(env, NULL, "ephemeris must be a packed Float64Array with 7 columns");
+        return -1;
+    }
+
+    *cols = (double*)data;
+    return (long)(length / 7);
+}
+
+/**
+ * temeToGcrf(packed: Float64Array) -> undefined
+ *
+ * Rotate a packed ephemeris from TEME to GCRF in place.
+ */
+static napi_value NativeTemeToGcrf(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value argv[1];
+    NAPI_CHECK_STATUS(env, napi_get_cb_info(env, info, &argc, argv, NULL, NULL),
+                      "Failed to get arguments");
+
+    if (argc < 1) {
+        napi_throw_error(env, NULL, "temeToGcrf requires 1 argument: packed ephemeris");
+        return NULL;
+    }
+
+    double* cols;
+    long n = get_packed_ephemeris(env, argv[0], &cols);
+    if (n < 0) return NULL;
+
+    sgp4_teme_to_gcrf(cols, cols + n, cols + 2 * n, cols + 3 * n,
+                      cols + 4 * n, cols + 5 * n, cols + 6 * n, (int)n);
+
+    napi_value result;
+    napi_get_undefined(env, &result);
+    return result;
+}
+
+// Upper bound of one serialized state (XML stateVector is the longest)
+#define OEM_MAX_ROW_BYTES 512
+
+/**
+ * formatEphemeris(packed: Float64Array, start: number, count: number, format: 'kvn' | 'xml')
+ *   -> string
+ *
+ * Serialize rows [start, start + count) of a packed ephemeris as CCSDS OEM
+ * data lines (KVN) or <stateVector> elements (XML). Intended to be called
+ * chunk by chunk so large OEM products are never held as one string.
+ */
+static napi_value NativeFormatEphemeris(napi_env env, napi_callback_info info) {
+    size_t argc = 4;
+    napi_value argv[4];
+    NAPI_CHECK_STATUS(env, napi_get_cb_info(env, info, &argc, argv, NULL, NULL),
+                      "Failed to get arguments");
+
+    if (argc < 4) {
+        napi_throw_error(env, NULL, "formatEphemeris requires 4 arguments: packed, start, count, format");
+        return NULL;
+    }
+
+    double* cols;
+    long n = get_packed_ephemeris(env, argv[0], &cols);
+    if (n < 0) return NULL;
+
+    int64_t start, count;
+    napi_get_value_int64(env, argv[1], &start);
+    napi_get_value_int64(env, argv[2], &count);
+
+    char format[8];
+    size_t format_len;
+    napi_get_value_string_utf8(env, argv[3], format, sizeof(format), &format_len);
+    int xml = strcmp(format, "xml") == 0;
+    if (!xml && strcmp(format, "kvn") != 0) {
+        napi_throw_error(env, NULL, "format must be 'kvn' or 'xml'");
+        return NULL;
+    }
+
+    if (start < 0) start = 0;
+    if (start > n) start = n;
+    if (count < 0 || start + count > n) count = n - start;
+
+    size_t cap = (size_t)count * OEM_MAX_ROW_BYTES + 1;
+    char* buffer = malloc(cap);
+    if (!buffer) {
+        napi_throw_error(env, NULL, "Failed to allocate output buffer");
+        return NULL;
+    }
+
+    size_t pos = 0;
+    char epoch[40];
+
+    for (int64_t i = start; i < start + count; i++) {
+        format_utc(cols[i], epoch, sizeof(epoch), 0);
+        for (;;) {
+            int written;
+            if (xml) {
+                written = snprintf(buffer + pos, cap - pos,
+                    "        <stateVector>\n"
+                    "          <EPOCH>%s</EPOCH>\n"
+                    "          <X>%.6f</X>\n"
+                    "          <Y>%.6f</Y>\n"
+                    "          <Z>%.6f</Z>\n"
+                    "          <X_DOT>%.9f</X_DOT>\n"
+                    "          <Y_DOT>%.9f</Y_DOT>\n"
+                    "          <Z_DOT>%.9f</Z_DOT>\n"
+                    "        </stateVector>\n",
+                    epoch, cols[n + i], cols[2 * n + i], cols[3 * n + i],
+                    cols[4 * n + i], cols[5 * n + i], cols[6 * n + i]);
+            } else {
+                written = snprintf(buffer + pos, cap - pos,
+                    "%s %.6f %.6f %.6f %.9f %.9f %.9f\n",
+                    epoch, cols[n + i], cols[2 * n + i], cols[3 * n + i],
+                    cols[4 * n + i], cols[5 * n + i], cols[6 * n + i]);
+            }
+            if (written < 0) {
+                free(buffer);
+                napi_throw_error(env, NULL, "Failed to format state vector");
+                return NULL;
+            }
+            if ((size_t)written < cap - pos) {
+                pos += (size_t)written;
+                break;
+            }
+            // Row longer than the estimate (huge values): grow and format it again
+            size_t grown = cap * 2 + (size_t)written;
+            char* larger = realloc(buffer, grown);
+            if (!larger) {
+                free(buffer);
+                napi_throw_error(env, NULL, "Failed to allocate output buffer");
+                return NULL;
+            }
+            buffer = larger;
+            cap = grown;
+        }
+    }
+
+    napi_value result;
+    napi_status status = napi_create_string_utf8(env, buffer, pos, &result);
+    free(buffer);
+
+    if (status != napi_ok) {
+        napi_throw_error(env, NULL, "Failed to create output string");
+        return NULL;
+    }
+
+    return result;
+}
+
+/**
+ * utcToET(utc: string) -> number
+ */
+static napi_value NativeUtcToET(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value argv[1];
+    NAPI_CHECK_STATUS(env, napi_get_cb_info(env, info, &argc, argv, NULL, NULL),
+                      "Failed to get arguments");
+
+    if (argc < 1) {
+        napi_throw_error(env, NULL, "utcToET requires 1 argument: utc string");
+        return NULL;
+    }
+
+    size_t utc_len;
+    napi_get_value_string_utf8(env, argv[0], NULL, 0, &utc_len);
+    char* utc = malloc(utc_len + 1);
+    napi_get_value_string_utf8(env, argv[0], utc, utc_len + 1, &utc_len);
+
+    double et = utc_to_et(utc);
+    free(utc);
+
+    napi_value result;
+    napi_create_double(env, et, &result);
+    return result;
+}
+
+/**
+ * etToUTC(et: number) -> string
+ */
+static napi_value NativeEtToUTC(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value argv[1];
+    NAPI_CHECK_STATUS(env, napi_get_cb_info(env, info, &argc, argv, NULL, NULL),
+                      "Failed to get arguments");
+
+    if (argc < 1) {
+        napi_throw_error(env, NULL, "etToUTC requires 1 argument: et");
+        return NULL;
+    }
+
+    double et;
+    napi_get_value_double(env, argv[0], &et);
+
+    char utc[64];
+    et_to_utc(et, utc, sizeof(utc));
+
+    napi_value result;
+    napi_create_string_utf8(env, utc, NAPI_AUTO_LENGTH, &result);
+    return result;
+}
+
+/**
+ * setGeophysicalConstants(constants, modelName)
+ */
+static napi_value NativeSetGeophs(napi_env env, napi_callback_info info) {
+    size_t argc = 2;
+    napi_value argv[2];
+    NAPI_CHECK_STATUS(env, napi_get_cb_info(env, info, &argc, argv, NULL, NULL),
+                      "Failed to get arguments");
+
+    if (argc < 1) {
+        napi_throw_error(env, NULL, "setGeophysicalConstants requires constants object");
+        return NULL;
+    }
+
+    // Get constants from object
+    napi_value j2_val, j3_val, j4_val, ke_val, qo_val, so_val, re_val, ae_val;
+    napi_get_named_property(env, argv[0], "J2", &j2_val);
+    napi_get_named_property(env, argv[0], "J3", &j3_val);
+    napi_get_named_property(env, argv[0], "J4", &j4_val);
+    napi_get_named_property(env, argv[0], "KE", &ke_val);
+    napi_get_named_property(env, argv[0], "QO", &qo_val);
+    napi_get_named_property(env, argv[0], "SO", &so_val);
+    napi_get_named_property(env, argv[0], "RE", &re_val);
+    napi_get_named_property(env, argv[0], "AE", &ae_val);
+
+    napi_get_value_double(env, j2_val, &current_geophs.j2);
+    napi_get_value_double(env, j3_val, &current_geophs.j3);
+    napi_get_value_double(env, j4_val, &current_geophs.j4);
+    napi_get_value_double(env, ke_val, &current_geophs.ke);
+    napi_get_value_double(env, qo_val, &current_geophs.qo);
+    napi_get_value_double(env, so_val, &current_geophs.so);
+    napi_get_value_double(env, re_val, &current_geophs.re);
+    napi_get_value_double(env, ae_val, &current_geophs.ae);
+
+    // Get model name if provided
+    if (argc >= 2) {
+        size_t name_len;
+        napi_get_value_string_utf8(env, argv[1], NULL, 0, &name_len);
+        if (name_len > 0 && name_len < sizeof(current_model_name)) {
+            napi_get_value_string_utf8(env, argv[1], current_model_name,
+                                       sizeof(current_model_name), &name_len);
+        }
+    }
+
+    napi_value result;
+    napi_get_undefined(env, &result);
+    return result;
+}
+
+/**
+ * getGeophysicalConstants() -> constants object
+ */
+static napi_value NativeGetGeophs(napi_env env, napi_callback_info info) {
+    napi_value result;
+    napi_create_object(env, &result);
+
+    napi_value j2, j3, j4, ke, qo, so, re, ae;
+    napi_create_double(env, current_geophs.j2, &j2);
+    napi_create_double(env, current_geophs.j3, &j3);
+    napi_create_double(env, current_geophs.j4, &j4);
+    napi_create_double(env, current_geophs.ke, &ke);
+    napi_create_double(env, current_geophs.qo, &qo);
+    napi_create_double(env, current_geophs.so, &so);
+    napi_create_double(env, current_geophs.re, &re);
+    napi_create_double(env, current_geophs.ae, &ae);
+
+    napi_set_named_property(env, result, "J2", j2);
+    napi_set_named_property(env, result, "J3", j3);
+    napi_set_named_property(env, result, "J4", j4);
     napi_set_named_property(env, result, "KE", ke);
     napi_set_named_property(env, result, "QO", qo);
     napi_set_named_property(env, result, "SO", so);
@@ -676,6 +1840,27 @@ static napi_value NativeGetGeophs(napi_env env, napi_callback_info info) {
     return result;
 }
 
+/**
+ * setCompactCoefficients(enabled: boolean)
+ *
+ * Select compact (quantized) or full coefficient storage for the sweeps
+ * from now on. Propagators already created keep their storage.
+ */
+static napi_value NativeSetCompactCoeffs(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value argv[1];
+    NAPI_CHECK_STATUS(env, napi_get_cb_info(env, info, &argc, argv, NULL, NULL),
+                      "Failed to get arguments");
+
+    bool enabled = false;
+    if (argc < 1 || napi_get_value_bool(env, argv[0], &enabled) != napi_ok) {
+        napi_throw_error(env, NULL, "setCompactCoefficients requires a boolean");
+        return NULL;
+    }
+    compact_coeffs = enabled;
+    return NULL;
+}
+
 /**
  * getModelName() -> string
  */
@@ -722,11 +1907,29 @@ static napi_value Init(napi_env env, napi_value exports) {
         { "init", NULL, NativeInit, NULL, NULL, NULL, napi_default, NULL },
         { "parseTLE", NULL, NativeParseTLE, NULL, NULL, NULL, napi_default, NULL },
         { "propagate", NULL, NativePropagate, NULL, NULL, NULL, napi_default, NULL },
+        { "propagator", NULL, NativePropagator, NULL, NULL, NULL, napi_default, NULL },
         { "propagateRange", NULL, NativePropagateRange, NULL, NULL, NULL, napi_default, NULL },
+        { "propagateRangePacked", NULL, NativePropagateRangePacked, NULL, NULL, NULL, napi_default, NULL },
+        { "propagateRangePartials", NULL, NativePropagateRangePartials, NULL, NULL, NULL, napi_default, NULL },
+        { "propagateBatchPacked", NULL, NativePropagateBatchPacked, NULL, NULL, NULL, napi_default, NULL },
+        { "runPipeline", NULL, NativeRunPipeline, NULL, NULL, NULL, napi_default, NULL },
+        { "findEvents", NULL, NativeFindEvents, NULL, NULL, NULL, napi_default, NULL },
+        { "screenEphemeris", NULL, NativeScreenEphemeris, NULL, NULL, NULL, napi_default, NULL },
+        { "archiveBuilder", NULL, NativeArchiveBuilder, NULL, NULL, NULL, napi_default, NULL },
+        { "archiveAdd", NULL, NativeArchiveAdd, NULL, NULL, NULL, napi_default, NULL },
+        { "archiveWrite", NULL, NativeArchiveWrite, NULL, NULL, NULL, napi_default, NULL },
+        { "archiveOpen", NULL, NativeArchiveOpen, NULL, NULL, NULL, napi_default, NULL },
+        { "archiveQuery", NULL, NativeArchiveQuery, NULL, NULL, NULL, napi_default, NULL },
+        { "catalogIndex", NULL, NativeCatalogIndex, NULL, NULL, NULL, napi_default, NULL },
+        { "catalogValues", NULL, NativeCatalogValues, NULL, NULL, NULL, napi_default, NULL },
+        { "catalogQuery", NULL, NativeCatalogQuery, NULL, NULL, NULL, napi_default, NULL },
+        { "temeToGcrf", NULL, NativeTemeToGcrf, NULL, NULL, NULL, napi_default, NULL },
+        { "formatEphemeris", NULL, NativeFormatEphemeris, NULL, NULL, NULL, napi_default, NULL },
         { "utcToET", NULL, NativeUtcToET, NULL, NULL, NULL, napi_default, NULL },
         { "etToUTC", NULL, NativeEtToUTC, NULL, NULL, NULL, napi_default, NULL },
         { "setGeophysicalConstants", NULL, NativeSetGeophs, NULL, NULL, NULL, napi_default, NULL },
         { "getGeophysicalConstants", NULL, NativeGetGeophs, NULL, NULL, NULL, napi_default, NULL },
+        { "setCompactCoefficients", NULL, NativeSetCompactCoeffs, NULL, NULL, NULL, napi_default, NULL },
         { "getModelName", NULL, NativeGetModelName, NULL, NULL, NULL, napi_default, NULL },
         { "getLastError", NULL, NativeGetLastError, NULL, NULL, NULL, napi_default, NULL },
         { "clearError", NULL, NativeClearError, NULL, NULL, NULL, napi_default, NULL },
@@ -0,0 +1,654 @@
+/**
+ * SGP4 Element-Set History Archive
+ *
+ * Years of catalog TLE history are mostly repetition: the same objects,
+ * fixed-precision fields and small changes between consecutive sets. The
+ * archive stores history column-wise instead of as text:
+ *
+ *   - Each TLE field is kept as the exact scaled integer written in the
+ *     TLE (epoch in 1e-8 days, angles in 1e-4 deg, mean motion in 1e-8
+ *     rev/day, ...), so decoding reproduces parse_tle() bit for bit.
+ *   - Records are grouped by object and sorted by epoch, then cut into
+ *     blocks of SGP4_ARCHIVE_BLOCK records. Inside a block each field is
+ *     delta-encoded against the previous record and written as zigzag
+ *     LEB128 varints, one column after another.
+ *   - A per-object index lists each block's epoch range and file offset,
+ *     so "objects X in window W" reads only the overlapping blocks.
+ *
+ * File layout (little-endian):
+ *
+ *   header   SGP4ArchiveHeader
+ *   blocks   u32 records, u32 bytes, then the varint columns
+ *   objects  SGP4ArchiveObject[n_objects], sorted by NORAD ID
+ *   blocks   SGP4ArchiveBlock[n_blocks], grouped by object
+ */
+
+#include <stdint.h>
+#include "sgp4_batch.h"
+
+#define SGP4_ARCHIVE_MAGIC   "SGP4ARC1"
+#define SGP4_ARCHIVE_VERSION 1
+#define SGP4_ARCHIVE_BLOCK   256
+#define SGP4_ARCHIVE_FIELDS  12
+
+/** Fields of one element set, as the scaled integers of the TLE text */
+typedef struct {
+    int32_t norad;
+    double et;                          // Epoch (ET), for sorting and indexing
+    int64_t f[SGP4_ARCHIVE_FIELDS];     // See SGP4ArchiveField
+} SGP4TleRecord;
+
+typedef enum {
+    SGP4_ARCHIVE_EPOCH = 0,  // YYDDD.DDDDDDDD x 1e8
+    SGP4_ARCHIVE_NDOT,       // rev/day^2 x 1e8
+    SGP4_ARCHIVE_NDDOT_M,    // mantissa (5 implied-decimal digits)
+    SGP4_ARCHIVE_NDDOT_E,    // exponent
+    SGP4_ARCHIVE_BSTAR_M,
+    SGP4_ARCHIVE_BSTAR_E,
+    SGP4_ARCHIVE_INCL,       // deg x 1e4
+    SGP4_ARCHIVE_NODE,       // deg x 1e4
+    SGP4_ARCHIVE_ECC,        // x 1e7
+    SGP4_ARCHIVE_ARGP,       // deg x 1e4
+    SGP4_ARCHIVE_MA,         // deg x 1e4
+    SGP4_ARCHIVE_MM          // rev/day x 1e8
+} SGP4ArchiveField;
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t block_records;
+    uint64_t n_records;
+    uint64_t n_objects;
+    uint64_t n_blocks;
+    uint64_t index_offset;  // Offset of the objects table
+} SGP4ArchiveHeader;
+
+typedef struct {
+    int32_t norad;
+    uint32_t n_blocks;
+    uint64_t first_block;   // Index into the blocks table
+} SGP4ArchiveObject;
+
+typedef struct {
+    double et_first;
+    double et_last;
+    uint64_t offset;        // File offset of the block
+    uint32_t n_records;
+    uint32_t bytes;         // Encoded column bytes after the block header
+} SGP4ArchiveBlock;
+
+/** In-memory records collected before writing */
+typedef struct {
+    SGP4TleRecord* records;
+    long n;
+    long capacity;
+} SGP4ArchiveBuilder;
+
+/** An open archive: index in memory, blocks read on demand */
+typedef struct {
+    FILE* file;
+    SGP4ArchiveHeader header;
+    SGP4ArchiveObject* objects;
+    SGP4ArchiveBlock* blocks;
+} SGP4Archive;
+
+/** Element sets loaded from an archive, in elements[10] layout */
+typedef struct {
+    long n;
+    long capacity;
+    double* elements;
+    int32_t* norad;
+} SGP4ArchiveResult;
+
+// ============================================================================
+// TLE fields
+// ============================================================================
+
+/**
+ * Convert TLE field values (in TLE units) to the elements[10] layout.
+ * Shared with the addon's parse_tle() so archived and parsed element sets
+ * are identical.
+ */
+static void sgp4_tle_values_to_elements(double epoch_val, double ndot, double nddot, double bstar,
+                                        double incl, double raan, double ecc, double argp,
+                                        double ma, double mm, double* elements) {
+    int epoch_year = (int)(epoch_val / 1000.0);
+    double epoch_day = epoch_val - epoch_year * 1000.0;
+
+    // Convert 2-digit year to 4-digit
+    epoch_year += epoch_year < 57 ? 2000 : 1900;
+
+    // Julian day of Jan 1 of the epoch year, then days since J2000
+    int a = (14 - 1) / 12;
+    int y = epoch_year + 4800 - a;
+    int m = 1 + 12 * a - 3;
+    int jdn_jan1 = 1 + (153 * m + 2) / 5 + 365 * y + y / 4 - y / 100 + y / 400 - 32045;
+    double jd_jan1 = jdn_jan1 - 0.5;  // JD at midnight
+    double jd_epoch = jd_jan1 + epoch_day - 1.0;  // epoch_day is 1-indexed
+
+    elements[0] = ndot * TWOPI / (MIN_PER_DAY * MIN_PER_DAY);
+    elements[1] = nddot * TWOPI / (MIN_PER_DAY * MIN_PER_DAY * MIN_PER_DAY);
+    elements[2] = bstar;
+    elements[3] = incl * DEG2RAD;
+    elements[4] = raan * DEG2RAD;
+    elements[5] = ecc;
+    elements[6] = argp * DEG2RAD;
+    elements[7] = ma * DEG2RAD;
+    elements[8] = mm * (TWOPI / MIN_PER_DAY);
+    elements[9] = (jd_epoch - 2451545.0) * 86400.0;
+}
+
+/**
+ * Elements of an archived record
+ */
+static void sgp4_archive_record_elements(const int64_t* f, double* elements) {
+    sgp4_tle_values_to_elements(
+        (double)f[SGP4_ARCHIVE_EPOCH] / 1e8,
+        (double)f[SGP4_ARCHIVE_NDOT] / 1e8,
+        (double)f[SGP4_ARCHIVE_NDDOT_M] * pow(10.0, (double)(f[SGP4_ARCHIVE_NDDOT_E] - 5)),
+        (double)f[SGP4_ARCHIVE_BSTAR_M] * pow(10.0, (double)(f[SGP4_ARCHIVE_BSTAR_E] - 5)),
+        (double)f[SGP4_ARCHIVE_INCL] / 1e4,
+        (double)f[SGP4_ARCHIVE_NODE] / 1e4,
+        (double)f[SGP4_ARCHIVE_ECC] / 1e7,
+        (double)f[SGP4_ARCHIVE_ARGP] / 1e4,
+        (double)f[SGP4_ARCHIVE_MA] / 1e4,
+        (double)f[SGP4_ARCHIVE_MM] / 1e8,
+        elements);
+}
+
+/**
+ * Parse a fixed-point decimal field of `len` characters into an integer
+ * scaled by 10^decimals. Blanks are ignored.
+ *
+ * @return 0 on success, -1 if the field holds anything but a number
+ */
+static int archive_parse_fixed(const char* s, int len, int decimals, int64_t* out) {
+    int64_t value = 0;
+    int sign = 1, seen_point = 0, frac = 0, digits = 0;
+
+    for (int i = 0; i < len && s[i]; i++) {
+        char c = s[i];
+        if (c == ' ') {
+            continue;
+        } else if (c == '-' || c == '+') {
+            if (digits || seen_point) return -1;
+            sign = c == '-' ? -1 : 1;
+        } else if (c == '.') {
+            if (seen_point) return -1;
+            seen_point = 1;
+        } else if (c >= '0' && c <= '9') {
+            if (seen_point) {
+                if (frac == decimals) continue;  // Beyond archive precision
+                frac++;
+            }
+            value = value * 10 + (c - '0');
+            digits++;
+        } else {
+            return -1;
+        }
+    }
+
+    for (; frac < decimals; frac++) {
+        value *= 10;
+    }
+    *out = sign * value;
+    return 0;
+}
+
+/**
+ * Catalog number from columns 3-7, including Alpha-5 (A0000-Z9999,
+ * skipping I and O)
+ */
+static int32_t archive_parse_norad(const char* s) {
+    int32_t lead = 0;
+    char c = s[0];
+    if (c >= 'A' && c <= 'Z') {
+        lead = 10 + (c - 'A') - (c > 'I') - (c > 'O');
+    } else if (c >= '0' && c <= '9') {
+        lead = c - '0';
+    }
+    int64_t rest = 0;
+    archive_parse_fixed(s + 1, 4, 0, &rest);
+    return lead * 10000 + (int32_t)rest;
+}
+
+/**
+ * Parse one TLE into archive fields (columns as in parse_tle())
+ *
+ * @return 0 on success, -1 on a malformed line
+ */
+static int sgp4_archive_parse_tle(const char* line1, const char* line2, SGP4TleRecord* r) {
+    int64_t* f = r->f;
+
+    if (archive_parse_fixed(line1 + 18, 14, 8, &f[SGP4_ARCHIVE_EPOCH]) ||
+        archive_parse_fixed(line1 + 33, 10, 8, &f[SGP4_ARCHIVE_NDOT]) ||
+        archive_parse_fixed(line1 + 44, 6, 0, &f[SGP4_ARCHIVE_NDDOT_M]) ||
+        archive_parse_fixed(line1 + 53, 6, 0, &f[SGP4_ARCHIVE_BSTAR_M]) ||
+        archive_parse_fixed(line2 + 8, 8, 4, &f[SGP4_ARCHIVE_INCL]) ||
+        archive_parse_fixed(line2 + 17, 8, 4, &f[SGP4_ARCHIVE_NODE]) ||
+        archive_parse_fixed(line2 + 26, 7, 0, &f[SGP4_ARCHIVE_ECC]) ||
+        archive_parse_fixed(line2 + 34, 8, 4, &f[SGP4_ARCHIVE_ARGP]) ||
+        archive_parse_fixed(line2 + 43, 8, 4, &f[SGP4_ARCHIVE_MA]) ||
+        archive_parse_fixed(line2 + 52, 11, 8, &f[SGP4_ARCHIVE_MM])) {
+        return -1;
+    }
+
+    // Exponents: sign at column 51 / 60, as read by parse_tle()
+    f[SGP4_ARCHIVE_NDDOT_E] = (line1[50] == '-' || line1[50] == '+') ? atoi(line1 + 50) : 0;
+    f[SGP4_ARCHIVE_BSTAR_E] = (line1[59] == '-' || line1[59] == '+') ? atoi(line1 + 59) : 0;
+
+    r->norad = archive_parse_norad(line1 + 2);
+
+    double elements[10];
+    sgp4_archive_record_elements(f, elements);
+    r->et = elements[9];
+    return 0;
+}
+
+// ============================================================================
+// Builder
+// ============================================================================
+
+static SGP4ArchiveBuilder* sgp4_archive_builder_alloc(void) {
+    return (SGP4ArchiveBuilder*)calloc(1, sizeof(SGP4ArchiveBuilder));
+}
+
+static void sgp4_archive_builder_free(SGP4ArchiveBuilder* b) {
+    if (!b) return;
+    free(b->records);
+    free(b);
+}
+
+static int archive_builder_push(SGP4ArchiveBuilder* b, const SGP4TleRecord* r) {
+    if (b->n == b->capacity) {
+        long capacity = b->capacity ? b->capacity * 2 : 4096;
+        SGP4TleRecord* records = (SGP4TleRecord*)realloc(b->records, capacity * sizeof(SGP4TleRecord));
+        if (!records) return -1;
+        b->records = records;
+        b->capacity = capacity;
+    }
+    b->records[b->n++] = *r;
+    return 0;
+}
+
+/**
+ * Add every TLE in a block of 2LE/3LE text (name lines are skipped).
+ *
+ * @return Number of element sets added, or -1 on allocation failure;
+ *         *skipped counts malformed line pairs
+ */
+static long sgp4_archive_builder_add_text(SGP4ArchiveBuilder* b, const char* text, size_t len, long* skipped) {
+    const char* line1 = NULL;
+    const char* p = text;
+    const char* end = text + len;
+    long added = 0;
+
+    *skipped = 0;
+    while (p < end) {
+        const char* eol = memchr(p, '\n', end - p);
+        if (!eol) eol = end;
+        size_t n = eol - p;
+        if (n && p[n - 1] == '\r') n--;
+
+        if (n >= 68 && p[0] == '1' && p[1] == ' ') {
+            line1 = p;
+        } else if (n >= 68 && p[0] == '2' && p[1] == ' ' && line1) {
+            SGP4TleRecord r;
+            if (sgp4_archive_parse_tle(line1, p, &r) == 0) {
+                if (archive_builder_push(b, &r)) return -1;
+                added++;
+            } else {
+                (*skipped)++;
+            }
+            line1 = NULL;
+        } else {
+            line1 = NULL;
+        }
+        p = eol + 1;
+    }
+    return added;
+}
+
+static int archive_record_compare(const void* a, const void* b) {
+    const SGP4TleRecord* ra = (const SGP4TleRecord*)a;
+    const SGP4TleRecord* rb = (const SGP4TleRecord*)b;
+    if (ra->norad != rb->norad) return ra->norad < rb->norad ? -1 : 1;
+    if (ra->et != rb->et) return ra->et < rb->et ? -1 : 1;
+    return 0;
+}
+
+// ============================================================================
+// Column coding
+// ============================================================================
+
+static size_t archive_put_varint(uint8_t* out, int64_t v) {
+    uint64_t z = ((uint64_t)v << 1) ^ (uint64_t)(v >> 63);  // zigzag
+    size_t n = 0;
+    while (z >= 0x80) {
+        out[n++] = (uint8_t)(z | 0x80);
+        z >>= 7;
+    }
+    out[n++] = (uint8_t)z;
+    return n;
+}
+
+static const uint8_t* archive_get_varint(const uint8_t* p, const uint8_t* end, int64_t* v) {
+    uint64_t z = 0;
+    int shift = 0;
+    while (p < end && shift < 64) {
+        uint8_t byte = *p++;
+        z |= (uint64_t)(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            *v = (int64_t)(z >> 1) ^ -(int64_t)(z & 1);
+            return p;
+        }
+        shift += 7;
+    }
+    return NULL;
+}
+
+/**
+ * Encode n records, one delta-coded column per field
+ *
+ * @return Encoded size (out must hold n * SGP4_ARCHIVE_FIELDS * 10 bytes)
+ */
+static size_t archive_encode_block(const SGP4TleRecord* records, int n, uint8_t* out) {
+    size_t size = 0;
+    for (int k = 0; k < SGP4_ARCHIVE_FIELDS; k++) {
+        int64_t prev = 0;
+        for (int i = 0; i < n; i++) {
+            size += archive_put_varint(out + size, records[i].f[k] - prev);
+            prev = records[i].f[k];
+        }
+    }
+    return size;
+}
+
+/**
+ * Decode a block into fields[k * SGP4_ARCHIVE_BLOCK + i]
+ *
+ * @return 0 on success, -1 on corrupt data
+ */
+static int archive_decode_block(const uint8_t* p, size_t bytes, int n, int64_t* fields) {
+    if (n < 0 || n > SGP4_ARCHIVE_BLOCK) return -1;
+    const uint8_t* end = p + bytes;
+    for (int k = 0; k < SGP4_ARCHIVE_FIELDS; k++) {
+        int64_t prev = 0;
+        for (int i = 0; i < n; i++) {
+            int64_t delta;
+            p = archive_get_varint(p, end, &delta);
+            if (!p) return -1;
+            prev += delta;
+            fields[k * SGP4_ARCHIVE_BLOCK + i] = prev;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Sort, de-duplicate and write the collected records.
+ *
+ * Sets with the same object and epoch are kept once (the first added).
+ *
+ * @return File size in bytes, or -1 on I/O or allocation failure
+ */
+static long sgp4_archive_builder_write(SGP4ArchiveBuilder* b, const char* path,
+                                       long* n_records, long* n_objects) {
+    qsort(b->records, b->n, sizeof(SGP4TleRecord), archive_record_compare);
+
+    long unique = 0;
+    for (long i = 0; i < b->n; i++) {
+        if (unique && b->records[unique - 1].norad == b->records[i].norad &&
+            b->records[unique - 1].f[SGP4_ARCHIVE_EPOCH] == b->records[i].f[SGP4_ARCHIVE_EPOCH]) {
+            continue;
+        }
+        b->records[unique++] = b->records[i];
+    }
+    b->n = unique;
+
+    FILE* file = fopen(path, "wb");
+    if (!file) return -1;
+
+    long max_objects = 0, max_blocks = 0;
+    for (long i = 0; i < b->n; i++) {
+        if (i == 0 || b->records[i].norad != b->records[i - 1].norad) max_objects++;
+    }
+    max_blocks = max_objects + b->n / SGP4_ARCHIVE_BLOCK + 1;
+
+    SGP4ArchiveObject* objects = (SGP4ArchiveObject*)calloc(max_objects + 1, sizeof(SGP4ArchiveObject));
+    SGP4ArchiveBlock* blocks = (SGP4ArchiveBlock*)calloc(max_blocks, sizeof(SGP4ArchiveBlock));
+    uint8_t* buf = (uint8_t*)malloc(SGP4_ARCHIVE_BLOCK * SGP4_ARCHIVE_FIELDS * 10);
+    SGP4ArchiveHeader header;
+    memset(&header, 0, sizeof(header));
+
+    int ok = objects && blocks && buf && fwrite(&header, sizeof(header), 1, file) == 1;
+    uint64_t offset = sizeof(header);
+    long n_obj = 0, n_blk = 0;
+
+    for (long i = 0; ok && i < b->n;) {
+        // One object's records: [i, j)
+        long j = i;
+        while (j < b->n && b->records[j].norad == b->records[i].norad) j++;
+
+        SGP4ArchiveObject* obj = &objects[n_obj++];
+        obj->norad = b->records[i].norad;
+        obj->first_block = n_blk;
+
+        for (long s = i; ok && s < j; s += SGP4_ARCHIVE_BLOCK) {
+            int n = (int)(j - s < SGP4_ARCHIVE_BLOCK ? j - s : SGP4_ARCHIVE_BLOCK);
+            size_t bytes = archive_encode_block(b->records + s, n, buf);
+            uint32_t head[2] = { (uint32_t)n, (uint32_t)bytes };
+
+            SGP4ArchiveBlock* blk = &blocks[n_blk++];
+            blk->et_first = b->records[s].et;
+            blk->et_last = b->records[s + n - 1].et;
+            blk->offset = offset;
+            blk->n_records = n;
+            blk->bytes = (uint32_t)bytes;
+            obj->n_blocks++;
+
+            ok = fwrite(head, sizeof(head), 1, file) == 1 && fwrite(buf, 1, bytes, file) == bytes;
+            offset += sizeof(head) + bytes;
+        }
+        i = j;
+    }
+
+    memcpy(header.magic, SGP4_ARCHIVE_MAGIC, 8);
+    header.version = SGP4_ARCHIVE_VERSION;
+    header.block_records = SGP4_ARCHIVE_BLOCK;
+    header.n_records = b->n;
+    header.n_objects = n_obj;
+    header.n_blocks = n_blk;
+    header.index_offset = offset;
+
+    ok = ok &&
+         fwrite(objects, sizeof(SGP4ArchiveObject), n_obj, file) == (size_t)n_obj &&
+         fwrite(blocks, sizeof(SGP4ArchiveBlock), n_blk, file) == (size_t)n_blk &&
+         fseek(file, 0, SEEK_SET) == 0 &&
+         fwrite(&header, sizeof(header), 1, file) == 1;
+
+    free(objects);
+    free(blocks);
+    free(buf);
+    if (fclose(file) != 0) ok = 0;
+    if (!ok) return -1;
+
+    *n_records = b->n;
+    *n_objects = n_obj;
+    return (long)(offset + n_obj * sizeof(SGP4ArchiveObject) + n_blk * sizeof(SGP4ArchiveBlock));
+}
+
+// ============================================================================
+// Reader
+// ============================================================================
+
+static void sgp4_archive_close(SGP4Archive* ar) {
+    if (!ar) return;
+    if (ar->file) fclose(ar->file);
+    free(ar->objects);
+    free(ar->blocks);
+    free(ar);
+}
+
+/**
+ * Check a loaded index against the file: every object's blocks lie in the
+ * blocks table, and every block holds 1..SGP4_ARCHIVE_BLOCK records whose
+ * bytes lie between the header and the index
+ */
+static int archive_index_valid(const SGP4Archive* ar) {
+    const SGP4ArchiveHeader* h = &ar->header;
+    uint64_t records = 0;
+    for (uint64_t i = 0; i < h->n_objects; i++) {
+        const SGP4ArchiveObject* obj = &ar->objects[i];
+        if (obj->first_block > h->n_blocks || obj->n_blocks > h->n_blocks - obj->first_block) return 0;
+    }
+    for (uint64_t i = 0; i < h->n_blocks; i++) {
+        const SGP4ArchiveBlock* blk = &ar->blocks[i];
+        if (blk->n_records == 0 || blk->n_records > SGP4_ARCHIVE_BLOCK ||
+            blk->bytes > SGP4_ARCHIVE_BLOCK * SGP4_ARCHIVE_FIELDS * 10 ||
+            blk->offset < sizeof(SGP4ArchiveHeader) ||
+            blk->offset > h->index_offset ||
+            h->index_offset - blk->offset < 2 * sizeof(uint32_t) + (uint64_t)blk->bytes) {
+            return 0;
+        }
+        records += blk->n_records;
+    }
+    return records == h->n_records;
+}
+
+/**
+ * Open an archive and load its index
+ *
+ * The header counts and the index are checked against the file size, so a
+ * truncated or corrupt file is rejected here rather than read past.
+ *
+ * @return Archive, or NULL if the file is missing, not an archive or corrupt
+ */
+static SGP4Archive* sgp4_archive_open(const char* path) {
+    SGP4Archive* ar = (SGP4Archive*)calloc(1, sizeof(SGP4Archive));
+    if (!ar) return NULL;
+
+    ar->file = fopen(path, "rb");
+    SGP4ArchiveHeader* h = &ar->header;
+    long size = -1;
+    if (ar->file && fseek(ar->file, 0, SEEK_END) == 0) {
+        size = ftell(ar->file);
+    }
+    if (size < (long)sizeof(*h) ||
+        fseek(ar->file, 0, SEEK_SET) != 0 ||
+        fread(h, sizeof(*h), 1, ar->file) != 1 ||
+        memcmp(h->magic, SGP4_ARCHIVE_MAGIC, 8) != 0 ||
+        h->version != SGP4_ARCHIVE_VERSION ||
+        h->block_records != SGP4_ARCHIVE_BLOCK) {
+        sgp4_archive_close(ar);
+        return NULL;
+    }
+
+    // The index is the rest of the file: objects table, then blocks table
+    uint64_t index_bytes = h->index_offset >= sizeof(*h) && h->index_offset <= (uint64_t)size
+        ? (uint64_t)size - h->index_offset : 0;
+    if (h->index_offset < sizeof(*h) ||
+        h->n_objects > index_bytes / sizeof(SGP4ArchiveObject) ||
+        h->n_blocks > index_bytes / sizeof(SGP4ArchiveBlock) ||
+        h->n_objects * sizeof(SGP4ArchiveObject) + h->n_blocks * sizeof(SGP4ArchiveBlock) != index_bytes) {
+        sgp4_archive_close(ar);
+        return NULL;
+    }
+
+    ar->objects = (SGP4ArchiveObject*)malloc((h->n_objects + 1) * sizeof(SGP4ArchiveObject));
+    ar->blocks = (SGP4ArchiveBlock*)malloc((h->n_blocks + 1) * sizeof(SGP4ArchiveBlock));
+    if (!ar->objects || !ar->blocks ||
+        fseek(ar->file, (long)h->index_offset, SEEK_SET) != 0 ||
+        fread(ar->objects, sizeof(SGP4ArchiveObject), h->n_objects, ar->file) != h->n_objects ||
+        fread(ar->blocks, sizeof(SGP4ArchiveBlock), h->n_blocks, ar->file) != h->n_blocks ||
+        !archive_index_valid(ar)) {
+        sgp4_archive_close(ar);
+        return NULL;
+    }
+    return ar;
+}
+
+static const SGP4ArchiveObject* archive_find_object(const SGP4Archive* ar, int32_t norad) {
+    long lo = 0, hi = (long)ar->header.n_objects - 1;
+    while (lo <= hi) {
+        long mid = (lo + hi) / 2;
+        int32_t id = ar->objects[mid].norad;
+        if (id == norad) return &ar->objects[mid];
+        if (id < norad) lo = mid + 1; else hi = mid - 1;
+    }
+    return NULL;
+}
+
+static int archive_result_push(SGP4ArchiveResult* out, const double* elements, int32_t norad) {
+    if (out->n == out->capacity) {
+        long capacity = out->capacity ? out->capacity * 2 : 1024;
+        double* e = (double*)realloc(out->elements, capacity * 10 * sizeof(double));
+        if (!e) return -1;
+        out->elements = e;
+        int32_t* ids = (int32_t*)realloc(out->norad, capacity * sizeof(int32_t));
+        if (!ids) return -1;
+        out->norad = ids;
+        out->capacity = capacity;
+    }
+    memcpy(out->elements + out->n * 10, elements, 10 * sizeof(double));
+    out->norad[out->n++] = norad;
+    return 0;
+}
+
+/**
+ * Load every element set of the given objects with epoch in [et0, etf],
+ * in request order and epoch order per object. Unknown objects are skipped.
+ *
+ * @return 0 on success, -1 on read failure or corrupt data
+ */
+static int sgp4_archive_query(SGP4Archive* ar, const int32_t* norads, int n_norads,
+                              double et0, double etf, SGP4ArchiveResult* out) {
+    int64_t* fields = (int64_t*)malloc(SGP4_ARCHIVE_BLOCK * SGP4_ARCHIVE_FIELDS * sizeof(int64_t));
+    uint8_t* buf = (uint8_t*)malloc(SGP4_ARCHIVE_BLOCK * SGP4_ARCHIVE_FIELDS * 10);
+    int status = fields && buf ? 0 : -1;
+
+    for (int q = 0; status == 0 && q < n_norads; q++) {
+        const SGP4ArchiveObject* obj = archive_find_object(ar, norads[q]);
+        if (!obj) continue;
+
+        for (uint32_t k = 0; status == 0 && k < obj->n_blocks; k++) {
+            const SGP4ArchiveBlock* blk = &ar->blocks[obj->first_block + k];
+            if (blk->et_last < et0) continue;
+            if (blk->et_first > etf) break;
+
+            if (blk->bytes > SGP4_ARCHIVE_BLOCK * SGP4_ARCHIVE_FIELDS * 10 ||
+                fseek(ar->file, (long)(blk->offset + 2 * sizeof(uint32_t)), SEEK_SET) != 0 ||
+                fread(buf, 1, blk->bytes, ar->file) != blk->bytes ||
+                archive_decode_block(buf, blk->bytes, (int)blk->n_records, fields) != 0) {
+                status = -1;
+                break;
+            }
+
+            for (uint32_t i = 0; i < blk->n_records; i++) {
+                int64_t f[SGP4_ARCHIVE_FIELDS];
+                double elements[10];
+                for (int c = 0; c < SGP4_ARCHIVE_FIELDS; c++) {
+                    f[c] = fields[c * SGP4_ARCHIVE_BLOCK + i];
+                }
+                sgp4_archive_record_elements(f, elements);
+                if (elements[9] < et0 || elements[9] > etf) continue;
+                if (archive_result_push(out, elements, obj->norad)) {
+                    status = -1;
+                    break;
+                }
+            }
+        }
+    }
+
+    free(fields);
+    free(buf);
+    return status;
+}
+
+static void sgp4_archive_result_free(SGP4ArchiveResult* out) {
+    free(out->elements);
+    free(out->norad);
+    out->elements = NULL;
+    out->norad = NULL;
+    out->n = out->capacity = 0;
+}
@@ -8,6 +8,7 @@
 #ifndef SGP4_BATCH_H
 #define SGP4_BATCH_H
 
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
@@ -99,6 +100,69 @@ typedef struct {
     double* vz;
 } SGP4BatchResult;
 
+/**
+ * Quantized coefficient columns (see sgp4_coeffs_alloc_compact()).
+ *
+ * Fixed-point scales and the largest rounding error they add to a
+ * position, at 42164 km (GEO) radius:
+ *   unit values:  int32 x 2^-30           4.7e-10 -> 2 cm
+ *   fractions:    uint32 x 2^-31          2.3e-10 -> 1 cm
+ *   angles:       uint32 turns x 2^-32    7.3e-10 rad -> 3 cm
+ *   ke_sqrt_a/p:  float (velocity only)   6e-8 relative -> 0.5 mm/s
+ */
+typedef struct {
+    void* block;         // Single allocation holding every column
+    int32_t* cosio;
+    int32_t* sinio;
+    int32_t* sin_node;
+    int32_t* cos_node;
+    uint32_t* ecco;
+    uint32_t* sqrt_el2;
+    uint32_t* mo;
+    uint32_t* argpo;
+    float* ke_sqrt_a;
+    float* ke_sqrt_p;
+} SGP4CompactCoeffs;
+
+#define SGP4_Q_UNIT (1.0 / 1073741824.0)                   // 2^-30
+#define SGP4_Q_FRAC (1.0 / 2147483648.0)                   // 2^-31
+#define SGP4_Q_TURN (6.28318530717958647692 / 4294967296.0) // 2 pi / 2^32
+
+/**
+ * Per-satellite SGP4 coefficients in SoA layout.
+ *
+ * Everything in the propagation that does not depend on time, computed
+ * once per batch by sgp4_batch_init_coeffs(). The step kernels then only
+ * evaluate the time-dependent part (mean anomaly, Kepler, orientation).
+ *
+ * With compact storage only xnodp, aodp, c1 and epoch stay doubles (their
+ * errors grow with time since epoch or scale the radius directly); the
+ * other columns are NULL and held quantized in `compact`, 72 instead of
+ * 112 bytes per satellite. The sweep decodes them once per tile.
+ */
+typedef struct {
+    int count;           // Number of satellites
+    int capacity;        // Allocated capacity (rounded up for SIMD)
+    double re;           // Earth radius (km) of the geophysical model used
+
+    double* cosio;       // cos(inclination)
+    double* sinio;       // sin(inclination)
+    double* ecco;        // Eccentricity
+    double* sqrt_el2;    // sqrt(1 - e^2)
+    double* xnodp;       // Recovered mean motion (rad/min)
+    double* aodp;        // Recovered semi-major axis (earth radii)
+    double* c1;          // Drag term
+    double* mo;          // Mean anomaly at epoch (radians)
+    double* argpo;       // Argument of perigee (radians)
+    double* sin_node;    // sin(RAAN)
+    double* cos_node;    // cos(RAAN)
+    double* ke_sqrt_a;   // ke * sqrt(aodp)
+    double* ke_sqrt_p;   // ke * sqrt(semi-latus rectum)
+    double* epoch;       // Epoch time (ET seconds)
+
+    SGP4CompactCoeffs* compact;  // Quantized columns, or NULL
+} SGP4BatchCoeffs;
+
 /**
  * Allocate a batch structure with SIMD-aligned memory.
  * Capacity is rounded up to nearest multiple of 8 for AVX-512.
@@ -169,6 +233,118 @@ static inline void sgp4_batch_free(SGP4Batch* batch) {
     free(batch);
 }
 
+/**
+ * Allocate coefficient structure with SIMD-aligned memory.
+ * Capacity is rounded up the same way as sgp4_batch_alloc().
+ */
+static inline SGP4BatchCoeffs* sgp4_coeffs_alloc(int count) {
+    SGP4BatchCoeffs* coeffs = (SGP4BatchCoeffs*)malloc(sizeof(SGP4BatchCoeffs));
+    if (!coeffs) return NULL;
+
+    int capacity = ((count + 7) / 8) * 8;
+    size_t size = capacity * sizeof(double);
+
+    coeffs->count = count;
+    coeffs->capacity = capacity;
+    coeffs->re = 0.0;
+
+    coeffs->cosio     = (double*)aligned_alloc(SIMD_ALIGN, size);
+    coeffs->sinio     = (double*)aligned_alloc(SIMD_ALIGN, size);
+    coeffs->ecco      = (double*)aligned_alloc(SIMD_ALIGN, size);
+    coeffs->sqrt_el2  = (double*)aligned_alloc(SIMD_ALIGN, size);
+    coeffs->xnodp     = (double*)aligned_alloc(SIMD_ALIGN, size);
+    coeffs->aodp      = (double*)aligned_alloc(SIMD_ALIGN, size);
+    coeffs->c1        = (double*)aligned_alloc(SIMD_ALIGN, size);
+    coeffs->mo        = (double*)aligned_alloc(SIMD_ALIGN, size);
+    coeffs->argpo     = (double*)aligned_alloc(SIMD_ALIGN, size);
+    coeffs->sin_node  = (double*)aligned_alloc(SIMD_ALIGN, size);
+    coeffs->cos_node  = (double*)aligned_alloc(SIMD_ALIGN, size);
+    coeffs->ke_sqrt_a = (double*)aligned_alloc(SIMD_ALIGN, size);
+    coeffs->ke_sqrt_p = (double*)aligned_alloc(SIMD_ALIGN, size);
+    coeffs->epoch     = (double*)aligned_alloc(SIMD_ALIGN, size);
+    coeffs->compact   = NULL;
+
+    return coeffs;
+}
+
+/**
+ * Allocate coefficients with compact storage: the double columns and the
+ * quantized ones share one SIMD-aligned block. Returns NULL when out of
+ * memory.
+ */
+static inline SGP4BatchCoeffs* sgp4_coeffs_alloc_compact(int count) {
+    SGP4BatchCoeffs* coeffs = (SGP4BatchCoeffs*)calloc(1, sizeof(SGP4BatchCoeffs));
+    SGP4CompactCoeffs* q = (SGP4CompactCoeffs*)malloc(sizeof(SGP4CompactCoeffs));
+    int capacity = ((count + 7) / 8) * 8;
+    size_t wide = capacity * sizeof(double);
+    size_t narrow = capacity * sizeof(uint32_t);
+    char* block = (char*)aligned_alloc(SIMD_ALIGN, 4 * wide + 10 * narrow);
+    if (!coeffs || !q || !block) {
+        free(coeffs);
+        free(q);
+        free(block);
+        return NULL;
+    }
+
+    coeffs->count = count;
+    coeffs->capacity = capacity;
+    coeffs->compact = q;
+    coeffs->xnodp = (double*)block;
+    coeffs->aodp  = (double*)(block + wide);
+    coeffs->c1    = (double*)(block + 2 * wide);
+    coeffs->epoch = (double*)(block + 3 * wide);
+
+    char* col = block + 4 * wide;
+    q->block     = block;
+    q->cosio     = (int32_t*)col;   col += narrow;
+    q->sinio     = (int32_t*)col;   col += narrow;
+    q->sin_node  = (int32_t*)col;   col += narrow;
+    q->cos_node  = (int32_t*)col;   col += narrow;
+    q->ecco      = (uint32_t*)col;  col += narrow;
+    q->sqrt_el2  = (uint32_t*)col;  col += narrow;
+    q->mo        = (uint32_t*)col;  col += narrow;
+    q->argpo     = (uint32_t*)col;  col += narrow;
+    q->ke_sqrt_a = (float*)col;     col += narrow;
+    q->ke_sqrt_p = (float*)col;
+
+    return coeffs;
+}
+
+/**
+ * Allocate coefficients with compact or full storage.
+ */
+static inline SGP4BatchCoeffs* sgp4_coeffs_alloc_mode(int count, int compact) {
+    return compact ? sgp4_coeffs_alloc_compact(count) : sgp4_coeffs_alloc(count);
+}
+
+/**
+ * Free coefficient memory.
+ */
+static inline void sgp4_coeffs_free(SGP4BatchCoeffs* coeffs) {
+    if (!coeffs) return;
+    if (coeffs->compact) {
+        free(coeffs->compact->block);
+        free(coeffs->compact);
+        free(coeffs);
+        return;
+    }
+    free(coeffs->cosio);
+    free(coeffs->sinio);
+    free(coeffs->ecco);
+    free(coeffs->sqrt_el2);
+    free(coeffs->xnodp);
+    free(coeffs->aodp);
+    free(coeffs->c1);
+    free(coeffs->mo);
+    free(coeffs->argpo);
+    free(coeffs->sin_node);
+    free(coeffs->cos_node);
+    free(coeffs->ke_sqrt_a);
+    free(coeffs->ke_sqrt_p);
+    free(coeffs->epoch);
+    free(coeffs);
+}
+
 /**
  * Allocate result structure.
  */
@@ -231,6 +407,21 @@ static inline void sgp4_batch_set(SGP4Batch* batch, int idx,
     batch->epoch[idx] = epoch_et;
 }
 
+/**
+ * Load elements for satellites [0, n) from 10 contiguous columns of n
+ * values each, in sgp4_batch_set() order. One memcpy per column.
+ */
+static inline void sgp4_batch_set_columns(SGP4Batch* batch, const double* columns, int n) {
+    if (n > batch->capacity) n = batch->capacity;
+    double* dst[10] = {
+        batch->ndot, batch->nddot, batch->bstar, batch->inclo, batch->nodeo,
+        batch->ecco, batch->argpo, batch->mo, batch->no, batch->epoch
+    };
+    for (int c = 0; c < 10; c++) {
+        memcpy(dst[c], columns + (size_t)c * n, (size_t)n * sizeof(double));
+    }
+}
+
 // Constants used in SGP4
 #define PI 3.14159265358979323846
 #define TWOPI (2.0 * PI)
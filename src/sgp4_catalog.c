@@ -0,0 +1,234 @@
+/**
+ * SGP4 Catalog Secondary Indexes
+ *
+ * Filter queries over a resident catalog ("sun-synchronous 500-600 km",
+ * "GEO within 5 deg of a longitude", "53 deg shells") would otherwise scan
+ * every element set. The catalog index keeps, per derived orbital
+ * parameter, the values in sorted order with the object each belongs to:
+ *
+ *   - A range predicate is two binary searches, giving a run of sorted
+ *     positions whose objects are set in a bitmap of n bits.
+ *   - Predicates are combined by AND-ing bitmaps, 256 bits (AVX2) or 128
+ *     bits (NEON) per instruction.
+ *   - Matches come out in catalog order by scanning the set bits.
+ *
+ * Altitudes come from the batch's derived columns (sgp4_batch_derive()
+ * fills a, alta and altp), so they agree with the propagator's recovered
+ * semi-major axis.
+ */
+
+#include <stdint.h>
+#include "sgp4_batch.h"
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+#elif defined(__aarch64__) || defined(__ARM_NEON)
+    #include <arm_neon.h>
+#endif
+
+/** Indexed parameters, in the order of SGP4Catalog.values */
+typedef enum {
+    SGP4_CAT_PERIGEE = 0,  // Perigee altitude (km)
+    SGP4_CAT_APOGEE,       // Apogee altitude (km)
+    SGP4_CAT_INCL,         // Inclination (deg)
+    SGP4_CAT_PERIOD,       // Period (min)
+    SGP4_CAT_RAAN,         // RAAN at epoch (deg, 0..360)
+    SGP4_CAT_ECC,          // Eccentricity
+    SGP4_CAT_LON,          // Earth-fixed mean longitude at epoch (deg, -180..180)
+    SGP4_CAT_NPARAMS
+} SGP4CatalogParam;
+
+/** Derived parameters of a catalog, each with a sorted index */
+typedef struct {
+    int n;
+    int words;             // 64-bit words per bitmap (multiple of 8)
+    double* values;        // [SGP4_CAT_NPARAMS][n], per object
+    double* sorted;        // [SGP4_CAT_NPARAMS][n], ascending (NaN last)
+    int32_t* order;        // [SGP4_CAT_NPARAMS][n], object of each sorted value
+    uint64_t* result;      // Bitmap of the current query
+    uint64_t* scratch;     // Bitmap of one predicate
+} SGP4Catalog;
+
+typedef struct {
+    double value;
+    int32_t index;
+} CatalogEntry;
+
+static int catalog_entry_compare(const void* a, const void* b) {
+    double x = ((const CatalogEntry*)a)->value;
+    double y = ((const CatalogEntry*)b)->value;
+    if (isnan(x) || isnan(y)) {
+        return isnan(x) - isnan(y);
+    }
+    return x < y ? -1 : x > y ? 1 : 0;
+}
+
+static double catalog_wrap(double deg, double lo) {
+    deg = fmod(deg - lo, 360.0);
+    return (deg < 0 ? deg + 360.0 : deg) + lo;
+}
+
+void sgp4_catalog_free(SGP4Catalog* cat) {
+    if (!cat) return;
+    free(cat->values);
+    free(cat->sorted);
+    free(cat->order);
+    free(cat->result);
+    free(cat->scratch);
+    free(cat);
+}
+
+/**
+ * Derive the indexed parameters of every set in a batch and sort them.
+ * Fills the batch's a/alta/altp columns. Returns NULL when out of memory.
+ */
+SGP4Catalog* sgp4_catalog_build(SGP4Batch* batch, const SGP4Geophs* geophs) {
+    int n = batch->count;
+    SGP4Catalog* cat = (SGP4Catalog*)calloc(1, sizeof(SGP4Catalog));
+    if (!cat) return NULL;
+
+    cat->n = n;
+    cat->words = (n / 512 + 1) * 8;
+    size_t cells = (size_t)SGP4_CAT_NPARAMS * (n > 0 ? n : 1);
+    cat->values = (double*)malloc(cells * sizeof(double));
+    cat->sorted = (double*)malloc(cells * sizeof(double));
+    cat->order = (int32_t*)malloc(cells * sizeof(int32_t));
+    cat->result = (uint64_t*)aligned_alloc(SIMD_ALIGN, (size_t)cat->words * 8);
+    cat->scratch = (uint64_t*)aligned_alloc(SIMD_ALIGN, (size_t)cat->words * 8);
+    CatalogEntry* entries = (CatalogEntry*)malloc((n > 0 ? n : 1) * sizeof(CatalogEntry));
+    if (!cat->values || !cat->sorted || !cat->order || !cat->result || !cat->scratch || !entries) {
+        free(entries);
+        sgp4_catalog_free(cat);
+        return NULL;
+    }
+
+    sgp4_batch_derive(batch, geophs);
+    double* v = cat->values;
+    for (int i = 0; i < n; i++) {
+        double valid = isnan(batch->a[i]) ? NAN : 1.0;
+        double gmst = pipeline_gmst(batch->epoch[i]);
+        v[SGP4_CAT_PERIGEE * n + i] = batch->altp[i];
+        v[SGP4_CAT_APOGEE * n + i] = batch->alta[i];
+        v[SGP4_CAT_INCL * n + i] = valid * batch->inclo[i] / DEG2RAD;
+        v[SGP4_CAT_PERIOD * n + i] = valid * TWOPI / batch->no[i];
+        v[SGP4_CAT_RAAN * n + i] = valid * catalog_wrap(batch->nodeo[i] / DEG2RAD, 0.0);
+        v[SGP4_CAT_ECC * n + i] = valid * batch->ecco[i];
+        v[SGP4_CAT_LON * n + i] = valid * catalog_wrap(
+            (batch->nodeo[i] + batch->argpo[i] + batch->mo[i] - gmst) / DEG2RAD, -180.0);
+    }
+
+    for (int p = 0; p < SGP4_CAT_NPARAMS; p++) {
+        for (int i = 0; i < n; i++) {
+            entries[i].value = v[(size_t)p * n + i];
+            entries[i].index = i;
+        }
+        qsort(entries, n, sizeof(CatalogEntry), catalog_entry_compare);
+        for (int i = 0; i < n; i++) {
+            cat->sorted[(size_t)p * n + i] = entries[i].value;
+            cat->order[(size_t)p * n + i] = entries[i].index;
+        }
+    }
+
+    free(entries);
+    return cat;
+}
+
+/** First sorted position with a value >= x (NaN values sort last) */
+static int catalog_lower_bound(const double* sorted, int n, double x) {
+    int lo = 0, hi = n;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (sorted[mid] < x) lo = mid + 1; else hi = mid;
+    }
+    return lo;
+}
+
+/** First sorted position with a value > x */
+static int catalog_upper_bound(const double* sorted, int n, double x) {
+    int lo = 0, hi = n;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (sorted[mid] <= x) lo = mid + 1; else hi = mid;
+    }
+    return lo;
+}
+
+/** Set the bits of the objects with lo <= value <= hi */
+static void catalog_mark(const SGP4Catalog* cat, int p, double lo, double hi, uint64_t* bits) {
+    const double* sorted = cat->sorted + (size_t)p * cat->n;
+    const int32_t* order = cat->order + (size_t)p * cat->n;
+    int from = catalog_lower_bound(sorted, cat->n, lo);
+    int to = catalog_upper_bound(sorted, cat->n, hi);
+    for (int k = from; k < to; k++) {
+        bits[order[k] >> 6] |= (uint64_t)1 << (order[k] & 63);
+    }
+}
+
+/** dst &= src over `words` 64-bit words (a multiple of 8, 64-byte aligned) */
+static void catalog_bitmap_and(uint64_t* dst, const uint64_t* src, int words) {
+#if defined(__AVX2__)
+    for (int w = 0; w < words; w += 4) {
+        __m256i a = _mm256_load_si256((const __m256i*)(dst + w));
+        __m256i b = _mm256_load_si256((const __m256i*)(src + w));
+        _mm256_store_si256((__m256i*)(dst + w), _mm256_and_si256(a, b));
+    }
+#elif defined(__aarch64__) || defined(__ARM_NEON)
+    for (int w = 0; w < words; w += 2) {
+        vst1q_u64(dst + w, vandq_u64(vld1q_u64(dst + w), vld1q_u64(src + w)));
+    }
+#else
+    for (int w = 0; w < words; w++) {
+        dst[w] &= src[w];
+    }
+#endif
+}
+
+/**
+ * Objects matching every predicate, in catalog order.
+ *
+ * preds holds n_preds triples (parameter, lo, hi), bounds inclusive. For
+ * the angles (RAAN, longitude) lo > hi selects the range wrapping through
+ * 360/180; for the other parameters it matches nothing. `out` must hold
+ * cat->n indices. Returns the number of matches, or -1 on an unknown
+ * parameter.
+ */
+long sgp4_catalog_query(SGP4Catalog* cat, const double* preds, int n_preds, int32_t* out) {
+    int words = cat->words;
+    memset(cat->result, 0xff, (size_t)words * 8);
+
+    for (int k = 0; k < n_preds; k++) {
+        int p = (int)preds[3 * k];
+        double lo = preds[3 * k + 1];
+        double hi = preds[3 * k + 2];
+        if (p < 0 || p >= SGP4_CAT_NPARAMS) {
+            return -1;
+        }
+
+        memset(cat->scratch, 0, (size_t)words * 8);
+        if (lo <= hi) {
+            catalog_mark(cat, p, lo, hi, cat->scratch);
+        } else if (p == SGP4_CAT_RAAN || p == SGP4_CAT_LON) {
+            catalog_mark(cat, p, lo, INFINITY, cat->scratch);
+            catalog_mark(cat, p, -INFINITY, hi, cat->scratch);
+        }
+        catalog_bitmap_and(cat->result, cat->scratch, words);
+    }
+
+    // Padding bits past n never match
+    if (cat->n & 63) {
+        cat->result[cat->n >> 6] &= ((uint64_t)1 << (cat->n & 63)) - 1;
+    }
+    for (int w = (cat->n + 63) >> 6; w < words; w++) {
+        cat->result[w] = 0;
+    }
+
+    long count = 0;
+    for (int w = 0; w < words; w++) {
+        uint64_t bits = cat->result[w];
+        while (bits) {
+            out[count++] = (w << 6) + __builtin_ctzll(bits);
+            bits &= bits - 1;
+        }
+    }
+    return count;
+}
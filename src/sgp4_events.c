@@ -0,0 +1,366 @@
+/**
+ * SGP4 Event Finder
+ *
+ * Finds the times at which scalar event functions g(t) of a satellite's
+ * state change sign:
+ *
+ *   1. Sample g on a coarse, orbit-aware grid (a fraction of the orbital
+ *      period) with the tiled sweep, one chunk at a time. Consecutive
+ *      satellites with similar grids are swept together on the finest.
+ *   2. Bracket every sign change between consecutive samples.
+ *   3. Refine each bracket to SGP4_EVENT_TOLERANCE with the Illinois
+ *      variant of regula falsi, propagating single epochs.
+ *
+ * Event functions come from a small built-in library, each offset by a
+ * threshold so the same function serves "crosses 500 km" and "crosses
+ * 600 km". Events whose sign changes twice within one coarse step are
+ * missed; the default grid (period / 48) is far finer than any of the
+ * library functions' natural period.
+ *
+ * Uses the Earth-fixed and geodetic helpers of sgp4_pipeline.c.
+ */
+
+#include "sgp4_batch.h"
+
+#define SGP4_EVENT_MAX_SPECS     16
+#define SGP4_EVENT_WORDS         3      // doubles per encoded spec
+#define SGP4_EVENT_SAMPLES_PER_REV 48
+#define SGP4_EVENT_TOLERANCE     1.0e-3 // seconds
+#define SGP4_EVENT_MAX_ITER      60
+#define SGP4_EVENT_GROUP         8      // satellites swept together
+#define SGP4_EVENT_GROUP_SLACK   1.25   // largest / smallest coarse step in a group
+
+typedef enum {
+    SGP4_EVENT_NODE = 0,      // z (TEME, km): rising = ascending node
+    SGP4_EVENT_APSIS,         // r.v / |r| (km/s): rising = perigee, falling = apogee
+    SGP4_EVENT_ALTITUDE,      // geodetic altitude - threshold (km)
+    SGP4_EVENT_LATITUDE,      // geodetic latitude - threshold (deg)
+    SGP4_EVENT_LAT_BAND,      // min(lat - lo, hi - lat) (deg): rising = entry
+    SGP4_EVENT_BETA,          // solar beta angle - threshold (deg)
+    SGP4_EVENT_COUNT
+} SGP4EventFunction;
+
+typedef struct {
+    int fn;
+    double p[2];    // threshold (or band lo, hi)
+} SGP4EventSpec;
+
+typedef struct {
+    double et;
+    int sat;        // Satellite index (relative to first)
+    int spec;       // Index of the event spec
+    int direction;  // +1: g went from negative to non-negative, -1: the reverse
+} SGP4Event;
+
+typedef struct {
+    long n_events;
+    long capacity;
+    long max_events;  // 0 = unlimited; set by caller before run
+    int truncated;
+    SGP4Event* events;
+} SGP4EventResult;
+
+// ============================================================================
+// Event functions
+// ============================================================================
+
+/**
+ * Unit vector to the Sun (mean equator of date), low-precision series
+ * from the Astronomical Almanac (~0.01 deg, 1950-2050).
+ */
+static void events_sun_direction(double et, double s[3]) {
+    double t = et / (36525.0 * 86400.0);
+    double lmean = 280.460 + 36000.771 * t;
+    double m = (357.5291092 + 35999.05034 * t) * DEG2RAD;
+    double lambda = (lmean + 1.914666471 * sin(m) + 0.019994643 * sin(2.0 * m)) * DEG2RAD;
+    double eps = (23.439291 - 0.0130042 * t) * DEG2RAD;
+    s[0] = cos(lambda);
+    s[1] = cos(eps) * sin(lambda);
+    s[2] = sin(eps) * sin(lambda);
+}
+
+/**
+ * Evaluate an event function for n TEME states.
+ */
+static void events_evaluate(
+    const SGP4EventSpec* spec,
+    const double* et,
+    const double* x, const double* y, const double* z,
+    const double* vx, const double* vy, const double* vz,
+    double* g, int n
+) {
+    switch (spec->fn) {
+        case SGP4_EVENT_NODE:
+            for (int i = 0; i < n; i++) g[i] = z[i];
+            break;
+        case SGP4_EVENT_APSIS:
+            for (int i = 0; i < n; i++) {
+                double r = sqrt(x[i] * x[i] + y[i] * y[i] + z[i] * z[i]);
+                g[i] = (x[i] * vx[i] + y[i] * vy[i] + z[i] * vz[i]) / r;
+            }
+            break;
+        case SGP4_EVENT_ALTITUDE:
+        case SGP4_EVENT_LATITUDE:
+        case SGP4_EVENT_LAT_BAND:
+            for (int i = 0; i < n; i++) {
+                double ex, ey, ez, lat, alt;
+                pipeline_teme_to_ecef(&et[i], &x[i], &y[i], &z[i], NULL, NULL, NULL,
+                                      &ex, &ey, &ez, NULL, NULL, NULL, 1);
+                pipeline_geodetic(ex, ey, ez, &lat, &alt);
+                if (spec->fn == SGP4_EVENT_ALTITUDE) {
+                    g[i] = alt - spec->p[0];
+                } else if (spec->fn == SGP4_EVENT_LATITUDE) {
+                    g[i] = lat - spec->p[0];
+                } else {
+                    g[i] = fmin(lat - spec->p[0], spec->p[1] - lat);
+                }
+            }
+            break;
+        case SGP4_EVENT_BETA:
+            for (int i = 0; i < n; i++) {
+                double hx = y[i] * vz[i] - z[i] * vy[i];
+                double hy = z[i] * vx[i] - x[i] * vz[i];
+                double hz = x[i] * vy[i] - y[i] * vx[i];
+                double h = sqrt(hx * hx + hy * hy + hz * hz);
+                double s[3];
+                events_sun_direction(et[i], s);
+                g[i] = asin((hx * s[0] + hy * s[1] + hz * s[2]) / h) / DEG2RAD - spec->p[0];
+            }
+            break;
+        default:
+            for (int i = 0; i < n; i++) g[i] = NAN;
+            break;
+    }
+}
+
+// g at a single epoch
+static double events_evaluate_at(
+    const SGP4EventSpec* spec, const SGP4BatchCoeffs* coeffs, int sat, double et
+) {
+    double x, y, z, vx, vy, vz, g;
+    sgp4_batch_sweep(coeffs, sat, 1, et, 0.0, 1, &x, &y, &z, &vx, &vy, &vz, 0, 1);
+    events_evaluate(spec, &et, &x, &y, &z, &vx, &vy, &vz, &g, 1);
+    return g;
+}
+
+/**
+ * Refine a sign change of g in [a, b] (ga, gb of opposite sign) with the
+ * Illinois method.
+ */
+static double events_refine(
+    const SGP4EventSpec* spec, const SGP4BatchCoeffs* coeffs, int sat,
+    double a, double ga, double b, double gb
+) {
+    int side = 0;
+    for (int k = 0; k < SGP4_EVENT_MAX_ITER && b - a > SGP4_EVENT_TOLERANCE; k++) {
+        double c = (a * gb - b * ga) / (gb - ga);
+        if (!(c > a && c < b)) {
+            c = 0.5 * (a + b);
+        }
+        double gc = events_evaluate_at(spec, coeffs, sat, c);
+        if ((gc < 0.0) == (gb < 0.0)) {
+            b = c;
+            gb = gc;
+            if (side == -1) ga *= 0.5;
+            side = -1;
+        } else {
+            a = c;
+            ga = gc;
+            if (side == 1) gb *= 0.5;
+            side = 1;
+        }
+    }
+    return fabs(ga) < fabs(gb) ? a : b;
+}
+
+static int events_push(SGP4EventResult* out, double et, int sat, int spec, int direction) {
+    if (out->max_events > 0 && out->n_events >= out->max_events) {
+        out->truncated = 1;
+        return 0;
+    }
+    if (out->n_events == out->capacity) {
+        long cap = out->capacity ? out->capacity * 2 : 256;
+        SGP4Event* ev = (SGP4Event*)realloc(out->events, cap * sizeof(SGP4Event));
+        if (!ev) return -1;
+        out->events = ev;
+        out->capacity = cap;
+    }
+    SGP4Event* e = &out->events[out->n_events++];
+    e->et = et;
+    e->sat = sat;
+    e->spec = spec;
+    e->direction = direction;
+    return 0;
+}
+
+static int events_compare(const void* a, const void* b) {
+    const SGP4Event* ea = (const SGP4Event*)a;
+    const SGP4Event* eb = (const SGP4Event*)b;
+    if (ea->sat != eb->sat) return ea->sat - eb->sat;
+    if (ea->et != eb->et) return ea->et < eb->et ? -1 : 1;
+    return ea->spec - eb->spec;
+}
+
+// ============================================================================
+// Finder
+// ============================================================================
+
+/**
+ * Decode specs from their flat encoding: records of [fn, p0, p1].
+ *
+ * @return Number of specs, or -1 if a record is invalid
+ */
+int sgp4_events_decode(const double* words, int n_specs, SGP4EventSpec* specs) {
+    if (n_specs < 1 || n_specs > SGP4_EVENT_MAX_SPECS) return -1;
+    for (int i = 0; i < n_specs; i++) {
+        const double* w = &words[i * SGP4_EVENT_WORDS];
+        specs[i].fn = (int)w[0];
+        specs[i].p[0] = w[1];
+        specs[i].p[1] = w[2];
+        if (specs[i].fn < 0 || specs[i].fn >= SGP4_EVENT_COUNT || isnan(w[1]) || isnan(w[2])) {
+            return -1;
+        }
+    }
+    return n_specs;
+}
+
+/**
+ * Coarse step (seconds) for a satellite: 1/SGP4_EVENT_SAMPLES_PER_REV of its
+ * shortest period over [et0, etf], capped at max_step (0 = no cap).
+ */
+static double events_coarse_step(
+    const SGP4BatchCoeffs* coeffs, int sat, double et0, double etf, double max_step
+) {
+    // Fastest mean-anomaly rate over the window (drag term included)
+    double tmax = fmax(fabs(et0 - coeffs->epoch[sat]), fabs(etf - coeffs->epoch[sat])) / 60.0;
+    double rate = coeffs->xnodp[sat] + 2.0 * fabs(coeffs->c1[sat]) * tmax;   // rad/min
+    double step = TWOPI / rate * 60.0 / SGP4_EVENT_SAMPLES_PER_REV;
+    return max_step > 0.0 && step > max_step ? max_step : step;
+}
+
+/**
+ * Find the events of satellites [first, first + n) in [et0, etf].
+ *
+ * The coarse step is events_coarse_step() of each satellite. Runs of up
+ * to SGP4_EVENT_GROUP consecutive satellites whose steps differ by at most
+ * SGP4_EVENT_GROUP_SLACK are swept together on the smallest of them.
+ * Events are returned sorted by satellite, then time, and max_events keeps
+ * the first ones in that order. `compact` selects compact coefficient
+ * storage (sgp4_coeffs_alloc_mode()).
+ *
+ * @return 0 on success, -1 on allocation failure
+ */
+int sgp4_events_find(
+    const SGP4EventSpec* specs, int n_specs,
+    const SGP4Batch* batch,
+    int first, int n,
+    const SGP4Geophs* geophs,
+    double et0, double etf, double max_step,
+    int compact,
+    SGP4EventResult* out
+) {
+    enum { CHUNK = 256, GROUP = SGP4_EVENT_GROUP };
+    SGP4BatchCoeffs* coeffs = sgp4_coeffs_alloc_mode(n, compact);
+    // Group states: x, y, z, vx, vy, vz columns of GROUP x CHUNK
+    double* states = (double*)malloc((size_t)6 * GROUP * CHUNK * sizeof(double));
+    if (!coeffs || !states) {
+        sgp4_coeffs_free(coeffs);
+        free(states);
+        return -1;
+    }
+    sgp4_batch_init_coeffs_range(batch, first, n, geophs, coeffs);
+
+    double* x = states;
+    double* y = x + GROUP * CHUNK;
+    double* z = y + GROUP * CHUNK;
+    double* vx = z + GROUP * CHUNK;
+    double* vy = vx + GROUP * CHUNK;
+    double* vz = vy + GROUP * CHUNK;
+    double et[CHUNK];
+    double g[SGP4_EVENT_MAX_SPECS][CHUNK];
+    double prev_g[GROUP][SGP4_EVENT_MAX_SPECS];
+    int status = 0;
+
+    // A group's events arrive chunk by chunk across its satellites, so the
+    // cap is applied once they are sorted
+    long max_events = out->max_events;
+    out->max_events = 0;
+
+    for (int s0 = 0; s0 < n && status == 0 && !out->truncated; ) {
+        double step = events_coarse_step(coeffs, s0, et0, etf, max_step);
+        double widest = step;
+        int lanes = 1;
+        while (lanes < GROUP && s0 + lanes < n) {
+            double next = events_coarse_step(coeffs, s0 + lanes, et0, etf, max_step);
+            if (fmax(widest, next) > fmin(step, next) * SGP4_EVENT_GROUP_SLACK) break;
+            step = fmin(step, next);
+            widest = fmax(widest, next);
+            lanes++;
+        }
+        long steps = (long)ceil((etf - et0) / step) + 1;
+        long group_start = out->n_events;
+        double prev_et = 0.0;
+
+        for (long t0 = 0; t0 < steps && status == 0; t0 += CHUNK) {
+            int rows = steps - t0 < CHUNK ? (int)(steps - t0) : CHUNK;
+            for (int i = 0; i < rows; i++) {
+                et[i] = fmin(et0 + (t0 + i) * step, etf);
+            }
+            // The last sample is clamped to etf; propagate it separately
+            int regular = rows;
+            if (t0 + rows == steps && et[rows - 1] < et0 + (t0 + rows - 1) * step) {
+                regular = rows - 1;
+            }
+            sgp4_batch_sweep(coeffs, s0, lanes, et[0], step, regular, x, y, z, vx, vy, vz, CHUNK, 1);
+            if (regular < rows) {
+                sgp4_batch_sweep(coeffs, s0, lanes, etf, 0.0, 1,
+                                 &x[regular], &y[regular], &z[regular],
+                                 &vx[regular], &vy[regular], &vz[regular], CHUNK, 1);
+            }
+
+            for (int l = 0; l < lanes && status == 0; l++) {
+                int sat = s0 + l;
+                long o = (long)l * CHUNK;
+                for (int k = 0; k < n_specs && status == 0; k++) {
+                    events_evaluate(&specs[k], et, &x[o], &y[o], &z[o], &vx[o], &vy[o], &vz[o], g[k], rows);
+
+                    double pa = prev_et, pg = prev_g[l][k];
+                    for (int i = (t0 == 0 ? 1 : 0); i < rows && status == 0; i++) {
+                        if (i > 0) {
+                            pa = et[i - 1];
+                            pg = g[k][i - 1];
+                        }
+                        double cg = g[k][i];
+                        if (isnan(pg) || isnan(cg) || (pg < 0.0) == (cg < 0.0)) continue;
+                        double t = events_refine(&specs[k], coeffs, sat, pa, pg, et[i], cg);
+                        status = events_push(out, t, sat, k, cg >= 0.0 ? 1 : -1);
+                    }
+                    prev_g[l][k] = g[k][rows - 1];
+                }
+            }
+            prev_et = et[rows - 1];
+        }
+
+        if (out->n_events > group_start) {
+            qsort(&out->events[group_start], out->n_events - group_start, sizeof(SGP4Event), events_compare);
+        }
+        if (max_events > 0 && out->n_events > max_events) {
+            out->n_events = max_events;
+            out->truncated = 1;
+        }
+        s0 += lanes;
+    }
+
+    out->max_events = max_events;
+    sgp4_coeffs_free(coeffs);
+    free(states);
+    return status;
+}
+
+/**
+ * Free result buffers (not the struct itself).
+ */
+void sgp4_events_result_free(SGP4EventResult* out) {
+    free(out->events);
+    out->events = NULL;
+}
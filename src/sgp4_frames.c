@@ -0,0 +1,178 @@
+/**
+ * SGP4 Reference Frame Conversions
+ *
+ * Rotations applied to SoA ephemeris buffers after propagation.
+ * SGP4 produces states in TEME (True Equator Mean Equinox of date);
+ * downstream consumers (CCSDS OEM products) may request GCRF instead.
+ *
+ * TEME -> GCRF uses the IAU-76/FK5 chain from Vallado, "Revisiting
+ * Spacetrack Report #3" (AIAA 2006-6753):
+ *
+ *   r_GCRF = P * N * R3(-eqeq) * r_TEME
+ *
+ * with IAU-1976 precession (P) and the IAU-1980 nutation series (N)
+ * truncated to its 10 largest terms. Truncation error is ~0.1 arcsec,
+ * i.e. a few metres at LEO radius - well below SGP4's own accuracy.
+ */
+
+#include "sgp4_batch.h"
+
+#define ARCSEC2RAD (PI / 648000.0)
+#define SEC_PER_CENTURY (36525.0 * 86400.0)
+
+// Rebuild the rotation when the epoch moves more than this (seconds).
+// The fastest retained nutation term (13.66 days) moves < 0.005 arcsec/hour.
+#define FRAME_MATRIX_VALIDITY 3600.0
+
+/**
+ * Truncated IAU-1980 nutation series.
+ * Multipliers of (l, l', F, D, Omega) and coefficients in 0.0001 arcsec.
+ */
+static const struct {
+    int l, lp, f, d, om;
+    double dpsi, dpsi_t;  // sine coefficient for longitude
+    double deps, deps_t;  // cosine coefficient for obliquity
+} NUTATION_1980[10] = {
+    { 0,  0, 0,  0, 1, -171996.0, -174.2, 92025.0,  8.9 },
+    { 0,  0, 2, -2, 2,  -13187.0,   -1.6,  5736.0, -3.1 },
+    { 0,  0, 2,  0, 2,   -2274.0,   -0.2,   977.0, -0.5 },
+    { 0,  0, 0,  0, 2,    2062.0,    0.2,  -895.0,  0.5 },
+    { 0,  1, 0,  0, 0,    1426.0,   -3.4,    54.0, -0.1 },
+    { 1,  0, 0,  0, 0,     712.0,    0.1,    -7.0,  0.0 },
+    { 0,  1, 2, -2, 2,    -517.0,    1.2,   224.0, -0.6 },
+    { 0,  0, 2,  0, 1,    -386.0,   -0.4,   200.0,  0.0 },
+    { 1,  0, 2,  0, 2,    -301.0,    0.0,   129.0, -0.1 },
+    { 0, -1, 2, -2, 2,     217.0,   -0.5,   -95.0,  0.3 },
+};
+
+// 3x3 matrix product: out = a * b
+static void mat3_mul(const double a[3][3], const double b[3][3], double out[3][3]) {
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            out[i][j] = a[i][0] * b[0][j] + a[i][1] * b[1][j] + a[i][2] * b[2][j];
+        }
+    }
+}
+
+// Passive rotation matrices (Vallado ROT1/ROT2/ROT3 convention)
+static void rot1(double angle, double m[3][3]) {
+    double c = cos(angle), s = sin(angle);
+    double r[3][3] = {{1, 0, 0}, {0, c, s}, {0, -s, c}};
+    memcpy(m, r, sizeof(r));
+}
+
+static void rot2(double angle, double m[3][3]) {
+    double c = cos(angle), s = sin(angle);
+    double r[3][3] = {{c, 0, -s}, {0, 1, 0}, {s, 0, c}};
+    memcpy(m, r, sizeof(r));
+}
+
+static void rot3(double angle, double m[3][3]) {
+    double c = cos(angle), s = sin(angle);
+    double r[3][3] = {{c, s, 0}, {-s, c, 0}, {0, 0, 1}};
+    memcpy(m, r, sizeof(r));
+}
+
+/**
+ * Build the TEME -> GCRF rotation matrix for a given epoch.
+ *
+ * @param et  Epoch (seconds past J2000)
+ * @param m   Output: 3x3 rotation, r_GCRF = m * r_TEME
+ */
+void sgp4_teme_to_gcrf_matrix(double et, double m[3][3]) {
+    double t = et / SEC_PER_CENTURY;
+    double t2 = t * t;
+    double t3 = t2 * t;
+
+    // IAU-1976 precession angles
+    double zeta  = (2306.2181 * t + 0.30188 * t2 + 0.017998 * t3) * ARCSEC2RAD;
+    double theta = (2004.3109 * t - 0.42665 * t2 - 0.041833 * t3) * ARCSEC2RAD;
+    double z     = (2306.2181 * t + 1.09468 * t2 + 0.018203 * t3) * ARCSEC2RAD;
+
+    // Mean obliquity of the ecliptic
+    double eps_bar = (84381.448 - 46.8150 * t - 0.00059 * t2 + 0.001813 * t3) * ARCSEC2RAD;
+
+    // Delaunay fundamental arguments (degrees -> radians)
+    double l  = fmod(134.96340251 + (1717915923.2178 * t + 31.8792 * t2) / 3600.0, 360.0) * DEG2RAD;
+    double lp = fmod(357.52910918 + (129596581.0481 * t - 0.5532 * t2) / 3600.0, 360.0) * DEG2RAD;
+    double f  = fmod(93.27209062 + (1739527262.8478 * t - 12.7512 * t2) / 3600.0, 360.0) * DEG2RAD;
+    double d  = fmod(297.85019547 + (1602961601.2090 * t - 6.3706 * t2) / 3600.0, 360.0) * DEG2RAD;
+    double om = fmod(125.04455501 + (-6962890.2665 * t + 7.4722 * t2) / 3600.0, 360.0) * DEG2RAD;
+
+    double dpsi = 0.0, deps = 0.0;
+    for (int i = 0; i < 10; i++) {
+        double arg = NUTATION_1980[i].l * l + NUTATION_1980[i].lp * lp +
+                     NUTATION_1980[i].f * f + NUTATION_1980[i].d * d +
+                     NUTATION_1980[i].om * om;
+        dpsi += (NUTATION_1980[i].dpsi + NUTATION_1980[i].dpsi_t * t) * sin(arg);
+        deps += (NUTATION_1980[i].deps + NUTATION_1980[i].deps_t * t) * cos(arg);
+    }
+    dpsi *= 1.0e-4 * ARCSEC2RAD;
+    deps *= 1.0e-4 * ARCSEC2RAD;
+
+    double eps = eps_bar + deps;
+    double eqeq = dpsi * cos(eps_bar);
+
+    // P = ROT3(zeta) ROT2(-theta) ROT3(z)
+    double r_a[3][3], r_b[3][3], r_c[3][3], tmp[3][3], prec[3][3];
+    rot3(zeta, r_a);
+    rot2(-theta, r_b);
+    rot3(z, r_c);
+    mat3_mul(r_a, r_b, tmp);
+    mat3_mul(tmp, r_c, prec);
+
+    // N = ROT1(-eps_bar) ROT3(dpsi) ROT1(eps)
+    double nut[3][3];
+    rot1(-eps_bar, r_a);
+    rot3(dpsi, r_b);
+    rot1(eps, r_c);
+    mat3_mul(r_a, r_b, tmp);
+    mat3_mul(tmp, r_c, nut);
+
+    // TEME -> TOD = ROT3(-eqeq)
+    double teme[3][3];
+    rot3(-eqeq, teme);
+
+    mat3_mul(prec, nut, tmp);
+    mat3_mul(tmp, teme, m);
+}
+
+/**
+ * Rotate SoA state vectors from TEME to GCRF in place.
+ *
+ * Precession/nutation rates are negligible at SGP4 accuracy, so velocity
+ * is rotated with the same matrix as position.
+ *
+ * @param et       Epoch of each state (seconds past J2000) [n]
+ * @param x,y,z    Position (km) [n], overwritten
+ * @param vx,vy,vz Velocity (km/s) [n], overwritten
+ * @param n        Number of states
+ */
+void sgp4_teme_to_gcrf(
+    const double* et,
+    double* x, double* y, double* z,
+    double* vx, double* vy, double* vz,
+    int n
+) {
+    double m[3][3];
+    double matrix_et = 0.0;
+    int have_matrix = 0;
+
+    for (int i = 0; i < n; i++) {
+        if (!have_matrix || fabs(et[i] - matrix_et) > FRAME_MATRIX_VALIDITY) {
+            sgp4_teme_to_gcrf_matrix(et[i], m);
+            matrix_et = et[i];
+            have_matrix = 1;
+        }
+
+        double px = x[i], py = y[i], pz = z[i];
+        x[i] = m[0][0] * px + m[0][1] * py + m[0][2] * pz;
+        y[i] = m[1][0] * px + m[1][1] * py + m[1][2] * pz;
+        z[i] = m[2][0] * px + m[2][1] * py + m[2][2] * pz;
+
+        double qx = vx[i], qy = vy[i], qz = vz[i];
+        vx[i] = m[0][0] * qx + m[0][1] * qy + m[0][2] * qz;
+        vy[i] = m[1][0] * qx + m[1][1] * qy + m[1][2] * qz;
+        vz[i] = m[2][0] * qx + m[2][1] * qy + m[2][2] * qz;
+    }
+}
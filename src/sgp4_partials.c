@@ -0,0 +1,371 @@
+/**
+ * SGP4 State Partials (Forward-Mode Automatic Differentiation)
+ *
+ * Dual-number variant of the batch SGP4 kernel. Alongside each state it
+ * returns the 6x7 Jacobian
+ *
+ *   d(x, y, z, vx, vy, vz) / d(inclo, nodeo, ecco, argpo, mo, no, bstar)
+ *
+ * for orbit fitting, covariance mapping and sensitivity studies, without
+ * finite differencing through repeated propagations.
+ *
+ * Every intermediate carries its value plus 7 tangents, for SGP4_AD_LANES
+ * satellites at once (SoA: v[lane], d[k][lane]). Transcendentals are
+ * evaluated once per value and reused for the tangents, so a propagation
+ * with partials costs a small constant factor over the plain kernel
+ * instead of 8 propagations. The formulas mirror sgp4_propagate_scalar();
+ * derivatives through the Kepler iteration are exact for the iterate.
+ *
+ * Units: elements in radians, eccentricity dimensionless, no in rad/min,
+ * bstar in 1/earth-radii; positions in km and velocities in km/s.
+ */
+
+#include "sgp4_batch.h"
+
+#define SGP4_NPARTIALS 7            // inclo, nodeo, ecco, argpo, mo, no, bstar
+#define SGP4_NJACOBIAN (6 * SGP4_NPARTIALS)
+
+// Satellites per dual-number vector (one AVX2 register, two NEON registers)
+#define SGP4_AD_LANES 4
+
+typedef struct {
+    double v[SGP4_AD_LANES];
+    double d[SGP4_NPARTIALS][SGP4_AD_LANES];
+} ad_t;
+
+// ============================================================================
+// Dual-number arithmetic (lane-wise)
+// ============================================================================
+
+static inline ad_t ad_const(double c) {
+    ad_t r;
+    for (int l = 0; l < SGP4_AD_LANES; l++) r.v[l] = c;
+    memset(r.d, 0, sizeof(r.d));
+    return r;
+}
+
+// Independent variable k with per-lane values
+static inline ad_t ad_var(const double* v, int k) {
+    ad_t r;
+    memcpy(r.v, v, sizeof(r.v));
+    memset(r.d, 0, sizeof(r.d));
+    for (int l = 0; l < SGP4_AD_LANES; l++) r.d[k][l] = 1.0;
+    return r;
+}
+
+static inline ad_t ad_add(ad_t a, ad_t b) {
+    ad_t r;
+    for (int l = 0; l < SGP4_AD_LANES; l++) r.v[l] = a.v[l] + b.v[l];
+    for (int k = 0; k < SGP4_NPARTIALS; k++)
+        for (int l = 0; l < SGP4_AD_LANES; l++) r.d[k][l] = a.d[k][l] + b.d[k][l];
+    return r;
+}
+
+static inline ad_t ad_sub(ad_t a, ad_t b) {
+    ad_t r;
+    for (int l = 0; l < SGP4_AD_LANES; l++) r.v[l] = a.v[l] - b.v[l];
+    for (int k = 0; k < SGP4_NPARTIALS; k++)
+        for (int l = 0; l < SGP4_AD_LANES; l++) r.d[k][l] = a.d[k][l] - b.d[k][l];
+    return r;
+}
+
+static inline ad_t ad_mul(ad_t a, ad_t b) {
+    ad_t r;
+    for (int l = 0; l < SGP4_AD_LANES; l++) r.v[l] = a.v[l] * b.v[l];
+    for (int k = 0; k < SGP4_NPARTIALS; k++)
+        for (int l = 0; l < SGP4_AD_LANES; l++)
+            r.d[k][l] = a.d[k][l] * b.v[l] + a.v[l] * b.d[k][l];
+    return r;
+}
+
+static inline ad_t ad_div(ad_t a, ad_t b) {
+    ad_t r;
+    double inv[SGP4_AD_LANES];
+    for (int l = 0; l < SGP4_AD_LANES; l++) {
+        inv[l] = 1.0 / b.v[l];
+        r.v[l] = a.v[l] * inv[l];
+    }
+    for (int k = 0; k < SGP4_NPARTIALS; k++)
+        for (int l = 0; l < SGP4_AD_LANES; l++)
+            r.d[k][l] = (a.d[k][l] - r.v[l] * b.d[k][l]) * inv[l];
+    return r;
+}
+
+// s * a + c (scalar s, c)
+static inline ad_t ad_affine(ad_t a, double s, double c) {
+    ad_t r;
+    for (int l = 0; l < SGP4_AD_LANES; l++) r.v[l] = s * a.v[l] + c;
+    for (int k = 0; k < SGP4_NPARTIALS; k++)
+        for (int l = 0; l < SGP4_AD_LANES; l++) r.d[k][l] = s * a.d[k][l];
+    return r;
+}
+
+// a * s[lane] (per-lane constant, e.g. tsince)
+static inline ad_t ad_scale_lanes(ad_t a, const double* s) {
+    ad_t r;
+    for (int l = 0; l < SGP4_AD_LANES; l++) r.v[l] = a.v[l] * s[l];
+    for (int k = 0; k < SGP4_NPARTIALS; k++)
+        for (int l = 0; l < SGP4_AD_LANES; l++) r.d[k][l] = a.d[k][l] * s[l];
+    return r;
+}
+
+// Apply f with value fv[lane] and derivative dv[lane] (chain rule)
+static inline ad_t ad_chain(ad_t a, const double* fv, const double* dv) {
+    ad_t r;
+    memcpy(r.v, fv, sizeof(r.v));
+    for (int k = 0; k < SGP4_NPARTIALS; k++)
+        for (int l = 0; l < SGP4_AD_LANES; l++) r.d[k][l] = dv[l] * a.d[k][l];
+    return r;
+}
+
+static inline ad_t ad_sin(ad_t a) {
+    double fv[SGP4_AD_LANES], dv[SGP4_AD_LANES];
+    for (int l = 0; l < SGP4_AD_LANES; l++) {
+        fv[l] = sin(a.v[l]);
+        dv[l] = cos(a.v[l]);
+    }
+    return ad_chain(a, fv, dv);
+}
+
+static inline ad_t ad_cos(ad_t a) {
+    double fv[SGP4_AD_LANES], dv[SGP4_AD_LANES];
+    for (int l = 0; l < SGP4_AD_LANES; l++) {
+        fv[l] = cos(a.v[l]);
+        dv[l] = -sin(a.v[l]);
+    }
+    return ad_chain(a, fv, dv);
+}
+
+static inline ad_t ad_sqrt(ad_t a) {
+    double fv[SGP4_AD_LANES], dv[SGP4_AD_LANES];
+    for (int l = 0; l < SGP4_AD_LANES; l++) {
+        fv[l] = sqrt(a.v[l]);
+        dv[l] = 0.5 / fv[l];
+    }
+    return ad_chain(a, fv, dv);
+}
+
+// a^p for constant p
+static inline ad_t ad_pow(ad_t a, double p) {
+    double fv[SGP4_AD_LANES], dv[SGP4_AD_LANES];
+    for (int l = 0; l < SGP4_AD_LANES; l++) {
+        fv[l] = pow(a.v[l], p);
+        dv[l] = p * fv[l] / a.v[l];
+    }
+    return ad_chain(a, fv, dv);
+}
+
+// Reduce into [0, 2pi); the shift is locally constant
+static inline ad_t ad_mod_2pi(ad_t a) {
+    double fv[SGP4_AD_LANES], dv[SGP4_AD_LANES];
+    for (int l = 0; l < SGP4_AD_LANES; l++) {
+        fv[l] = fmod(a.v[l], TWOPI);
+        if (fv[l] < 0) fv[l] += TWOPI;
+        dv[l] = 1.0;
+    }
+    return ad_chain(a, fv, dv);
+}
+
+static inline ad_t ad_atan2(ad_t y, ad_t x) {
+    ad_t r;
+    double iy[SGP4_AD_LANES], ix[SGP4_AD_LANES];
+    for (int l = 0; l < SGP4_AD_LANES; l++) {
+        double inv = 1.0 / (x.v[l] * x.v[l] + y.v[l] * y.v[l]);
+        r.v[l] = atan2(y.v[l], x.v[l]);
+        iy[l] = x.v[l] * inv;
+        ix[l] = -y.v[l] * inv;
+    }
+    for (int k = 0; k < SGP4_NPARTIALS; k++)
+        for (int l = 0; l < SGP4_AD_LANES; l++)
+            r.d[k][l] = iy[l] * y.d[k][l] + ix[l] * x.d[k][l];
+    return r;
+}
+
+// ============================================================================
+// Differentiated kernel
+// ============================================================================
+
+/**
+ * Time-independent terms for one vector of satellites, as duals.
+ */
+typedef struct {
+    ad_t cosio, sinio, ecco, el2, xnodp, aodp, c1, mo, argpo, nodeo;
+    double epoch[SGP4_AD_LANES];
+} ad_coeffs_t;
+
+static void ad_init(const SGP4Batch* batch, int idx, int lanes,
+                    const SGP4Geophs* geophs, ad_coeffs_t* c) {
+    // Element vectors; padding lanes repeat the first satellite
+    double e[SGP4_NPARTIALS][SGP4_AD_LANES];
+    for (int l = 0; l < SGP4_AD_LANES; l++) {
+        int i = idx + (l < lanes ? l : 0);
+        e[0][l] = batch->inclo[i];
+        e[1][l] = batch->nodeo[i];
+        e[2][l] = batch->ecco[i];
+        e[3][l] = batch->argpo[i];
+        e[4][l] = batch->mo[i];
+        e[5][l] = batch->no[i];
+        e[6][l] = batch->bstar[i];
+        c->epoch[l] = batch->epoch[i];
+    }
+
+    ad_t inclo = ad_var(e[0], 0);
+    ad_t ecco  = ad_var(e[2], 2);
+    ad_t no    = ad_var(e[5], 5);
+    ad_t bstar = ad_var(e[6], 6);
+
+    ad_t cosio = ad_cos(inclo);
+    ad_t theta2 = ad_mul(cosio, cosio);
+    ad_t x3thm1 = ad_affine(theta2, 3.0, -1.0);
+    ad_t eosq = ad_mul(ecco, ecco);
+    ad_t betao2 = ad_affine(eosq, -1.0, 1.0);
+    ad_t betao = ad_sqrt(betao2);
+    ad_t b3 = ad_mul(betao2, betao);
+
+    // Recover mean motion and semi-major axis
+    ad_t a1 = ad_pow(ad_div(ad_const(geophs->ke), no), 2.0/3.0);
+    ad_t k2 = ad_affine(x3thm1, 1.5 * geophs->j2, 0.0);
+    ad_t del1 = ad_div(k2, ad_mul(ad_mul(b3, a1), a1));
+    ad_t ao = ad_mul(a1, ad_sub(ad_const(1.0),
+        ad_mul(del1, ad_add(ad_const(1.0/3.0), ad_mul(del1, ad_affine(del1, 1.0, 1.0))))));
+    ad_t delo = ad_div(k2, ad_mul(ad_mul(b3, ao), ao));
+
+    c->cosio = cosio;
+    c->sinio = ad_sin(inclo);
+    c->ecco = ecco;
+    c->el2 = betao2;
+    c->xnodp = ad_div(no, ad_affine(delo, 1.0, 1.0));
+    c->aodp = ad_div(ao, ad_affine(delo, -1.0, 1.0));
+    c->c1 = ad_mul(bstar, ad_mul(c->aodp, c->aodp));
+    c->mo = ad_var(e[4], 4);
+    c->argpo = ad_var(e[3], 3);
+    c->nodeo = ad_var(e[1], 1);
+}
+
+/**
+ * State and Jacobian for one vector of satellites at one epoch per lane.
+ * Writes lanes [0, lanes) to out[l * sat_stride] / jac[l * sat_stride * 42].
+ */
+static void ad_step(const ad_coeffs_t* c, const double* tsince, int lanes,
+                    const SGP4Geophs* geophs,
+                    double* x, double* y, double* z,
+                    double* vx, double* vy, double* vz,
+                    double* jac, long sat_stride) {
+    // Secular effects (simplified)
+    ad_t xmp = ad_add(c->mo, ad_scale_lanes(c->xnodp, tsince));
+    ad_t xmdf = ad_add(xmp, ad_scale_lanes(ad_scale_lanes(c->c1, tsince), tsince));
+
+    // Solve Kepler's equation
+    ad_t u = ad_mod_2pi(xmdf);
+    ad_t eo1 = u;
+    for (int i = 0; i < 4; i++) {
+        ad_t f = ad_sub(ad_sub(eo1, ad_mul(c->ecco, ad_sin(eo1))), u);
+        ad_t fp = ad_sub(ad_const(1.0), ad_mul(c->ecco, ad_cos(eo1)));
+        eo1 = ad_sub(eo1, ad_div(f, fp));
+    }
+
+    // Position and velocity
+    ad_t sin_eo1 = ad_sin(eo1);
+    ad_t cos_eo1 = ad_cos(eo1);
+    ad_t ecose = ad_mul(c->ecco, cos_eo1);
+    ad_t esine = ad_mul(c->ecco, sin_eo1);
+    ad_t one_m_ecose = ad_affine(ecose, -1.0, 1.0);
+    ad_t pl = ad_mul(c->aodp, c->el2);
+    ad_t r = ad_mul(c->aodp, one_m_ecose);
+    ad_t rdot = ad_div(ad_mul(ad_affine(ad_sqrt(c->aodp), geophs->ke, 0.0), esine), r);
+    ad_t rvdot = ad_div(ad_affine(ad_sqrt(pl), geophs->ke, 0.0), r);
+
+    // True anomaly
+    ad_t sinv = ad_div(ad_mul(ad_sqrt(c->el2), sin_eo1), one_m_ecose);
+    ad_t cosv = ad_div(ad_sub(cos_eo1, c->ecco), one_m_ecose);
+    ad_t v = ad_atan2(sinv, cosv);
+
+    // Argument of latitude
+    ad_t su = ad_add(c->argpo, v);
+    ad_t sin_su = ad_sin(su);
+    ad_t cos_su = ad_cos(su);
+    ad_t sin_node = ad_sin(c->nodeo);
+    ad_t cos_node = ad_cos(c->nodeo);
+
+    // Unit vectors
+    ad_t sin_su_ci = ad_mul(sin_su, c->cosio);
+    ad_t cos_su_ci = ad_mul(cos_su, c->cosio);
+    ad_t ux = ad_sub(ad_mul(cos_su, cos_node), ad_mul(sin_su_ci, sin_node));
+    ad_t uy = ad_add(ad_mul(cos_su, sin_node), ad_mul(sin_su_ci, cos_node));
+    ad_t uz = ad_mul(sin_su, c->sinio);
+    ad_t vx_u = ad_affine(ad_add(ad_mul(sin_su, cos_node), ad_mul(cos_su_ci, sin_node)), -1.0, 0.0);
+    ad_t vy_u = ad_sub(ad_mul(cos_su_ci, cos_node), ad_mul(sin_su, sin_node));
+    ad_t vz_u = ad_mul(cos_su, c->sinio);
+
+    // Scale to km and km/s
+    ad_t r_km = ad_affine(r, geophs->re, 0.0);
+    ad_t rdot_kms = ad_affine(rdot, geophs->re / 60.0, 0.0);
+    ad_t rvdot_kms = ad_affine(rvdot, geophs->re / 60.0, 0.0);
+
+    ad_t out[6] = {
+        ad_mul(r_km, ux),
+        ad_mul(r_km, uy),
+        ad_mul(r_km, uz),
+        ad_add(ad_mul(rdot_kms, ux), ad_mul(rvdot_kms, vx_u)),
+        ad_add(ad_mul(rdot_kms, uy), ad_mul(rvdot_kms, vy_u)),
+        ad_add(ad_mul(rdot_kms, uz), ad_mul(rvdot_kms, vz_u)),
+    };
+
+    for (int l = 0; l < lanes; l++) {
+        long o = l * sat_stride;
+        x[o] = out[0].v[l];
+        y[o] = out[1].v[l];
+        z[o] = out[2].v[l];
+        vx[o] = out[3].v[l];
+        vy[o] = out[4].v[l];
+        vz[o] = out[5].v[l];
+
+        double* j = &jac[o * SGP4_NJACOBIAN];
+        for (int row = 0; row < 6; row++) {
+            for (int k = 0; k < SGP4_NPARTIALS; k++) {
+                j[row * SGP4_NPARTIALS + k] = out[row].d[k][l];
+            }
+        }
+    }
+}
+
+/**
+ * Propagate satellites [first, first + n) over the grid et0 + t * step
+ * and return states plus their partials w.r.t. the mean elements.
+ *
+ * State layout matches sgp4_batch_sweep(): (satellite first + i, step t)
+ * at x[i * sat_stride + t * step_stride]. The 6x7 Jacobian for the same
+ * state is row-major at partials[(i * sat_stride + t * step_stride) * 42],
+ * rows x, y, z, vx, vy, vz and columns inclo, nodeo, ecco, argpo, mo, no,
+ * bstar.
+ */
+void sgp4_batch_propagate_partials(
+    const SGP4Batch* batch,
+    int first, int n,
+    double et0, double step, int steps,
+    const SGP4Geophs* geophs,
+    double* x, double* y, double* z,
+    double* vx, double* vy, double* vz,
+    double* partials,
+    long sat_stride, long step_stride
+) {
+    ad_coeffs_t c;
+    double tsince[SGP4_AD_LANES];
+
+    for (int i = 0; i < n; i += SGP4_AD_LANES) {
+        int lanes = n - i < SGP4_AD_LANES ? n - i : SGP4_AD_LANES;
+        ad_init(batch, first + i, lanes, geophs, &c);
+
+        for (int t = 0; t < steps; t++) {
+            double et = et0 + t * step;
+            for (int l = 0; l < SGP4_AD_LANES; l++) {
+                tsince[l] = (et - c.epoch[l]) / 60.0;  // minutes
+            }
+
+            long o = i * sat_stride + t * step_stride;
+            ad_step(&c, tsince, lanes, geophs,
+                    &x[o], &y[o], &z[o], &vx[o], &vy[o], &vz[o],
+                    &partials[o * SGP4_NJACOBIAN], sat_stride);
+        }
+    }
+}
@@ -0,0 +1,871 @@
+/**
+ * SGP4 Pipeline Executor
+ *
+ * Runs a chain of stages over SoA chunks of one satellite's ephemeris
+ * without materializing the full ephemeris:
+ *
+ *   propagate -> frame -> derived quantities -> filters -> reductions / rows
+ *
+ * Each chunk (SGP4_PIPELINE_CHUNK epochs, all columns ~52 KB) is produced
+ * by the register-tiled sweep and passes through every stage while it is
+ * still in cache. Filters narrow a per-row mask; reductions accumulate
+ * per satellite over the rows still selected at their position in the
+ * chain; select stages emit the selected rows.
+ *
+ * Pipelines are built with the sgp4_pipeline_add_*() functions, which
+ * validate each stage against the ones before it, or decoded from the
+ * flat encoding used by the JS builder (5 doubles per stage).
+ */
+
+#include "sgp4_batch.h"
+
+#define SGP4_PIPELINE_CHUNK      256
+#define SGP4_PIPELINE_STAGING    (1 << 20)  // bytes of states swept ahead per group
+#define SGP4_PIPELINE_MAX_STAGES 32
+#define SGP4_PIPELINE_WORDS      5   // doubles per encoded stage
+
+// WGS-84 ellipsoid for geodetic quantities
+#define PIPELINE_WGS84_A   6378.137
+#define PIPELINE_WGS84_E2  6.69437999014e-3
+#define PIPELINE_OMEGA_E   7.292115146706979e-5   // Earth rotation (rad/s)
+#define PIPELINE_RAD2DEG   (180.0 / PI)
+
+// Stage kinds (encoded word 0)
+typedef enum {
+    SGP4_STAGE_FRAME    = 0,   // arg = SGP4Frame
+    SGP4_STAGE_OBSERVER = 1,   // p = lat (deg), lon (deg), alt (km)
+    SGP4_STAGE_DERIVE   = 2,   // arg = SGP4Column
+    SGP4_STAGE_FILTER   = 3,   // arg = SGP4Column, op = SGP4FilterOp, p = lo, hi
+    SGP4_STAGE_REDUCE   = 4,   // arg = SGP4Column, op = SGP4ReduceOp, p = where op, value
+    SGP4_STAGE_SELECT   = 5,   // arg = SGP4Column
+} SGP4StageKind;
+
+typedef enum {
+    SGP4_FRAME_TEME = 0,
+    SGP4_FRAME_GCRF = 1,
+    SGP4_FRAME_ECEF = 2,
+} SGP4Frame;
+
+// Chunk columns. State columns are in the pipeline's current frame.
+typedef enum {
+    SGP4_COL_ET = 0,      // seconds past J2000
+    SGP4_COL_X, SGP4_COL_Y, SGP4_COL_Z,            // km
+    SGP4_COL_VX, SGP4_COL_VY, SGP4_COL_VZ,         // km/s
+    SGP4_COL_RADIUS,      // km
+    SGP4_COL_SPEED,       // km/s
+    SGP4_COL_ALT,         // geodetic altitude (km)
+    SGP4_COL_LAT,         // geodetic latitude (deg)
+    SGP4_COL_LON,         // longitude (deg, -180..180)
+    SGP4_COL_AZ,          // azimuth from observer (deg, 0..360)
+    SGP4_COL_EL,          // elevation from observer (deg)
+    SGP4_COL_RANGE,       // slant range from observer (km)
+    // Osculating elements in the current (inertial) frame
+    SGP4_COL_SMA,         // semi-major axis (km, negative when hyperbolic)
+    SGP4_COL_ECC,         // eccentricity
+    SGP4_COL_INC,         // inclination (deg, 0..180)
+    SGP4_COL_RAAN,        // right ascension of ascending node (deg, 0..360)
+    SGP4_COL_ARGP,        // argument of perigee (deg, 0..360)
+    SGP4_COL_NU,          // true anomaly (deg, 0..360)
+    SGP4_COL_EQ_H,        // equinoctial h = e sin(argp + raan)
+    SGP4_COL_EQ_K,        // equinoctial k = e cos(argp + raan)
+    SGP4_COL_EQ_P,        // equinoctial p = tan(i/2) sin(raan)
+    SGP4_COL_EQ_Q,        // equinoctial q = tan(i/2) cos(raan)
+    SGP4_COL_EQ_L,        // true longitude raan + argp + nu (deg, 0..360)
+    SGP4_COL_COUNT
+} SGP4Column;
+
+typedef enum {
+    SGP4_FILTER_LT = 0,
+    SGP4_FILTER_LE,
+    SGP4_FILTER_GT,
+    SGP4_FILTER_GE,
+    SGP4_FILTER_BETWEEN,  // lo <= v <= hi
+    SGP4_FILTER_OUTSIDE,  // v < lo || v > hi
+} SGP4FilterOp;
+
+typedef enum {
+    SGP4_REDUCE_MIN = 0,
+    SGP4_REDUCE_MAX,
+    SGP4_REDUCE_SUM,
+    SGP4_REDUCE_MEAN,
+    SGP4_REDUCE_COUNT,    // rows selected (column ignored)
+    SGP4_REDUCE_ARGMIN,   // et of the minimum
+    SGP4_REDUCE_ARGMAX,   // et of the maximum
+    SGP4_REDUCE_COUNT_WHERE,     // rows selected where column <where op> value
+    SGP4_REDUCE_DURATION_WHERE,  // the same, as sampled time (count * step, seconds)
+} SGP4ReduceOp;
+
+typedef struct {
+    int kind;
+    int arg;
+    int op;
+    double p[3];
+} SGP4PipelineStage;
+
+typedef struct {
+    int n_stages;
+    SGP4PipelineStage stages[SGP4_PIPELINE_MAX_STAGES];
+
+    int n_reduce;              // Reduce stages (outputs per satellite)
+    int n_select;              // Select stages (columns per emitted row)
+
+    // Builder state used for validation
+    int frame;                 // Frame after the stages so far
+    int available[SGP4_COL_COUNT];
+    int has_observer;
+
+    const char* error;         // Set by the first failing builder call
+} SGP4Pipeline;
+
+typedef struct {
+    int n_sats;
+    int n_reduce;
+    double* reduce;            // [n_sats * n_reduce]
+
+    int n_select;
+    long n_rows;
+    long row_capacity;
+    long max_rows;             // 0 = unlimited; set by caller before run
+    int truncated;             // Rows were dropped because of max_rows
+    int* row_sat;              // [n_rows] satellite index (relative to first)
+    double* rows;              // [n_rows * n_select]
+} SGP4PipelineResult;
+
+// ============================================================================
+// Builder
+// ============================================================================
+
+void sgp4_pipeline_init(SGP4Pipeline* p) {
+    memset(p, 0, sizeof(*p));
+    p->frame = SGP4_FRAME_TEME;
+    for (int c = SGP4_COL_ET; c <= SGP4_COL_VZ; c++) {
+        p->available[c] = 1;
+    }
+}
+
+static SGP4PipelineStage* pipeline_push(SGP4Pipeline* p, int kind) {
+    if (p->error) return NULL;
+    if (p->n_stages >= SGP4_PIPELINE_MAX_STAGES) {
+        p->error = "Too many pipeline stages";
+        return NULL;
+    }
+    SGP4PipelineStage* s = &p->stages[p->n_stages++];
+    memset(s, 0, sizeof(*s));
+    s->kind = kind;
+    return s;
+}
+
+static int pipeline_valid_column(int col) {
+    return col >= 0 && col < SGP4_COL_COUNT;
+}
+
+int sgp4_pipeline_add_frame(SGP4Pipeline* p, int frame) {
+    if (p->error) return -1;
+    if (frame != SGP4_FRAME_GCRF && frame != SGP4_FRAME_ECEF && frame != SGP4_FRAME_TEME) {
+        p->error = "Unknown frame";
+        return -1;
+    }
+    if (p->frame != SGP4_FRAME_TEME) {
+        p->error = "Frame conversion must start from TEME (only one frame stage allowed)";
+        return -1;
+    }
+    SGP4PipelineStage* s = pipeline_push(p, SGP4_STAGE_FRAME);
+    if (!s) return -1;
+    s->arg = frame;
+    p->frame = frame;
+    // Speed is frame dependent; anything derived earlier keeps its value
+    return 0;
+}
+
+int sgp4_pipeline_add_observer(SGP4Pipeline* p, double lat_deg, double lon_deg, double alt_km) {
+    if (p->error) return -1;
+    if (!(lat_deg >= -90.0 && lat_deg <= 90.0) || !(lon_deg >= -180.0 && lon_deg <= 360.0) || isnan(alt_km)) {
+        p->error = "Invalid observer location";
+        return -1;
+    }
+    SGP4PipelineStage* s = pipeline_push(p, SGP4_STAGE_OBSERVER);
+    if (!s) return -1;
+    s->p[0] = lat_deg;
+    s->p[1] = lon_deg;
+    s->p[2] = alt_km;
+    p->has_observer = 1;
+    return 0;
+}
+
+int sgp4_pipeline_add_derive(SGP4Pipeline* p, int col) {
+    if (p->error) return -1;
+    if (!pipeline_valid_column(col) || col < SGP4_COL_RADIUS) {
+        p->error = "Unknown derived quantity";
+        return -1;
+    }
+    if (col >= SGP4_COL_ALT && col <= SGP4_COL_RANGE && p->frame == SGP4_FRAME_GCRF) {
+        p->error = "Earth-fixed quantities must be derived before a GCRF frame stage";
+        return -1;
+    }
+    if (col >= SGP4_COL_SMA && p->frame == SGP4_FRAME_ECEF) {
+        p->error = "Orbital elements need an inertial frame (TEME or GCRF)";
+        return -1;
+    }
+    if (col >= SGP4_COL_AZ && col <= SGP4_COL_RANGE && !p->has_observer) {
+        p->error = "Look angles require an observer stage";
+        return -1;
+    }
+    SGP4PipelineStage* s = pipeline_push(p, SGP4_STAGE_DERIVE);
+    if (!s) return -1;
+    s->arg = col;
+    p->available[col] = 1;
+    return 0;
+}
+
+int sgp4_pipeline_add_filter(SGP4Pipeline* p, int col, int op, double lo, double hi) {
+    if (p->error) return -1;
+    if (!pipeline_valid_column(col) || !p->available[col]) {
+        p->error = "Filter column is not available at this point of the pipeline";
+        return -1;
+    }
+    if (op < SGP4_FILTER_LT || op > SGP4_FILTER_OUTSIDE) {
+        p->error = "Unknown filter operator";
+        return -1;
+    }
+    SGP4PipelineStage* s = pipeline_push(p, SGP4_STAGE_FILTER);
+    if (!s) return -1;
+    s->arg = col;
+    s->op = op;
+    s->p[0] = lo;
+    s->p[1] = hi;
+    return 0;
+}
+
+int sgp4_pipeline_add_reduce(SGP4Pipeline* p, int col, int op) {
+    if (p->error) return -1;
+    if (op < SGP4_REDUCE_MIN || op > SGP4_REDUCE_ARGMAX) {
+        p->error = "Unknown reduction";
+        return -1;
+    }
+    if (op != SGP4_REDUCE_COUNT && (!pipeline_valid_column(col) || !p->available[col])) {
+        p->error = "Reduction column is not available at this point of the pipeline";
+        return -1;
+    }
+    SGP4PipelineStage* s = pipeline_push(p, SGP4_STAGE_REDUCE);
+    if (!s) return -1;
+    s->arg = op == SGP4_REDUCE_COUNT ? SGP4_COL_ET : col;
+    s->op = op;
+    p->n_reduce++;
+    return 0;
+}
+
+/**
+ * Conditional reduction: count (or sampled duration) of the rows selected
+ * so far that also satisfy column <where_op> value. Unlike a filter stage
+ * this does not narrow the rows seen by later stages.
+ */
+int sgp4_pipeline_add_reduce_where(SGP4Pipeline* p, int col, int op, int where_op, double value) {
+    if (p->error) return -1;
+    if (op != SGP4_REDUCE_COUNT_WHERE && op != SGP4_REDUCE_DURATION_WHERE) {
+        p->error = "Unknown conditional reduction";
+        return -1;
+    }
+    if (where_op < SGP4_FILTER_LT || where_op > SGP4_FILTER_GE || isnan(value)) {
+        p->error = "Conditional reductions take one comparison (<, <=, >, >=)";
+        return -1;
+    }
+    if (!pipeline_valid_column(col) || !p->available[col]) {
+        p->error = "Reduction column is not available at this point of the pipeline";
+        return -1;
+    }
+    SGP4PipelineStage* s = pipeline_push(p, SGP4_STAGE_REDUCE);
+    if (!s) return -1;
+    s->arg = col;
+    s->op = op;
+    s->p[0] = where_op;
+    s->p[1] = value;
+    p->n_reduce++;
+    return 0;
+}
+
+int sgp4_pipeline_add_select(SGP4Pipeline* p, int col) {
+    if (p->error) return -1;
+    if (!pipeline_valid_column(col) || !p->available[col]) {
+        p->error = "Selected column is not available at this point of the pipeline";
+        return -1;
+    }
+    SGP4PipelineStage* s = pipeline_push(p, SGP4_STAGE_SELECT);
+    if (!s) return -1;
+    s->arg = col;
+    p->n_select++;
+    return 0;
+}
+
+/**
+ * Build a pipeline from its flat encoding: n_stages records of
+ * [kind, arg, op, p0, p1] (observer stages: [kind, lat, lon, alt, 0];
+ * conditional reductions: [kind, column, op, where op, value]).
+ *
+ * @return 0 on success, -1 with p->error set
+ */
+int sgp4_pipeline_decode(SGP4Pipeline* p, const double* words, int n_stages) {
+    sgp4_pipeline_init(p);
+
+    for (int i = 0; i < n_stages && !p->error; i++) {
+        const double* w = &words[i * SGP4_PIPELINE_WORDS];
+        switch ((int)w[0]) {
+            case SGP4_STAGE_FRAME:    sgp4_pipeline_add_frame(p, (int)w[1]); break;
+            case SGP4_STAGE_OBSERVER: sgp4_pipeline_add_observer(p, w[1], w[2], w[3]); break;
+            case SGP4_STAGE_DERIVE:   sgp4_pipeline_add_derive(p, (int)w[1]); break;
+            case SGP4_STAGE_FILTER:   sgp4_pipeline_add_filter(p, (int)w[1], (int)w[2], w[3], w[4]); break;
+            case SGP4_STAGE_REDUCE:
+                if ((int)w[2] >= SGP4_REDUCE_COUNT_WHERE) {
+                    sgp4_pipeline_add_reduce_where(p, (int)w[1], (int)w[2], (int)w[3], w[4]);
+                } else {
+                    sgp4_pipeline_add_reduce(p, (int)w[1], (int)w[2]);
+                }
+                break;
+            case SGP4_STAGE_SELECT:   sgp4_pipeline_add_select(p, (int)w[1]); break;
+            default: p->error = "Unknown pipeline stage"; break;
+        }
+    }
+
+    return p->error ? -1 : 0;
+}
+
+// ============================================================================
+// Stage kernels (one chunk of n rows)
+// ============================================================================
+
+/**
+ * Greenwich mean sidereal time (IAU-82), radians.
+ * The native engine's time scale is UTC-like, used here as UT1.
+ */
+static double pipeline_gmst(double et) {
+    double tut1 = et / (36525.0 * 86400.0);
+    double gmst = 67310.54841 + (876600.0 * 3600.0 + 8640184.812866) * tut1 +
+                  0.093104 * tut1 * tut1 - 6.2e-6 * tut1 * tut1 * tut1;
+    gmst = fmod(gmst * (PI / 43200.0), TWOPI);
+    return gmst < 0 ? gmst + TWOPI : gmst;
+}
+
+// Earth-fixed position (and optionally velocity) from TEME, per row
+static void pipeline_teme_to_ecef(
+    const double* et, const double* x, const double* y, const double* z,
+    const double* vx, const double* vy, const double* vz,
+    double* ex, double* ey, double* ez,
+    double* evx, double* evy, double* evz, int n
+) {
+    for (int i = 0; i < n; i++) {
+        double g = pipeline_gmst(et[i]);
+        double c = cos(g), s = sin(g);
+        double px = c * x[i] + s * y[i];
+        double py = -s * x[i] + c * y[i];
+        ex[i] = px;
+        ey[i] = py;
+        ez[i] = z[i];
+        if (evx) {
+            evx[i] = c * vx[i] + s * vy[i] + PIPELINE_OMEGA_E * py;
+            evy[i] = -s * vx[i] + c * vy[i] - PIPELINE_OMEGA_E * px;
+            evz[i] = vz[i];
+        }
+    }
+}
+
+static void pipeline_site_ecef(double lat_deg, double lon_deg, double alt_km, double site[3]) {
+    double lat = lat_deg * DEG2RAD, lon = lon_deg * DEG2RAD;
+    double sl = sin(lat);
+    double n = PIPELINE_WGS84_A / sqrt(1.0 - PIPELINE_WGS84_E2 * sl * sl);
+    site[0] = (n + alt_km) * cos(lat) * cos(lon);
+    site[1] = (n + alt_km) * cos(lat) * sin(lon);
+    site[2] = (n * (1.0 - PIPELINE_WGS84_E2) + alt_km) * sl;
+}
+
+// Geodetic latitude (deg) and altitude (km) of an Earth-fixed position
+static void pipeline_geodetic(double x, double y, double z, double* lat_deg, double* alt_km) {
+    double p = sqrt(x * x + y * y);
+    double phi = atan2(z, p * (1.0 - PIPELINE_WGS84_E2));
+    double h = 0.0;
+    for (int k = 0; k < 4; k++) {
+        double s = sin(phi);
+        double nn = PIPELINE_WGS84_A / sqrt(1.0 - PIPELINE_WGS84_E2 * s * s);
+        h = p * cos(phi) + z * s - PIPELINE_WGS84_A * sqrt(1.0 - PIPELINE_WGS84_E2 * s * s);
+        phi = atan2(z, p * (1.0 - PIPELINE_WGS84_E2 * nn / (nn + h)));
+    }
+    *lat_deg = phi * PIPELINE_RAD2DEG;
+    *alt_km = h;
+}
+
+#define PIPELINE_ELEMENTS (SGP4_COL_COUNT - SGP4_COL_SMA)
+
+/**
+ * Per-chunk working set: columns, row mask, and lazily computed
+ * Earth-fixed positions and orbital elements (in the current frame).
+ */
+typedef struct {
+    double col[SGP4_COL_COUNT][SGP4_PIPELINE_CHUNK];
+    double ecef[3][SGP4_PIPELINE_CHUNK];
+    double elements[PIPELINE_ELEMENTS][SGP4_PIPELINE_CHUNK];
+    unsigned char mask[SGP4_PIPELINE_CHUNK];
+    double mu;             // km^3/s^2
+    int frame;
+    int have_ecef;
+    int have_elements;
+    int n;
+} PipelineChunk;
+
+static void chunk_ecef(PipelineChunk* ch) {
+    if (ch->have_ecef) return;
+    if (ch->frame == SGP4_FRAME_ECEF) {
+        memcpy(ch->ecef[0], ch->col[SGP4_COL_X], ch->n * sizeof(double));
+        memcpy(ch->ecef[1], ch->col[SGP4_COL_Y], ch->n * sizeof(double));
+        memcpy(ch->ecef[2], ch->col[SGP4_COL_Z], ch->n * sizeof(double));
+    } else {
+        pipeline_teme_to_ecef(ch->col[SGP4_COL_ET],
+            ch->col[SGP4_COL_X], ch->col[SGP4_COL_Y], ch->col[SGP4_COL_Z],
+            NULL, NULL, NULL,
+            ch->ecef[0], ch->ecef[1], ch->ecef[2], NULL, NULL, NULL, ch->n);
+    }
+    ch->have_ecef = 1;
+}
+
+static void stage_frame(PipelineChunk* ch, int frame) {
+    if (frame == SGP4_FRAME_GCRF) {
+        sgp4_teme_to_gcrf(ch->col[SGP4_COL_ET],
+            ch->col[SGP4_COL_X], ch->col[SGP4_COL_Y], ch->col[SGP4_COL_Z],
+            ch->col[SGP4_COL_VX], ch->col[SGP4_COL_VY], ch->col[SGP4_COL_VZ], ch->n);
+    } else if (frame == SGP4_FRAME_ECEF) {
+        pipeline_teme_to_ecef(ch->col[SGP4_COL_ET],
+            ch->col[SGP4_COL_X], ch->col[SGP4_COL_Y], ch->col[SGP4_COL_Z],
+            ch->col[SGP4_COL_VX], ch->col[SGP4_COL_VY], ch->col[SGP4_COL_VZ],
+            ch->col[SGP4_COL_X], ch->col[SGP4_COL_Y], ch->col[SGP4_COL_Z],
+            ch->col[SGP4_COL_VX], ch->col[SGP4_COL_VY], ch->col[SGP4_COL_VZ], ch->n);
+        ch->have_ecef = 0;
+    }
+    ch->frame = frame;
+    ch->have_elements = 0;
+}
+
+/**
+ * Osculating Keplerian and equinoctial elements of every row, all at once
+ * into ch->elements (derive stages copy out the columns they name).
+ *
+ * The vector algebra is one straight-line pass with selects instead of
+ * branches, which the compiler vectorizes across rows; it leaves the
+ * five angles as (y, x) pairs for a scalar atan2 pass, as in the sweep
+ * kernel. Singular cases resolve to the usual conventions rather than NaN:
+ *
+ *   - circular (e < PIPELINE_ELEMENT_EPS): argp = 0, nu = argument of latitude
+ *   - equatorial (sin i < PIPELINE_ELEMENT_EPS): raan = 0, argp = longitude
+ *     of perigee, nu measured from the x axis
+ *
+ * The equinoctial set uses the prograde (retrograde factor +1) convention:
+ * regular for every orbit except i = 180 deg exactly, and without the
+ * e -> 0 / i -> 0 ambiguities of the Keplerian angles.
+ */
+#define PIPELINE_ELEMENT_EPS 1e-11
+
+/** Degrees in (-360, 360) to [0, 360): a tiny negative angle rounds up to 360, so it maps to 0 */
+static void pipeline_wrap360(double* deg, int n) {
+    for (int i = 0; i < n; i++) {
+        double d = deg[i] < 0 ? deg[i] + 360.0 : deg[i];
+        deg[i] = d < 360.0 ? d : 0.0;
+    }
+}
+
+static void chunk_elements(PipelineChunk* ch) {
+    if (ch->have_elements) return;
+    const int n = ch->n;
+    const double mu = ch->mu;
+    const double *rx = ch->col[SGP4_COL_X], *ry = ch->col[SGP4_COL_Y], *rz = ch->col[SGP4_COL_Z];
+    const double *vx = ch->col[SGP4_COL_VX], *vy = ch->col[SGP4_COL_VY], *vz = ch->col[SGP4_COL_VZ];
+#define ELEMENT(c) ch->elements[(c) - SGP4_COL_SMA]
+    double *sma = ELEMENT(SGP4_COL_SMA), *ecc = ELEMENT(SGP4_COL_ECC), *inc = ELEMENT(SGP4_COL_INC);
+    double *raan = ELEMENT(SGP4_COL_RAAN), *argp = ELEMENT(SGP4_COL_ARGP), *nu = ELEMENT(SGP4_COL_NU);
+    double *eh = ELEMENT(SGP4_COL_EQ_H), *ek = ELEMENT(SGP4_COL_EQ_K);
+    double *ep = ELEMENT(SGP4_COL_EQ_P), *eq = ELEMENT(SGP4_COL_EQ_Q), *el = ELEMENT(SGP4_COL_EQ_L);
+#undef ELEMENT
+    // Angle columns hold atan2's y until the second pass; nu holds the argument of latitude
+    double* angle[5] = { inc, raan, argp, nu, el };
+    double cosine[5][SGP4_PIPELINE_CHUNK];
+
+    for (int i = 0; i < n; i++) {
+        double x = rx[i], y = ry[i], z = rz[i];
+        double u = vx[i], v = vy[i], w = vz[i];
+        double r = sqrt(x * x + y * y + z * z);
+        double v2 = u * u + v * v + w * w;
+        double rv = x * u + y * v + z * w;
+
+        // Angular momentum and eccentricity vector
+        double hx = y * w - z * v, hy = z * u - x * w, hz = x * v - y * u;
+        double hxy = sqrt(hx * hx + hy * hy);
+        double h = sqrt(hxy * hxy + hz * hz);
+        double c = v2 - mu / r;
+        double ex = (c * x - rv * u) / mu;
+        double ey = (c * y - rv * v) / mu;
+        double ez = (c * z - rv * w) / mu;
+        double e = sqrt(ex * ex + ey * ey + ez * ez);
+
+        sma[i] = 1.0 / (2.0 / r - v2 / mu);
+        ecc[i] = e;
+        inc[i] = hxy;
+        cosine[0][i] = hz;
+
+        // Node direction z x h (x axis when equatorial), in-plane axis 90 deg ahead
+        int equatorial = hxy < PIPELINE_ELEMENT_EPS * h;
+        double nx = equatorial ? 1.0 : -hy / hxy;
+        double ny = equatorial ? 0.0 : hx / hxy;
+        double mx = -hz * ny / h, my = hz * nx / h, mz = (hx * ny - hy * nx) / h;
+        int circular = e < PIPELINE_ELEMENT_EPS;
+        raan[i] = ny;
+        cosine[1][i] = nx;
+        argp[i] = circular ? 0.0 : ex * mx + ey * my + ez * mz;
+        cosine[2][i] = circular ? 1.0 : ex * nx + ey * ny;
+        nu[i] = x * mx + y * my + z * mz;
+        cosine[3][i] = x * nx + y * ny;
+
+        // Equinoctial frame f, g from p, q (denominator 0 only at i = 180)
+        double d = h + hz;
+        double p = hx / d, q = -hy / d;
+        double s = 1.0 + p * p + q * q;
+        double fx = (1.0 - p * p + q * q) / s, fy = 2.0 * p * q / s, fz = -2.0 * p / s;
+        double gx = 2.0 * p * q / s, gy = (1.0 + p * p - q * q) / s, gz = 2.0 * q / s;
+        eh[i] = ex * gx + ey * gy + ez * gz;
+        ek[i] = ex * fx + ey * fy + ez * fz;
+        ep[i] = p;
+        eq[i] = q;
+        el[i] = x * gx + y * gy + z * gz;
+        cosine[4][i] = x * fx + y * fy + z * fz;
+    }
+
+    for (int k = 0; k < 5; k++) {
+        double* a = angle[k];
+        for (int i = 0; i < n; i++) a[i] = atan2(a[i], cosine[k][i]) * PIPELINE_RAD2DEG;
+    }
+
+    // True anomaly from the argument of latitude; angles to 0..360
+    for (int i = 0; i < n; i++) nu[i] -= argp[i];
+    pipeline_wrap360(raan, n);
+    pipeline_wrap360(argp, n);
+    pipeline_wrap360(nu, n);
+    pipeline_wrap360(el, n);
+    ch->have_elements = 1;
+}
+
+static void stage_derive(PipelineChunk* ch, int col, const double site[3], double site_lat, double site_lon) {
+    int n = ch->n;
+    double* out = ch->col[col];
+
+    switch (col) {
+        case SGP4_COL_RADIUS: {
+            const double *x = ch->col[SGP4_COL_X], *y = ch->col[SGP4_COL_Y], *z = ch->col[SGP4_COL_Z];
+            for (int i = 0; i < n; i++) out[i] = sqrt(x[i] * x[i] + y[i] * y[i] + z[i] * z[i]);
+            break;
+        }
+        case SGP4_COL_SPEED: {
+            const double *x = ch->col[SGP4_COL_VX], *y = ch->col[SGP4_COL_VY], *z = ch->col[SGP4_COL_VZ];
+            for (int i = 0; i < n; i++) out[i] = sqrt(x[i] * x[i] + y[i] * y[i] + z[i] * z[i]);
+            break;
+        }
+        case SGP4_COL_ALT:
+        case SGP4_COL_LAT: {
+            chunk_ecef(ch);
+            double* alt = ch->col[SGP4_COL_ALT];
+            double* lat = ch->col[SGP4_COL_LAT];
+            for (int i = 0; i < n; i++) {
+                pipeline_geodetic(ch->ecef[0][i], ch->ecef[1][i], ch->ecef[2][i], &lat[i], &alt[i]);
+            }
+            break;
+        }
+        case SGP4_COL_LON: {
+            chunk_ecef(ch);
+            for (int i = 0; i < n; i++) out[i] = atan2(ch->ecef[1][i], ch->ecef[0][i]) * PIPELINE_RAD2DEG;
+            break;
+        }
+        case SGP4_COL_AZ:
+        case SGP4_COL_EL:
+        case SGP4_COL_RANGE: {
+            chunk_ecef(ch);
+            double slat = sin(site_lat * DEG2RAD), clat = cos(site_lat * DEG2RAD);
+            double slon = sin(site_lon * DEG2RAD), clon = cos(site_lon * DEG2RAD);
+            double* az = ch->col[SGP4_COL_AZ];
+            double* el = ch->col[SGP4_COL_EL];
+            double* rng = ch->col[SGP4_COL_RANGE];
+            for (int i = 0; i < n; i++) {
+                double dx = ch->ecef[0][i] - site[0];
+                double dy = ch->ecef[1][i] - site[1];
+                double dz = ch->ecef[2][i] - site[2];
+                double e = -slon * dx + clon * dy;
+                double nn = -slat * clon * dx - slat * slon * dy + clat * dz;
+                double u = clat * clon * dx + clat * slon * dy + slat * dz;
+                double a = atan2(e, nn) * PIPELINE_RAD2DEG;
+                az[i] = a < 0 ? a + 360.0 : a;
+                el[i] = atan2(u, sqrt(e * e + nn * nn)) * PIPELINE_RAD2DEG;
+                rng[i] = sqrt(dx * dx + dy * dy + dz * dz);
+            }
+            break;
+        }
+        default:
+            if (col >= SGP4_COL_SMA) {
+                chunk_elements(ch);
+                memcpy(out, ch->elements[col - SGP4_COL_SMA], n * sizeof(double));
+            }
+            break;
+    }
+}
+
+static void stage_filter(PipelineChunk* ch, const SGP4PipelineStage* s) {
+    const double* v = ch->col[s->arg];
+    double lo = s->p[0], hi = s->p[1];
+    unsigned char* m = ch->mask;
+
+    switch (s->op) {
+        case SGP4_FILTER_LT:      for (int i = 0; i < ch->n; i++) m[i] &= v[i] < lo; break;
+        case SGP4_FILTER_LE:      for (int i = 0; i < ch->n; i++) m[i] &= v[i] <= lo; break;
+        case SGP4_FILTER_GT:      for (int i = 0; i < ch->n; i++) m[i] &= v[i] > lo; break;
+        case SGP4_FILTER_GE:      for (int i = 0; i < ch->n; i++) m[i] &= v[i] >= lo; break;
+        case SGP4_FILTER_BETWEEN: for (int i = 0; i < ch->n; i++) m[i] &= v[i] >= lo && v[i] <= hi; break;
+        case SGP4_FILTER_OUTSIDE: for (int i = 0; i < ch->n; i++) m[i] &= v[i] < lo || v[i] > hi; break;
+    }
+}
+
+// Running state of one reduce stage for the current satellite
+typedef struct {
+    double value;
+    double at;       // et of the current extremum (argmin/argmax)
+    long count;
+} PipelineAccum;
+
+static void stage_reduce(const PipelineChunk* ch, const SGP4PipelineStage* s, PipelineAccum* acc) {
+    const double* v = ch->col[s->arg];
+    const double* et = ch->col[SGP4_COL_ET];
+    const unsigned char* m = ch->mask;
+
+    if (s->op == SGP4_REDUCE_COUNT_WHERE || s->op == SGP4_REDUCE_DURATION_WHERE) {
+        double x = s->p[1];
+        long c = 0;
+        switch ((int)s->p[0]) {
+            case SGP4_FILTER_LT: for (int i = 0; i < ch->n; i++) c += m[i] && v[i] < x; break;
+            case SGP4_FILTER_LE: for (int i = 0; i < ch->n; i++) c += m[i] && v[i] <= x; break;
+            case SGP4_FILTER_GT: for (int i = 0; i < ch->n; i++) c += m[i] && v[i] > x; break;
+            case SGP4_FILTER_GE: for (int i = 0; i < ch->n; i++) c += m[i] && v[i] >= x; break;
+        }
+        acc->count += c;
+        return;
+    }
+
+    for (int i = 0; i < ch->n; i++) {
+        if (!m[i]) continue;
+        switch (s->op) {
+            case SGP4_REDUCE_MIN:
+            case SGP4_REDUCE_ARGMIN:
+                if (acc->count == 0 || v[i] < acc->value) { acc->value = v[i]; acc->at = et[i]; }
+                break;
+            case SGP4_REDUCE_MAX:
+            case SGP4_REDUCE_ARGMAX:
+                if (acc->count == 0 || v[i] > acc->value) { acc->value = v[i]; acc->at = et[i]; }
+                break;
+            case SGP4_REDUCE_SUM:
+            case SGP4_REDUCE_MEAN: acc->value += v[i]; break;
+            default: break;
+        }
+        acc->count++;
+    }
+}
+
+static double reduce_finish(const SGP4PipelineStage* s, const PipelineAccum* acc, double step) {
+    switch (s->op) {
+        case SGP4_REDUCE_COUNT:
+        case SGP4_REDUCE_COUNT_WHERE:    return (double)acc->count;
+        case SGP4_REDUCE_DURATION_WHERE: return acc->count * step;
+        case SGP4_REDUCE_SUM:            return acc->value;
+        case SGP4_REDUCE_MEAN:           return acc->count ? acc->value / acc->count : NAN;
+        case SGP4_REDUCE_ARGMIN:
+        case SGP4_REDUCE_ARGMAX:         return acc->count ? acc->at : NAN;
+        default:                         return acc->count ? acc->value : NAN;
+    }
+}
+
+// Append the selected rows of a chunk. Returns -1 on allocation failure.
+static int stage_emit(const SGP4Pipeline* p, const PipelineChunk* ch, int sat, SGP4PipelineResult* out) {
+    for (int i = 0; i < ch->n; i++) {
+        if (!ch->mask[i]) continue;
+
+        if (out->max_rows > 0 && out->n_rows >= out->max_rows) {
+            out->truncated = 1;
+            return 0;
+        }
+
+        if (out->n_rows == out->row_capacity) {
+            long cap = out->row_capacity ? out->row_capacity * 2 : 1024;
+            int* rs = (int*)realloc(out->row_sat, cap * sizeof(int));
+            if (!rs) return -1;
+            out->row_sat = rs;
+            double* rows = (double*)realloc(out->rows, cap * p->n_select * sizeof(double));
+            if (!rows) return -1;
+            out->rows = rows;
+            out->row_capacity = cap;
+        }
+
+        double* row = &out->rows[out->n_rows * p->n_select];
+        int k = 0;
+        for (int j = 0; j < p->n_stages; j++) {
+            if (p->stages[j].kind == SGP4_STAGE_SELECT) {
+                row[k++] = ch->col[p->stages[j].arg][i];
+            }
+        }
+        out->row_sat[out->n_rows++] = sat;
+    }
+    return 0;
+}
+
+// ============================================================================
+// Executor
+// ============================================================================
+
+/**
+ * Run a pipeline for satellites [first, first + n) over the grid
+ * et0 + t * step, t = 0..steps-1.
+ *
+ * out->max_rows may be set beforehand to cap emitted rows. On return,
+ * out->reduce holds n * n_reduce values in reduce-stage order per
+ * satellite (NaN for min/max/mean/argmin/argmax with no selected rows;
+ * argmin/argmax report the et of the first extremum).
+ * `compact` selects compact coefficient storage (sgp4_coeffs_alloc_mode()).
+ *
+ * @return 0 on success, -1 on allocation failure
+ */
+int sgp4_pipeline_run(
+    const SGP4Pipeline* p,
+    const SGP4Batch* batch,
+    int first, int n,
+    const SGP4Geophs* geophs,
+    double et0, double step, int steps,
+    int compact,
+    SGP4PipelineResult* out
+) {
+    out->n_sats = n;
+    out->n_reduce = p->n_reduce;
+    out->n_select = p->n_select;
+    out->reduce = (double*)malloc(((size_t)n * p->n_reduce + 1) * sizeof(double));
+
+    // Satellites are swept together in groups whose whole grid fits the
+    // staging buffer, then run through the stages one at a time so rows
+    // stay in satellite order. Grids too long to stage two satellites are
+    // swept one satellite and chunk at a time.
+    size_t sat_bytes = (size_t)steps * 6 * sizeof(double);
+    int group = sat_bytes > 0 ? (int)(SGP4_PIPELINE_STAGING / sat_bytes) : n;
+    if (group > n) group = n;
+    if (group < 2) group = 1;
+
+    SGP4BatchCoeffs* coeffs = sgp4_coeffs_alloc_mode(n, compact);
+    PipelineChunk* ch = (PipelineChunk*)aligned_alloc(SIMD_ALIGN, sizeof(PipelineChunk));
+    double* staged = group > 1 ? (double*)malloc((size_t)group * sat_bytes) : NULL;
+    if (!out->reduce || !coeffs || !ch || (group > 1 && !staged)) {
+        sgp4_coeffs_free(coeffs);
+        free(ch);
+        free(staged);
+        return -1;
+    }
+    sgp4_batch_init_coeffs_range(batch, first, n, geophs, coeffs);
+
+    ch->mu = geophs->ke * geophs->ke * geophs->re * geophs->re * geophs->re / 3600.0;
+
+    PipelineAccum acc[SGP4_PIPELINE_MAX_STAGES];
+    double site[3] = {0, 0, 0};
+    double site_lat = 0.0, site_lon = 0.0;
+    int emits = p->n_select > 0;
+    int status = 0;
+
+    for (int s = 0; s < n && status == 0; s++) {
+        // Sweep the next group; its states are columns of lanes x steps
+        int g = s % group;
+        int lanes = n - (s - g) < group ? n - (s - g) : group;
+        if (staged && g == 0) {
+            size_t col = (size_t)lanes * steps;
+            sgp4_batch_sweep(coeffs, s, lanes, et0, step, steps,
+                             staged, staged + col, staged + 2 * col,
+                             staged + 3 * col, staged + 4 * col, staged + 5 * col,
+                             steps, 1);
+        }
+        memset(acc, 0, sizeof(acc));
+
+        for (int t0 = 0; t0 < steps && status == 0; t0 += SGP4_PIPELINE_CHUNK) {
+            int rows = steps - t0 < SGP4_PIPELINE_CHUNK ? steps - t0 : SGP4_PIPELINE_CHUNK;
+            double chunk_et0 = et0 + t0 * step;
+
+            // Propagate
+            ch->n = rows;
+            ch->frame = SGP4_FRAME_TEME;
+            ch->have_ecef = 0;
+            ch->have_elements = 0;
+            for (int i = 0; i < rows; i++) {
+                ch->col[SGP4_COL_ET][i] = et0 + (t0 + i) * step;
+            }
+            memset(ch->mask, 1, rows);
+            if (staged) {
+                const double* src = staged + (size_t)g * steps + t0;
+                for (int c = 0; c < 6; c++) {
+                    memcpy(ch->col[SGP4_COL_X + c], src + (size_t)c * lanes * steps, rows * sizeof(double));
+                }
+            } else {
+                sgp4_batch_sweep(coeffs, s, 1, chunk_et0, step, rows,
+                                 ch->col[SGP4_COL_X], ch->col[SGP4_COL_Y], ch->col[SGP4_COL_Z],
+                                 ch->col[SGP4_COL_VX], ch->col[SGP4_COL_VY], ch->col[SGP4_COL_VZ],
+                                 0, 1);
+            }
+
+            // Remaining stages, in order, on the cached chunk
+            int r = 0;
+            for (int j = 0; j < p->n_stages; j++) {
+                const SGP4PipelineStage* st = &p->stages[j];
+                switch (st->kind) {
+                    case SGP4_STAGE_FRAME:
+                        stage_frame(ch, st->arg);
+                        break;
+                    case SGP4_STAGE_OBSERVER:
+                        site_lat = st->p[0];
+                        site_lon = st->p[1];
+                        pipeline_site_ecef(st->p[0], st->p[1], st->p[2], site);
+                        break;
+                    case SGP4_STAGE_DERIVE:
+                        stage_derive(ch, st->arg, site, site_lat, site_lon);
+                        break;
+                    case SGP4_STAGE_FILTER:
+                        stage_filter(ch, st);
+                        break;
+                    case SGP4_STAGE_REDUCE:
+                        stage_reduce(ch, st, &acc[r++]);
+                        break;
+                    default:
+                        break;
+                }
+            }
+
+            if (emits && stage_emit(p, ch, s, out) != 0) {
+                status = -1;
+            }
+        }
+
+        // Finish this satellite's reductions
+        int r = 0;
+        for (int j = 0; j < p->n_stages; j++) {
+            if (p->stages[j].kind == SGP4_STAGE_REDUCE) {
+                out->reduce[(size_t)s * p->n_reduce + r] = reduce_finish(&p->stages[j], &acc[r], step);
+                r++;
+            }
+        }
+    }
+
+    sgp4_coeffs_free(coeffs);
+    free(ch);
+    free(staged);
+    return status;
+}
+
+/**
+ * Free result buffers (not the struct itself).
+ */
+void sgp4_pipeline_result_free(SGP4PipelineResult* out) {
+    free(out->reduce);
+    free(out->row_sat);
+    free(out->rows);
+    out->reduce = NULL;
+    out->row_sat = NULL;
+    out->rows = NULL;
+}
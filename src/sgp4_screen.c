@@ -0,0 +1,432 @@
+/**
+ * SGP4 Ephemeris Screening
+ *
+ * Screens a user ephemeris (a planned launch or maneuver trajectory given
+ * as sampled states) against catalog objects for collision avoidance:
+ *
+ *   1. Shell prefilter: an object whose perigee..apogee radius band,
+ *      widened by SGP4_SCREEN_SHELL_PAD and the screening distance, misses
+ *      the radius span of the ephemeris is skipped without propagating.
+ *   2. Each remaining object is swept on a coarse grid over the ephemeris
+ *      span (1/SGP4_SCREEN_SAMPLES_PER_REV of the shorter of the two
+ *      periods), the ephemeris Hermite-interpolated at each sample.
+ *      Consecutive objects with similar grids are swept together on the
+ *      finest, sharing the interpolated ephemeris.
+ *   3. Range minima are sign changes of rho . rho_dot from negative to
+ *      positive. Brackets that cannot come within the screening distance
+ *      at the larger of the two speeds are dropped; the rest are refined to
+ *      SGP4_SCREEN_TOLERANCE with the Illinois method, as in the event
+ *      finder, and kept when the miss distance and the optional radial /
+ *      in-track / cross-track limits are met.
+ *
+ * A range that is still falling at the end of the ephemeris (or rising at
+ * its start) is reported at that bound.
+ *
+ * Catalog states are rotated into the ephemeris frame (TEME or GCRF).
+ */
+
+#include "sgp4_batch.h"
+
+#define SGP4_SCREEN_SAMPLES_PER_REV 48
+#define SGP4_SCREEN_TOLERANCE       1.0e-3  // seconds
+#define SGP4_SCREEN_MAX_ITER        60
+#define SGP4_SCREEN_SHELL_PAD       50.0    // km, mean vs osculating radius and decay
+#define SGP4_SCREEN_GROUP           8       // satellites swept together
+#define SGP4_SCREEN_GROUP_SLACK     1.25    // largest / smallest coarse step in a group
+
+/** A user ephemeris: n states in increasing time, in packed columns */
+typedef struct {
+    int n;
+    const double* et;
+    const double *x, *y, *z;        // km
+    const double *vx, *vy, *vz;     // km/s
+    int frame;                      // SGP4_FRAME_TEME or SGP4_FRAME_GCRF
+} SGP4Ephemeris;
+
+/** Screening thresholds (km); component limits <= 0 are not applied */
+typedef struct {
+    double distance;
+    double radial;
+    double in_track;
+    double cross_track;
+} SGP4ScreenLimits;
+
+typedef struct {
+    double tca;         // Time of closest approach (seconds past J2000)
+    double distance;    // Miss distance (km)
+    double speed;       // Relative speed (km/s)
+    double ric[3];      // Miss vector in the ephemeris object's radial / in-track / cross-track axes (km)
+    int sat;            // Satellite index (relative to first)
+} SGP4Approach;
+
+typedef struct {
+    long n_approaches;
+    long capacity;
+    long max_approaches;  // 0 = unlimited; set by caller before run
+    int truncated;
+    int candidates;       // Objects passing the shell prefilter
+    SGP4Approach* approaches;
+} SGP4ScreenResult;
+
+// ============================================================================
+// Ephemeris interpolation
+// ============================================================================
+
+/**
+ * Cubic Hermite interpolation of the ephemeris at et (clamped to its
+ * span), from the positions and velocities of the bracketing states.
+ * `hint` caches the last segment for monotonic queries.
+ */
+static void screen_interpolate(const SGP4Ephemeris* eph, double et, int* hint, double r[3], double v[3]) {
+    int k = *hint;
+    if (k < 0 || k > eph->n - 2 || et < eph->et[k] || et > eph->et[k + 1]) {
+        int lo = 0, hi = eph->n - 1;
+        while (hi - lo > 1) {
+            int mid = (lo + hi) / 2;
+            if (eph->et[mid] <= et) lo = mid; else hi = mid;
+        }
+        k = lo;
+        *hint = k;
+    }
+
+    double h = eph->et[k + 1] - eph->et[k];
+    double s = fmin(fmax((et - eph->et[k]) / h, 0.0), 1.0);
+    double s2 = s * s, s3 = s2 * s;
+    double h00 = 2.0 * s3 - 3.0 * s2 + 1.0, h10 = s3 - 2.0 * s2 + s;
+    double h01 = -2.0 * s3 + 3.0 * s2, h11 = s3 - s2;
+    double d00 = (6.0 * s2 - 6.0 * s) / h, d10 = 3.0 * s2 - 4.0 * s + 1.0;
+    double d01 = (-6.0 * s2 + 6.0 * s) / h, d11 = 3.0 * s2 - 2.0 * s;
+
+    const double* p[3] = { eph->x, eph->y, eph->z };
+    const double* q[3] = { eph->vx, eph->vy, eph->vz };
+    for (int c = 0; c < 3; c++) {
+        double p0 = p[c][k], p1 = p[c][k + 1], v0 = q[c][k], v1 = q[c][k + 1];
+        r[c] = h00 * p0 + h10 * h * v0 + h01 * p1 + h11 * h * v1;
+        v[c] = d00 * p0 + d10 * v0 + d01 * p1 + d11 * v1;
+    }
+}
+
+// ============================================================================
+// Screening
+// ============================================================================
+
+/** Catalog state at one epoch, in the ephemeris frame */
+static void screen_state_at(
+    const SGP4BatchCoeffs* coeffs, int sat, int frame, double et, double r[3], double v[3]
+) {
+    sgp4_batch_sweep(coeffs, sat, 1, et, 0.0, 1, &r[0], &r[1], &r[2], &v[0], &v[1], &v[2], 0, 1);
+    if (frame == SGP4_FRAME_GCRF) {
+        sgp4_teme_to_gcrf(&et, &r[0], &r[1], &r[2], &v[0], &v[1], &v[2], 1);
+    }
+}
+
+/** rho . rho_dot (km^2/s) at one epoch; zero at range extrema */
+static double screen_range_rate_at(
+    const SGP4Ephemeris* eph, const SGP4BatchCoeffs* coeffs, int sat, double et, int* hint
+) {
+    double r[3], v[3], ur[3], uv[3];
+    screen_state_at(coeffs, sat, eph->frame, et, r, v);
+    screen_interpolate(eph, et, hint, ur, uv);
+    return (r[0] - ur[0]) * (v[0] - uv[0]) + (r[1] - ur[1]) * (v[1] - uv[1]) + (r[2] - ur[2]) * (v[2] - uv[2]);
+}
+
+/**
+ * Refine a range minimum in [a, b] (ga < 0 <= gb) with the Illinois method.
+ */
+static double screen_refine(
+    const SGP4Ephemeris* eph, const SGP4BatchCoeffs* coeffs, int sat,
+    double a, double ga, double b, double gb, int* hint
+) {
+    int side = 0;
+    for (int k = 0; k < SGP4_SCREEN_MAX_ITER && b - a > SGP4_SCREEN_TOLERANCE; k++) {
+        double c = (a * gb - b * ga) / (gb - ga);
+        if (!(c > a && c < b)) {
+            c = 0.5 * (a + b);
+        }
+        double gc = screen_range_rate_at(eph, coeffs, sat, c, hint);
+        if ((gc < 0.0) == (gb < 0.0)) {
+            b = c;
+            gb = gc;
+            if (side == -1) ga *= 0.5;
+            side = -1;
+        } else {
+            a = c;
+            ga = gc;
+            if (side == 1) gb *= 0.5;
+            side = 1;
+        }
+    }
+    return fabs(ga) < fabs(gb) ? a : b;
+}
+
+/**
+ * Evaluate the encounter at tca and record it if within the limits.
+ */
+static int screen_record(
+    const SGP4Ephemeris* eph, const SGP4BatchCoeffs* coeffs, int sat,
+    double tca, const SGP4ScreenLimits* lim, int* hint, SGP4ScreenResult* out
+) {
+    double r[3], v[3], ur[3], uv[3];
+    screen_state_at(coeffs, sat, eph->frame, tca, r, v);
+    screen_interpolate(eph, tca, hint, ur, uv);
+
+    double d[3] = { r[0] - ur[0], r[1] - ur[1], r[2] - ur[2] };
+    double dv[3] = { v[0] - uv[0], v[1] - uv[1], v[2] - uv[2] };
+    double distance = sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+    if (!(distance <= lim->distance)) return 0;
+
+    // Radial / in-track / cross-track axes of the ephemeris object
+    double un = sqrt(ur[0] * ur[0] + ur[1] * ur[1] + ur[2] * ur[2]);
+    double rad[3] = { ur[0] / un, ur[1] / un, ur[2] / un };
+    double h[3] = { ur[1] * uv[2] - ur[2] * uv[1], ur[2] * uv[0] - ur[0] * uv[2], ur[0] * uv[1] - ur[1] * uv[0] };
+    double hn = sqrt(h[0] * h[0] + h[1] * h[1] + h[2] * h[2]);
+    double crs[3] = { h[0] / hn, h[1] / hn, h[2] / hn };
+    double trk[3] = {
+        crs[1] * rad[2] - crs[2] * rad[1], crs[2] * rad[0] - crs[0] * rad[2], crs[0] * rad[1] - crs[1] * rad[0]
+    };
+    double ric[3] = {
+        d[0] * rad[0] + d[1] * rad[1] + d[2] * rad[2],
+        d[0] * trk[0] + d[1] * trk[1] + d[2] * trk[2],
+        d[0] * crs[0] + d[1] * crs[1] + d[2] * crs[2],
+    };
+    if ((lim->radial > 0.0 && fabs(ric[0]) > lim->radial) ||
+        (lim->in_track > 0.0 && fabs(ric[1]) > lim->in_track) ||
+        (lim->cross_track > 0.0 && fabs(ric[2]) > lim->cross_track)) {
+        return 0;
+    }
+
+    if (out->max_approaches > 0 && out->n_approaches >= out->max_approaches) {
+        out->truncated = 1;
+        return 0;
+    }
+    if (out->n_approaches == out->capacity) {
+        long cap = out->capacity ? out->capacity * 2 : 64;
+        SGP4Approach* ap = (SGP4Approach*)realloc(out->approaches, cap * sizeof(SGP4Approach));
+        if (!ap) return -1;
+        out->approaches = ap;
+        out->capacity = cap;
+    }
+    SGP4Approach* ap = &out->approaches[out->n_approaches++];
+    ap->tca = tca;
+    ap->distance = distance;
+    ap->speed = sqrt(dv[0] * dv[0] + dv[1] * dv[1] + dv[2] * dv[2]);
+    ap->ric[0] = ric[0];
+    ap->ric[1] = ric[1];
+    ap->ric[2] = ric[2];
+    ap->sat = sat;
+    return 0;
+}
+
+/** Order approaches by satellite, then time */
+static int screen_compare(const void* a, const void* b) {
+    const SGP4Approach* x = (const SGP4Approach*)a;
+    const SGP4Approach* y = (const SGP4Approach*)b;
+    if (x->sat != y->sat) return x->sat < y->sat ? -1 : 1;
+    return x->tca < y->tca ? -1 : x->tca > y->tca ? 1 : 0;
+}
+
+/**
+ * Coarse step (seconds) for a satellite: 1/SGP4_SCREEN_SAMPLES_PER_REV of
+ * the shorter of its fastest period over [et0, etf] and the ephemeris
+ * period, capped at max_step (0 = no cap).
+ */
+static double screen_coarse_step(
+    const SGP4BatchCoeffs* coeffs, int sat, double et0, double etf, double period, double max_step
+) {
+    // Fastest mean-anomaly rate over the window (drag term included), as in the event finder
+    double tmax = fmax(fabs(et0 - coeffs->epoch[sat]), fabs(etf - coeffs->epoch[sat])) / 60.0;
+    double rate = coeffs->xnodp[sat] + 2.0 * fabs(coeffs->c1[sat]) * tmax;   // rad/min
+    double step = fmin(TWOPI / rate * 60.0, period) / SGP4_SCREEN_SAMPLES_PER_REV;
+    return max_step > 0.0 && step > max_step ? max_step : step;
+}
+
+/**
+ * Screen an ephemeris against satellites [first, first + n) of a batch.
+ *
+ * The coarse step is screen_coarse_step() of each satellite. Runs of up to
+ * SGP4_SCREEN_GROUP consecutive candidates whose steps differ by at most
+ * SGP4_SCREEN_GROUP_SLACK are swept together on the smallest of them.
+ * Approaches come out by satellite, then time, and max_approaches keeps
+ * the first ones in that order. Coefficients are built for the slice only.
+ * Fills the batch's derived columns (sgp4_batch_derive()). `compact`
+ * selects compact coefficient storage (sgp4_coeffs_alloc_mode()).
+ *
+ * @return 0 on success, -1 on allocation failure
+ */
+int sgp4_screen_run(
+    const SGP4Ephemeris* eph,
+    const SGP4ScreenLimits* lim,
+    SGP4Batch* batch,
+    int first, int n,
+    const SGP4Geophs* geophs,
+    double max_step,
+    int compact,
+    SGP4ScreenResult* out
+) {
+    const double mu = geophs->ke * geophs->ke * geophs->re * geophs->re * geophs->re / 3600.0;
+    const double et0 = eph->et[0], etf = eph->et[eph->n - 1];
+
+    // Radius span and shortest period of the ephemeris
+    double rmin = INFINITY, rmax = 0.0, umax = 0.0, period = INFINITY;
+    for (int i = 0; i < eph->n; i++) {
+        double r = sqrt(eph->x[i] * eph->x[i] + eph->y[i] * eph->y[i] + eph->z[i] * eph->z[i]);
+        double v2 = eph->vx[i] * eph->vx[i] + eph->vy[i] * eph->vy[i] + eph->vz[i] * eph->vz[i];
+        double a = 1.0 / (2.0 / r - v2 / mu);
+        rmin = fmin(rmin, r);
+        rmax = fmax(rmax, r);
+        umax = fmax(umax, sqrt(v2));
+        if (a > 0.0) period = fmin(period, TWOPI * sqrt(a * a * a / mu));
+    }
+    double pad = SGP4_SCREEN_SHELL_PAD + lim->distance;
+
+    enum { CHUNK = 256, GROUP = SGP4_SCREEN_GROUP };
+    SGP4BatchCoeffs* coeffs = sgp4_coeffs_alloc_mode(n, compact);
+    // Group states: x, y, z, vx, vy, vz columns of GROUP x CHUNK
+    double* states = (double*)malloc((size_t)6 * GROUP * CHUNK * sizeof(double));
+    unsigned char* candidate = (unsigned char*)malloc(n > 0 ? n : 1);
+    if (!coeffs || !states || !candidate) {
+        sgp4_coeffs_free(coeffs);
+        free(states);
+        free(candidate);
+        return -1;
+    }
+    sgp4_batch_derive(batch, geophs);
+    sgp4_batch_init_coeffs_range(batch, first, n, geophs, coeffs);
+
+    for (int s = 0; s < n; s++) {
+        double rp = batch->altp[first + s] + geophs->re;
+        double ra = batch->alta[first + s] + geophs->re;
+        candidate[s] = rp - pad <= rmax && ra + pad >= rmin;
+        out->candidates += candidate[s];
+    }
+
+    double* x = states;
+    double* y = x + GROUP * CHUNK;
+    double* z = y + GROUP * CHUNK;
+    double* vx = z + GROUP * CHUNK;
+    double* vy = vx + GROUP * CHUNK;
+    double* vz = vy + GROUP * CHUNK;
+    double et[CHUNK], ur[3][CHUNK], uv[3][CHUNK];
+    double g[CHUNK], d[CHUNK], w[CHUNK];
+    double prev_g[GROUP], prev_d[GROUP], prev_w[GROUP];
+    int hint = 0;
+    int status = 0;
+
+    // A group's approaches arrive chunk by chunk across its satellites, so
+    // the cap is applied once they are sorted
+    long max_approaches = out->max_approaches;
+    out->max_approaches = 0;
+
+    for (int s0 = 0; s0 < n && status == 0 && !out->truncated; ) {
+        if (!candidate[s0]) {
+            s0++;
+            continue;
+        }
+        double step = screen_coarse_step(coeffs, s0, et0, etf, period, max_step);
+        double widest = step;
+        int lanes = 1;
+        while (lanes < GROUP && s0 + lanes < n && candidate[s0 + lanes]) {
+            double next = screen_coarse_step(coeffs, s0 + lanes, et0, etf, period, max_step);
+            if (fmax(widest, next) > fmin(step, next) * SGP4_SCREEN_GROUP_SLACK) break;
+            step = fmin(step, next);
+            widest = fmax(widest, next);
+            lanes++;
+        }
+        long steps = (long)ceil((etf - et0) / step) + 1;
+        long group_start = out->n_approaches;
+        double prev_et = et0;
+
+        for (long t0 = 0; t0 < steps && status == 0; t0 += CHUNK) {
+            int rows = steps - t0 < CHUNK ? (int)(steps - t0) : CHUNK;
+            for (int i = 0; i < rows; i++) {
+                et[i] = fmin(et0 + (t0 + i) * step, etf);
+            }
+            // The last sample is clamped to etf; propagate it separately
+            int regular = rows;
+            if (t0 + rows == steps && et[rows - 1] < et0 + (t0 + rows - 1) * step) {
+                regular = rows - 1;
+            }
+            sgp4_batch_sweep(coeffs, s0, lanes, et[0], step, regular, x, y, z, vx, vy, vz, CHUNK, 1);
+            if (regular < rows) {
+                sgp4_batch_sweep(coeffs, s0, lanes, etf, 0.0, 1,
+                                 &x[regular], &y[regular], &z[regular],
+                                 &vx[regular], &vy[regular], &vz[regular], CHUNK, 1);
+            }
+
+            // The ephemeris at every sample, shared by the group
+            for (int i = 0; i < rows; i++) {
+                double r[3], v[3];
+                screen_interpolate(eph, et[i], &hint, r, v);
+                for (int c = 0; c < 3; c++) {
+                    ur[c][i] = r[c];
+                    uv[c][i] = v[c];
+                }
+            }
+
+            for (int l = 0; l < lanes && status == 0; l++) {
+                int sat = s0 + l;
+                long o = (long)l * CHUNK;
+                if (eph->frame == SGP4_FRAME_GCRF) {
+                    sgp4_teme_to_gcrf(et, &x[o], &y[o], &z[o], &vx[o], &vy[o], &vz[o], rows);
+                }
+
+                // Range, range rate and the speed bound at every sample
+                for (int i = 0; i < rows; i++) {
+                    double dx = x[o + i] - ur[0][i], dy = y[o + i] - ur[1][i], dz = z[o + i] - ur[2][i];
+                    g[i] = dx * (vx[o + i] - uv[0][i]) + dy * (vy[o + i] - uv[1][i]) + dz * (vz[o + i] - uv[2][i]);
+                    d[i] = sqrt(dx * dx + dy * dy + dz * dz);
+                    w[i] = sqrt(vx[o + i] * vx[o + i] + vy[o + i] * vy[o + i] + vz[o + i] * vz[o + i]) + umax;
+                }
+
+                // Still receding at the start: the closest point is the start
+                if (t0 == 0 && g[0] >= 0.0 && d[0] <= lim->distance) {
+                    status = screen_record(eph, coeffs, sat, et0, lim, &hint, out);
+                }
+
+                for (int i = (t0 == 0 ? 1 : 0); i < rows && status == 0; i++) {
+                    double pa = i > 0 ? et[i - 1] : prev_et;
+                    double pg = i > 0 ? g[i - 1] : prev_g[l];
+                    double pd = i > 0 ? d[i - 1] : prev_d[l];
+                    double pw = i > 0 ? w[i - 1] : prev_w[l];
+                    if (!(pg < 0.0 && g[i] >= 0.0)) continue;
+                    // Neither end can reach the screening distance within the bracket
+                    if (0.5 * (pd + d[i]) - fmax(pw, w[i]) * (et[i] - pa) > lim->distance) continue;
+                    double tca = screen_refine(eph, coeffs, sat, pa, pg, et[i], g[i], &hint);
+                    status = screen_record(eph, coeffs, sat, tca, lim, &hint, out);
+                }
+
+                // Still closing at the end: the closest point is the end
+                if (t0 + rows == steps && g[rows - 1] < 0.0 && d[rows - 1] <= lim->distance && status == 0) {
+                    status = screen_record(eph, coeffs, sat, etf, lim, &hint, out);
+                }
+                prev_g[l] = g[rows - 1];
+                prev_d[l] = d[rows - 1];
+                prev_w[l] = w[rows - 1];
+            }
+            prev_et = et[rows - 1];
+        }
+
+        if (out->n_approaches > group_start) {
+            qsort(&out->approaches[group_start], out->n_approaches - group_start, sizeof(SGP4Approach), screen_compare);
+        }
+        if (max_approaches > 0 && out->n_approaches > max_approaches) {
+            out->n_approaches = max_approaches;
+            out->truncated = 1;
+        }
+        s0 += lanes;
+    }
+
+    out->max_approaches = max_approaches;
+    sgp4_coeffs_free(coeffs);
+    free(states);
+    free(candidate);
+    return status;
+}
+
+/**
+ * Free result buffers (not the struct itself).
+ */
+void sgp4_screen_result_free(SGP4ScreenResult* out) {
+    free(out->approaches);
+    out->approaches = NULL;
+}
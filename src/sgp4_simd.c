@@ -1,8 +1,11 @@
 /**
  * SGP4 SIMD Implementation
  *
- * Vectorized SGP4 propagation using ARM NEON (Apple Silicon) or x86 AVX2.
- * Processes 2 (NEON) or 4 (AVX2) satellites per instruction.
+ * Single-step batch propagation (sgp4_batch_propagate_step()) runs 2
+ * satellites per instruction with ARM NEON and is scalar elsewhere.
+ * Grid sweeps (sgp4_batch_sweep(), sgp4_batch_propagate()) walk scalar
+ * satellite x time tiles (see SGP4_TILE_SATS / SGP4_TILE_STEPS) over
+ * precomputed coefficients on every ISA.
  *
  * Based on Vallado's SGP4 implementation and CSPICE evsgp4_c.
  */
@@ -23,6 +26,21 @@
     #define SIMD_WIDTH 1
 #endif
 
+/*
+ * Tile shape for grid sweeps: SGP4_TILE_SATS satellites x SGP4_TILE_STEPS
+ * time steps. A tile's coefficients are loaded (and, with compact storage,
+ * decoded) once and reused for every step in it. The tile body is scalar
+ * code per satellite calling libm for the trigonometry, which dominates the
+ * cost, so the shape is not tuned per ISA: 1x1 through 8x4 measured within
+ * noise of each other with bin/benchmark_native_batch.
+ *
+ * The NEON kernel is not used for sweeps: its trigonometry is scalar too,
+ * and it re-derives each satellite's coefficients at every step (pow plus
+ * four sin/cos on top of the 13 trigonometric calls per state a tile makes).
+ */
+#define SGP4_TILE_SATS  4
+#define SGP4_TILE_STEPS 4
+
 // Mathematical constants
 #define SGP4_PI     3.14159265358979323846
 #define SGP4_TWOPI  6.28318530717958647692
@@ -391,8 +409,347 @@ void sgp4_batch_propagate_step(
     }
 }
 
+// ============================================================================
+// Blocked grid sweep
+// ============================================================================
+
+/** Fixed-point codes of the compact coefficient columns */
+static inline int32_t quantize_unit(double v) {
+    return (int32_t)lrint(v / SGP4_Q_UNIT);
+}
+
+static inline uint32_t quantize_frac(double v) {
+    return (uint32_t)lrint(v / SGP4_Q_FRAC);
+}
+
+static inline uint32_t quantize_turn(double rad) {
+    double turns = rad / SGP4_TWOPI;
+    turns -= floor(turns);
+    return (uint32_t)(uint64_t)llrint(turns * 4294967296.0);  // 1 turn wraps to 0
+}
+
+/** Store one satellite's coefficients in full or compact storage */
+static inline void coeffs_store(
+    SGP4BatchCoeffs* c, int i,
+    double cosio, double sinio, double ecco, double sqrt_el2,
+    double xnodp, double aodp, double c1, double mo, double argpo,
+    double sin_node, double cos_node, double ke_sqrt_a, double ke_sqrt_p,
+    double epoch
+) {
+    c->xnodp[i] = xnodp;
+    c->aodp[i] = aodp;
+    c->c1[i] = c1;
+    c->epoch[i] = epoch;
+
+    SGP4CompactCoeffs* q = c->compact;
+    if (q) {
+        q->cosio[i] = quantize_unit(cosio);
+        q->sinio[i] = quantize_unit(sinio);
+        q->sin_node[i] = quantize_unit(sin_node);
+        q->cos_node[i] = quantize_unit(cos_node);
+        q->ecco[i] = quantize_frac(ecco);
+        q->sqrt_el2[i] = quantize_frac(sqrt_el2);
+        q->mo[i] = quantize_turn(mo);
+        q->argpo[i] = quantize_turn(argpo);
+        q->ke_sqrt_a[i] = (float)ke_sqrt_a;
+        q->ke_sqrt_p[i] = (float)ke_sqrt_p;
+        return;
+    }
+    c->cosio[i] = cosio;
+    c->sinio[i] = sinio;
+    c->ecco[i] = ecco;
+    c->sqrt_el2[i] = sqrt_el2;
+    c->mo[i] = mo;
+    c->argpo[i] = argpo;
+    c->sin_node[i] = sin_node;
+    c->cos_node[i] = cos_node;
+    c->ke_sqrt_a[i] = ke_sqrt_a;
+    c->ke_sqrt_p[i] = ke_sqrt_p;
+}
+
+/**
+ * Compute the time-independent coefficients of satellites [first, first + n)
+ * of a batch into coefficient slots 0..n-1, in full or compact storage, so
+ * callers working on a slice of a batch build only the slice's.
+ * Same formulas as sgp4_propagate_scalar(), hoisted out of the step loop.
+ * Padding lanes get a harmless circular orbit so full tiles stay finite.
+ */
+void sgp4_batch_init_coeffs_range(
+    const SGP4Batch* batch,
+    int first, int n,
+    const SGP4Geophs* geophs,
+    SGP4BatchCoeffs* coeffs
+) {
+    coeffs->re = geophs->re;
+
+    for (int k = 0; k < coeffs->capacity; k++) {
+        int i = first + k;
+        if (k >= n || i >= batch->count || batch->no[i] <= 0.0) {
+            coeffs_store(coeffs, k, 1.0, 0.0, 0.0, 1.0, 0.0, 1.0, 0.0, 0.0, 0.0,
+                         0.0, 1.0, geophs->ke, geophs->ke, 0.0);
+            continue;
+        }
+
+        double inclo = batch->inclo[i];
+        double ecco = batch->ecco[i];
+        double no = batch->no[i];
+
+        double cosio = cos(inclo);
+        double theta2 = cosio * cosio;
+        double x3thm1 = 3.0 * theta2 - 1.0;
+        double eosq = ecco * ecco;
+        double betao2 = 1.0 - eosq;
+        double betao = sqrt(betao2);
+
+        // Recover mean motion and semi-major axis
+        double a1 = pow(geophs->ke / no, 2.0/3.0);
+        double del1 = 1.5 * geophs->j2 * x3thm1 / (betao2 * betao * a1 * a1);
+        double ao = a1 * (1.0 - del1 * (1.0/3.0 + del1 * (1.0 + del1)));
+        double delo = 1.5 * geophs->j2 * x3thm1 / (betao2 * betao * ao * ao);
+        double xnodp = no / (1.0 + delo);
+        double aodp = ao / (1.0 - delo);
+        double el2 = 1.0 - eosq;
+
+        coeffs_store(coeffs, k,
+            cosio, sin(inclo), ecco, sqrt(el2),
+            xnodp, aodp, batch->bstar[i] * aodp * aodp, batch->mo[i], batch->argpo[i],
+            sin(batch->nodeo[i]), cos(batch->nodeo[i]),
+            geophs->ke * sqrt(aodp), geophs->ke * sqrt(aodp * el2),
+            batch->epoch[i]);
+    }
+}
+
+/**
+ * Compute the time-independent coefficients for every satellite in a batch
+ * (slot i holds satellite i).
+ */
+void sgp4_batch_init_coeffs(
+    const SGP4Batch* batch,
+    const SGP4Geophs* geophs,
+    SGP4BatchCoeffs* coeffs
+) {
+    sgp4_batch_init_coeffs_range(batch, 0, batch->count, geophs, coeffs);
+}
+
+/**
+ * Fill the batch's derived columns: recovered semi-major axis (earth
+ * radii) and apogee/perigee altitude (km), with the recovery of
+ * sgp4_batch_init_coeffs(). Sets without a valid mean motion get NaN.
+ */
+void sgp4_batch_derive(SGP4Batch* batch, const SGP4Geophs* geophs) {
+    for (int i = 0; i < batch->count; i++) {
+        double no = batch->no[i];
+        double ecco = batch->ecco[i];
+        if (!(no > 0.0) || !(ecco >= 0.0 && ecco < 1.0)) {
+            batch->a[i] = batch->alta[i] = batch->altp[i] = NAN;
+            continue;
+        }
+
+        double cosio = cos(batch->inclo[i]);
+        double x3thm1 = 3.0 * cosio * cosio - 1.0;
+        double betao2 = 1.0 - ecco * ecco;
+        double betao = sqrt(betao2);
+
+        double a1 = pow(geophs->ke / no, 2.0/3.0);
+        double del1 = 1.5 * geophs->j2 * x3thm1 / (betao2 * betao * a1 * a1);
+        double ao = a1 * (1.0 - del1 * (1.0/3.0 + del1 * (1.0 + del1)));
+        double delo = 1.5 * geophs->j2 * x3thm1 / (betao2 * betao * ao * ao);
+        double aodp = ao / (1.0 - delo);
+
+        batch->a[i] = aodp;
+        batch->alta[i] = (aodp * (1.0 + ecco) - 1.0) * geophs->re;
+        batch->altp[i] = (aodp * (1.0 - ecco) - 1.0) * geophs->re;
+    }
+}
+
+/**
+ * Evaluate one tile: `lanes` satellites starting at idx, for `nsteps`
+ * epochs. Coefficients are read (and, with compact storage, decoded) into
+ * locals once, then every step of the tile reuses them. Always inlined so
+ * the full-tile call sites get a constant trip count and storage mode.
+ *
+ * Output for (lane l, step s) goes to x[l * sat_stride + s * step_stride].
+ */
+static inline __attribute__((always_inline)) void sgp4_tile(
+    const SGP4BatchCoeffs* c, const int compact,
+    int idx, int lanes,
+    const double* et, int nsteps,
+    double* x, double* y, double* z,
+    double* vx, double* vy, double* vz,
+    long sat_stride, long step_stride
+) {
+    double cosio[SGP4_TILE_SATS], sinio[SGP4_TILE_SATS], ecco[SGP4_TILE_SATS];
+    double sqrt_el2[SGP4_TILE_SATS], xnodp[SGP4_TILE_SATS], aodp[SGP4_TILE_SATS];
+    double c1[SGP4_TILE_SATS], mo[SGP4_TILE_SATS], argpo[SGP4_TILE_SATS];
+    double sin_node[SGP4_TILE_SATS], cos_node[SGP4_TILE_SATS];
+    double ke_sqrt_a[SGP4_TILE_SATS], ke_sqrt_p[SGP4_TILE_SATS], epoch[SGP4_TILE_SATS];
+
+    for (int l = 0; l < lanes; l++) {
+        xnodp[l] = c->xnodp[idx + l];
+        aodp[l] = c->aodp[idx + l];
+        c1[l] = c->c1[idx + l];
+        epoch[l] = c->epoch[idx + l];
+        if (compact) {
+            const SGP4CompactCoeffs* q = c->compact;
+            cosio[l] = q->cosio[idx + l] * SGP4_Q_UNIT;
+            sinio[l] = q->sinio[idx + l] * SGP4_Q_UNIT;
+            sin_node[l] = q->sin_node[idx + l] * SGP4_Q_UNIT;
+            cos_node[l] = q->cos_node[idx + l] * SGP4_Q_UNIT;
+            ecco[l] = q->ecco[idx + l] * SGP4_Q_FRAC;
+            sqrt_el2[l] = q->sqrt_el2[idx + l] * SGP4_Q_FRAC;
+            mo[l] = q->mo[idx + l] * SGP4_Q_TURN;
+            argpo[l] = q->argpo[idx + l] * SGP4_Q_TURN;
+            ke_sqrt_a[l] = q->ke_sqrt_a[idx + l];
+            ke_sqrt_p[l] = q->ke_sqrt_p[idx + l];
+        } else {
+            cosio[l] = c->cosio[idx + l];
+            sinio[l] = c->sinio[idx + l];
+            ecco[l] = c->ecco[idx + l];
+            sqrt_el2[l] = c->sqrt_el2[idx + l];
+            mo[l] = c->mo[idx + l];
+            argpo[l] = c->argpo[idx + l];
+            sin_node[l] = c->sin_node[idx + l];
+            cos_node[l] = c->cos_node[idx + l];
+            ke_sqrt_a[l] = c->ke_sqrt_a[idx + l];
+            ke_sqrt_p[l] = c->ke_sqrt_p[idx + l];
+        }
+    }
+
+    double re = c->re;
+
+    for (int s = 0; s < nsteps; s++) {
+        for (int l = 0; l < lanes; l++) {
+            double tsince = (et[s] - epoch[l]) / 60.0;  // minutes
+
+            // Secular effects (simplified)
+            double xmp = mo[l] + xnodp[l] * tsince;
+            double xmdf = xmp + c1[l] * tsince * tsince;
+
+            // Solve Kepler's equation
+            double u = fmod(xmdf, SGP4_TWOPI);
+            if (u < 0) u += SGP4_TWOPI;
+            double eo1 = u;
+
+            for (int i = 0; i < 4; i++) {
+                double f = eo1 - ecco[l] * sin(eo1) - u;
+                double fp = 1.0 - ecco[l] * cos(eo1);
+                eo1 = eo1 - f / fp;
+            }
+
+            // Position and velocity
+            double sin_eo1 = sin(eo1);
+            double cos_eo1 = cos(eo1);
+            double ecose = ecco[l] * cos_eo1;
+            double esine = ecco[l] * sin_eo1;
+            double r = aodp[l] * (1.0 - ecose);
+            double rdot = ke_sqrt_a[l] * esine / r;
+            double rvdot = ke_sqrt_p[l] / r;
+
+            // True anomaly
+            double sinv = sqrt_el2[l] * sin_eo1 / (1.0 - ecose);
+            double cosv = (cos_eo1 - ecco[l]) / (1.0 - ecose);
+            double v = atan2(sinv, cosv);
+
+            // Argument of latitude
+            double su = argpo[l] + v;
+            double sin_su = sin(su);
+            double cos_su = cos(su);
+
+            // Unit vectors
+            double ux = cos_su * cos_node[l] - sin_su * cosio[l] * sin_node[l];
+            double uy = cos_su * sin_node[l] + sin_su * cosio[l] * cos_node[l];
+            double uz = sin_su * sinio[l];
+            double vx_u = -(sin_su * cos_node[l] + cos_su * cosio[l] * sin_node[l]);
+            double vy_u = cos_su * cosio[l] * cos_node[l] - sin_su * sin_node[l];
+            double vz_u = cos_su * sinio[l];
+
+            // Scale to km and km/s
+            double r_km = r * re;
+            double rdot_kms = rdot * re / 60.0;
+            double rvdot_kms = rvdot * re / 60.0;
+
+            long o = l * sat_stride + s * step_stride;
+            x[o] = r_km * ux;
+            y[o] = r_km * uy;
+            z[o] = r_km * uz;
+            vx[o] = rdot_kms * ux + rvdot_kms * vx_u;
+            vy[o] = rdot_kms * uy + rvdot_kms * vy_u;
+            vz[o] = rdot_kms * uz + rvdot_kms * vz_u;
+        }
+    }
+}
+
+/** Tile loop of sgp4_batch_sweep(), specialized per storage mode */
+static inline __attribute__((always_inline)) void sgp4_sweep_tiles(
+    const SGP4BatchCoeffs* coeffs, const int compact,
+    int first, int n,
+    double et0, double step, int steps,
+    double* x, double* y, double* z,
+    double* vx, double* vy, double* vz,
+    long sat_stride, long step_stride
+) {
+    double et[SGP4_TILE_STEPS];
+
+    for (int i = 0; i < n; i += SGP4_TILE_SATS) {
+        int lanes = n - i < SGP4_TILE_SATS ? n - i : SGP4_TILE_SATS;
+
+        for (int t = 0; t < steps; t += SGP4_TILE_STEPS) {
+            int nsteps = steps - t < SGP4_TILE_STEPS ? steps - t : SGP4_TILE_STEPS;
+            for (int s = 0; s < nsteps; s++) {
+                et[s] = et0 + (t + s) * step;
+            }
+
+            long o = i * sat_stride + t * step_stride;
+            if (lanes == SGP4_TILE_SATS && nsteps == SGP4_TILE_STEPS) {
+                sgp4_tile(coeffs, compact, first + i, SGP4_TILE_SATS, et, SGP4_TILE_STEPS,
+                          &x[o], &y[o], &z[o], &vx[o], &vy[o], &vz[o],
+                          sat_stride, step_stride);
+            } else {
+                sgp4_tile(coeffs, compact, first + i, lanes, et, nsteps,
+                          &x[o], &y[o], &z[o], &vx[o], &vy[o], &vz[o],
+                          sat_stride, step_stride);
+            }
+        }
+    }
+}
+
+/**
+ * Propagate satellites [first, first + n) over the uniform grid
+ * et0 + t * step, t = 0..steps-1, in tiles of
+ * SGP4_TILE_SATS x SGP4_TILE_STEPS.
+ *
+ * Output for (satellite first + i, step t) goes to
+ * x[i * sat_stride + t * step_stride], so callers choose the layout:
+ *   time-major (SGP4BatchResult): sat_stride = 1, step_stride = capacity
+ *   satellite-major:               sat_stride = steps, step_stride = 1
+ *
+ * @param coeffs  Coefficients from sgp4_batch_init_coeffs() (full or compact)
+ * @param first   First satellite index
+ * @param n       Number of satellites
+ * @param et0     First epoch (ET seconds)
+ * @param step    Step size (seconds)
+ * @param steps   Number of epochs
+ */
+void sgp4_batch_sweep(
+    const SGP4BatchCoeffs* coeffs,
+    int first, int n,
+    double et0, double step, int steps,
+    double* x, double* y, double* z,
+    double* vx, double* vy, double* vz,
+    long sat_stride, long step_stride
+) {
+    if (coeffs->compact) {
+        sgp4_sweep_tiles(coeffs, 1, first, n, et0, step, steps,
+                         x, y, z, vx, vy, vz, sat_stride, step_stride);
+    } else {
+        sgp4_sweep_tiles(coeffs, 0, first, n, et0, step, steps,
+                         x, y, z, vx, vy, vz, sat_stride, step_stride);
+    }
+}
+
 /**
  * Propagate entire batch over time range.
+ * Result is time-major: step t of satellite i at [t * capacity + i].
  */
 void sgp4_batch_propagate(
     const SGP4Batch* batch,
@@ -400,16 +757,16 @@ void sgp4_batch_propagate(
     const SGP4Geophs* geophs,
     SGP4BatchResult* result
 ) {
-    for (int t = 0; t < steps; t++) {
-        double tsince = t * step / 60.0;  // Convert seconds to minutes
-        int offset = t * batch->capacity;
-
-        sgp4_batch_propagate_step(
-            batch, tsince, geophs,
-            &result->x[offset], &result->y[offset], &result->z[offset],
-            &result->vx[offset], &result->vy[offset], &result->vz[offset]
-        );
-    }
+    SGP4BatchCoeffs* coeffs = sgp4_coeffs_alloc(batch->count);
+    if (!coeffs) return;
+
+    sgp4_batch_init_coeffs(batch, geophs, coeffs);
+    sgp4_batch_sweep(coeffs, 0, batch->count, et0, step, steps,
+                     result->x, result->y, result->z,
+                     result->vx, result->vy, result->vz,
+                     1, result->capacity);
+
+    sgp4_coeffs_free(coeffs);
 }
 
 /**
@@ -5,7 +5,7 @@
  * Provides a clean API for JavaScript to:
  * - Parse TLE (Two-Line Element) data
  * - Propagate satellite state vectors
- * - Convert between UTC and Ephemeris Time
+ * - Convert between UTC and Ephemeris Time (single values or arrays)
  */
 
 #include <stdio.h>
@@ -315,6 +315,97 @@ int sgp4_et_to_utc(double et, char* utc_string, int max_len) {
     return 0;
 }
 
+/**
+ * Convert an array of UTC strings to ephemeris times in one call.
+ *
+ * Strings are packed in fixed-width slots of `width` bytes, each
+ * NUL-terminated within its slot.
+ *
+ * @param utc_strings  n slots of width bytes
+ * @param width        Slot width in bytes
+ * @param n            Number of strings
+ * @param et_out       Output array of n ephemeris times
+ *
+ * @return 0 on success, -1 on error (last error names the failing index)
+ */
+EMSCRIPTEN_KEEPALIVE
+int sgp4_utc_to_et_array(const char* utc_strings, int width, int n, double* et_out) {
+    if (!initialized) {
+        strcpy(last_error, "SGP4 module not initialized. Call sgp4_init() first.");
+        return -1;
+    }
+
+    for (int i = 0; i < n; i++) {
+        str2et_c(utc_strings + (size_t)i * width, &et_out[i]);
+
+        if (failed_c()) {
+            char msg[1024];
+            getmsg_c("LONG", sizeof(msg), msg);
+            reset_c();
+            snprintf(last_error, sizeof(last_error), "Time %d: %s", i, msg);
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Format an ET grid (et0 + i * step, i < n) as UTC strings in one call.
+ *
+ * Writes n ISO calendar strings ("2024-01-15T12:00:00.000", 3 decimal
+ * places as in sgp4_et_to_utc) back to back in fixed-width slots of
+ * `width` bytes, with no separators or terminators, so the caller can
+ * decode the whole buffer at once and slice it.
+ *
+ * @param et0    First ephemeris time
+ * @param step   Grid step in seconds
+ * @param n      Number of times
+ * @param out    Output buffer of n * width bytes
+ * @param width  Slot width in bytes (at least 23)
+ *
+ * @return 0 on success, -1 on error (including a string longer than width)
+ */
+EMSCRIPTEN_KEEPALIVE
+int sgp4_et_grid_to_utc(double et0, double step, int n, char* out, int width) {
+    char utc[64];
+
+    if (!initialized) {
+        strcpy(last_error, "SGP4 module not initialized. Call sgp4_init() first.");
+        return -1;
+    }
+
+    if (width < 23 || width >= (int)sizeof(utc)) {
+        strcpy(last_error, "UTC slot width must be between 23 and 63 bytes");
+        return -1;
+    }
+
+    for (int i = 0; i < n; i++) {
+        char* slot = out + (size_t)i * width;
+
+        et2utc_c(et0 + i * step, "ISOC", 3, sizeof(utc), utc);
+
+        if (failed_c()) {
+            getmsg_c("LONG", 1024, last_error);
+            reset_c();
+            return -1;
+        }
+
+        /* Pad short strings so every slot is exactly width bytes; years
+         * outside 1-9999 format longer than a 23-byte slot */
+        size_t len = strlen(utc);
+        if (len > (size_t)width) {
+            snprintf(last_error, sizeof(last_error),
+                     "Time %d: UTC string '%s' does not fit a %d-byte slot", i, utc, width);
+            return -1;
+        }
+        memcpy(slot, utc, len);
+        memset(slot + len, ' ', width - len);
+    }
+
+    return 0;
+}
+
 /**
  * Get the last error message.
  *
@@ -0,0 +1,171 @@
+/**
+ * Affinity Routing Test Suite
+ *
+ * Checks the satellite-to-worker router (lib/affinity.ts): a satellite goes
+ * to the same worker while it is idle, spills over to its second choice and
+ * then to any idle worker when busy, keeps its worker when others leave the
+ * pool, and is counted as preferred or spilled accordingly; and the
+ * per-worker TLE cache's hits and LRU eviction.
+ */
+
+import { describe, it, expect, afterAll } from 'vitest';
+import { AffinityRouter, TLECache, affinityKey, type RoutedWorker } from '../../lib/affinity.js';
+import { writeFileSync, mkdirSync } from 'fs';
+import { join, dirname } from 'path';
+import { fileURLToPath } from 'url';
+
+// Results directory for this test suite
+const __filename = fileURLToPath(import.meta.url);
+const __dirname = dirname(__filename);
+const RESULTS_DIR = join(__dirname, 'results');
+
+// Ensure results directory exists
+mkdirSync(RESULTS_DIR, { recursive: true });
+
+/**
+ * Write test results to the results directory
+ */
+function writeTestResult(filename: string, data: unknown): void {
+  const filepath = join(RESULTS_DIR, filename);
+  writeFileSync(filepath, JSON.stringify(data, null, 2));
+}
+
+const ISS = {
+  line1: '1 25544U 98067A   24015.50000000  .00016717  00000-0  10270-3 0  9025',
+  line2: '2 25544  51.6400 208.9163 0006703  30.0825 330.0579 15.49560830    19',
+};
+
+/** Eight ready, idle workers */
+const pool = (): RoutedWorker[] => Array.from({ length: 8 }, (_, id) => ({ id, ready: true, busy: false }));
+
+/** Router created under the given affinity settings */
+function router(env: Record<string, string>): AffinityRouter {
+  Object.assign(process.env, env);
+  const r = new AffinityRouter();
+  for (const name of Object.keys(env)) {
+    delete process.env[name];
+  }
+  return r;
+}
+
+/** Range task key of a NORAD ID */
+const keyOf = (norad: number, model = 'wgs72'): string =>
+  affinityKey({ type: 'propagate', tle: { line1: `1 ${String(norad).padStart(5, '0')}U` }, model })!;
+
+describe('Affinity Routing', () => {
+  const testResults: Record<string, unknown> = {
+    suite: 'Affinity Routing',
+    tests: {} as Record<string, unknown>,
+  };
+
+  afterAll(() => {
+    writeTestResult('affinity-results.json', testResults);
+  });
+
+  it('should key range tasks by NORAD ID and model only', () => {
+    expect(affinityKey({ type: 'propagate', tle: ISS, model: 'wgs72' })).toBe('25544|wgs72');
+    expect(affinityKey({ type: 'propagate', tle: ISS })).toBe('25544|');
+    expect(affinityKey({ type: 'propagate-batch', tle: ISS, model: 'wgs72' })).toBeUndefined();
+    expect(affinityKey({ type: 'pipeline' })).toBeUndefined();
+  });
+
+  it('should send a satellite to the same worker, spilling over when it is busy', () => {
+    const r = router({ SGP4_AFFINITY: 'on', SGP4_AFFINITY_CHOICES: '2' });
+    const workers = pool();
+    const key = keyOf(25544);
+
+    const first = r.pick(workers, key)!;
+    for (let i = 0; i < 10; i++) {
+      expect(r.pick(workers, key)).toBe(first);
+    }
+
+    // Busy first choice: the second choice, still preferred
+    first.busy = true;
+    const second = r.pick(workers, key)!;
+    expect(second).not.toBe(first);
+    expect(r.pick(workers, key)).toBe(second);
+
+    // Both choices busy: any other idle worker, counted as spilled
+    second.busy = true;
+    const spill = r.pick(workers, key)!;
+    expect(spill.busy).toBe(false);
+    expect([first, second]).not.toContain(spill);
+
+    // No idle worker: nothing picked, nothing counted
+    workers.forEach((w) => (w.busy = true));
+    expect(r.pick(workers, key)).toBeUndefined();
+
+    expect(r.stats).toEqual({ enabled: true, choices: 2, preferred: 13, spilled: 1 });
+
+    (testResults.tests as Record<string, unknown>).routing = { first: first.id, second: second.id, spill: spill.id, ...r.stats };
+  });
+
+  it('should move only the keys of a worker that leaves the pool', () => {
+    const r = router({ SGP4_AFFINITY: 'on' });
+    const workers = pool();
+    const keys = Array.from({ length: 400 }, (_, i) => keyOf(10000 + i));
+    const before = keys.map((k) => r.pick(workers, k)!.id);
+
+    // Every worker is some key's first choice
+    expect(new Set(before).size).toBe(workers.length);
+
+    const shrunk = workers.filter((w) => w.id !== 5);
+    let moved = 0;
+    keys.forEach((k, i) => {
+      const after = r.pick(shrunk, k)!.id;
+      if (before[i] === 5) {
+        moved++;
+      } else {
+        expect(after).toBe(before[i]);
+      }
+    });
+    expect(moved).toBeGreaterThan(0);
+
+    (testResults.tests as Record<string, unknown>).resize = { keys: keys.length, moved };
+  });
+
+  it('should pick the first idle worker when disabled or without a key', () => {
+    const workers = pool();
+    workers[0].busy = true;
+    workers[1].ready = false;
+
+    const off = router({});
+    expect(off.enabled).toBe(false);
+    expect(off.pick(workers, keyOf(25544))).toBe(workers[2]);
+
+    const on = router({ SGP4_AFFINITY: 'on' });
+    expect(on.pick(workers, undefined)).toBe(workers[2]);
+    expect(on.stats.preferred + on.stats.spilled).toBe(0);
+  });
+
+  it('should prepare a TLE once per model and evict the least recently used', () => {
+    process.env.SGP4_WORKER_CACHE = '2';
+    const prepared: string[] = [];
+    const cache = new TLECache((line1, line2) => (prepared.push(line1.slice(2, 7)), { line1, line2 }));
+    delete process.env.SGP4_WORKER_CACHE;
+
+    const a = { line1: '1 00001U', line2: '2 00001' };
+    const b = { line1: '1 00002U', line2: '2 00002' };
+    const c = { line1: '1 00003U', line2: '2 00003' };
+
+    const hit = cache.get(a, 'wgs72');
+    expect(cache.get(a, 'wgs72')).toBe(hit);
+    cache.get(a, 'wgs84');
+    expect(prepared).toEqual(['00001', '00001']);
+
+    // b evicts a|wgs72; a|wgs84 is then refreshed, so c evicts b
+    cache.get(b, 'wgs72');
+    cache.get(a, 'wgs84');
+    cache.get(c, 'wgs72');
+    cache.get(a, 'wgs84');
+    cache.get(a, 'wgs72');
+    expect(prepared).toEqual(['00001', '00001', '00002', '00003', '00001']);
+
+    process.env.SGP4_WORKER_CACHE = '0';
+    const uncached = new TLECache((line1) => line1);
+    delete process.env.SGP4_WORKER_CACHE;
+    expect(uncached.maxEntries).toBe(0);
+
+    (testResults.tests as Record<string, unknown>).cache = { gets: 7, prepared: prepared.length };
+  });
+});
@@ -0,0 +1,153 @@
+/**
+ * Aggregate Pushdown Test Suite
+ *
+ * Checks aggregate= reductions computed in the native pipeline against the
+ * same reductions over the full ephemeris, and the parser's error cases.
+ */
+
+import { describe, it, expect, afterAll } from 'vitest';
+import { encodePipeline, parseAggregateSpec, pipelineOutputs, runPipeline } from '../../lib/pipeline.js';
+import { createExtendedNativeSGP4, type NativeSGP4Module } from '../../dist/sgp4-native.js';
+import { writeFileSync, mkdirSync } from 'fs';
+import { join, dirname } from 'path';
+import { fileURLToPath } from 'url';
+
+// Results directory for this test suite
+const __filename = fileURLToPath(import.meta.url);
+const __dirname = dirname(__filename);
+const RESULTS_DIR = join(__dirname, 'results');
+
+// Ensure results directory exists
+mkdirSync(RESULTS_DIR, { recursive: true });
+
+/**
+ * Write test results to the results directory
+ */
+function writeTestResult(filename: string, data: unknown): void {
+  const filepath = join(RESULTS_DIR, filename);
+  writeFileSync(filepath, JSON.stringify(data, null, 2));
+}
+
+// The native addon is only built for the native server image
+const native: NativeSGP4Module | undefined = await createExtendedNativeSGP4()
+  .then(async (m) => (await m.init(), m))
+  .catch(() => undefined);
+
+describe('Aggregate Pushdown', () => {
+  const testResults: Record<string, unknown> = {
+    suite: 'Aggregate Pushdown',
+    tests: {} as Record<string, unknown>,
+  };
+
+  afterAll(() => {
+    writeTestResult('aggregate-results.json', testResults);
+  });
+
+  const SATELLITES = [
+    {
+      name: 'ISS',
+      line1: '1 25544U 98067A   24015.50000000  .00016717  00000-0  10270-3 0  9025',
+      line2: '2 25544  51.6400 208.9163 0006703  30.0825 330.0579 15.49560830    19',
+    },
+    {
+      name: 'MOLNIYA',
+      line1: '1 40296U 14069A   24015.50000000  .00000100  00000-0  00000-0 0  9990',
+      line2: '2 40296  63.4000 300.0000 7000000 270.0000  10.0000  2.00600000    10',
+    },
+  ];
+
+  describe('parseAggregateSpec', () => {
+    it('should derive the columns the reductions read', () => {
+      const stages = parseAggregateSpec('min(alt),count(),duration(speed>7)');
+      expect(stages).toEqual([
+        { derive: ['alt', 'speed'] },
+        {
+          reduce: [
+            { op: 'min', column: 'alt' },
+            { op: 'count' },
+            { op: 'duration', column: 'speed', where: { op: 'gt', value: 7 } },
+          ],
+        },
+      ]);
+      expect(pipelineOutputs(stages).reductions).toEqual(['min(alt)', 'count', 'duration(speed>7)']);
+    });
+
+    it('should reject malformed terms', () => {
+      expect(() => parseAggregateSpec('min(alt')).toThrow('Invalid aggregate');
+      expect(() => parseAggregateSpec('median(alt)')).toThrow('Unknown aggregate function');
+      expect(() => parseAggregateSpec('max(alt>5)')).toThrow('only supported by count and duration');
+      expect(() => parseAggregateSpec('duration(alt)')).toThrow('needs a condition');
+    });
+  });
+
+  describe.skipIf(!native)('native reductions', () => {
+    const SPEC = 'min(alt),argmin(alt),max(radius),argmax(radius),mean(speed),sum(z),count(),count(alt<600),duration(alt<600)';
+    const STEP = 30;
+
+    it('should equal the reductions of the full ephemeris', () => {
+      const et0 = native!.utcToET('2024-01-15T12:00:00');
+      const times = { et0, etf: et0 + 86400, step: STEP };
+
+      const stages = parseAggregateSpec(SPEC);
+      const names = pipelineOutputs(stages).reductions;
+      const pushed = runPipeline(native!, SATELLITES, encodePipeline(stages), times);
+
+      const columns = ['et', 'z', 'alt', 'radius', 'speed'] as const;
+      const dense = runPipeline(
+        native!,
+        SATELLITES,
+        encodePipeline([{ derive: ['alt', 'radius', 'speed'] }, { select: [...columns] }]),
+        times
+      );
+
+      const report: Record<string, Record<string, number>> = {};
+      SATELLITES.forEach((sat, s) => {
+        const rows: number[][] = [];
+        for (let r = 0; r < dense.rowSat.length; r++) {
+          if (dense.rowSat[r] === s) {
+            rows.push(Array.from(dense.rows.subarray(r * columns.length, (r + 1) * columns.length)));
+          }
+        }
+        const col = (name: (typeof columns)[number]): number[] => rows.map((row) => row[columns.indexOf(name)]);
+        const et = col('et');
+        const alt = col('alt');
+        const radius = col('radius');
+        const argExtreme = (v: number[], best: number): number => et[v.indexOf(best)];
+        const below = alt.filter((a) => a < 600).length;
+
+        const expected = [
+          Math.min(...alt),
+          argExtreme(alt, Math.min(...alt)),
+          Math.max(...radius),
+          argExtreme(radius, Math.max(...radius)),
+          col('speed').reduce((a, b) => a + b, 0) / rows.length,
+          col('z').reduce((a, b) => a + b, 0),
+          rows.length,
+          below,
+          below * STEP,
+        ];
+
+        report[sat.name] = {};
+        names.forEach((name, r) => {
+          const value = pushed.reduce[s * pushed.nReduce + r];
+          report[sat.name][name] = value;
+          expect(Math.abs(value - expected[r])).toBeLessThanOrEqual(1e-9 * Math.max(1, Math.abs(expected[r])));
+        });
+      });
+
+      (testResults.tests as Record<string, unknown>).reductions = report;
+    });
+
+    it('should return NaN for extrema over no selected rows', () => {
+      const et0 = native!.utcToET('2024-01-15T12:00:00');
+      const stages = encodePipeline([
+        { derive: ['alt'] },
+        { filter: { column: 'alt', op: 'lt', value: 0 } },
+        { reduce: [{ op: 'min', column: 'alt' }, { op: 'count' }] },
+      ]);
+      const out = runPipeline(native!, SATELLITES.slice(0, 1), stages, { et0, etf: et0 + 3600, step: 60 });
+      expect(out.reduce[0]).toBeNaN();
+      expect(out.reduce[1]).toBe(0);
+    });
+  });
+});
@@ -0,0 +1,142 @@
+/**
+ * Element-Set History Archive Test Suite
+ *
+ * Checks a build -> open -> query round trip against parseTLE(), the epoch
+ * window, and that truncated or corrupt files are rejected when opened.
+ */
+
+import { describe, it, expect, afterAll } from 'vitest';
+import { buildArchive, loadHistory } from '../../lib/archive.js';
+import { createExtendedNativeSGP4, type NativeSGP4Module } from '../../dist/sgp4-native.js';
+import { writeFileSync, mkdirSync, mkdtempSync, readFileSync, rmSync } from 'fs';
+import { tmpdir } from 'os';
+import { join, dirname } from 'path';
+import { fileURLToPath } from 'url';
+
+// Results directory for this test suite
+const __filename = fileURLToPath(import.meta.url);
+const __dirname = dirname(__filename);
+const RESULTS_DIR = join(__dirname, 'results');
+
+// Ensure results directory exists
+mkdirSync(RESULTS_DIR, { recursive: true });
+
+/**
+ * Write test results to the results directory
+ */
+function writeTestResult(filename: string, data: unknown): void {
+  const filepath = join(RESULTS_DIR, filename);
+  writeFileSync(filepath, JSON.stringify(data, null, 2));
+}
+
+// The native addon is only built for the native server image
+const native: NativeSGP4Module | undefined = await createExtendedNativeSGP4()
+  .then(async (m) => (await m.init(), m))
+  .catch(() => undefined);
+
+/** Header, object and block entry sizes of the file layout (src/sgp4_archive.c) */
+const HEADER_BYTES = 48;
+const OBJECT_BYTES = 16;
+const BLOCK_BYTES = 32;
+
+describe.skipIf(!native)('Element-Set History Archive', () => {
+  const testResults: Record<string, unknown> = {
+    suite: 'Element-Set History Archive',
+    tests: {} as Record<string, unknown>,
+  };
+
+  const dir = mkdtempSync(join(tmpdir(), 'sgp4-archive-'));
+
+  afterAll(() => {
+    rmSync(dir, { recursive: true, force: true });
+    writeTestResult('archive-results.json', testResults);
+  });
+
+  /**
+   * Element sets of two objects, one set per 6 hours: 600 for the first
+   * (three blocks) and 10 for the second
+   */
+  const TLES = [
+    ...Array.from({ length: 600 }, (_, i) => ({
+      line1: `1 25544U 98067A   24${(1 + i * 0.25).toFixed(8).padStart(12, '0')}  .00016717  00000-0  10270-3 0  9025`,
+      line2: `2 25544  51.6400 ${(208.9163 - i * 1.3).toFixed(4).padStart(8, ' ')} 0006703  30.0825 330.0579 15.49560830    19`,
+    })),
+    ...Array.from({ length: 10 }, (_, i) => ({
+      line1: `1 43013U 17073A   24${(10 + i * 0.25).toFixed(8).padStart(12, '0')}  .00000100  00000-0  50000-4 0  9990`,
+      line2: '2 43013  97.7000  10.0000 0001000  90.0000 270.0000 14.80000000    10',
+    })),
+  ];
+
+  /** Build an archive of TLES, listed newest first to exercise the sort */
+  const build = async (name: string): Promise<string> => {
+    const text = join(dir, `${name}.txt`);
+    writeFileSync(text, [...TLES].reverse().map((t) => `${t.line1}\n${t.line2}`).join('\n'));
+    const out = join(dir, `${name}.sgpa`);
+    await buildArchive(native!, [text], out);
+    return out;
+  };
+
+  it('should load every element set bit-identical to parseTLE()', async () => {
+    const file = await build('round-trip');
+    const info = native!.archiveOpen(file);
+    expect(info.records).toBe(TLES.length);
+    expect(info.objects).toBe(2);
+    expect(info.blocks).toBe(4);
+
+    const sets = loadHistory(native!, info, [43013, '25544', 99999]);
+    expect(sets.norad.length).toBe(TLES.length);
+    // Request order, then epoch order per object
+    const expected = [...TLES.slice(600), ...TLES.slice(0, 600)];
+    expected.forEach((tle, i) => {
+      expect(Array.from(sets.elements.subarray(i * 10, i * 10 + 10))).toEqual(
+        Array.from(native!.parseTLE(tle.line1, tle.line2).elements)
+      );
+    });
+
+    (testResults.tests as Record<string, unknown>).roundTrip = { ...info, handle: undefined };
+  });
+
+  it('should keep only the sets inside the epoch window', async () => {
+    const file = await build('window');
+    const epochs = TLES.slice(0, 600).map((t) => native!.parseTLE(t.line1, t.line2).elements[9]);
+    const sets = loadHistory(native!, file, [25544], { et0: epochs[300], etf: epochs[309] });
+    expect(Array.from(sets.elements.filter((_, k) => k % 10 === 9))).toEqual(epochs.slice(300, 310));
+  });
+
+  it('should reject a truncated or corrupt file when opened', async () => {
+    const file = await build('corrupt');
+    const bytes = readFileSync(file);
+    const index = Number(bytes.readBigUInt64LE(40));
+    const blocks = index + 2 * OBJECT_BYTES;
+    const variants: Record<string, Buffer> = {};
+
+    variants.truncatedHeader = bytes.subarray(0, HEADER_BYTES - 1);
+    variants.truncatedIndex = bytes.subarray(0, bytes.length - 1);
+    variants.truncatedBlocks = Buffer.concat([bytes.subarray(0, index - 100), bytes.subarray(index)]);
+
+    // More blocks than the index holds
+    variants.blockCount = Buffer.from(bytes);
+    variants.blockCount.writeBigUInt64LE(1n << 40n, 32);
+
+    // A block claiming more records than a block holds
+    variants.blockRecords = Buffer.from(bytes);
+    variants.blockRecords.writeUInt32LE(2560, blocks + 24);
+
+    // An object whose blocks run past the blocks table
+    variants.objectBlocks = Buffer.from(bytes);
+    variants.objectBlocks.writeUInt32LE(5, OBJECT_BYTES + 4);
+
+    // A block whose bytes run into the index
+    variants.blockOffset = Buffer.from(bytes);
+    variants.blockOffset.writeBigUInt64LE(BigInt(index - 8), blocks + 3 * BLOCK_BYTES + 16);
+
+    for (const [name, data] of Object.entries(variants)) {
+      const path = join(dir, `${name}.sgpa`);
+      writeFileSync(path, data);
+      expect(() => native!.archiveOpen(path), name).toThrow('Cannot open archive');
+    }
+    expect(native!.archiveOpen(file).records).toBe(TLES.length);
+
+    (testResults.tests as Record<string, unknown>).rejected = Object.keys(variants);
+  });
+});
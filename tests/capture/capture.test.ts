@@ -0,0 +1,208 @@
+/**
+ * Traffic Capture and Replay Test Suite
+ *
+ * Records requests through the capture middleware over two server sessions
+ * appended to one log, loads the log with the replay tool, and re-issues
+ * it: each request must arrive with its original method, URL, body and
+ * scheduling headers, on one timeline across the sessions. Streamed
+ * uploads must be flagged and skipped rather than replayed bodyless.
+ */
+
+import { describe, it, expect, afterAll } from 'vitest';
+import express from 'express';
+import { createServer, type Server } from 'http';
+import type { AddressInfo } from 'net';
+import { trafficCapture } from '../../lib/capture.js';
+import { issue, loadCapture } from '../../lib/replay.js';
+import { writeFileSync, mkdirSync, mkdtempSync, readFileSync, rmSync } from 'fs';
+import { tmpdir } from 'os';
+import { join, dirname } from 'path';
+import { fileURLToPath } from 'url';
+
+// Results directory for this test suite
+const __filename = fileURLToPath(import.meta.url);
+const __dirname = dirname(__filename);
+const RESULTS_DIR = join(__dirname, 'results');
+
+// Ensure results directory exists
+mkdirSync(RESULTS_DIR, { recursive: true });
+
+/**
+ * Write test results to the results directory
+ */
+function writeTestResult(filename: string, data: unknown): void {
+  const filepath = join(RESULTS_DIR, filename);
+  writeFileSync(filepath, JSON.stringify(data, null, 2));
+}
+
+/** A request as an echo server received it */
+interface Received {
+  method: string;
+  url: string;
+  headers: Record<string, string | undefined>;
+  body: unknown;
+}
+
+const HEADERS = ['content-type', 'x-qos-class', 'x-tenant-id', 'x-deadline-ms'];
+
+/**
+ * Start a server that records each request it receives, behind the capture
+ * middleware when `capture` is set
+ */
+async function echoServer(received: Received[], capture?: string): Promise<{ server: Server; url: string }> {
+  const app = express();
+  if (capture) {
+    app.use(trafficCapture(capture));
+  }
+  app.use(express.json());
+  app.use((req: express.Request, res: express.Response) => {
+    received.push({
+      method: req.method,
+      url: req.originalUrl,
+      headers: Object.fromEntries(HEADERS.map((h) => [h, req.get(h)])),
+      body: req.body,
+    });
+    res.json({ ok: true });
+  });
+  const server = await new Promise<Server>((resolve) => {
+    const s = createServer(app).listen(0, '127.0.0.1', () => resolve(s));
+  });
+  return { server, url: `http://127.0.0.1:${(server.address() as AddressInfo).port}` };
+}
+
+const sleep = (ms: number) => new Promise((resolve) => setTimeout(resolve, ms));
+
+describe('Traffic Capture and Replay', () => {
+  const testResults: Record<string, unknown> = {
+    suite: 'Traffic Capture and Replay',
+    tests: {} as Record<string, unknown>,
+  };
+
+  const dir = mkdtempSync(join(tmpdir(), 'sgp4-capture-'));
+
+  afterAll(() => {
+    delete process.env.SGP4_CAPTURE_FILE;
+    rmSync(dir, { recursive: true, force: true });
+    writeTestResult('capture-results.json', testResults);
+  });
+
+  /** Requests of each session; both start their body ids at 0 */
+  const SESSIONS = [
+    [
+      {
+        method: 'POST',
+        url: '/api/propagate?model=wgs72',
+        headers: { 'Content-Type': 'application/json', 'X-QoS-Class': 'bulk', 'X-Tenant-ID': 'ops' },
+        body: { tle: 'first' },
+      },
+      { method: 'GET', url: '/api/health', headers: { 'X-Deadline-Ms': '250' } },
+    ],
+    [
+      {
+        method: 'POST',
+        url: '/api/propagate',
+        headers: { 'Content-Type': 'application/json', 'X-QoS-Class': 'interactive', 'X-Deadline-Ms': '100' },
+        body: { tle: 'second' },
+      },
+      {
+        method: 'POST',
+        url: '/api/propagate',
+        headers: { 'Content-Type': 'application/json' },
+        body: { tle: 'first' },
+      },
+    ],
+  ];
+
+  it('should replay every request with its body and headers across appended sessions', async () => {
+    const file = join(dir, 'capture.ndjson');
+    process.env.SGP4_CAPTURE_FILE = file;
+    let expectedLines = 0;
+
+    // Record each session against its own server start
+    for (const session of SESSIONS) {
+      const { server, url } = await echoServer([], 'test');
+      for (const req of session) {
+        await fetch(url + req.url, {
+          method: req.method,
+          headers: req.headers,
+          body: req.body === undefined ? undefined : JSON.stringify(req.body),
+        }).then((res) => res.arrayBuffer());
+      }
+      server.close();
+      // Header, one line per distinct body and one per request
+      expectedLines += 1 + session.filter((r) => r.body).length + session.length;
+      for (let i = 0; i < 100 && readFileSync(file, 'utf8').split('\n').length - 1 < expectedLines; i++) {
+        await sleep(10);
+      }
+      await sleep(20);
+    }
+
+    const { sessions, requests } = loadCapture(file);
+    expect(sessions.length).toBe(2);
+    expect(requests.length).toBe(4);
+
+    // The second session follows the first on the merged timeline
+    const offset = Date.parse(sessions[1].started) - Date.parse(sessions[0].started);
+    expect(requests[2].t).toBeGreaterThanOrEqual(offset);
+    expect(requests.map((r) => r.t)).toEqual(requests.map((r) => r.t).sort((a, b) => a - b));
+
+    const received: Received[] = [];
+    const { server, url } = await echoServer(received);
+    for (const req of requests) {
+      expect((await issue(url, req)).ok).toBe(true);
+    }
+    server.close();
+
+    const sent = SESSIONS.flat();
+    expect(received.length).toBe(sent.length);
+    received.forEach((got, i) => {
+      const want = sent[i];
+      const headers = Object.fromEntries(Object.entries(want.headers).map(([k, v]) => [k.toLowerCase(), v]));
+      expect(got.method).toBe(want.method);
+      expect(got.url).toBe(want.url);
+      for (const name of HEADERS) {
+        expect(got.headers[name], `${i} ${name}`).toBe(headers[name]);
+      }
+      if (want.body) {
+        expect(got.body).toEqual(want.body);
+      }
+    });
+
+    (testResults.tests as Record<string, unknown>).roundTrip = {
+      sessions: sessions.length,
+      requests: requests.length,
+      sessionOffsetMs: offset,
+    };
+  });
+
+  it('should flag streamed uploads and skip them on replay', async () => {
+    const file = join(dir, 'streamed.ndjson');
+    process.env.SGP4_CAPTURE_FILE = file;
+    const { server, url } = await echoServer([], 'test');
+    const uploads: Array<[string, string]> = [
+      ['text/plain', 'ISS\n1 25544U ...\n2 25544 ...\n'],
+      ['application/x-ndjson', '{"line1":"1 25544U ...","line2":"2 25544 ..."}\n'],
+      ['application/x-sgp4-elements; charset=binary', 'SGP4ELM1'],
+      ['application/json', '{"tle":"first"}'],
+    ];
+    for (const [type, body] of uploads) {
+      await fetch(url + '/api/batch', { method: 'POST', headers: { 'Content-Type': type }, body }).then((res) => res.arrayBuffer());
+    }
+    server.close();
+    for (let i = 0; i < 100 && readFileSync(file, 'utf8').split('\n').length - 1 < 2 + uploads.length; i++) {
+      await sleep(10);
+    }
+
+    const lines = readFileSync(file, 'utf8').trim().split('\n').map((l) => JSON.parse(l));
+    const entries = lines.filter((r) => 'm' in r);
+    expect(entries.map((e) => e.raw)).toEqual([1, 1, 1, undefined]);
+    expect(entries.slice(0, 3).every((e) => e.b === undefined)).toBe(true);
+
+    const { requests, skipped } = loadCapture(file);
+    expect(skipped).toBe(3);
+    expect(requests.length).toBe(1);
+    expect(requests[0].body).toEqual({ tle: 'first' });
+
+    (testResults.tests as Record<string, unknown>).streamed = { flagged: skipped, replayed: requests.length };
+  });
+});
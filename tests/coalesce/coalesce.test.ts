@@ -0,0 +1,142 @@
+/**
+ * Range Task Coalescing Test Suite
+ *
+ * Checks the native worker pool's coalescing of concurrent range requests
+ * (lib/worker-pool-native.ts): requests on one time grid that arrive while
+ * a task of that grid is in flight run as a single batch task, every caller
+ * still receives its own satellite's states, and a bad TLE in the batch
+ * fails only its own request.
+ */
+
+import { describe, it, expect, afterAll } from 'vitest';
+import { SGP4NativeWorkerPool } from '../../lib/worker-pool-native.js';
+import { createExtendedNativeSGP4, type NativeSGP4Module } from '../../dist/sgp4-native.js';
+import { writeFileSync, mkdirSync } from 'fs';
+import { join, dirname } from 'path';
+import { fileURLToPath } from 'url';
+
+// Results directory for this test suite
+const __filename = fileURLToPath(import.meta.url);
+const __dirname = dirname(__filename);
+const RESULTS_DIR = join(__dirname, 'results');
+
+// Ensure results directory exists
+mkdirSync(RESULTS_DIR, { recursive: true });
+
+/**
+ * Write test results to the results directory
+ */
+function writeTestResult(filename: string, data: unknown): void {
+  const filepath = join(RESULTS_DIR, filename);
+  writeFileSync(filepath, JSON.stringify(data, null, 2));
+}
+
+// The native addon is only built for the native server image
+const native: NativeSGP4Module | undefined = await createExtendedNativeSGP4()
+  .then(async (m) => (await m.init(), m))
+  .catch(() => undefined);
+
+describe.skipIf(!native)('Range Task Coalescing', () => {
+  const testResults: Record<string, unknown> = {
+    suite: 'Range Task Coalescing',
+    tests: {} as Record<string, unknown>,
+  };
+
+  // Two workers and a window long enough to gather every request below
+  process.env.SGP4_COALESCE_MS = '20';
+  const pool = new SGP4NativeWorkerPool(2);
+  delete process.env.SGP4_COALESCE_MS;
+
+  afterAll(async () => {
+    await pool.shutdown();
+    writeTestResult('coalesce-results.json', testResults);
+  });
+
+  const ISS = {
+    line1: '1 25544U 98067A   24015.50000000  .00016717  00000-0  10270-3 0  9025',
+    line2: '2 25544  51.6400 208.9163 0006703  30.0825 330.0579 15.49560830    19',
+  };
+  const SSO = {
+    line1: '1 43013U 17073A   24015.50000000  .00000100  00000-0  50000-4 0  9990',
+    line2: '2 43013  97.7000  10.0000 0001000  90.0000 270.0000 14.80000000    10',
+  };
+  const BAD = { line1: '1 99999U not a tle', line2: '2 99999 not a tle' };
+
+  const times = () => {
+    const et0 = native!.utcToET('2024-01-15T12:00:00');
+    return { et0, etf: et0 + 3600, step: 60 };
+  };
+
+  /** Largest position difference (km) from the satellite propagated alone */
+  const worstKm = (tle: { line1: string; line2: string }, packed: Float64Array): number => {
+    const { et0, etf, step } = times();
+    const alone = native!.propagateRangePacked(native!.parseTLE(tle.line1, tle.line2), et0, etf, step);
+    expect(packed.length).toBe(alone.length);
+    let km = 0;
+    for (let i = 0; i < alone.length; i++) {
+      km = Math.max(km, Math.abs(packed[i] - alone[i]));
+    }
+    return km;
+  };
+
+  it('should run requests behind an in-flight one as one batch, each with its own states', async () => {
+    await pool.initialize();
+    const before = pool.stats;
+
+    // The first is submitted at once; the rest arrive while it is in flight,
+    // two of them identical
+    const tles = [ISS, SSO, ISS, SSO, ISS];
+    const results = await Promise.all(tles.map((tle) => pool.propagate({ tle, times: times(), model: 'wgs72', packed: true })));
+
+    const stats = pool.stats;
+    expect(stats.coalescedBatches - before.coalescedBatches).toBe(1);
+    expect(stats.coalescedTasks - before.coalescedTasks).toBe(tles.length - 1);
+    expect(stats.coalescingTasks).toBe(0);
+
+    let worst = 0;
+    results.forEach((r, i) => (worst = Math.max(worst, worstKm(tles[i], r.packed!))));
+    // Identical requests get equal but separate results
+    expect(results[2].packed).not.toBe(results[4].packed);
+    expect(Array.from(results[2].packed!)).toEqual(Array.from(results[4].packed!));
+    expect(worst).toBeLessThan(1e-4);
+
+    (testResults.tests as Record<string, unknown>).batch = {
+      requests: tles.length,
+      coalesced: stats.coalescedTasks - before.coalescedTasks,
+      worstKm: worst,
+    };
+  });
+
+  it('should fail only the request with a bad TLE', async () => {
+    await pool.initialize();
+    const before = pool.stats;
+
+    const tles = [ISS, SSO, BAD, ISS];
+    const settled = await Promise.allSettled(
+      tles.map((tle) => pool.propagate({ tle, times: times(), model: 'wgs72', packed: true }))
+    );
+
+    expect(pool.stats.coalescedBatches - before.coalescedBatches).toBe(1);
+    expect(settled.map((s) => s.status)).toEqual(['fulfilled', 'fulfilled', 'rejected', 'fulfilled']);
+    settled.forEach((s, i) => {
+      if (s.status === 'fulfilled') {
+        expect(worstKm(tles[i], s.value.packed!)).toBeLessThan(1e-4);
+      }
+    });
+
+    (testResults.tests as Record<string, unknown>).badTle = {
+      error: settled[2].status === 'rejected' ? String((settled[2] as PromiseRejectedResult).reason.message) : undefined,
+    };
+  });
+
+  it('should not coalesce requests on different grids', async () => {
+    await pool.initialize();
+    const before = pool.stats;
+    const { et0, etf } = times();
+
+    await Promise.all(
+      [60, 30, 20].map((step) => pool.propagate({ tle: ISS, times: { et0, etf, step }, model: 'wgs72', packed: true }))
+    );
+    expect(pool.stats.coalescedBatches).toBe(before.coalescedBatches);
+  });
+});
@@ -0,0 +1,130 @@
+/**
+ * Elastic Pool Sizing Test Suite
+ *
+ * Checks the sizing policy (lib/elastic.ts): plan() tops up to the
+ * minimum, scales up on queue wait (at most doubling, never past the
+ * maximum, counting workers still starting), keeps warm spares, and
+ * retires one worker at a time once it has stayed idle.
+ */
+
+import { describe, it, expect, afterAll } from 'vitest';
+import { ElasticSizing, type SizedWorker } from '../../lib/elastic.js';
+import { writeFileSync, mkdirSync } from 'fs';
+import { join, dirname } from 'path';
+import { fileURLToPath } from 'url';
+
+// Results directory for this test suite
+const __filename = fileURLToPath(import.meta.url);
+const __dirname = dirname(__filename);
+const RESULTS_DIR = join(__dirname, 'results');
+
+// Ensure results directory exists
+mkdirSync(RESULTS_DIR, { recursive: true });
+
+/**
+ * Write test results to the results directory
+ */
+function writeTestResult(filename: string, data: unknown): void {
+  const filepath = join(RESULTS_DIR, filename);
+  writeFileSync(filepath, JSON.stringify(data, null, 2));
+}
+
+const ENV = {
+  SGP4_POOL_MIN: '2',
+  SGP4_POOL_MAX: '8',
+  SGP4_POOL_SPARES: '1',
+  SGP4_POOL_IDLE_MS: '100',
+  SGP4_POOL_SCALE_WAIT_MS: '50',
+};
+
+/** Workers in the given states; idle ones became idle idleMs ago */
+function workers(counts: { busy?: number; idle?: number; starting?: number }, idleMs = 0): SizedWorker[] {
+  const now = performance.now();
+  return [
+    ...Array.from({ length: counts.busy ?? 0 }, () => ({ ready: true, busy: true, idleSince: now })),
+    ...Array.from({ length: counts.idle ?? 0 }, () => ({ ready: true, busy: false, idleSince: now - idleMs })),
+    ...Array.from({ length: counts.starting ?? 0 }, () => ({ ready: false, busy: false, idleSince: now })),
+  ];
+}
+
+describe('Elastic Pool Sizing', () => {
+  const testResults: Record<string, unknown> = {
+    suite: 'Elastic Pool Sizing',
+    tests: {} as Record<string, unknown>,
+  };
+
+  Object.assign(process.env, ENV);
+  const sizing = new ElasticSizing(2);
+  for (const name of Object.keys(ENV)) {
+    delete process.env[name];
+  }
+
+  afterAll(() => {
+    writeTestResult('elastic-results.json', testResults);
+  });
+
+  it('should read its bounds and be disabled when they are equal', () => {
+    expect(sizing.enabled).toBe(true);
+    expect([sizing.minSize, sizing.maxSize, sizing.initialSize, sizing.spares]).toEqual([2, 8, 2, 1]);
+
+    const fixed = new ElasticSizing(4);
+    expect(fixed.enabled).toBe(false);
+    expect(fixed.spares).toBe(0);
+    expect(fixed.plan(workers({ busy: 4 }), 100, 10000).start).toBe(0);
+  });
+
+  it('should top up to the minimum', () => {
+    expect(sizing.plan(workers({ idle: 1 }), 0, 0)).toEqual({ start: 1, reason: 'below minimum', retire: [] });
+  });
+
+  it('should scale up on queue wait, at most doubling and never past the maximum', () => {
+    // Queued, but not for long: only the warm spare
+    expect(sizing.plan(workers({ busy: 2 }), 10, 10)).toEqual({ start: 1, reason: 'warm spare', retire: [] });
+    expect(sizing.plan(workers({ busy: 2, idle: 1 }), 10, 10).start).toBe(0);
+
+    const up = sizing.plan(workers({ busy: 2 }), 10, 60);
+    expect(up.start).toBe(2);
+    expect(up.reason).toBe('queue wait 60 ms');
+    // Never more than the queue
+    expect(sizing.plan(workers({ busy: 4 }), 1, 60).start).toBe(1);
+    // Workers still starting count against the step
+    expect(sizing.plan(workers({ busy: 2, starting: 1 }), 10, 60).start).toBe(1);
+    expect(sizing.plan(workers({ busy: 2, starting: 2 }), 10, 60).start).toBe(0);
+    // Room left below the maximum
+    expect(sizing.plan(workers({ busy: 7 }), 100, 60).start).toBe(1);
+    expect(sizing.plan(workers({ busy: 8 }), 100, 60).start).toBe(0);
+
+    (testResults.tests as Record<string, unknown>).scaleUp = { from: 2, start: up.start, reason: up.reason };
+  });
+
+  it('should retire the longest-idle worker once it has stayed idle', () => {
+    const pool = workers({ busy: 1, idle: 3 });
+    // Idle for less than SGP4_POOL_IDLE_MS: kept
+    expect(sizing.plan(pool, 0, 0).retire).toEqual([]);
+
+    pool[2].idleSince -= 150;
+    pool[3].idleSince -= 120;
+    const down = sizing.plan(pool, 0, 0);
+    expect(down.start).toBe(0);
+    expect(down.retire.length).toBe(1);
+    expect(down.retire[0]).toBe(pool[2]);
+
+    // Not while tasks are queued, nor at the minimum or down to the spares
+    expect(sizing.plan(pool, 1, 0).retire).toEqual([]);
+    expect(sizing.plan(workers({ idle: 2 }, 1000), 0, 0).retire).toEqual([]);
+    expect(sizing.plan(workers({ busy: 2, idle: 1 }, 1000), 0, 0).retire).toEqual([]);
+
+    (testResults.tests as Record<string, unknown>).retire = { workers: pool.length, retired: down.retire.length };
+  });
+
+  it('should keep the most recent scaling events', () => {
+    for (let i = 0; i < 25; i++) {
+      sizing.record(i % 2 ? 'down' : 'up', 1, 2 + (i % 2), 'test');
+    }
+    const stats = sizing.stats(0);
+    expect(stats.scaleUps).toBe(13);
+    expect(stats.scaleDowns).toBe(12);
+    expect(stats.events.length).toBe(20);
+    expect(stats.events[19].action).toBe('up');
+  });
+});
@@ -0,0 +1,200 @@
+/**
+ * Osculating Elements Test Suite
+ *
+ * Checks the native pipeline's Keplerian and equinoctial columns against a
+ * reference conversion of the same states, and the conventions at the
+ * circular and equatorial singularities (finite values, angles in [0, 360)).
+ */
+
+import { describe, it, expect, afterAll } from 'vitest';
+import { ELEMENT_COLUMNS, encodePipeline, runPipeline, type PipelineColumn } from '../../lib/pipeline.js';
+import { createExtendedNativeSGP4, type NativeSGP4Module } from '../../dist/sgp4-native.js';
+import { writeFileSync, mkdirSync } from 'fs';
+import { join, dirname } from 'path';
+import { fileURLToPath } from 'url';
+
+// Results directory for this test suite
+const __filename = fileURLToPath(import.meta.url);
+const __dirname = dirname(__filename);
+const RESULTS_DIR = join(__dirname, 'results');
+
+// Ensure results directory exists
+mkdirSync(RESULTS_DIR, { recursive: true });
+
+/**
+ * Write test results to the results directory
+ */
+function writeTestResult(filename: string, data: unknown): void {
+  const filepath = join(RESULTS_DIR, filename);
+  writeFileSync(filepath, JSON.stringify(data, null, 2));
+}
+
+// The native addon is only built for the native server image
+const native: NativeSGP4Module | undefined = await createExtendedNativeSGP4()
+  .then(async (m) => (await m.init(), m))
+  .catch(() => undefined);
+
+/** Gravitational parameter (km^3/s^2) the pipeline derives from WGS-72 ke and radius */
+const MU = (0.0743669161 ** 2 * 6378.135 ** 3) / 3600;
+
+const RAD2DEG = 180 / Math.PI;
+
+/** Angle difference in degrees, wrapped to (-180, 180] */
+const angleDiff = (a: number, b: number): number => {
+  const d = (((a - b) % 360) + 540) % 360 - 180;
+  return d === -180 ? 180 : d;
+};
+
+/**
+ * Equinoctial elements (prograde convention) of a TEME state: regular at
+ * e = 0 and i = 0, so a reference for both sets
+ */
+function equinoctialOf(r: number[], v: number[]): { sma: number; h: number; k: number; p: number; q: number; l: number } {
+  const [x, y, z] = r;
+  const [u, w, s] = v;
+  const rn = Math.hypot(x, y, z);
+  const v2 = u * u + w * w + s * s;
+  const rv = x * u + y * w + z * s;
+  const hx = y * s - z * w;
+  const hy = z * u - x * s;
+  const hz = x * w - y * u;
+  const h = Math.hypot(hx, hy, hz);
+  const c = v2 - MU / rn;
+  const e = [(c * x - rv * u) / MU, (c * y - rv * w) / MU, (c * z - rv * s) / MU];
+  const p = hx / (h + hz);
+  const q = -hy / (h + hz);
+  const d = 1 + p * p + q * q;
+  const f = [(1 - p * p + q * q) / d, (2 * p * q) / d, (-2 * p) / d];
+  const g = [(2 * p * q) / d, (1 + p * p - q * q) / d, (2 * q) / d];
+  const dot = (a: number[], b: number[]): number => a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+  return {
+    sma: 1 / (2 / rn - v2 / MU),
+    h: dot(e, g),
+    k: dot(e, f),
+    p,
+    q,
+    l: Math.atan2(dot(r, g), dot(r, f)) * RAD2DEG,
+  };
+}
+
+describe.skipIf(!native)('Osculating Elements', () => {
+  const testResults: Record<string, unknown> = {
+    suite: 'Osculating Elements',
+    tests: {} as Record<string, unknown>,
+  };
+
+  afterAll(() => {
+    writeTestResult('elements-results.json', testResults);
+  });
+
+  // No drag: the native kernel keeps e = 0 and i = 0 exactly, which puts the
+  // first three objects on the singular branches
+  const SATELLITES = [
+    {
+      name: 'circular equatorial',
+      line1: '1 99001U 24001A   24015.50000000  .00000000  00000-0  00000-0 0  9990',
+      line2: '2 99001   0.0000   0.0000 0000000   0.0000   0.0000 15.00000000    10',
+    },
+    {
+      name: 'circular inclined',
+      line1: '1 99002U 24001A   24015.50000000  .00000000  00000-0  00000-0 0  9990',
+      line2: '2 99002  45.0000 100.0000 0000000   0.0000   0.0000 15.00000000    10',
+    },
+    {
+      name: 'eccentric equatorial',
+      line1: '1 99003U 24001A   24015.50000000  .00000000  00000-0  00000-0 0  9990',
+      line2: '2 99003   0.0000 250.0000 0100000 120.0000  30.0000 14.00000000    10',
+    },
+    {
+      name: 'near singular',
+      line1: '1 99004U 24001A   24015.50000000  .00000000  00000-0  00000-0 0  9990',
+      line2: '2 99004   0.0001  80.0000 0000010 200.0000  10.0000 15.20000000    10',
+    },
+    {
+      name: 'ISS',
+      line1: '1 25544U 98067A   24015.50000000  .00016717  00000-0  10270-3 0  9025',
+      line2: '2 25544  51.6400 208.9163 0006703  30.0825 330.0579 15.49560830    19',
+    },
+  ];
+
+  const KEPLERIAN = ELEMENT_COLUMNS.keplerian;
+  const EQUINOCTIAL = ELEMENT_COLUMNS.equinoctial.slice(1);
+  const COLUMNS: PipelineColumn[] = ['et', 'x', 'y', 'z', 'vx', 'vy', 'vz', ...KEPLERIAN, ...EQUINOCTIAL];
+
+  /** One record per row: name -> value */
+  function rowsOf(): Array<Record<string, number> & { sat: number }> {
+    const et0 = native!.utcToET('2024-01-15T12:00:00');
+    const stages = encodePipeline([{ derive: [...KEPLERIAN, ...EQUINOCTIAL] }, { select: COLUMNS }]);
+    const out = runPipeline(native!, SATELLITES, stages, { et0, etf: et0 + 86400, step: 60 });
+    return Array.from(out.rowSat, (sat, r) => {
+      const row = out.rows.subarray(r * COLUMNS.length, (r + 1) * COLUMNS.length);
+      return Object.assign({ sat }, Object.fromEntries(COLUMNS.map((c, k) => [c, row[k]])));
+    });
+  }
+
+  it('should be finite with angles in [0, 360)', () => {
+    for (const row of rowsOf()) {
+      for (const c of [...KEPLERIAN, ...EQUINOCTIAL]) {
+        expect(Number.isFinite(row[c])).toBe(true);
+      }
+      for (const c of ['raan', 'argp', 'nu', 'eq_l']) {
+        expect(row[c]).toBeGreaterThanOrEqual(0);
+        expect(row[c]).toBeLessThan(360);
+      }
+    }
+  });
+
+  it('should use the conventions on the singular branches', () => {
+    const rows = rowsOf();
+    const of = (sat: number) => rows.filter((r) => r.sat === sat);
+
+    for (const row of of(0)) {
+      expect(row.inc).toBe(0);
+      expect(row.raan).toBe(0);
+      expect(row.argp).toBe(0);
+      // nu is the true longitude from the x axis
+      expect(Math.abs(angleDiff(row.nu, Math.atan2(row.y, row.x) * RAD2DEG))).toBeLessThan(1e-9);
+    }
+    for (const row of of(1)) {
+      expect(row.argp).toBe(0);
+      expect(Math.abs(angleDiff(row.raan, 100))).toBeLessThan(1e-6);
+    }
+    for (const row of of(2)) {
+      expect(row.raan).toBe(0);
+      // argp is the longitude of perigee
+      expect(Math.abs(angleDiff(row.argp, Math.atan2(row.eq_h, row.eq_k) * RAD2DEG))).toBeLessThan(1e-9);
+    }
+  });
+
+  it('should agree with a reference conversion and between the two sets', () => {
+    const worst: Record<string, number> = { sma: 0, ecc: 0, inc: 0, eq_h: 0, eq_k: 0, eq_p: 0, eq_q: 0, eq_l: 0, longitude: 0 };
+    const track = (name: string, diff: number): void => {
+      worst[name] = Math.max(worst[name], Math.abs(diff));
+    };
+
+    for (const row of rowsOf()) {
+      const ref = equinoctialOf([row.x, row.y, row.z], [row.vx, row.vy, row.vz]);
+      track('sma', (row.sma - ref.sma) / ref.sma);
+      track('eq_h', row.eq_h - ref.h);
+      track('eq_k', row.eq_k - ref.k);
+      track('eq_p', row.eq_p - ref.p);
+      track('eq_q', row.eq_q - ref.q);
+      track('eq_l', angleDiff(row.eq_l, ref.l));
+
+      // Keplerian from equinoctial
+      track('ecc', row.ecc - Math.hypot(ref.h, ref.k));
+      track('inc', angleDiff(row.inc, 2 * Math.atan(Math.hypot(ref.p, ref.q)) * RAD2DEG));
+      track('longitude', angleDiff(row.raan + row.argp + row.nu, row.eq_l));
+    }
+
+    expect(worst.sma).toBeLessThan(1e-12);
+    for (const c of ['ecc', 'eq_h', 'eq_k', 'eq_p', 'eq_q']) {
+      expect(worst[c]).toBeLessThan(1e-12);
+    }
+    for (const c of ['inc', 'eq_l', 'longitude']) {
+      expect(worst[c]).toBeLessThan(1e-9);
+    }
+
+    (testResults.tests as Record<string, unknown>).worst = worst;
+  });
+});
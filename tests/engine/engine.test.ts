@@ -0,0 +1,137 @@
+/**
+ * Engine Routing Test Suite
+ *
+ * Checks how objects are classified between the native and CSPICE engines,
+ * the fallbacks without CSPICE, and that both engines put a requested time
+ * at the same UTC instant (native ET is UTC-based, CSPICE ET is TDB).
+ */
+
+import { describe, it, expect, afterAll } from 'vitest';
+import { classifyElements, EngineRouter } from '../../lib/engine.js';
+import { createExtendedNativeSGP4, type NativeSGP4Module } from '../../dist/sgp4-native.js';
+import { writeFileSync, mkdirSync } from 'fs';
+import { join, dirname } from 'path';
+import { fileURLToPath } from 'url';
+
+// Results directory for this test suite
+const __filename = fileURLToPath(import.meta.url);
+const __dirname = dirname(__filename);
+const RESULTS_DIR = join(__dirname, 'results');
+
+// Ensure results directory exists
+mkdirSync(RESULTS_DIR, { recursive: true });
+
+/**
+ * Write test results to the results directory
+ */
+function writeTestResult(filename: string, data: unknown): void {
+  const filepath = join(RESULTS_DIR, filename);
+  writeFileSync(filepath, JSON.stringify(data, null, 2));
+}
+
+// The native addon is only built for the native server image
+const native: NativeSGP4Module | undefined = await createExtendedNativeSGP4()
+  .then(async (m) => (await m.init(), m))
+  .catch(() => undefined);
+
+// CSPICE runs in WASM workers, only present with the WASM build
+const router = native ? new EngineRouter((et) => native.etToUTC(et)) : undefined;
+const cspice = router ? await router.initialize() : false;
+
+/** Element row with only eccentricity and mean motion (rev/day) set */
+const elementsOf = (ecco: number, revPerDay: number): number[] => {
+  const row = new Array(10).fill(0);
+  row[5] = ecco;
+  row[8] = (revPerDay * 2 * Math.PI) / 1440;
+  return row;
+};
+
+/** Milliseconds since 1970 of a UTC label with or without the Z designator */
+const instant = (utc: string): number => Date.parse(utc.endsWith('Z') ? utc : `${utc}Z`);
+
+describe('Engine Routing', () => {
+  const testResults: Record<string, unknown> = {
+    suite: 'Engine Routing',
+    tests: {} as Record<string, unknown>,
+  };
+
+  afterAll(async () => {
+    await router?.shutdown();
+    writeTestResult('engine-results.json', testResults);
+  });
+
+  const ISS = {
+    line1: '1 25544U 98067A   24015.50000000  .00016717  00000-0  10270-3 0  9025',
+    line2: '2 25544  51.6400 208.9163 0006703  30.0825 330.0579 15.49560830    19',
+  };
+
+  describe('classifyElements', () => {
+    it('should keep near-earth objects native', () => {
+      expect(classifyElements(elementsOf(0.0006703, 15.4956083)).engine).toBe('native');
+      expect(classifyElements(elementsOf(0.0001, 14.8)).engine).toBe('native');
+    });
+
+    it('should send deep-space, low-perigee and eccentric objects to CSPICE', () => {
+      const cases = {
+        gps: classifyElements(elementsOf(0.005, 2.00564)),
+        decaying: classifyElements(elementsOf(0.001, 16.3)),
+        eccentric: classifyElements(elementsOf(0.3, 8)),
+      };
+      expect(cases.gps).toEqual({ engine: 'cspice', reason: 'deep space (period 718 min)' });
+      expect(cases.decaying.engine).toBe('cspice');
+      expect(cases.decaying.reason).toMatch(/^low perigee/);
+      expect(cases.eccentric).toEqual({ engine: 'cspice', reason: 'eccentricity 0.300' });
+      (testResults.tests as Record<string, unknown>).classify = cases;
+    });
+  });
+
+  describe('select without CSPICE', () => {
+    const offline = new EngineRouter((et) => String(et));
+
+    it('should run CSPICE objects natively and say why', () => {
+      const choice = offline.select(elementsOf(0.005, 2.00564), 'auto');
+      expect(choice.engine).toBe('native');
+      expect(choice.reason).toBe('deep space (period 718 min); CSPICE engine unavailable');
+      expect(offline.stats.fallbacks).toBe(1);
+    });
+
+    it('should refuse a pinned CSPICE engine', () => {
+      expect(() => offline.select(elementsOf(0.0006703, 15.4956083), 'cspice')).toThrow('engine=cspice cannot be used');
+      expect(() => offline.select(elementsOf(0.005, 2.00564), 'cspice', 'aggregate')).toThrow(
+        'aggregate requires the native engine'
+      );
+    });
+  });
+
+  describe.skipIf(!cspice)('time scales', () => {
+    it('should give the same UTC instant and state for auto and engine=cspice', async () => {
+      const tle = native!.parseTLE(ISS.line1, ISS.line2);
+      const et0 = native!.utcToET('2024-01-15T12:00:00');
+      const times = { et0, etf: et0 + 600, step: 60 };
+
+      expect(router!.select(tle.elements, 'auto').engine).toBe('native');
+      expect(router!.select(tle.elements, 'cspice').engine).toBe('cspice');
+      const { states } = await router!.propagate({ tle: ISS, times, model: 'wgs72' });
+
+      let worstKm = 0;
+      states.forEach((s, i) => {
+        const et = et0 + i * times.step;
+        const n = native!.propagate(tle, et);
+        expect(s.et).toBe(et);
+        expect(instant(s.datetime)).toBe(instant(native!.etToUTC(et)));
+        worstKm = Math.max(
+          worstKm,
+          Math.hypot(s.position[0] - n.position.x, s.position[1] - n.position.y, s.position[2] - n.position.z)
+        );
+      });
+      // A 69 s offset would put the ISS about 500 km away
+      expect(worstKm).toBeLessThan(0.1);
+
+      (testResults.tests as Record<string, unknown>).timeScales = {
+        t0: states[0].datetime,
+        points: states.length,
+        worstKm,
+      };
+    });
+  });
+});
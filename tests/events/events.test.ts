@@ -0,0 +1,157 @@
+/**
+ * Event Finder Test Suite
+ *
+ * Checks the native event finder's coarse sampling and refinement against
+ * sign changes found by dense 1 s sampling through the pipeline.
+ */
+
+import { describe, it, expect, afterAll } from 'vitest';
+import { encodeEventSpecs, findEvents, type EventSpec } from '../../lib/events.js';
+import { encodePipeline, runPipeline } from '../../lib/pipeline.js';
+import { createExtendedNativeSGP4, type NativeSGP4Module } from '../../dist/sgp4-native.js';
+import { writeFileSync, mkdirSync } from 'fs';
+import { join, dirname } from 'path';
+import { fileURLToPath } from 'url';
+
+// Results directory for this test suite
+const __filename = fileURLToPath(import.meta.url);
+const __dirname = dirname(__filename);
+const RESULTS_DIR = join(__dirname, 'results');
+
+// Ensure results directory exists
+mkdirSync(RESULTS_DIR, { recursive: true });
+
+/**
+ * Write test results to the results directory
+ */
+function writeTestResult(filename: string, data: unknown): void {
+  const filepath = join(RESULTS_DIR, filename);
+  writeFileSync(filepath, JSON.stringify(data, null, 2));
+}
+
+// The native addon is only built for the native server image
+const native: NativeSGP4Module | undefined = await createExtendedNativeSGP4()
+  .then(async (m) => (await m.init(), m))
+  .catch(() => undefined);
+
+describe.skipIf(!native)('Event Finder', () => {
+  const testResults: Record<string, unknown> = {
+    suite: 'Event Finder',
+    tests: {} as Record<string, unknown>,
+  };
+
+  afterAll(() => {
+    writeTestResult('events-results.json', testResults);
+  });
+
+  // LEO, sun-synchronous and Molniya orbits
+  const SATELLITES = [
+    {
+      name: 'ISS',
+      line1: '1 25544U 98067A   24015.50000000  .00016717  00000-0  10270-3 0  9025',
+      line2: '2 25544  51.6400 208.9163 0006703  30.0825 330.0579 15.49560830    19',
+    },
+    {
+      name: 'SSO',
+      line1: '1 43013U 17073A   24015.50000000  .00000100  00000-0  50000-4 0  9990',
+      line2: '2 43013  97.7000  10.0000 0001000  90.0000 270.0000 14.80000000    10',
+    },
+    {
+      name: 'MOLNIYA',
+      line1: '1 40296U 14069A   24015.50000000  .00000100  00000-0  00000-0 0  9990',
+      line2: '2 40296  63.4000 300.0000 7000000 270.0000  10.0000  2.00600000    10',
+    },
+  ];
+
+  const SPECS: EventSpec[] = [
+    { type: 'node' },
+    { type: 'apsis' },
+    { type: 'altitude', value: 1000 },
+    { type: 'lat_band', min: 10, max: 30 },
+  ];
+
+  // Dense-sampling tolerance (s): linear interpolation of a 1 s grid
+  const TOLERANCE = 0.01;
+
+  /**
+   * Sign changes of each spec's function per satellite from 1 s samples,
+   * linearly interpolated
+   */
+  function denseEvents(et0: number, etf: number): Array<{ sat: number; spec: number; direction: number; et: number }> {
+    const columns = ['et', 'x', 'y', 'z', 'vx', 'vy', 'vz', 'alt', 'lat'] as const;
+    const stages = encodePipeline([{ derive: ['alt', 'lat'] }, { select: [...columns] }]);
+    const out = runPipeline(native!, SATELLITES, stages, { et0, etf, step: 1 });
+    const w = columns.length;
+    const g = (row: Float64Array, spec: EventSpec): number => {
+      const [, x, y, z, vx, vy, vz, alt, lat] = row;
+      switch (spec.type) {
+        case 'node':
+          return z;
+        case 'apsis':
+          return (x * vx + y * vy + z * vz) / Math.hypot(x, y, z);
+        case 'altitude':
+          return alt - spec.value!;
+        default:
+          return Math.min(lat - spec.min!, spec.max! - lat);
+      }
+    };
+
+    const events: Array<{ sat: number; spec: number; direction: number; et: number }> = [];
+    for (let r = 1; r < out.rowSat.length; r++) {
+      if (out.rowSat[r] !== out.rowSat[r - 1]) continue;
+      const a = out.rows.subarray((r - 1) * w, r * w);
+      const b = out.rows.subarray(r * w, (r + 1) * w);
+      SPECS.forEach((spec, k) => {
+        const ga = g(a, spec);
+        const gb = g(b, spec);
+        if (ga < 0 !== gb < 0) {
+          const et = a[0] + (ga / (ga - gb)) * (b[0] - a[0]);
+          events.push({ sat: out.rowSat[r], spec: k, direction: gb >= 0 ? 1 : -1, et });
+        }
+      });
+    }
+    return events;
+  }
+
+  it('should find every sign change of dense sampling at the same time', () => {
+    const et0 = native!.utcToET('2024-01-15T12:00:00');
+    const etf = et0 + 86400;
+    const found = findEvents(native!, SATELLITES, encodeEventSpecs(SPECS), { et0, etf });
+    const dense = denseEvents(et0, etf);
+
+    expect(found.truncated).toBe(false);
+    expect(found.et.length).toBe(dense.length);
+
+    let worst = 0;
+    for (const d of dense) {
+      let best = Infinity;
+      for (let i = 0; i < found.et.length; i++) {
+        if (found.sat[i] === d.sat && found.spec[i] === d.spec && found.direction[i] === d.direction) {
+          best = Math.min(best, Math.abs(found.et[i] - d.et));
+        }
+      }
+      worst = Math.max(worst, best);
+    }
+    expect(worst).toBeLessThan(TOLERANCE);
+
+    (testResults.tests as Record<string, unknown>).dense = { events: dense.length, worstSeconds: worst };
+  });
+
+  it('should return events sorted by satellite, then time', () => {
+    const et0 = native!.utcToET('2024-01-15T12:00:00');
+    const found = findEvents(native!, SATELLITES, encodeEventSpecs(SPECS), { et0, etf: et0 + 86400 });
+    for (let i = 1; i < found.et.length; i++) {
+      const sameSat = found.sat[i] === found.sat[i - 1];
+      expect(found.sat[i] > found.sat[i - 1] || (sameSat && found.et[i] >= found.et[i - 1])).toBe(true);
+    }
+  });
+
+  it('should keep the first events in that order when capped', () => {
+    const et0 = native!.utcToET('2024-01-15T12:00:00');
+    const specs = encodeEventSpecs(SPECS);
+    const all = findEvents(native!, SATELLITES, specs, { et0, etf: et0 + 86400 });
+    const capped = findEvents(native!, SATELLITES, specs, { et0, etf: et0 + 86400 }, 0, 40);
+    expect(capped.truncated).toBe(true);
+    expect(Array.from(capped.et)).toEqual(Array.from(all.et.subarray(0, 40)));
+  });
+});
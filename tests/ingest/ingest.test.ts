@@ -0,0 +1,149 @@
+/**
+ * Streaming Ingestion Test Suite
+ *
+ * Checks the binary element frame decoder against encodeElementFrame() for
+ * any split of the body into stream chunks, its error cases, and the line
+ * length cap of the text formats.
+ */
+
+import { describe, it, expect, afterAll } from 'vitest';
+import { Readable } from 'stream';
+import {
+  encodeElementFrame,
+  streamSatelliteChunks,
+  type ElementFrame,
+  type SatelliteInput,
+  type SatelliteStreamType,
+} from '../../lib/ingest.js';
+import { writeFileSync, mkdirSync } from 'fs';
+import { join, dirname } from 'path';
+import { fileURLToPath } from 'url';
+
+// Results directory for this test suite
+const __filename = fileURLToPath(import.meta.url);
+const __dirname = dirname(__filename);
+const RESULTS_DIR = join(__dirname, 'results');
+
+// Ensure results directory exists
+mkdirSync(RESULTS_DIR, { recursive: true });
+
+/**
+ * Write test results to the results directory
+ */
+function writeTestResult(filename: string, data: unknown): void {
+  const filepath = join(RESULTS_DIR, filename);
+  writeFileSync(filepath, JSON.stringify(data, null, 2));
+}
+
+/**
+ * Chunks read from a body delivered in pieces of `size` bytes
+ */
+async function read(
+  body: Buffer,
+  type: SatelliteStreamType,
+  size = body.length
+): Promise<Array<SatelliteInput[] | ElementFrame>> {
+  const pieces: Buffer[] = [];
+  for (let i = 0; i < body.length; i += size) {
+    pieces.push(body.subarray(i, i + size));
+  }
+  const out: Array<SatelliteInput[] | ElementFrame> = [];
+  for await (const chunk of streamSatelliteChunks(Readable.from(pieces), type, 1024)) {
+    out.push(chunk);
+  }
+  return out;
+}
+
+describe('Streaming Ingestion', () => {
+  const testResults: Record<string, unknown> = {
+    suite: 'Streaming Ingestion',
+    tests: {} as Record<string, unknown>,
+  };
+
+  afterAll(() => {
+    writeTestResult('ingest-results.json', testResults);
+  });
+
+  const ISS = {
+    line1: '1 25544U 98067A   24015.50000000  .00016717  00000-0  10270-3 0  9025',
+    line2: '2 25544  51.6400 208.9163 0006703  30.0825 330.0579 15.49560830    19',
+  };
+
+  describe('binary element frames', () => {
+    const ELEMENTS = 'application/x-sgp4-elements';
+
+    // Odd and even counts: odd frames end in 4 bytes of padding
+    const FRAMES = [3, 1, 4].map((n, f) => ({
+      columns: Float64Array.from({ length: 10 * n }, (_, i) => (f + 1) * 1000 + i * 0.25 - 3),
+      norad: Int32Array.from({ length: n }, (_, i) => 10000 * (f + 1) + i),
+    }));
+    const BODY = Buffer.concat(FRAMES.map((f) => encodeElementFrame(f.columns, f.norad)));
+
+    it('should lay out header, columns, IDs and padding', () => {
+      const frame = encodeElementFrame(FRAMES[0].columns, FRAMES[0].norad);
+      expect(frame.length).toBe(16 + 84 * 3 + 4);
+      expect(frame.toString('latin1', 0, 8)).toBe('SGP4ELM1');
+      expect(frame.readUInt32LE(8)).toBe(3);
+      expect(frame.readUInt32LE(12)).toBe(0);
+      expect(frame.readDoubleLE(16 + 8 * 29)).toBe(FRAMES[0].columns[29]);
+      expect(frame.readInt32LE(16 + 80 * 3 + 4)).toBe(10001);
+      expect(encodeElementFrame(FRAMES[2].columns, FRAMES[2].norad).length).toBe(16 + 84 * 4);
+      expect(() => encodeElementFrame(new Float64Array(9), [1])).toThrow('10 values per NORAD ID');
+    });
+
+    it('should decode every frame for any split of the body', async () => {
+      const sizes = [BODY.length, 1, 3, 7, 16, 100, 333];
+      for (const size of sizes) {
+        const frames = (await read(BODY, ELEMENTS, size)) as ElementFrame[];
+        expect(frames).toHaveLength(FRAMES.length);
+        frames.forEach((frame, f) => {
+          expect(Array.from(frame.columns)).toEqual(Array.from(FRAMES[f].columns));
+          expect(Array.from(frame.norad)).toEqual(Array.from(FRAMES[f].norad));
+        });
+      }
+      (testResults.tests as Record<string, unknown>).split = { bytes: BODY.length, frames: FRAMES.length, sizes };
+    });
+
+    it('should reject a bad magic, count or truncated body', async () => {
+      const bad = Buffer.from(BODY);
+      bad.write('SGP4ELM2', 0, 'latin1');
+      await expect(read(bad, ELEMENTS)).rejects.toThrow('Frame 0: bad magic');
+
+      const empty = Buffer.from(BODY.subarray(0, 16));
+      empty.writeUInt32LE(0, 8);
+      await expect(read(empty, ELEMENTS)).rejects.toThrow('satellite count must be 1 to');
+
+      // The first frame is handed out before the second is found incomplete
+      const cut = BODY.subarray(0, BODY.length - 5);
+      await expect(read(cut, ELEMENTS, 64)).rejects.toThrow('Frame 2: body ends mid-frame');
+      await expect(read(BODY.subarray(0, 10), ELEMENTS)).rejects.toThrow('Frame 0: body ends mid-frame');
+    });
+  });
+
+  describe('line formats', () => {
+    it('should read 3LE text with CRLF line ends and blank lines', async () => {
+      const body = Buffer.from(`ISS (ZARYA)\r\n${ISS.line1}\r\n${ISS.line2}\r\n\r\n${ISS.line1}\n${ISS.line2}`);
+      const [chunk] = (await read(body, 'text/plain', 5)) as SatelliteInput[][];
+      expect(chunk).toHaveLength(2);
+      expect(chunk[0]).toEqual({ ...ISS, name: 'ISS (ZARYA)' });
+      expect(chunk[1].line2).toBe(ISS.line2);
+    });
+
+    it('should reject a line over the cap before the body ends', async () => {
+      const text = Buffer.from(`${ISS.line1}\n${'2'.repeat(200)}\n`);
+      await expect(read(text, 'text/plain')).rejects.toThrow('Line 2: longer than 80 characters');
+
+      // No line break at all: rejected once the buffered line passes the cap
+      let served = 0;
+      const endless = new Readable({
+        read() {
+          served += 1;
+          this.push(served > 1000 ? null : Buffer.alloc(1024, 'x'));
+        },
+      });
+      const chunks = streamSatelliteChunks(endless, 'application/x-ndjson', 1024);
+      await expect(chunks.next()).rejects.toThrow('Line 1: longer than 65536 characters');
+      expect(served).toBeLessThan(100);
+    });
+  });
+});
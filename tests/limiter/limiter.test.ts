@@ -0,0 +1,148 @@
+/**
+ * Concurrency Limiter Test Suite
+ *
+ * Checks the request limiter (lib/limiter.ts): requests past the limit are
+ * shed with 503 and Retry-After, capacity returns as requests finish,
+ * health and stats are never shed, and the adaptive limit grows while
+ * latency holds and backs off when the pool's queue wait rises.
+ */
+
+import { describe, it, expect, afterAll } from 'vitest';
+import { EventEmitter } from 'events';
+import type { Request, Response } from 'express';
+import { ConcurrencyLimiter } from '../../lib/limiter.js';
+import { writeFileSync, mkdirSync } from 'fs';
+import { join, dirname } from 'path';
+import { fileURLToPath } from 'url';
+
+// Results directory for this test suite
+const __filename = fileURLToPath(import.meta.url);
+const __dirname = dirname(__filename);
+const RESULTS_DIR = join(__dirname, 'results');
+
+// Ensure results directory exists
+mkdirSync(RESULTS_DIR, { recursive: true });
+
+/**
+ * Write test results to the results directory
+ */
+function writeTestResult(filename: string, data: unknown): void {
+  const filepath = join(RESULTS_DIR, filename);
+  writeFileSync(filepath, JSON.stringify(data, null, 2));
+}
+
+/** A response as the middleware leaves it */
+interface FakeResponse extends EventEmitter {
+  statusCode: number;
+  headers: Record<string, string>;
+  body?: unknown;
+}
+
+const sleep = (ms: number) => new Promise((resolve) => setTimeout(resolve, ms));
+
+/**
+ * Run one request through the limiter; returns its response and whether it
+ * was passed on to the handler
+ */
+function request(limiter: ConcurrencyLimiter, method = 'POST', path = '/api/spice/sgp4/propagate') {
+  const res = Object.assign(new EventEmitter(), { statusCode: 200, headers: {} as Record<string, string> }) as FakeResponse;
+  const response = Object.assign(res, {
+    set: (name: string, value: string) => ((res.headers[name] = value), response),
+    status: (code: number) => ((res.statusCode = code), response),
+    json: (body: unknown) => ((res.body = body), response),
+  });
+  let admitted = false;
+  limiter.middleware()({ method, path } as Request, response as unknown as Response, () => (admitted = true));
+  return { res, admitted };
+}
+
+describe('Concurrency Limiter', () => {
+  const testResults: Record<string, unknown> = {
+    suite: 'Concurrency Limiter',
+    tests: {} as Record<string, unknown>,
+  };
+
+  afterAll(() => {
+    delete process.env.SGP4_CONCURRENCY_LIMIT;
+    writeTestResult('limiter-results.json', testResults);
+  });
+
+  it('should shed requests past a fixed limit until one finishes', () => {
+    process.env.SGP4_CONCURRENCY_LIMIT = '3';
+    const limiter = new ConcurrencyLimiter(2, () => 0);
+    expect(limiter.stats.mode).toBe('fixed');
+
+    const held = [request(limiter), request(limiter), request(limiter)];
+    expect(held.every((r) => r.admitted)).toBe(true);
+
+    const rejected = request(limiter);
+    expect(rejected.admitted).toBe(false);
+    expect(rejected.res.statusCode).toBe(503);
+    expect(rejected.res.headers['Retry-After']).toBe('1');
+
+    // Finish and close of one response free one slot between them
+    held[0].res.emit('finish');
+    held[0].res.emit('close');
+    expect(limiter.stats.inFlight).toBe(2);
+    expect(request(limiter).admitted).toBe(true);
+    expect(request(limiter).admitted).toBe(false);
+
+    const stats = limiter.stats;
+    expect(stats.shed).toBe(2);
+    expect(stats.inFlight).toBe(3);
+    expect(stats.limit).toBe(3);
+
+    (testResults.tests as Record<string, unknown>).fixed = { limit: stats.limit, shed: stats.shed };
+  });
+
+  it('should never shed health and stats requests, nor anything when off', () => {
+    process.env.SGP4_CONCURRENCY_LIMIT = '1';
+    const limiter = new ConcurrencyLimiter(2, () => 0);
+    expect(request(limiter).admitted).toBe(true);
+    expect(request(limiter, 'GET', '/api/spice/sgp4/health').admitted).toBe(true);
+    expect(request(limiter, 'GET', '/api/spice/sgp4/pool/stats').admitted).toBe(true);
+    expect(request(limiter, 'POST', '/api/spice/sgp4/health').admitted).toBe(false);
+
+    delete process.env.SGP4_CONCURRENCY_LIMIT;
+    const off = new ConcurrencyLimiter(2, () => 0);
+    expect(off.stats.mode).toBe('off');
+    for (let i = 0; i < 100; i++) {
+      expect(request(off).admitted).toBe(true);
+    }
+    expect(off.stats.shed).toBe(0);
+  });
+
+  it('should raise the adaptive limit while latency holds and back off on queue wait', async () => {
+    process.env.SGP4_CONCURRENCY_LIMIT = 'adaptive';
+    let queueWait = 0;
+    const limiter = new ConcurrencyLimiter(2, () => queueWait);
+    const initial = limiter.stats.limit;
+    expect(limiter.stats.mode).toBe('adaptive');
+    expect(initial).toBe(8);
+
+    // Keep the limit in use, completing one request at a time at steady latency
+    const inFlight: FakeResponse[] = [];
+    for (let i = 0; i < 200; i++) {
+      let next = request(limiter);
+      while (next.admitted) {
+        inFlight.push(next.res);
+        next = request(limiter);
+      }
+      inFlight.shift()!.emit('finish');
+    }
+    const grown = limiter.stats.limit;
+    expect(grown).toBeGreaterThan(initial);
+    expect(grown).toBeLessThanOrEqual(limiter.maxLimit);
+
+    // Queue wait far above the request latency: multiplicative decrease at
+    // the next congestion check
+    queueWait = 1e6;
+    await sleep(1100);
+    const stats = limiter.stats;
+    expect(stats.backoffs).toBeGreaterThanOrEqual(1);
+    expect(stats.limit).toBeLessThan(grown);
+    expect(stats.limit).toBeGreaterThanOrEqual(limiter.minLimit);
+
+    (testResults.tests as Record<string, unknown>).adaptive = { initial, grown, afterBackoff: stats.limit };
+  });
+});
@@ -0,0 +1,119 @@
+/**
+ * Ephemeris Pyramid Test Suite
+ *
+ * Checks windows served by EphemerisPyramidCache (lib/lod.ts) across tile
+ * boundaries at every level: samples are evenly spaced by the reported
+ * step, lie on ET multiples of it, and match the satellite propagated
+ * directly at those times; repeated windows are served from cache.
+ */
+
+import { describe, it, expect, afterAll } from 'vitest';
+import { EphemerisPyramidCache } from '../../lib/lod.js';
+import type { SGP4NativeWorkerPool } from '../../lib/worker-pool-native.js';
+import type { PropagateTask } from '../../lib/worker-types.js';
+import { createExtendedNativeSGP4, type NativeSGP4Module } from '../../dist/sgp4-native.js';
+import { writeFileSync, mkdirSync } from 'fs';
+import { join, dirname } from 'path';
+import { fileURLToPath } from 'url';
+
+// Results directory for this test suite
+const __filename = fileURLToPath(import.meta.url);
+const __dirname = dirname(__filename);
+const RESULTS_DIR = join(__dirname, 'results');
+
+// Ensure results directory exists
+mkdirSync(RESULTS_DIR, { recursive: true });
+
+/**
+ * Write test results to the results directory
+ */
+function writeTestResult(filename: string, data: unknown): void {
+  const filepath = join(RESULTS_DIR, filename);
+  writeFileSync(filepath, JSON.stringify(data, null, 2));
+}
+
+// The native addon is only built for the native server image
+const native: NativeSGP4Module | undefined = await createExtendedNativeSGP4()
+  .then(async (m) => (await m.init(), m))
+  .catch(() => undefined);
+
+describe.skipIf(!native)('Ephemeris Pyramid', () => {
+  const testResults: Record<string, unknown> = {
+    suite: 'Ephemeris Pyramid',
+    tests: {} as Record<string, unknown>,
+  };
+
+  afterAll(() => {
+    writeTestResult('lod-results.json', testResults);
+  });
+
+  const ISS = {
+    line1: '1 25544U 98067A   24015.50000000  .00016717  00000-0  10270-3 0  9025',
+    line2: '2 25544  51.6400 208.9163 0006703  30.0825 330.0579 15.49560830    19',
+  };
+
+  /** A pool propagating its tiles in-process */
+  const pool = {
+    propagate: async (task: Omit<PropagateTask, 'type' | 'taskId'>) => {
+      const { et0, etf, step } = task.times;
+      const tle = native!.parseTLE(task.tle.line1, task.tle.line2);
+      return { packed: native!.propagateRangePacked(tle, et0, etf, step) };
+    },
+  } as unknown as SGP4NativeWorkerPool;
+
+  it('should keep every level evenly spaced across tile boundaries', async () => {
+    // Day tiles at 10 s: the steps of levels 4 and 5 (2560 s, 10240 s) do
+    // not divide the tile length
+    const lod = new EphemerisPyramidCache(pool, 10, 86400);
+    const et0 = native!.utcToET('2024-01-15T12:00:00');
+    const etf = et0 + 3 * 86400;
+    const tle = native!.parseTLE(ISS.line1, ISS.line2);
+    const served: Array<{ level: number; step: number; points: number }> = [];
+
+    for (let level = 0; level < lod.levels; level++) {
+      const step = lod.levelStep(level);
+      const maxPoints = Math.floor((etf - et0) / step) + 1;
+      const window = await lod.window(ISS, 'wgs72', 'TEME', et0, etf, maxPoints);
+      expect(window.level).toBe(level);
+      expect(window.step).toBe(step);
+
+      const n = window.packed.length / 7;
+      expect(n).toBeGreaterThan(3);
+      const first = window.packed[0];
+      expect(first % step).toBe(0);
+      expect(first - et0).toBeLessThan(step);
+      for (let i = 1; i < n; i++) {
+        expect(window.packed[i] - window.packed[i - 1], `level ${level} row ${i}`).toBe(step);
+      }
+
+      // Same states as a direct propagation on the level's grid
+      const direct = native!.propagateRangePacked(tle, first, first + (n - 1) * step, step);
+      let km = 0;
+      for (let i = 0; i < direct.length; i++) {
+        km = Math.max(km, Math.abs(window.packed[i] - direct[i]));
+      }
+      expect(km).toBeLessThan(1e-6);
+
+      served.push({ level, step, points: n });
+    }
+
+    (testResults.tests as Record<string, unknown>).levels = served;
+  });
+
+  it('should serve a repeated window from cached tiles', async () => {
+    const lod = new EphemerisPyramidCache(pool, 10, 86400);
+    const et0 = native!.utcToET('2024-01-15T12:00:00');
+    const a = await lod.window(ISS, 'wgs72', 'TEME', et0, et0 + 86400, 500);
+    const b = await lod.window(ISS, 'wgs72', 'TEME', et0, et0 + 86400, 500);
+    expect([a.hits, a.misses]).toEqual([0, 2]);
+    expect([b.hits, b.misses]).toEqual([2, 0]);
+    expect(Array.from(b.packed)).toEqual(Array.from(a.packed));
+    expect(lod.stats.tiles).toBe(2);
+  });
+
+  it('should round the tile length up to the base step', () => {
+    const lod = new EphemerisPyramidCache(pool, 7, 86400);
+    expect(lod.tileSeconds % 7).toBe(0);
+    expect(lod.tileSeconds - 86400).toBeLessThan(7);
+  });
+});
@@ -0,0 +1,178 @@
+/**
+ * OEM Formatting Test Suite
+ *
+ * Tests for CCSDS 502.0-B-2 Orbit Ephemeris Message output in KVN and XML,
+ * single and multi-segment, and for the native data-line serializer.
+ */
+
+import { describe, it, expect, afterAll } from 'vitest';
+import {
+  buildOEMMetadata,
+  formatOEMFooter,
+  formatOEMHeader,
+  formatOEMSegmentFooter,
+  formatOEMSegmentHeader,
+  formatOEMStates,
+  type OEMFormat,
+  type OEMMetadata,
+} from '../../lib/oem.js';
+import { createExtendedNativeSGP4, type NativeSGP4Module } from '../../dist/sgp4-native.js';
+import type { PropagateState } from '../../lib/worker-types.js';
+import { writeFileSync, mkdirSync } from 'fs';
+import { join, dirname } from 'path';
+import { fileURLToPath } from 'url';
+
+// Results directory for this test suite
+const __filename = fileURLToPath(import.meta.url);
+const __dirname = dirname(__filename);
+const RESULTS_DIR = join(__dirname, 'results');
+
+// Ensure results directory exists
+mkdirSync(RESULTS_DIR, { recursive: true });
+
+/**
+ * Write test results to the results directory
+ */
+function writeTestResult(filename: string, data: unknown): void {
+  const filepath = join(RESULTS_DIR, filename);
+  writeFileSync(filepath, JSON.stringify(data, null, 2));
+}
+
+// The native addon is only built for the native server image
+const native: NativeSGP4Module | undefined = await createExtendedNativeSGP4()
+  .then(async (m) => (await m.init(), m))
+  .catch(() => undefined);
+
+describe('OEM Formatting', () => {
+  const testResults: Record<string, unknown> = {
+    suite: 'OEM Formatting',
+    tests: {} as Record<string, unknown>,
+  };
+
+  afterAll(() => {
+    writeTestResult('oem-formatting-results.json', testResults);
+  });
+
+  const ISS = {
+    name: 'ISS (ZARYA)',
+    line1: '1 25544U 98067A   24015.50000000  .00016717  00000-0  10270-3 0  9025',
+    line2: '2 25544  51.6400 208.9163 0006703  30.0825 330.0579 15.49560830    19',
+  };
+  const GPS = {
+    line1: '1 24876U 97035A   24015.50000000  .00000020  00000-0  00000-0 0  9990',
+    line2: '2 24876  55.4400 100.0000 0050000  50.0000 310.0000  2.00564000    10',
+  };
+
+  const STATES: PropagateState[] = [
+    {
+      datetime: '2024-01-15T12:00:00.000Z',
+      et: 758592069.184,
+      position: [-5942.639628, -3291.296542, 9.486008],
+      velocity: [2.313477992, -4.154517085, 6.008181535],
+    },
+    {
+      datetime: '2024-01-15T12:01:00.000Z',
+      et: 758592129.184,
+      position: [-5790.054988, -3533.250535, 370.300752],
+      velocity: [2.761976906, -3.893638946, 5.993663498],
+    },
+  ];
+
+  const metaOf = (sat: typeof ISS, name?: string): OEMMetadata =>
+    buildOEMMetadata({ ...sat, name }, 'TEME', STATES[0].datetime, STATES[1].datetime);
+
+  /** A complete message with one segment per metadata block */
+  const message = (metas: OEMMetadata[], format: OEMFormat): string =>
+    metas
+      .map(
+        (meta, i) =>
+          (i === 0 ? formatOEMHeader(meta, format) : formatOEMSegmentFooter(format) + formatOEMSegmentHeader(meta, format)) +
+          formatOEMStates(STATES, format)
+      )
+      .join('') + formatOEMFooter(format);
+
+  describe('metadata', () => {
+    it('should take OBJECT_ID from the international designator', () => {
+      const meta = metaOf(ISS, 'ISS (ZARYA)');
+      expect(meta.OBJECT_NAME).toBe('ISS (ZARYA)');
+      expect(meta.OBJECT_ID).toBe('1998-067A');
+      expect(meta.START_TIME).toBe('2024-01-15T12:00:00.000');
+      expect(meta.STOP_TIME).toBe('2024-01-15T12:01:00.000');
+      (testResults.tests as Record<string, unknown>).metadata = meta;
+    });
+  });
+
+  describe('KVN', () => {
+    it('should write header, metadata block and one data line per state', () => {
+      const text = message([metaOf(ISS, 'ISS (ZARYA)')], 'kvn');
+      const lines = text.trim().split('\n');
+      expect(lines[0]).toBe('CCSDS_OEM_VERS = 2.0');
+      expect(text).toContain('\nMETA_START\nOBJECT_NAME = ISS (ZARYA)\nOBJECT_ID = 1998-067A\n');
+      expect(text).toContain('REF_FRAME = TEME\nTIME_SYSTEM = UTC\n');
+      expect(lines.slice(-2)).toEqual([
+        '2024-01-15T12:00:00.000 -5942.639628 -3291.296542 9.486008 2.313477992 -4.154517085 6.008181535',
+        '2024-01-15T12:01:00.000 -5790.054988 -3533.250535 370.300752 2.761976906 -3.893638946 5.993663498',
+      ]);
+      (testResults.tests as Record<string, unknown>).kvn = text;
+    });
+
+    it('should write a META_START..META_STOP block per segment', () => {
+      const text = message([metaOf(ISS, 'ISS'), metaOf(GPS, 'GPS')], 'kvn');
+      expect(text.match(/^CCSDS_OEM_VERS/gm)).toHaveLength(1);
+      expect(text.match(/^META_START$/gm)).toHaveLength(2);
+      expect(text.match(/^META_STOP$/gm)).toHaveLength(2);
+      expect(text.indexOf('OBJECT_ID = 1997-035A')).toBeGreaterThan(text.indexOf('2024-01-15T12:01:00.000'));
+    });
+  });
+
+  describe('XML', () => {
+    it('should nest metadata and state vectors in balanced elements', () => {
+      const text = message([metaOf(ISS, 'ISS & co <1>')], 'xml');
+      expect(text.startsWith('<?xml version="1.0" encoding="UTF-8"?>\n<oem id="CCSDS_OEM_VERS" version="2.0">')).toBe(true);
+      expect(text).toContain('<OBJECT_NAME>ISS &amp; co &lt;1&gt;</OBJECT_NAME>');
+      for (const tag of ['oem', 'header', 'body', 'segment', 'metadata', 'data', 'stateVector']) {
+        expect(text.match(new RegExp(`<${tag}[ >]`, 'g'))?.length).toBe(text.match(new RegExp(`</${tag}>`, 'g'))?.length);
+      }
+      expect(text.match(/<stateVector>/g)).toHaveLength(2);
+      expect(text).toContain('<X_DOT>2.313477992</X_DOT>');
+      expect(text.endsWith('    </segment>\n  </body>\n</oem>\n')).toBe(true);
+      (testResults.tests as Record<string, unknown>).xml = text;
+    });
+
+    it('should close each segment before opening the next', () => {
+      const text = message([metaOf(ISS, 'ISS'), metaOf(GPS, 'GPS')], 'xml');
+      expect(text.match(/<segment>/g)).toHaveLength(2);
+      expect(text).toContain('      </data>\n    </segment>\n    <segment>\n      <metadata>\n');
+    });
+  });
+
+  describe.skipIf(!native)('native serializer', () => {
+    const packedOf = (states: PropagateState[]): Float64Array => {
+      const n = states.length;
+      const packed = new Float64Array(n * 7);
+      states.forEach((s, i) => {
+        [s.et, ...s.position, ...s.velocity].forEach((v, c) => (packed[c * n + i] = v));
+      });
+      return packed;
+    };
+
+    it('should match the JS data lines in both encodings', () => {
+      const states = STATES.map((s) => ({ ...s, datetime: native!.etToUTC(s.et) }));
+      for (const format of ['kvn', 'xml'] as const) {
+        expect(native!.formatEphemeris(packedOf(states), 0, states.length, format)).toBe(formatOEMStates(states, format));
+      }
+    });
+
+    it('should format a chunk of rows', () => {
+      const states = STATES.map((s) => ({ ...s, datetime: native!.etToUTC(s.et) }));
+      expect(native!.formatEphemeris(packedOf(states), 1, 1, 'kvn')).toBe(formatOEMStates(states.slice(1), 'kvn'));
+    });
+
+    it('should not overflow on extreme values', () => {
+      const huge: PropagateState = { ...STATES[0], position: [1e300, -1e300, 1e300], velocity: [1e300, 1e300, -1e300] };
+      const line = native!.formatEphemeris(packedOf([huge]), 0, 1, 'kvn');
+      expect(line.split(' ')).toHaveLength(7);
+      expect(line.length).toBeGreaterThan(1800);
+    });
+  });
+});
@@ -0,0 +1,135 @@
+/**
+ * State Partials Test Suite
+ *
+ * Checks the forward-mode Jacobian of propagateRangePartials() against
+ * central finite differences of propagateRangePacked() for each of
+ * (inclo, nodeo, ecco, argpo, mo, no, bstar), and that its states match the
+ * plain sweep.
+ */
+
+import { describe, it, expect, afterAll } from 'vitest';
+import { createExtendedNativeSGP4, type NativeSGP4Module } from '../../dist/sgp4-native.js';
+import type { TLEElements } from '../../lib/types.js';
+import { writeFileSync, mkdirSync } from 'fs';
+import { join, dirname } from 'path';
+import { fileURLToPath } from 'url';
+
+// Results directory for this test suite
+const __filename = fileURLToPath(import.meta.url);
+const __dirname = dirname(__filename);
+const RESULTS_DIR = join(__dirname, 'results');
+
+// Ensure results directory exists
+mkdirSync(RESULTS_DIR, { recursive: true });
+
+/**
+ * Write test results to the results directory
+ */
+function writeTestResult(filename: string, data: unknown): void {
+  const filepath = join(RESULTS_DIR, filename);
+  writeFileSync(filepath, JSON.stringify(data, null, 2));
+}
+
+// The native addon is only built for the native server image
+const native: NativeSGP4Module | undefined = await createExtendedNativeSGP4()
+  .then(async (m) => (await m.init(), m))
+  .catch(() => undefined);
+
+/** Index in TLEElements.elements of each partials column */
+const COLUMNS = [
+  { name: 'inclo', element: 3, h: 1e-6 },
+  { name: 'nodeo', element: 4, h: 1e-6 },
+  { name: 'ecco', element: 5, h: 1e-7 },
+  { name: 'argpo', element: 6, h: 1e-6 },
+  { name: 'mo', element: 7, h: 1e-6 },
+  { name: 'no', element: 8, h: 1e-9 },
+  // Positions move by ~1e9 km per unit bstar after a day; the step keeps
+  // the second-order term below the tolerance
+  { name: 'bstar', element: 2, h: 1e-10 },
+];
+
+describe.skipIf(!native)('State Partials', () => {
+  const testResults: Record<string, unknown> = {
+    suite: 'State Partials',
+    tests: {} as Record<string, unknown>,
+  };
+
+  afterAll(() => {
+    writeTestResult('partials-results.json', testResults);
+  });
+
+  // Drag-free TLEs: with bstar != 0 the kernel's velocities leave out the
+  // drag term, so they would not be the rate of its positions
+  const SATELLITES = [
+    {
+      line1: '1 99001U 24001A   24015.50000000  .00000000  00000-0  00000-0 0  9990',
+      line2: '2 99001  51.6400 208.9163 0006703  30.0825 330.0579 15.49560830    10',
+    },
+    {
+      line1: '1 99002U 24001A   24015.50000000  .00000000  00000-0  00000-0 0  9990',
+      line2: '2 99002  97.7000  10.0000 0150000  90.0000 270.0000 14.20000000    10',
+    },
+  ];
+
+  /** One day at hourly steps from the TLE epoch */
+  const grid = (tle: TLEElements) => ({ et0: tle.elements[9], etf: tle.elements[9] + 86400, step: 3600 });
+
+  /** The TLE with one element moved by delta */
+  const nudged = (tle: TLEElements, element: number, delta: number): TLEElements => {
+    const elements = Float64Array.from(tle.elements);
+    elements[element] += delta;
+    return { ...tle, elements };
+  };
+
+  it('should match central finite differences in every column', () => {
+    const worst: Record<string, number> = {};
+
+    for (const sat of SATELLITES) {
+      const tle = native!.parseTLE(sat.line1, sat.line2);
+      const { et0, etf, step } = grid(tle);
+      const { packed, partials } = native!.propagateRangePartials(tle, et0, etf, step);
+      const n = packed.length / 7;
+
+      COLUMNS.forEach(({ name, element, h }, k) => {
+        const plus = native!.propagateRangePacked(nudged(tle, element, h), et0, etf, step);
+        const minus = native!.propagateRangePacked(nudged(tle, element, -h), et0, etf, step);
+        // Error relative to the column's largest entry
+        let error = 0;
+        let scale = 0;
+        for (let i = 0; i < n; i++) {
+          for (let r = 0; r < 6; r++) {
+            const fd = (plus[(r + 1) * n + i] - minus[(r + 1) * n + i]) / (2 * h);
+            const analytic = partials[i * 42 + r * 7 + k];
+            error = Math.max(error, Math.abs(fd - analytic));
+            scale = Math.max(scale, Math.abs(analytic));
+          }
+        }
+        expect(scale).toBeGreaterThan(0);
+        worst[name] = Math.max(worst[name] ?? 0, error / scale);
+      });
+    }
+
+    for (const [name, relative] of Object.entries(worst)) {
+      expect(relative, name).toBeLessThan(1e-6);
+    }
+
+    (testResults.tests as Record<string, unknown>).finiteDifference = worst;
+  });
+
+  it('should return the same states as the plain sweep', () => {
+    let km = 0;
+    for (const sat of SATELLITES) {
+      const tle = native!.parseTLE(sat.line1, sat.line2);
+      const { et0, etf, step } = grid(tle);
+      const { packed } = native!.propagateRangePartials(tle, et0, etf, step);
+      const plain = native!.propagateRangePacked(tle, et0, etf, step);
+      expect(packed.length).toBe(plain.length);
+      for (let i = 0; i < plain.length; i++) {
+        km = Math.max(km, Math.abs(packed[i] - plain[i]));
+      }
+    }
+    expect(km).toBeLessThan(1e-8);
+
+    (testResults.tests as Record<string, unknown>).states = { worstDifference: km };
+  });
+});
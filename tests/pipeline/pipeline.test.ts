@@ -0,0 +1,117 @@
+/**
+ * Pipeline Sharding Test Suite
+ *
+ * Checks that executePipeline() merges worker shards in input order and
+ * applies max_rows to the merged rows: a cap is filled even when every
+ * selected row comes from one shard, and truncated is set only when rows
+ * were dropped.
+ */
+
+import { describe, it, expect, afterAll } from 'vitest';
+import { encodePipeline, executePipeline, runPipeline, type PipelineStage } from '../../lib/pipeline.js';
+import type { SGP4NativeWorkerPool } from '../../lib/worker-pool-native.js';
+import type { PipelineTask } from '../../lib/worker-types.js';
+import { createExtendedNativeSGP4, type NativeSGP4Module } from '../../dist/sgp4-native.js';
+import { writeFileSync, mkdirSync } from 'fs';
+import { join, dirname } from 'path';
+import { fileURLToPath } from 'url';
+
+// Results directory for this test suite
+const __filename = fileURLToPath(import.meta.url);
+const __dirname = dirname(__filename);
+const RESULTS_DIR = join(__dirname, 'results');
+
+// Ensure results directory exists
+mkdirSync(RESULTS_DIR, { recursive: true });
+
+/**
+ * Write test results to the results directory
+ */
+function writeTestResult(filename: string, data: unknown): void {
+  const filepath = join(RESULTS_DIR, filename);
+  writeFileSync(filepath, JSON.stringify(data, null, 2));
+}
+
+// The native addon is only built for the native server image
+const native: NativeSGP4Module | undefined = await createExtendedNativeSGP4()
+  .then(async (m) => (await m.init(), m))
+  .catch(() => undefined);
+
+describe.skipIf(!native)('Pipeline Sharding', () => {
+  const testResults: Record<string, unknown> = {
+    suite: 'Pipeline Sharding',
+    tests: {} as Record<string, unknown>,
+  };
+
+  afterAll(() => {
+    writeTestResult('pipeline-results.json', testResults);
+  });
+
+  // Three LEO objects, then a Molniya orbit: only the last reaches 10,000 km
+  const SATELLITES = [
+    {
+      line1: '1 25544U 98067A   24015.50000000  .00016717  00000-0  10270-3 0  9025',
+      line2: '2 25544  51.6400 208.9163 0006703  30.0825 330.0579 15.49560830    19',
+    },
+    {
+      line1: '1 43013U 17073A   24015.50000000  .00000100  00000-0  50000-4 0  9990',
+      line2: '2 43013  97.7000  10.0000 0001000  90.0000 270.0000 14.80000000    10',
+    },
+    {
+      line1: '1 28654U 05018A   24015.50000000  .00000090  00000-0  70000-4 0  9990',
+      line2: '2 28654  99.0000  45.0000 0014000  80.0000 280.0000 14.12000000    10',
+    },
+    {
+      line1: '1 40296U 14069A   24015.50000000  .00000100  00000-0  00000-0 0  9990',
+      line2: '2 40296  63.4000 300.0000 7000000 270.0000  10.0000  2.00600000    10',
+    },
+  ];
+
+  const STAGES: PipelineStage[] = [
+    { derive: ['alt'] },
+    { filter: { column: 'alt', op: 'gt', value: 10000 } },
+    { select: ['et', 'alt'] },
+  ];
+
+  /** A pool of four workers, each running its shard in-process */
+  const pool = {
+    stats: { poolSize: 4 },
+    runPipeline: async (task: Omit<PipelineTask, 'type' | 'taskId'>) =>
+      runPipeline(native!, task.tles, task.stages, task.times, task.maxRows),
+  } as unknown as SGP4NativeWorkerPool;
+
+  const request = (maxRows: number) => {
+    const et0 = native!.utcToET('2024-01-15T12:00:00');
+    return {
+      tles: SATELLITES,
+      stages: encodePipeline(STAGES),
+      times: { et0, etf: et0 + 86400, step: 60 },
+      model: 'wgs72',
+      maxRows,
+    };
+  };
+
+  it('should fill max_rows when every row comes from one shard', async () => {
+    const all = await executePipeline(pool, request(0));
+    expect(all.truncated).toBe(false);
+    expect(new Set(all.rowSat)).toEqual(new Set([3]));
+    expect(all.rowSat.length).toBeGreaterThan(100);
+
+    const capped = await executePipeline(pool, request(100));
+    expect(capped.truncated).toBe(true);
+    expect(capped.rowSat.length).toBe(100);
+    expect(Array.from(capped.rows)).toEqual(Array.from(all.rows.subarray(0, 100 * all.nSelect)));
+
+    (testResults.tests as Record<string, unknown>).oneShard = { rows: all.rowSat.length, capped: capped.rowSat.length };
+  });
+
+  it('should not report truncation when no row was dropped', async () => {
+    const rows = (await executePipeline(pool, request(0))).rowSat.length;
+    for (const maxRows of [rows, rows + 1]) {
+      const out = await executePipeline(pool, request(maxRows));
+      expect(out.truncated).toBe(false);
+      expect(out.rowSat.length).toBe(rows);
+    }
+    expect((await executePipeline(pool, request(rows - 1))).truncated).toBe(true);
+  });
+});
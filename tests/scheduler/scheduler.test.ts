@@ -0,0 +1,185 @@
+/**
+ * Task Scheduler Test Suite
+ *
+ * Checks the pools' task queue (lib/scheduler.ts): dispatch shares by QoS
+ * class, fairness between tenants of one class, earliest-deadline dispatch,
+ * and DeadlineError for deadlines that cannot be met at submission or that
+ * pass while queued.
+ */
+
+import { describe, it, expect, afterAll } from 'vitest';
+import {
+  DeadlineError,
+  TaskScheduler,
+  schedulingContext,
+  type QoSClass,
+  type Schedulable,
+} from '../../lib/scheduler.js';
+import { writeFileSync, mkdirSync } from 'fs';
+import { join, dirname } from 'path';
+import { fileURLToPath } from 'url';
+
+// Results directory for this test suite
+const __filename = fileURLToPath(import.meta.url);
+const __dirname = dirname(__filename);
+const RESULTS_DIR = join(__dirname, 'results');
+
+// Ensure results directory exists
+mkdirSync(RESULTS_DIR, { recursive: true });
+
+/**
+ * Write test results to the results directory
+ */
+function writeTestResult(filename: string, data: unknown): void {
+  const filepath = join(RESULTS_DIR, filename);
+  writeFileSync(filepath, JSON.stringify(data, null, 2));
+}
+
+/** A queued task labelled for the assertions */
+interface Task extends Schedulable {
+  label: string;
+  error?: Error;
+}
+
+/** Every worker busy, so admitted tasks queue */
+const BUSY = { size: 4, idle: 0 };
+
+/** Points costing 1 ms each at the scheduler's initial estimate */
+const POINTS = 1000;
+
+const sleep = (ms: number) => new Promise((resolve) => setTimeout(resolve, ms));
+
+/**
+ * Admit and queue a task as a request with the given class, tenant and
+ * deadline budget would
+ */
+function submit(
+  scheduler: TaskScheduler<Task>,
+  label: string,
+  qos: QoSClass,
+  tenant: string,
+  options: { budgetMs?: number; points?: number; workers?: { size: number; idle: number } } = {}
+): Task {
+  const task: Task = { label, reject: (error) => (task.error = error) };
+  const deadline = options.budgetMs === undefined ? undefined : performance.now() + options.budgetMs;
+  schedulingContext.run({ qos, tenant, deadline }, () => {
+    scheduler.admit(task, 'propagate', options.points ?? POINTS, options.workers ?? BUSY);
+  });
+  scheduler.enqueue(task);
+  return task;
+}
+
+/** Dispatch up to n queued tasks in scheduler order */
+function dispatch(scheduler: TaskScheduler<Task>, n = Infinity): Task[] {
+  const order: Task[] = [];
+  let task: Task | undefined;
+  while (order.length < n && (task = scheduler.next())) {
+    scheduler.dispatched(task);
+    order.push(task);
+  }
+  return order;
+}
+
+describe('Task Scheduler', () => {
+  const testResults: Record<string, unknown> = {
+    suite: 'Task Scheduler',
+    tests: {} as Record<string, unknown>,
+  };
+
+  afterAll(() => {
+    writeTestResult('scheduler-results.json', testResults);
+  });
+
+  it('should share dispatches between backlogged classes by their weights', () => {
+    const scheduler = new TaskScheduler<Task>();
+    for (let i = 0; i < 20; i++) {
+      for (const qos of ['bulk', 'standard', 'interactive'] as const) {
+        submit(scheduler, qos, qos, 'ops');
+      }
+    }
+
+    // Equal costs: the first 21 dispatches split 16:4:1
+    const first = dispatch(scheduler, 21);
+    const counts = { interactive: 0, standard: 0, bulk: 0 };
+    first.forEach((t) => counts[t.label as QoSClass]++);
+    expect(counts).toEqual({ interactive: 16, standard: 4, bulk: 1 });
+    expect(first[0].label).toBe('interactive');
+    expect(scheduler.stats.dispatched).toEqual(counts);
+
+    (testResults.tests as Record<string, unknown>).classShares = counts;
+  });
+
+  it('should not hold a tenant behind another tenant of the same class', () => {
+    const scheduler = new TaskScheduler<Task>();
+    for (let i = 0; i < 10; i++) {
+      submit(scheduler, `a${i}`, 'bulk', 'tenant-a');
+    }
+    submit(scheduler, 'b0', 'bulk', 'tenant-b');
+    expect(scheduler.stats.activeFlows).toBe(2);
+
+    const order = dispatch(scheduler).map((t) => t.label);
+    expect(order.indexOf('b0')).toBeLessThanOrEqual(1);
+    // Tenant A's own tasks keep their submission order
+    expect(order.filter((l) => l.startsWith('a'))).toEqual(Array.from({ length: 10 }, (_, i) => `a${i}`));
+
+    (testResults.tests as Record<string, unknown>).tenantFairness = { order };
+  });
+
+  it('should dispatch an urgent deadline task ahead of the fair queue', async () => {
+    const scheduler = new TaskScheduler<Task>();
+    // One 50 ms task raises the mean service time to about 11 ms and the
+    // cost estimate to 0.05 ms/point
+    const warm = submit(scheduler, 'warm', 'standard', 'ops');
+    dispatch(scheduler);
+    await sleep(50);
+    scheduler.completed(warm);
+
+    for (let i = 0; i < 5; i++) {
+      submit(scheduler, `i${i}`, 'interactive', 'ops');
+    }
+    submit(scheduler, 'due', 'bulk', 'ops', { budgetMs: 1000 });
+    // Latest start within a mean service time: urgent, ahead of the
+    // interactive tasks with smaller finish tags
+    submit(scheduler, 'sooner', 'bulk', 'ops', { budgetMs: 10, points: 20, workers: { size: 4, idle: 1 } });
+
+    const order = dispatch(scheduler, 2).map((t) => t.label);
+    expect(order).toEqual(['sooner', 'i0']);
+    expect(scheduler.stats.edfDispatches).toBe(1);
+  });
+
+  it('should reject a deadline that cannot be met at submission', () => {
+    const scheduler = new TaskScheduler<Task>();
+    // Estimated 1000 ms of service against a 5 ms budget
+    expect(() => submit(scheduler, 'late', 'interactive', 'ops', { budgetMs: 5, points: 1e6 })).toThrow('Deadline cannot be met');
+
+    // On one worker, 900 ms of deadline work due first stands in front of a
+    // 200 ms task due at the same time, but not in front of an earlier one
+    const one = { size: 1, idle: 0 };
+    for (let i = 0; i < 9; i++) {
+      submit(scheduler, `q${i}`, 'standard', 'ops', { budgetMs: 1000, points: 100000, workers: one });
+    }
+    expect(() => submit(scheduler, 'behind', 'standard', 'ops', { budgetMs: 1000, points: 200000, workers: one })).toThrow(
+      'Deadline cannot be met'
+    );
+    expect(submit(scheduler, 'fits', 'standard', 'ops', { budgetMs: 500, points: 200000, workers: one }).schedule).toBeDefined();
+
+    const stats = scheduler.stats;
+    expect(stats.deadlineRejected).toBe(2);
+    expect(stats.queued.standard).toBe(10);
+    expect(new DeadlineError('x').status).toBe(503);
+
+    (testResults.tests as Record<string, unknown>).deadlineRejected = stats.deadlineRejected;
+  });
+
+  it('should drop a task whose deadline passes while queued', async () => {
+    const scheduler = new TaskScheduler<Task>();
+    const expiring = submit(scheduler, 'expiring', 'standard', 'ops', { budgetMs: 20 });
+    const other = submit(scheduler, 'other', 'standard', 'ops');
+    await sleep(30);
+
+    expect(dispatch(scheduler)).toEqual([other]);
+    expect(expiring.error instanceof DeadlineError).toBe(true);
+    expect(scheduler.stats.deadlineExpired).toBe(1);
+    expect(scheduler.length).toBe(0);
+  });
+});
@@ -0,0 +1,195 @@
+/**
+ * Ephemeris Screening Test Suite
+ *
+ * Checks the native screener's grouped coarse sweep and refinement against
+ * range minima found by dense 1 s sampling through the pipeline, and that
+ * a capped screen keeps the first approaches of the full one.
+ */
+
+import { describe, it, expect, afterAll } from 'vitest';
+import { encodeScreenLimits, screenEphemeris, type UserEphemeris } from '../../lib/screen.js';
+import { encodePipeline, runPipeline } from '../../lib/pipeline.js';
+import { createExtendedNativeSGP4, type NativeSGP4Module } from '../../dist/sgp4-native.js';
+import { writeFileSync, mkdirSync } from 'fs';
+import { join, dirname } from 'path';
+import { fileURLToPath } from 'url';
+
+// Results directory for this test suite
+const __filename = fileURLToPath(import.meta.url);
+const __dirname = dirname(__filename);
+const RESULTS_DIR = join(__dirname, 'results');
+
+// Ensure results directory exists
+mkdirSync(RESULTS_DIR, { recursive: true });
+
+/**
+ * Write test results to the results directory
+ */
+function writeTestResult(filename: string, data: unknown): void {
+  const filepath = join(RESULTS_DIR, filename);
+  writeFileSync(filepath, JSON.stringify(data, null, 2));
+}
+
+// The native addon is only built for the native server image
+const native: NativeSGP4Module | undefined = await createExtendedNativeSGP4()
+  .then(async (m) => (await m.init(), m))
+  .catch(() => undefined);
+
+/** Drag-free TLE: the kernel's velocities are then the rate of its positions */
+function tleOf(id: number, inc: number, raan: number, ecc: number, argp: number, ma: number, revPerDay: number) {
+  const f = (v: number, width: number, digits: number): string => v.toFixed(digits).padStart(width, ' ');
+  const norad = String(id).padStart(5, '0');
+  return {
+    line1: `1 ${norad}U 24001A   24015.50000000  .00000000  00000-0  00000-0 0  9990`,
+    line2:
+      `2 ${norad} ${f(inc, 8, 4)} ${f(raan, 8, 4)} ${String(Math.round(ecc * 1e7)).padStart(7, '0')} ` +
+      `${f(argp, 8, 4)} ${f(ma, 8, 4)} ${f(revPerDay, 11, 8)}    10`,
+  };
+}
+
+describe.skipIf(!native)('Ephemeris Screening', () => {
+  const testResults: Record<string, unknown> = {
+    suite: 'Ephemeris Screening',
+    tests: {} as Record<string, unknown>,
+  };
+
+  afterAll(() => {
+    writeTestResult('screen-results.json', testResults);
+  });
+
+  // Pseudo-random LEO catalog; every 10th object in a 12 h orbit, so the
+  // screener's groups break on the coarse step
+  let seed = 1;
+  const random = (): number => (seed = (seed * 16807) % 2147483647) / 2147483647;
+  const SATELLITES = Array.from({ length: 80 }, (_, i) =>
+    tleOf(10000 + i, 40 + 60 * random(), 360 * random(), 0.02 * random(), 360 * random(), 360 * random(),
+      i % 10 === 9 ? 2.005 : 14.6 + random())
+  );
+
+  const LIMITS = { distance: 500 };
+
+  // Dense-sampling tolerances: parabola through three 1 s samples of range^2
+  const TCA_TOLERANCE = 0.01;
+  const DISTANCE_TOLERANCE = 1e-3;
+
+  const et0 = native ? native.utcToET('2024-01-15T12:00:00') : 0;
+  const etf = et0 + 43200;
+
+  /** Ephemeris of a 53 degree LEO at 30 s */
+  const ephemeris = (): UserEphemeris => {
+    const tle = tleOf(90000, 53, 40, 0.001, 90, 0, 15.06);
+    const packed = native!.propagateRangePacked(native!.parseTLE(tle.line1, tle.line2), et0, etf, 30);
+    return { frame: 'TEME', packed };
+  };
+
+  /** Ephemeris position at et, Hermite-interpolated as the native screener does */
+  function interpolate(packed: Float64Array, et: number): number[] {
+    const n = packed.length / 7;
+    let k = Math.min(Math.max(Math.floor((et - packed[0]) / (packed[1] - packed[0])), 0), n - 2);
+    while (k > 0 && packed[k] > et) k--;
+    while (k < n - 2 && packed[k + 1] < et) k++;
+    const h = packed[k + 1] - packed[k];
+    const s = Math.min(Math.max((et - packed[k]) / h, 0), 1);
+    const s2 = s * s;
+    const s3 = s2 * s;
+    const h00 = 2 * s3 - 3 * s2 + 1;
+    const h10 = s3 - 2 * s2 + s;
+    const h01 = -2 * s3 + 3 * s2;
+    const h11 = s3 - s2;
+    return [1, 2, 3].map(
+      (c) =>
+        h00 * packed[c * n + k] + h10 * h * packed[(c + 3) * n + k] +
+        h01 * packed[c * n + k + 1] + h11 * h * packed[(c + 3) * n + k + 1]
+    );
+  }
+
+  /**
+   * Local minima of the range within the distance limit, from 1 s samples
+   * refined with a parabola through range^2 around each
+   */
+  function denseApproaches(eph: UserEphemeris): Array<{ sat: number; tca: number; distance: number }> {
+    const stages = encodePipeline([{ select: ['et', 'x', 'y', 'z'] }]);
+    const approaches: Array<{ sat: number; tca: number; distance: number }> = [];
+
+    SATELLITES.forEach((satellite, sat) => {
+      const out = runPipeline(native!, [satellite], stages, { et0, etf, step: 1 });
+      const rows = out.rowSat.length;
+      const et = new Float64Array(rows);
+      const d2 = new Float64Array(rows);
+      for (let r = 0; r < rows; r++) {
+        const [t, x, y, z] = out.rows.subarray(r * 4, r * 4 + 4);
+        const u = interpolate(eph.packed, t);
+        et[r] = t;
+        d2[r] = (x - u[0]) ** 2 + (y - u[1]) ** 2 + (z - u[2]) ** 2;
+      }
+
+      for (let r = 0; r < rows; r++) {
+        const before = r > 0 ? d2[r - 1] : Infinity;
+        const after = r < rows - 1 ? d2[r + 1] : Infinity;
+        if (!(d2[r] < before && d2[r] <= after)) continue;
+        let tca = et[r];
+        let min = d2[r];
+        if (r > 0 && r < rows - 1) {
+          const curvature = before - 2 * d2[r] + after;
+          const shift = (0.5 * (before - after)) / curvature;
+          tca += shift;
+          min -= 0.25 * (before - after) * shift;
+        }
+        if (Math.sqrt(min) <= LIMITS.distance) {
+          approaches.push({ sat, tca, distance: Math.sqrt(min) });
+        }
+      }
+    });
+    return approaches;
+  }
+
+  it('should find every dense-sampling range minimum at the same time and distance', () => {
+    const eph = ephemeris();
+    const found = screenEphemeris(native!, SATELLITES, eph, encodeScreenLimits(LIMITS));
+    const dense = denseApproaches(eph);
+
+    expect(found.truncated).toBe(false);
+    expect(found.tca.length).toBe(dense.length);
+
+    let worstTca = 0;
+    let worstDistance = 0;
+    for (const d of dense) {
+      let best = -1;
+      for (let i = 0; i < found.tca.length; i++) {
+        if (found.sat[i] === d.sat && (best < 0 || Math.abs(found.tca[i] - d.tca) < Math.abs(found.tca[best] - d.tca))) {
+          best = i;
+        }
+      }
+      expect(best).toBeGreaterThanOrEqual(0);
+      worstTca = Math.max(worstTca, Math.abs(found.tca[best] - d.tca));
+      worstDistance = Math.max(worstDistance, Math.abs(found.distance[best] - d.distance));
+    }
+    expect(worstTca).toBeLessThan(TCA_TOLERANCE);
+    expect(worstDistance).toBeLessThan(DISTANCE_TOLERANCE);
+
+    (testResults.tests as Record<string, unknown>).dense = {
+      candidates: found.candidates,
+      approaches: dense.length,
+      worstTcaSeconds: worstTca,
+      worstDistanceKm: worstDistance,
+    };
+  });
+
+  it('should return approaches sorted by satellite, then time', () => {
+    const found = screenEphemeris(native!, SATELLITES, ephemeris(), encodeScreenLimits(LIMITS));
+    for (let i = 1; i < found.tca.length; i++) {
+      const sameSat = found.sat[i] === found.sat[i - 1];
+      expect(found.sat[i] > found.sat[i - 1] || (sameSat && found.tca[i] >= found.tca[i - 1])).toBe(true);
+    }
+  });
+
+  it('should keep the first approaches in that order when capped', () => {
+    const eph = ephemeris();
+    const limits = encodeScreenLimits(LIMITS);
+    const all = screenEphemeris(native!, SATELLITES, eph, limits);
+    const capped = screenEphemeris(native!, SATELLITES, eph, limits, 0, 20);
+    expect(capped.truncated).toBe(true);
+    expect(Array.from(capped.sat)).toEqual(Array.from(all.sat.subarray(0, 20)));
+    expect(Array.from(capped.tca)).toEqual(Array.from(all.tca.subarray(0, 20)));
+  });
+});
@@ -0,0 +1,136 @@
+/**
+ * Shadow Comparison Test Suite
+ *
+ * Checks that the shadow comparator pairs served and reference states at
+ * the same ET: identical engines give a near-zero difference, and a
+ * reference on another time scale fails the comparison instead of being
+ * recorded as an orbit-sized difference.
+ */
+
+import { describe, it, expect, afterAll } from 'vitest';
+import { ShadowComparator, type ShadowSample } from '../../lib/shadow.js';
+import type { EngineRouter } from '../../lib/engine.js';
+import type { SGP4NativeWorkerPool } from '../../lib/worker-pool-native.js';
+import type { PropagateState, PropagateTask } from '../../lib/worker-types.js';
+import { createExtendedNativeSGP4, type NativeSGP4Module } from '../../dist/sgp4-native.js';
+import { writeFileSync, mkdirSync } from 'fs';
+import { join, dirname } from 'path';
+import { fileURLToPath } from 'url';
+
+// Results directory for this test suite
+const __filename = fileURLToPath(import.meta.url);
+const __dirname = dirname(__filename);
+const RESULTS_DIR = join(__dirname, 'results');
+
+// Ensure results directory exists
+mkdirSync(RESULTS_DIR, { recursive: true });
+
+/**
+ * Write test results to the results directory
+ */
+function writeTestResult(filename: string, data: unknown): void {
+  const filepath = join(RESULTS_DIR, filename);
+  writeFileSync(filepath, JSON.stringify(data, null, 2));
+}
+
+// The native addon is only built for the native server image
+const native: NativeSGP4Module | undefined = await createExtendedNativeSGP4()
+  .then(async (m) => (await m.init(), m))
+  .catch(() => undefined);
+
+type Task = Omit<PropagateTask, 'type' | 'taskId'>;
+
+describe.skipIf(!native)('Shadow Comparison', () => {
+  const testResults: Record<string, unknown> = {
+    suite: 'Shadow Comparison',
+    tests: {} as Record<string, unknown>,
+  };
+
+  afterAll(() => {
+    writeTestResult('shadow-results.json', testResults);
+  });
+
+  const ISS = {
+    line1: '1 25544U 98067A   24015.50000000  .00016717  00000-0  10270-3 0  9025',
+    line2: '2 25544  51.6400 208.9163 0006703  30.0825 330.0579 15.49560830    19',
+  };
+
+  /** Native packed states over a task's grid */
+  const packedOf = (task: Task): Float64Array => {
+    const tle = native!.parseTLE(task.tle.line1, task.tle.line2);
+    return native!.propagateRangePacked(tle, task.times.et0, task.times.etf, task.times.step);
+  };
+
+  /** State objects of packed columns, ETs shifted by `shift` seconds */
+  const statesOf = (packed: Float64Array, shift = 0): PropagateState[] => {
+    const n = packed.length / 7;
+    return Array.from({ length: n }, (_, i) => ({
+      datetime: native!.etToUTC(packed[i]),
+      et: packed[i] + shift,
+      position: [packed[n + i], packed[2 * n + i], packed[3 * n + i]],
+      velocity: [packed[4 * n + i], packed[5 * n + i], packed[6 * n + i]],
+    }));
+  };
+
+  /**
+   * Comparator whose CSPICE engine is the native kernel returning ETs
+   * shifted by `shift` (0: the router's native ET grid)
+   */
+  const comparator = (shift = 0): ShadowComparator => {
+    const router = {
+      stats: { cspiceAvailable: true },
+      propagate: async (task: Task) => ({ states: statesOf(packedOf(task), shift), epoch: 0, model: task.model }),
+    };
+    const pool = {
+      propagate: async (task: Task) => ({ states: [], packed: packedOf(task), epoch: 0, model: task.model }),
+    };
+    process.env.SGP4_SHADOW_RATE = '1';
+    const shadow = new ShadowComparator(router as unknown as EngineRouter, pool as unknown as SGP4NativeWorkerPool);
+    delete process.env.SGP4_SHADOW_RATE;
+    return shadow;
+  };
+
+  const settle = async (shadow: ShadowComparator): Promise<void> => {
+    while (shadow.stats.inFlight > 0) {
+      await new Promise((resolve) => setTimeout(resolve, 5));
+    }
+  };
+
+  const sampleOf = (engine: 'native' | 'cspice'): ShadowSample => {
+    const et0 = native!.utcToET('2024-01-15T12:00:00');
+    const task = { tle: ISS, times: { et0, etf: et0 + 86400, step: 30 }, model: 'wgs72' };
+    const packed = packedOf(task);
+    return {
+      ...task,
+      elements: native!.parseTLE(ISS.line1, ISS.line2).elements,
+      engine,
+      ...(engine === 'native' ? { packed } : { states: statesOf(packed) }),
+    };
+  };
+
+  it('should find no difference between identical engines on the same grid', async () => {
+    const shadow = comparator();
+    shadow.offer(sampleOf('native'));
+    shadow.offer(sampleOf('cspice'));
+    await settle(shadow);
+
+    const { failed, regimes, worst } = shadow.stats;
+    expect(failed).toBe(0);
+    expect(regimes.LEO?.samples).toBe(2);
+    expect(regimes.LEO!.maxPositionKm).toBeLessThan(1e-9);
+    expect(regimes.LEO!.maxVelocityKmS).toBeLessThan(1e-12);
+    expect(worst.map((c) => c.reference).sort()).toEqual(['cspice', 'native']);
+
+    (testResults.tests as Record<string, unknown>).identical = regimes.LEO;
+  });
+
+  it('should fail a comparison whose reference states are on another time scale', async () => {
+    // CSPICE ET (TDB) runs 69.184 s ahead of native ET in 2024
+    const shadow = comparator(69.184);
+    shadow.offer(sampleOf('native'));
+    await settle(shadow);
+
+    expect(shadow.stats.failed).toBe(1);
+    expect(shadow.stats.regimes.LEO).toBeUndefined();
+  });
+});
@@ -0,0 +1,149 @@
+/**
+ * Sweep Kernel Test Suite
+ *
+ * Checks the tiled satellite x time sweep (propagateBatchPacked(),
+ * propagateRangePacked()) against the per-satellite scalar path
+ * (propagate()) over batch and grid sizes that leave partial tiles, in full
+ * and compact coefficient storage.
+ */
+
+import { describe, it, expect, afterAll } from 'vitest';
+import { createExtendedNativeSGP4, type NativeSGP4Module } from '../../dist/sgp4-native.js';
+import { writeFileSync, mkdirSync } from 'fs';
+import { join, dirname } from 'path';
+import { fileURLToPath } from 'url';
+
+// Results directory for this test suite
+const __filename = fileURLToPath(import.meta.url);
+const __dirname = dirname(__filename);
+const RESULTS_DIR = join(__dirname, 'results');
+
+// Ensure results directory exists
+mkdirSync(RESULTS_DIR, { recursive: true });
+
+/**
+ * Write test results to the results directory
+ */
+function writeTestResult(filename: string, data: unknown): void {
+  const filepath = join(RESULTS_DIR, filename);
+  writeFileSync(filepath, JSON.stringify(data, null, 2));
+}
+
+// The native addon is only built for the native server image
+const native: NativeSGP4Module | undefined = await createExtendedNativeSGP4()
+  .then(async (m) => (await m.init(), m))
+  .catch(() => undefined);
+
+describe.skipIf(!native)('Sweep Kernel', () => {
+  const testResults: Record<string, unknown> = {
+    suite: 'Sweep Kernel',
+    tests: {} as Record<string, unknown>,
+  };
+
+  afterAll(() => {
+    native?.setCompactCoefficients(false);
+    writeTestResult('sweep-results.json', testResults);
+  });
+
+  // LEO, sun-synchronous, Molniya and GPS-like orbits with different epochs;
+  // 7 satellites fill one 4-satellite tile and part of another
+  const SATELLITES = [
+    {
+      line1: '1 25544U 98067A   24015.50000000  .00016717  00000-0  10270-3 0  9025',
+      line2: '2 25544  51.6400 208.9163 0006703  30.0825 330.0579 15.49560830    19',
+    },
+    {
+      line1: '1 43013U 17073A   24014.25000000  .00000100  00000-0  50000-4 0  9990',
+      line2: '2 43013  97.7000  10.0000 0001000  90.0000 270.0000 14.80000000    10',
+    },
+    {
+      line1: '1 40296U 14069A   24015.00000000  .00000100  00000-0  00000-0 0  9990',
+      line2: '2 40296  63.4000 300.0000 7000000 270.0000  10.0000  2.00600000    10',
+    },
+    {
+      line1: '1 41019U 15062A   24013.75000000  .00000000  00000-0  00000-0 0  9990',
+      line2: '2 41019  55.0000 120.0000 0050000 200.0000 160.0000  2.00564000    10',
+    },
+    {
+      line1: '1 99001U 24001A   24015.50000000  .00000000  00000-0  00000-0 0  9990',
+      line2: '2 99001   0.0000   0.0000 0000000   0.0000   0.0000 15.00000000    10',
+    },
+    {
+      line1: '1 99003U 24001A   24016.00000000  .00000000  00000-0  00000-0 0  9990',
+      line2: '2 99003   0.0000 250.0000 0100000 120.0000  30.0000 14.00000000    10',
+    },
+    {
+      line1: '1 28654U 05018A   24015.10000000  .00000090  00000-0  70000-4 0  9990',
+      line2: '2 28654  99.0000  45.0000 0014000  80.0000 280.0000 14.12000000    10',
+    },
+  ];
+
+  const tles = () => SATELLITES.map((s) => native!.parseTLE(s.line1, s.line2));
+
+  /**
+   * Largest position (km) and velocity (km/s) difference of a packed batch
+   * from per-satellite propagate() on the same grid
+   */
+  function worstAgainstScalar(packed: Float64Array, et0: number, step: number, steps: number): { km: number; kms: number } {
+    let km = 0;
+    let kms = 0;
+    tles().forEach((tle, s) => {
+      const block = packed.subarray(s * steps * 7, (s + 1) * steps * 7);
+      for (let i = 0; i < steps; i++) {
+        const et = et0 + i * step;
+        const { position: p, velocity: v } = native!.propagate(tle, et);
+        expect(block[i]).toBe(et);
+        km = Math.max(km, Math.abs(block[steps + i] - p.x), Math.abs(block[2 * steps + i] - p.y), Math.abs(block[3 * steps + i] - p.z));
+        kms = Math.max(
+          kms,
+          Math.abs(block[4 * steps + i] - v.vx),
+          Math.abs(block[5 * steps + i] - v.vy),
+          Math.abs(block[6 * steps + i] - v.vz)
+        );
+      }
+    });
+    return { km, kms };
+  }
+
+  it('should match the per-satellite path with full coefficients', () => {
+    native!.setCompactCoefficients(false);
+    const et0 = native!.utcToET('2024-01-15T12:00:00');
+    const elements = new Float64Array(SATELLITES.length * 10);
+    tles().forEach((tle, s) => elements.set(tle.elements, s * 10));
+
+    // 11 steps: two full 4-step tiles and a partial one
+    const worst = worstAgainstScalar(native!.propagateBatchPacked(elements, et0, et0 + 5000, 500), et0, 500, 11);
+    expect(worst.km).toBeLessThan(1e-8);
+    expect(worst.kms).toBeLessThan(1e-11);
+
+    (testResults.tests as Record<string, unknown>).full = worst;
+  });
+
+  it('should match a satellite swept alone', () => {
+    native!.setCompactCoefficients(false);
+    const et0 = native!.utcToET('2024-01-15T12:00:00');
+    const elements = new Float64Array(SATELLITES.length * 10);
+    tles().forEach((tle, s) => elements.set(tle.elements, s * 10));
+    const batch = native!.propagateBatchPacked(elements, et0, et0 + 86400, 60);
+    const steps = 1441;
+
+    tles().forEach((tle, s) => {
+      const alone = native!.propagateRangePacked(tle, et0, et0 + 86400, 60);
+      expect(Array.from(batch.subarray(s * steps * 7, (s + 1) * steps * 7))).toEqual(Array.from(alone));
+    });
+  });
+
+  it('should stay within centimetres of the per-satellite path with compact coefficients', () => {
+    native!.setCompactCoefficients(true);
+    const et0 = native!.utcToET('2024-01-15T12:00:00');
+    const elements = new Float64Array(SATELLITES.length * 10);
+    tles().forEach((tle, s) => elements.set(tle.elements, s * 10));
+
+    const worst = worstAgainstScalar(native!.propagateBatchPacked(elements, et0, et0 + 5000, 500), et0, 500, 11);
+    native!.setCompactCoefficients(false);
+    expect(worst.km).toBeLessThan(1e-4);
+    expect(worst.kms).toBeLessThan(1e-6);
+
+    (testResults.tests as Record<string, unknown>).compact = worst;
+  });
+});